@@ -68,6 +68,10 @@ std::string AcceptedLedgerTx::getEscMeta () const
 
 void AcceptedLedgerTx::buildJson ()
 {
+    // The transaction is cached with its ledger, long after the request
+    // that may have built it
+    Json::Arena::Suspend heap;
+
     mJson = Json::objectValue;
     mJson[jss::transaction] = mTxn->getJson (0);
 
@@ -13,6 +13,7 @@
 
 #include <mtchain/app/main/Application.h>
 #include <mtchain/app/ledger/Ledger.h>
+#include <mtchain/app/ledger/impl/FetchPipeline.h>
 #include <mtchain/overlay/PeerSet.h>
 #include <mtchain/basics/CountedObject.h>
 #include <mutex>
@@ -89,7 +90,15 @@ private:
 
     void filterNodes (
         std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-        TriggerReason reason);
+        TriggerReason reason, std::size_t limit);
+
+    std::vector<std::shared_ptr<Peer>> getPipelinePeers (
+        std::shared_ptr<Peer> const& peer);
+
+    void requestNodes (protocol::TMGetLedger& tmGL,
+        std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
+        std::shared_ptr<Peer> const& peer,
+        std::vector<std::shared_ptr<Peer>> const& pipelinePeers);
 
     void trigger (std::shared_ptr<Peer> const&, TriggerReason);
 
@@ -116,7 +125,7 @@ private:
 
     bool takeHeader (std::string const& data);
     bool takeTxNode (const std::vector<SHAMapNodeID>& IDs,
-                     const std::vector<Blob>& data,
+                     const std::vector<Slice>& data,
                      SHAMapAddNode&);
     bool takeTxRootNode (Slice const& data, SHAMapAddNode&);
 
@@ -125,7 +134,7 @@ private:
     //             capitalize them correctly.
     //
     bool takeAsNode (const std::vector<SHAMapNodeID>& IDs,
-                     const std::vector<Blob>& data,
+                     const std::vector<Slice>& data,
                      SHAMapAddNode&);
     bool takeAsRootNode (Slice const& data, SHAMapAddNode&);
 
@@ -154,6 +163,9 @@ private:
 
     std::set <uint256> mRecentNodes;
 
+    // Node requests outstanding with each peer
+    FetchPipeline      mPipeline;
+
     SHAMapAddNode      mStats;
 
     // Data we have received from peers
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_APP_LEDGER_LEDGERHANDLES_H_INCLUDED
+#define MTCHAIN_APP_LEDGER_LEDGERHANDLES_H_INCLUDED
+
+#include <mtchain/app/ledger/Ledger.h>
+#include <mtchain/basics/base_uint.h>
+#include <mtchain/basics/chrono.h>
+#include <mtchain/basics/UnorderedContainers.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/ledger/CachedSLEs.h>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mtchain {
+
+/** Short lived handles on ledgers for RPC clients.
+
+    A handle keeps a ledger alive so that a client paging through it
+    reads the same ledger with every request. A closed ledger is read
+    through a CachedView, so the entries one request read are found by
+    the next without walking the state map again.
+
+    A handle expires once it has gone unused for its time to live. The
+    handles are limited in number, in all and for each client. The
+    ledgers they pin and the entries held by their views are counted
+    against a memory budget: over it, views drop the entries they hold
+    and read the plain ledger, and no more handles are made.
+*/
+class LedgerHandles
+{
+public:
+    struct Limits
+    {
+        std::size_t maxHandles;
+        std::size_t maxPerClient;
+        std::size_t maxBytes;
+        std::chrono::seconds maxTimeToLive;
+    };
+
+    /** A rough size of an entry held by a view. */
+    static std::size_t const bytesPerEntry = 512;
+
+    /** A rough size of the state a pinned ledger keeps in memory. */
+    static std::size_t const bytesPerLedger = 1024 * 1024;
+
+    LedgerHandles (Stopwatch& clock, CachedSLEs& cache,
+        Limits const& limits);
+
+    /** Make a handle on a ledger.
+
+        The per client limit does not apply if `unlimited` is set.
+
+        @return The handle, or boost::none if a limit was reached.
+    */
+    boost::optional<uint256>
+    make (std::shared_ptr<ReadView const> const& ledger,
+        std::string const& client, std::chrono::seconds timeToLive,
+        bool unlimited);
+
+    /** Returns the ledger of a handle and restarts its time to live.
+
+        Returns nullptr if there is no such handle.
+    */
+    std::shared_ptr<ReadView const>
+    find (uint256 const& handle);
+
+    /** Release a handle before it expires. */
+    bool
+    release (uint256 const& handle);
+
+    /** Drop the expired handles, then the entries held by the views
+        least recently used while over the budget.
+
+        Needs to be called periodically.
+    */
+    void
+    expire ();
+
+    /** Returns the number of handles. */
+    std::size_t
+    size () const;
+
+    /** Returns the bytes held by the ledgers and views of the handles. */
+    std::size_t
+    getBytes () const;
+
+    Json::Value
+    getJson () const;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<ReadView const> ledger;
+        std::shared_ptr<ReadView const> view;
+        std::shared_ptr<CachedLedger const> cached; // null if open or trimmed
+        std::string client;
+        std::chrono::seconds timeToLive;
+        Stopwatch::time_point used;
+    };
+
+    using Entries = hash_map<uint256, Entry>;
+
+    static
+    std::size_t
+    bytes (Entry const& entry);
+
+    std::size_t
+    bytes (std::lock_guard<std::mutex> const&) const;
+
+    bool
+    pinned (ReadView const* ledger,
+        std::lock_guard<std::mutex> const&) const;
+
+    std::size_t
+    trim (std::size_t total, std::lock_guard<std::mutex> const&);
+
+    Entries::iterator
+    erase (Entries::iterator iter, std::lock_guard<std::mutex> const&);
+
+    Stopwatch& clock_;
+    CachedSLEs& cache_;
+    Limits const limits_;
+
+    std::mutex mutable mutex_;
+    Entries entries_;
+    std::map<std::string, std::size_t> clients_;
+};
+
+} //
+
+#endif
@@ -34,6 +34,7 @@
 
 namespace mtchain {
 
+class FetchPackStream;
 class Peer;
 class Transaction;
 
@@ -272,6 +273,14 @@ private:
     void updatePaths(Job& job);
     void newPFWork(const char *name);
 
+    void streamFetchPack (
+        std::weak_ptr<Peer> const& wPeer,
+        std::shared_ptr<FetchPackStream> const& stream,
+        std::shared_ptr<Ledger const> haveLedger,
+        std::uint32_t uUptime);
+
+    void finishFetchPack (FetchPackStream& stream);
+
 private:
     using ScopedLockType = std::lock_guard <std::recursive_mutex>;
     using ScopedUnlockType = GenericScopedUnlock <std::recursive_mutex>;
@@ -343,6 +352,12 @@ private:
 
     TaggedCache<uint256, Blob> fetch_packs_;
 
+    // Bytes sent by the fetch packs still being built
+    std::atomic <std::size_t> fetch_pack_bytes_ {0};
+
+    // A job is queued to use newly arrived fetch packs
+    std::atomic <bool> got_fetch_pack_ {false};
+
     std::uint32_t fetch_seq_;
     std::uint32_t last_missing_ledger_;
     DeadlineTimer tryAdvanceTimer_;
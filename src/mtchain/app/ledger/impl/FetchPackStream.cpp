@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/impl/FetchPackStream.h>
+
+namespace mtchain {
+
+FetchPackStream::FetchPackStream (
+        protocol::TMGetObjectByHash const& request,
+        std::size_t chunkBytes, Sink sink)
+    : chunkBytes_ (chunkBytes)
+    , sink_ (std::move (sink))
+{
+    chunk_.set_query (false);
+    if (request.has_seq ())
+        chunk_.set_seq (request.seq ());
+    chunk_.set_ledgerhash (request.ledgerhash ());
+    chunk_.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
+}
+
+void
+FetchPackStream::add (std::uint32_t seq, uint256 const& hash,
+    void const* data, std::size_t size)
+{
+    protocol::TMIndexedObject& newObj = *chunk_.add_objects ();
+    newObj.set_hash (hash.data (), hash.size ());
+    newObj.set_data (data, size);
+    newObj.set_ledgerseq (seq);
+
+    ++objects_;
+    pending_ += size;
+    if (pending_ >= chunkBytes_)
+        flush ();
+}
+
+void
+FetchPackStream::addMap (std::uint32_t seq, SHAMap const& want,
+    SHAMap const* have, int max)
+{
+    want.getFetchPack (have, true, max,
+        [this, seq] (SHAMapHash const& hash, Blob const& blob)
+        {
+            add (seq, hash.as_uint256 (), blob.data (), blob.size ());
+        });
+}
+
+void
+FetchPackStream::flush ()
+{
+    if (chunk_.objects_size () == 0)
+        return;
+
+    sink_ (chunk_, pending_);
+    bytes_ += pending_;
+    ++chunks_;
+    pending_ = 0;
+    chunk_.clear_objects ();
+}
+
+} //
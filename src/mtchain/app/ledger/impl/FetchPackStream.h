@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_APP_LEDGER_FETCHPACKSTREAM_H_INCLUDED
+#define MTCHAIN_APP_LEDGER_FETCHPACKSTREAM_H_INCLUDED
+
+#include <mtchain/basics/base_uint.h>
+#include <mtchain/shamap/SHAMap.h>
+#include "mtchain.pb.h"
+#include <cstdint>
+#include <functional>
+
+namespace mtchain {
+
+/** Sends a fetch pack in chunks as it is built.
+
+    Each chunk is a complete fetch pack reply holding about `chunkBytes`
+    of objects. It is handed to the sink as soon as it fills, so the
+    pack is never held in memory whole and the peer can use each chunk
+    as it arrives.
+*/
+class FetchPackStream
+{
+public:
+    /** Called with each chunk and the bytes of object data it holds. */
+    using Sink = std::function <void (
+        protocol::TMGetObjectByHash const& chunk, std::size_t bytes)>;
+
+    FetchPackStream (protocol::TMGetObjectByHash const& request,
+        std::size_t chunkBytes, Sink sink);
+
+    /** Add an object to the pack. */
+    void
+    add (std::uint32_t seq, uint256 const& hash,
+        void const* data, std::size_t size);
+
+    /** Add up to `max` nodes of `want` that are not in `have`. */
+    void
+    addMap (std::uint32_t seq, SHAMap const& want,
+        SHAMap const* have, int max);
+
+    /** Send the objects not sent yet. */
+    void
+    flush ();
+
+    /** Returns the number of objects added. */
+    std::size_t
+    getObjects () const
+    {
+        return objects_;
+    }
+
+    /** Returns the bytes of object data sent. */
+    std::size_t
+    getBytes () const
+    {
+        return bytes_;
+    }
+
+    /** Returns the number of chunks sent. */
+    std::size_t
+    getChunks () const
+    {
+        return chunks_;
+    }
+
+private:
+    protocol::TMGetObjectByHash chunk_;
+    std::size_t const chunkBytes_;
+    Sink sink_;
+    std::size_t pending_ = 0;
+    std::size_t objects_ = 0;
+    std::size_t bytes_ = 0;
+    std::size_t chunks_ = 0;
+};
+
+} //
+
+#endif
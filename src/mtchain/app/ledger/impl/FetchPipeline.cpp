@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/impl/FetchPipeline.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace mtchain {
+
+FetchPipeline::FetchPipeline (clock_type& clock, std::size_t depth)
+    : clock_ (clock)
+    , depth_ (std::max <std::size_t> (depth, 1))
+{
+}
+
+std::size_t
+FetchPipeline::capacity (std::vector <Peer::id_t> const& peers) const
+{
+    std::size_t result = 0;
+    for (auto id : peers)
+    {
+        auto const iter = peers_.find (id);
+        if (iter == peers_.end ())
+            result += depth_;
+        else if (iter->second.sent.size () < depth_)
+            result += depth_ - iter->second.sent.size ();
+    }
+    return result;
+}
+
+std::vector <FetchPipeline::Request>
+FetchPipeline::assign (std::vector <Peer::id_t> const& peers,
+    std::size_t count, std::size_t maxNodes)
+{
+    std::vector <Request> result;
+    if (count == 0 || maxNodes == 0)
+        return result;
+
+    // Peers that have not replied yet are taken to be average
+    double total = 0;
+    std::size_t measured = 0;
+    for (auto const& entry : peers_)
+    {
+        if (entry.second.replies != 0)
+        {
+            total += entry.second.rate;
+            ++measured;
+        }
+    }
+    double const defaultRate = (measured != 0 && total > 0)
+        ? total / measured
+        : 1;
+
+    struct Share
+    {
+        Peer::id_t id;
+        PeerState* state;
+        double weight;
+        std::size_t room;
+        std::size_t nodes;
+    };
+
+    std::vector <Share> shares;
+    double weights = 0;
+    for (auto id : peers)
+    {
+        auto& state = peers_[id];
+        if (state.sent.size () >= depth_)
+            continue;
+        auto const w = weight (state, defaultRate);
+        shares.push_back ({ id, &state, w,
+            (depth_ - state.sent.size ()) * maxNodes, 0 });
+        weights += w;
+    }
+    if (shares.empty ())
+        return result;
+
+    // The fastest peers go first, and get what is left over
+    std::stable_sort (shares.begin (), shares.end (),
+        [](Share const& a, Share const& b)
+        {
+            return a.weight > b.weight;
+        });
+
+    std::size_t assigned = 0;
+    for (auto& share : shares)
+    {
+        share.nodes = std::min (share.room,
+            static_cast <std::size_t> (count * share.weight / weights));
+        assigned += share.nodes;
+    }
+    for (auto& share : shares)
+    {
+        auto const extra = std::min (share.room - share.nodes,
+            count - assigned);
+        share.nodes += extra;
+        assigned += extra;
+    }
+
+    auto const now = clock_.now ();
+    if (! started_)
+    {
+        start_ = now;
+        started_ = true;
+    }
+
+    std::size_t first = 0;
+    for (auto const& share : shares)
+    {
+        for (auto left = share.nodes; left != 0;)
+        {
+            auto const n = std::min (left, maxNodes);
+            result.push_back ({ share.id, first, n });
+            share.state->sent.push_back (now);
+            ++share.state->requests;
+            first += n;
+            left -= n;
+        }
+    }
+    return result;
+}
+
+void
+FetchPipeline::onReply (Peer::id_t peer, std::size_t nodes)
+{
+    nodes_ += nodes;
+
+    auto const iter = peers_.find (peer);
+    if (iter == peers_.end ())
+        return;
+    auto& state = iter->second;
+    state.nodes += nodes;
+
+    // A reply to a request sent to every peer
+    if (state.sent.empty ())
+        return;
+
+    auto const elapsed = std::chrono::duration <double> (
+        clock_.now () - state.sent.front ()).count ();
+    state.sent.pop_front ();
+    state.strikes = 0;
+
+    auto const latency = elapsed * 1000;
+    auto const rate = nodes / std::max (elapsed, 0.001);
+    if (state.replies++ == 0)
+    {
+        state.latency = latency;
+        state.rate = rate;
+    }
+    else
+    {
+        state.latency += (latency - state.latency) / 4;
+        state.rate += (rate - state.rate) / 4;
+    }
+}
+
+void
+FetchPipeline::expire (std::chrono::milliseconds timeout)
+{
+    auto const now = clock_.now ();
+    for (auto& entry : peers_)
+    {
+        auto& state = entry.second;
+        while (! state.sent.empty () && now - state.sent.front () >= timeout)
+        {
+            state.sent.pop_front ();
+            ++state.timeouts;
+            ++state.strikes;
+        }
+    }
+}
+
+double
+FetchPipeline::getRate () const
+{
+    if (! started_)
+        return 0;
+    auto const elapsed = std::chrono::duration <double> (
+        clock_.now () - start_).count ();
+    if (elapsed <= 0)
+        return 0;
+    return nodes_ / elapsed;
+}
+
+Json::Value
+FetchPipeline::getJson () const
+{
+    Json::Value ret (Json::arrayValue);
+    for (auto const& entry : peers_)
+    {
+        auto const& state = entry.second;
+        Json::Value& peer = ret.append (Json::objectValue);
+        peer[jss::peer] = static_cast <Json::UInt> (entry.first);
+        peer[jss::outstanding] = static_cast <Json::UInt> (state.sent.size ());
+        peer[jss::requests] = static_cast <Json::UInt> (state.requests);
+        peer[jss::timeouts] = static_cast <Json::UInt> (state.timeouts);
+        peer[jss::nodes] = static_cast <Json::UInt> (state.nodes);
+        if (state.replies != 0)
+        {
+            peer[jss::latency] = static_cast <Json::UInt> (state.latency);
+            peer[jss::nodes_per_second] =
+                static_cast <Json::UInt> (state.rate);
+        }
+    }
+    return ret;
+}
+
+double
+FetchPipeline::weight (PeerState const& state, double defaultRate) const
+{
+    // A slow peer still gets a trickle of nodes, so that it is measured
+    // again, but a peer that stopped replying gets less and less
+    auto const rate = (state.replies != 0)
+        ? std::max (state.rate, defaultRate / 16)
+        : defaultRate;
+    return rate / (1 + state.strikes);
+}
+
+} //
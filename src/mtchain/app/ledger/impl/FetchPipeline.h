@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_APP_LEDGER_FETCHPIPELINE_H_INCLUDED
+#define MTCHAIN_APP_LEDGER_FETCHPIPELINE_H_INCLUDED
+
+#include <mtchain/basics/chrono.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/overlay/Peer.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace mtchain {
+
+/** Spreads the node requests of a ledger acquisition over its peers.
+
+    Each peer may have several requests outstanding at once. The missing
+    nodes, sorted so that neighbours share subtrees, are cut into runs
+    and each peer is asked for its own runs, the peers that have been
+    delivering nodes fastest getting the longest ones. Replies from a
+    peer are matched to its requests in the order they were sent.
+
+    Not thread safe, the owner serializes access.
+*/
+class FetchPipeline
+{
+public:
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+    /** Ask `peer` for the `count` nodes starting at `first`. */
+    struct Request
+    {
+        Peer::id_t peer;
+        std::size_t first;
+        std::size_t count;
+    };
+
+    /** @param depth The number of requests a peer may have outstanding. */
+    FetchPipeline (clock_type& clock, std::size_t depth);
+
+    /** Returns the number of requests the peers can take right now. */
+    std::size_t
+    capacity (std::vector <Peer::id_t> const& peers) const;
+
+    /** Divide `count` nodes between the peers with room for requests.
+
+        No request is for more than `maxNodes` nodes. The requests
+        returned are taken to have been sent.
+    */
+    std::vector <Request>
+    assign (std::vector <Peer::id_t> const& peers,
+        std::size_t count, std::size_t maxNodes);
+
+    /** Record a reply from a peer carrying `nodes` useful nodes. */
+    void
+    onReply (Peer::id_t peer, std::size_t nodes);
+
+    /** Give up on requests outstanding for longer than `timeout`. */
+    void
+    expire (std::chrono::milliseconds timeout);
+
+    /** Returns the number of useful nodes received so far. */
+    std::uint64_t
+    getNodes () const
+    {
+        return nodes_;
+    }
+
+    /** Returns the useful nodes received per second since the start. */
+    double
+    getRate () const;
+
+    Json::Value
+    getJson () const;
+
+private:
+    struct PeerState
+    {
+        std::deque <clock_type::time_point> sent;
+        double latency = 0;         // milliseconds, smoothed
+        double rate = 0;            // nodes per second, smoothed
+        std::size_t strikes = 0;    // timeouts since the last reply
+        std::uint64_t requests = 0;
+        std::uint64_t replies = 0;
+        std::uint64_t timeouts = 0;
+        std::uint64_t nodes = 0;
+    };
+
+    double
+    weight (PeerState const& state, double defaultRate) const;
+
+    clock_type& clock_;
+    std::size_t const depth_;
+    std::map <Peer::id_t, PeerState> peers_;
+    clock_type::time_point start_;
+    bool started_ = false;
+    std::uint64_t nodes_ = 0;
+};
+
+} //
+
+#endif
@@ -52,6 +52,12 @@ enum
 
     // Number of nodes to request blindly
     ,reqNodes = 8
+
+    // Most nodes to request from all peers at once
+    ,reqNodesPipeline = 4096
+
+    // Number of peers asked for objects by hash
+    ,byHashPeers = 2
 };
 
 // millisecond for each ledger timeout
@@ -68,6 +74,7 @@ InboundLedger::InboundLedger (
     , mByHash (true)
     , mSeq (seq)
     , mReason (reason)
+    , mPipeline (clock, app.config().FETCH_PIPELINE)
     , mReceiveDispatched (false)
 {
     JLOG (m_journal.trace()) <<
@@ -346,6 +353,7 @@ bool InboundLedger::tryLocal ()
 void InboundLedger::onTimer (bool wasProgress, ScopedLockType&)
 {
     mRecentNodes.clear ();
+    mPipeline.expire (ledgerAcquireTimeout);
 
     if (isDone())
     {
@@ -531,16 +539,26 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                     }
                 }
 
-                auto packet = std::make_shared <Message> (
-                    tmBH, protocol::mtGET_OBJECTS);
-
+                // Ask the peers expected to answer soonest
+                std::vector <std::pair <std::chrono::milliseconds,
+                    std::shared_ptr <Peer>>> peers;
                 for (auto id : mPeers)
                 {
                     if (auto p = app_.overlay ().findPeerByShortID (id))
+                        peers.emplace_back (p->getObjectQueryWait (), p);
+                }
+                std::sort (peers.begin (), peers.end (),
+                    [](auto const& a, auto const& b)
                     {
-                        mByHash = false;
-                        p->send (packet);
-                    }
+                        return a.first < b.first;
+                    });
+                if (peers.size () > byHashPeers)
+                    peers.resize (byHashPeers);
+
+                for (auto const& p : peers)
+                {
+                    mByHash = false;
+                    p.second->sendObjectQuery (tmBH);
                 }
             }
             else
@@ -583,6 +601,21 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
     else
         tmGL.set_querydepth (1);
 
+    // Once peers are replying, keep every peer's pipeline full
+    std::vector<std::shared_ptr<Peer>> pipelinePeers;
+    std::size_t limit = reqNodes;
+    if (reason == TriggerReason::reply)
+    {
+        pipelinePeers = getPipelinePeers (peer);
+
+        std::vector<Peer::id_t> ids;
+        ids.reserve (pipelinePeers.size ());
+        for (auto const& p : pipelinePeers)
+            ids.push_back (p->id ());
+        limit = std::min<std::size_t> (reqNodesPipeline,
+            mPipeline.capacity (ids) * reqNodesReply);
+    }
+
     // Get the state data first because it's the most likely to be useful
     // if we wind up abandoning this fetch.
     if (mHaveHeader && !mHaveState && !mFailed)
@@ -612,7 +645,7 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
             // Release the lock while we process the large state map
             sl.unlock();
             auto nodes = mLedger->stateMap().getMissingNodes (
-                missingNodesFind, &filter);
+                std::max<std::size_t> (missingNodesFind, limit), &filter);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -632,21 +665,17 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                 }
                 else
                 {
-                    filterNodes (nodes, reason);
+                    filterNodes (nodes, reason, limit);
 
                     if (!nodes.empty ())
                     {
                         tmGL.set_itype (protocol::liAS_NODE);
-                        for (auto const& id : nodes)
-                        {
-                            * (tmGL.add_nodeids ()) = id.first.getRawString ();
-                        }
-
                         JLOG (m_journal.trace()) <<
                             "Sending AS node request (" <<
                             nodes.size () << ") to " <<
-                            (peer ? "selected peer" : "all peers");
-                        sendRequest (tmGL, peer);
+                            (!pipelinePeers.empty () ? "pipelined peers" :
+                                peer ? "selected peer" : "all peers");
+                        requestNodes (tmGL, nodes, peer, pipelinePeers);
                         return;
                     }
                     else
@@ -684,7 +713,7 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                 app_.getLedgerMaster());
 
             auto nodes = mLedger->txMap().getMissingNodes (
-                missingNodesFind, &filter);
+                std::max<std::size_t> (missingNodesFind, limit), &filter);
 
             if (nodes.empty ())
             {
@@ -700,20 +729,17 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
             }
             else
             {
-                filterNodes (nodes, reason);
+                filterNodes (nodes, reason, limit);
 
                 if (!nodes.empty ())
                 {
                     tmGL.set_itype (protocol::liTX_NODE);
-                    for (auto const& n : nodes)
-                    {
-                        * (tmGL.add_nodeids ()) = n.first.getRawString ();
-                    }
                     JLOG (m_journal.trace()) <<
                         "Sending TX node request (" <<
                         nodes.size () << ") to " <<
-                        (peer ? "selected peer" : "all peers");
-                    sendRequest (tmGL, peer);
+                        (!pipelinePeers.empty () ? "pipelined peers" :
+                            peer ? "selected peer" : "all peers");
+                    requestNodes (tmGL, nodes, peer, pipelinePeers);
                     return;
                 }
                 else
@@ -738,7 +764,7 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
 
 void InboundLedger::filterNodes (
     std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-    TriggerReason reason)
+    TriggerReason reason, std::size_t limit)
 {
     // Sort nodes so that the ones we haven't recently
     // requested come before the ones we have.
@@ -771,10 +797,6 @@ void InboundLedger::filterNodes (
         nodes.erase (dup, nodes.end());
     }
 
-    std::size_t const limit = (reason == TriggerReason::reply)
-        ? reqNodesReply
-        : reqNodes;
-
     if (nodes.size () > limit)
         nodes.resize (limit);
 
@@ -782,6 +804,74 @@ void InboundLedger::filterNodes (
         mRecentNodes.insert (n.second);
 }
 
+/** The peers to spread node requests over: those in the set we can
+    still reach, and the peer that just replied
+*/
+std::vector<std::shared_ptr<Peer>> InboundLedger::getPipelinePeers (
+    std::shared_ptr<Peer> const& peer)
+{
+    std::vector<std::shared_ptr<Peer>> ret;
+    ret.reserve (mPeers.size () + 1);
+
+    for (auto id : mPeers)
+    {
+        if (auto p = app_.overlay ().findPeerByShortID (id))
+            ret.push_back (std::move (p));
+    }
+
+    if (peer && (mPeers.count (peer->id ()) == 0))
+        ret.push_back (peer);
+
+    return ret;
+}
+
+/** Send a request for nodes, either as one request to `peer` (or all
+    peers) or divided between the pipelines of `pipelinePeers`
+*/
+void InboundLedger::requestNodes (protocol::TMGetLedger& tmGL,
+    std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
+    std::shared_ptr<Peer> const& peer,
+    std::vector<std::shared_ptr<Peer>> const& pipelinePeers)
+{
+    if (pipelinePeers.empty ())
+    {
+        for (auto const& n : nodes)
+            * (tmGL.add_nodeids ()) = n.first.getRawString ();
+        sendRequest (tmGL, peer);
+        return;
+    }
+
+    // Neighbouring nodes share subtrees, so the runs each peer
+    // is given cover disjoint parts of the tree
+    std::sort (nodes.begin (), nodes.end (),
+        [](auto const& a, auto const& b)
+        {
+            if (a.first.getNodeID () != b.first.getNodeID ())
+                return a.first.getNodeID () < b.first.getNodeID ();
+            return a.first.getDepth () < b.first.getDepth ();
+        });
+
+    std::vector<Peer::id_t> ids;
+    ids.reserve (pipelinePeers.size ());
+    for (auto const& p : pipelinePeers)
+        ids.push_back (p->id ());
+
+    for (auto const& request :
+        mPipeline.assign (ids, nodes.size (), reqNodesReply))
+    {
+        auto const iter = std::find (ids.begin (), ids.end (), request.peer);
+        auto const& p = pipelinePeers[iter - ids.begin ()];
+
+        protocol::TMGetLedger tmRequest (tmGL);
+        tmRequest.set_querydepth (p->isHighLatency () ? 2 : 1);
+        for (auto i = request.first; i != request.first + request.count; ++i)
+            * (tmRequest.add_nodeids ()) = nodes[i].first.getRawString ();
+
+        p->send (std::make_shared<Message> (
+            tmRequest, protocol::mtGET_LEDGER));
+    }
+}
+
 /** Take ledger header data
     Call with a lock
 */
@@ -833,7 +923,7 @@ bool InboundLedger::takeHeader (std::string const& data)
     Call with a lock
 */
 bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector< Slice >& data, SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -860,14 +950,14 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
         {
             san += mLedger->txMap().addRootNode (
                 SHAMapHash{mLedger->info().txHash},
-                    makeSlice(*nodeDatait), snfWIRE, &filter);
+                    *nodeDatait, snfWIRE, &filter);
             if (!san.isGood())
                 return false;
         }
         else
         {
             san +=  mLedger->txMap().addKnownNode (
-                *nodeIDit, makeSlice(*nodeDatait), &filter);
+                *nodeIDit, *nodeDatait, &filter);
             if (!san.isGood())
                 return false;
         }
@@ -894,7 +984,7 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
     Call with a lock
 */
 bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector< Slice >& data, SHAMapAddNode& san)
 {
     JLOG (m_journal.trace()) <<
         "got AMta (" << nodeIDs.size () <<
@@ -932,7 +1022,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         {
             san += mLedger->stateMap().addRootNode (
                 SHAMapHash{mLedger->info().accountHash},
-                    makeSlice(*nodeDatait), snfWIRE, &filter);
+                    *nodeDatait, snfWIRE, &filter);
             if (!san.isGood ())
             {
                 JLOG (m_journal.warn()) <<
@@ -943,7 +1033,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         else
         {
             san += mLedger->stateMap().addKnownNode (
-                *nodeIDit, makeSlice(*nodeDatait), &filter);
+                *nodeIDit, *nodeDatait, &filter);
             if (!san.isGood ())
             {
                 JLOG (m_journal.warn()) <<
@@ -1149,7 +1239,9 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
         std::vector<SHAMapNodeID> nodeIDs;
         nodeIDs.reserve(packet.nodes().size());
-        std::vector< Blob > nodeData;
+        // The node data is handed to the maps straight out of the
+        // packet, which outlives this call
+        std::vector< Slice > nodeData;
         nodeData.reserve(packet.nodes().size());
 
         for (int i = 0; i < packet.nodes ().size (); ++i)
@@ -1166,8 +1258,7 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
             nodeIDs.push_back (SHAMapNodeID (node.nodeid ().data (),
                 node.nodeid ().size ()));
-            nodeData.push_back (Blob (node.nodedata ().begin (),
-                node.nodedata ().end ()));
+            nodeData.push_back (makeSlice (node.nodedata ()));
         }
 
         SHAMapAddNode san;
@@ -1185,6 +1276,8 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
                 "Ledger AS node stats: " << san.get();
         }
 
+        mPipeline.onReply (peer->id (), san.getGood ());
+
         if (san.isUseful ())
             progress ();
 
@@ -1267,6 +1360,11 @@ Json::Value InboundLedger::getJson (int)
 
     ret[jss::timeouts] = getTimeouts ();
 
+    ret[jss::nodes_per_second] =
+        static_cast<Json::UInt> (mPipeline.getRate ());
+    if (!mComplete && !mFailed)
+        ret[jss::pipeline] = mPipeline.getJson ();
+
     if (mHaveHeader && !mHaveState)
     {
         Json::Value hv (Json::arrayValue);
@@ -149,8 +149,10 @@ public:
             return;
         }
 
-        std::list<SHAMapNodeID> nodeIDs;
-        std::list< Blob > nodeData;
+        std::vector<SHAMapNodeID> nodeIDs;
+        nodeIDs.reserve (packet.nodes ().size ());
+        std::vector< Slice > nodeData;
+        nodeData.reserve (packet.nodes ().size ());
         for (auto const &node : packet.nodes())
         {
             if (!node.has_nodeid () || !node.has_nodedata () || (
@@ -162,8 +164,7 @@ public:
 
             nodeIDs.emplace_back (node.nodeid ().data (),
                                static_cast<int>(node.nodeid ().size ()));
-            nodeData.emplace_back (node.nodedata ().begin (),
-                node.nodedata ().end ());
+            nodeData.push_back (makeSlice (node.nodedata ()));
         }
 
         if (! ta->takeNodes (nodeIDs, nodeData, peer).isUseful ())
@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/LedgerHandles.h>
+#include <mtchain/beast/utility/rngfill.h>
+#include <mtchain/crypto/csprng.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <algorithm>
+#include <vector>
+
+namespace mtchain {
+
+LedgerHandles::LedgerHandles (Stopwatch& clock, CachedSLEs& cache,
+        Limits const& limits)
+    : clock_ (clock)
+    , cache_ (cache)
+    , limits_ (limits)
+{
+}
+
+boost::optional<uint256>
+LedgerHandles::make (std::shared_ptr<ReadView const> const& ledger,
+    std::string const& client, std::chrono::seconds timeToLive,
+    bool unlimited)
+{
+    Entry entry;
+    entry.client = client;
+    entry.timeToLive = std::min (timeToLive, limits_.maxTimeToLive);
+    entry.used = clock_.now ();
+    entry.ledger = ledger;
+
+    // An open ledger already reads through the cache of its base
+    if (auto closed = std::dynamic_pointer_cast<Ledger const> (ledger))
+    {
+        entry.cached = std::make_shared<CachedLedger const> (
+            closed, cache_);
+        entry.view = entry.cached;
+    }
+    else
+    {
+        entry.view = ledger;
+    }
+
+    uint256 handle;
+    beast::rngfill (handle.begin (), handle.size (), crypto_prng ());
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (entries_.size () >= limits_.maxHandles)
+        return boost::none;
+
+    auto total = bytes (lock);
+    if (! pinned (ledger.get (), lock))
+        total += bytesPerLedger;
+    if (total > limits_.maxBytes &&
+        trim (total, lock) > limits_.maxBytes)
+        return boost::none;
+
+    auto& count = clients_[client];
+    if (! unlimited && count >= limits_.maxPerClient)
+    {
+        if (count == 0)
+            clients_.erase (client);
+        return boost::none;
+    }
+
+    ++count;
+    entries_.emplace (handle, std::move (entry));
+    return handle;
+}
+
+std::shared_ptr<ReadView const>
+LedgerHandles::find (uint256 const& handle)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const iter = entries_.find (handle);
+    if (iter == entries_.end ())
+        return nullptr;
+
+    // Between sweeps a handle may have expired already
+    auto const now = clock_.now ();
+    if (now - iter->second.used > iter->second.timeToLive)
+    {
+        erase (iter, lock);
+        return nullptr;
+    }
+    iter->second.used = now;
+    return iter->second.view;
+}
+
+bool
+LedgerHandles::release (uint256 const& handle)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const iter = entries_.find (handle);
+    if (iter == entries_.end ())
+        return false;
+    erase (iter, lock);
+    return true;
+}
+
+void
+LedgerHandles::expire ()
+{
+    auto const now = clock_.now ();
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto iter = entries_.begin (); iter != entries_.end ();)
+    {
+        if (now - iter->second.used > iter->second.timeToLive)
+            iter = erase (iter, lock);
+        else
+            ++iter;
+    }
+
+    trim (bytes (lock), lock);
+}
+
+std::size_t
+LedgerHandles::size () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return entries_.size ();
+}
+
+std::size_t
+LedgerHandles::getBytes () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return bytes (lock);
+}
+
+Json::Value
+LedgerHandles::getJson () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    Json::Value ret (Json::objectValue);
+    ret[jss::handles] = static_cast<Json::UInt> (entries_.size ());
+    ret[jss::clients] = static_cast<Json::UInt> (clients_.size ());
+    ret[jss::bytes] = static_cast<Json::UInt> (bytes (lock));
+    return ret;
+}
+
+std::size_t
+LedgerHandles::bytes (Entry const& entry)
+{
+    if (! entry.cached)
+        return 0;
+    return entry.cached->size () * bytesPerEntry;
+}
+
+std::size_t
+LedgerHandles::bytes (std::lock_guard<std::mutex> const&) const
+{
+    // A ledger counts once, however many handles pin it
+    hash_set<ReadView const*> ledgers;
+    std::size_t total = 0;
+    for (auto const& entry : entries_)
+    {
+        if (ledgers.insert (entry.second.ledger.get ()).second)
+            total += bytesPerLedger;
+        total += bytes (entry.second);
+    }
+    return total;
+}
+
+bool
+LedgerHandles::pinned (ReadView const* ledger,
+    std::lock_guard<std::mutex> const&) const
+{
+    return std::any_of (entries_.begin (), entries_.end (),
+        [ledger](auto const& entry)
+        {
+            return entry.second.ledger.get () == ledger;
+        });
+}
+
+std::size_t
+LedgerHandles::trim (std::size_t total, std::lock_guard<std::mutex> const&)
+{
+    std::vector<Entry*> cached;
+    for (auto& entry : entries_)
+    {
+        if (entry.second.cached)
+            cached.push_back (&entry.second);
+    }
+    std::sort (cached.begin (), cached.end (),
+        [](Entry const* a, Entry const* b)
+        {
+            return a->used < b->used;
+        });
+
+    // The handle stays on its ledger, so a client paging through it
+    // goes on without the entries read so far.
+    for (auto entry : cached)
+    {
+        if (total <= limits_.maxBytes)
+            break;
+        total -= bytes (*entry);
+        entry->cached.reset ();
+        entry->view = entry->ledger;
+    }
+    return total;
+}
+
+auto
+LedgerHandles::erase (Entries::iterator iter,
+    std::lock_guard<std::mutex> const&) -> Entries::iterator
+{
+    auto const client = clients_.find (iter->second.client);
+    if (client != clients_.end () && --client->second == 0)
+        clients_.erase (client);
+    return entries_.erase (iter);
+}
+
+} //
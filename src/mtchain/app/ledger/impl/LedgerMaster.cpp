@@ -14,6 +14,7 @@
 #include <mtchain/app/ledger/OpenLedger.h>
 #include <mtchain/app/ledger/OrderBookDB.h>
 #include <mtchain/app/ledger/PendingSaves.h>
+#include <mtchain/app/ledger/impl/FetchPackStream.h>
 #include <mtchain/app/tx/apply.h>
 #include <mtchain/app/main/Application.h>
 #include <mtchain/app/misc/AmendmentTable.h>
@@ -51,6 +52,12 @@ using namespace std::chrono_literals;
 // Don't acquire history if ledger is too old
 auto constexpr MAX_LEDGER_AGE_ACQUIRE = 1min;
 
+// Bytes of objects in each chunk of a fetch pack
+std::size_t constexpr FETCH_PACK_CHUNK_BYTES = 256 * 1024;
+
+// Stop fetch packs early once those being built have sent this much
+std::size_t constexpr FETCH_PACK_BUDGET_BYTES = 32 * 1024 * 1024;
+
 LedgerMaster::LedgerMaster (Application& app, Stopwatch& stopwatch,
     Stoppable& parent,
     beast::insight::Collector::ptr const& collector, beast::Journal journal)
@@ -540,21 +547,21 @@ LedgerMaster::getFetchPack (LedgerHash missingHash, LedgerIndex missingIndex)
     }
     assert(haveHash->isNonZero());
 
-    // Select target Peer based on highest score.  The score is randomized
-    // but biased in favor of Peers with low latency.
+    // Select the target Peer expected to answer soonest, from how
+    // quickly it has answered before and the queries it still owes.
     std::shared_ptr<Peer> target;
     {
-        int maxScore = 0;
+        std::chrono::milliseconds minWait {0};
         auto peerList = app_.overlay ().getActivePeers();
         for (auto const& peer : peerList)
         {
             if (peer->hasRange (missingIndex, missingIndex + 1))
             {
-                int score = peer->getScore (true);
-                if (! target || (score > maxScore))
+                auto const wait = peer->getObjectQueryWait ();
+                if (! target || (wait < minWait))
                 {
                     target = peer;
-                    maxScore = score;
+                    minWait = wait;
                 }
             }
         }
@@ -566,10 +573,8 @@ LedgerMaster::getFetchPack (LedgerHash missingHash, LedgerIndex missingIndex)
         tmBH.set_query (true);
         tmBH.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
         tmBH.set_ledgerhash (haveHash->begin(), 32);
-        auto packet = std::make_shared<Message> (
-            tmBH, protocol::mtGET_OBJECTS);
 
-        target->send (packet);
+        target->sendObjectQuery (tmBH);
         JLOG (m_journal.trace()) << "Requested fetch pack for "
                                             << missingIndex;
     }
@@ -1767,13 +1772,19 @@ LedgerMaster::gotFetchPack (
     bool progress,
     std::uint32_t seq)
 {
-    // FIXME: Calling this function more than once will result in
-    // InboundLedgers::gotFetchPack being called more than once
-    // which is expensive. A flag should track whether we've already dispatched
+    // Fetch packs arrive in chunks, so only queue a job if one is not
+    // already waiting. The flag is cleared before the job runs, so
+    // chunks that arrive while it runs get a job of their own.
+    if (got_fetch_pack_.exchange (true))
+        return;
 
     app_.getJobQueue().addJob (
         jtLEDGER_DATA, "gotFetchPack",
-        [&] (Job&) { app_.getInboundLedgers().gotFetchPack(); });
+        [&] (Job&)
+        {
+            got_fetch_pack_ = false;
+            app_.getInboundLedgers().gotFetchPack();
+        });
 }
 
 void
@@ -1840,84 +1851,98 @@ LedgerMaster::makeFetchPack (
         return;
     }
 
+    // The chunks go out as they fill, so the pack is never held whole
+    auto stream = std::make_shared<FetchPackStream> (
+        *request, FETCH_PACK_CHUNK_BYTES,
+        [this, wPeer] (protocol::TMGetObjectByHash const& chunk,
+            std::size_t bytes)
+        {
+            fetch_pack_bytes_ += bytes;
+            if (auto peer = wPeer.lock ())
+                peer->send (std::make_shared<Message> (
+                    chunk, protocol::mtGET_OBJECTS));
+        });
 
-    auto fpAppender = [](
-        protocol::TMGetObjectByHash* reply,
-        std::uint32_t ledgerSeq,
-        SHAMapHash const& hash,
-        const Blob& blob)
-    {
-        protocol::TMIndexedObject& newObj = * (reply->add_objects ());
-        newObj.set_ledgerseq (ledgerSeq);
-        newObj.set_hash (hash.as_uint256().begin (), 256 / 8);
-        newObj.set_data (&blob[0], blob.size ());
-    };
+    streamFetchPack (wPeer, stream, std::move (haveLedger), uUptime);
+}
 
+void
+LedgerMaster::streamFetchPack (
+    std::weak_ptr<Peer> const& wPeer,
+    std::shared_ptr<FetchPackStream> const& stream,
+    std::shared_ptr<Ledger const> haveLedger,
+    std::uint32_t uUptime)
+{
+    // Building a fetch pack, one ledger per job so that several
+    // packs can be built at once:
+    //  1. Add the header for the requested ledger.
+    //  2. Add the nodes for the AccountStateMap of that ledger.
+    //  3. If there are transactions, add the nodes for the
+    //     transactions of the ledger.
+    //  4. If the FetchPack now contains greater than or equal to
+    //     512 entries then stop.
+    //  5. If not very much time has elapsed, and the packs being
+    //     built are within their byte budget, then queue a job to
+    //     add the previous ledger to the FetchPack.
     try
     {
-        protocol::TMGetObjectByHash reply;
-        reply.set_query (false);
-
-        if (request->has_seq ())
-            reply.set_seq (request->seq ());
-
-        reply.set_ledgerhash (request->ledgerhash ());
-        reply.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
-
-        // Building a fetch pack:
-        //  1. Add the header for the requested ledger.
-        //  2. Add the nodes for the AccountStateMap of that ledger.
-        //  3. If there are transactions, add the nodes for the
-        //     transactions of the ledger.
-        //  4. If the FetchPack now contains greater than or equal to
-        //     256 entries then stop.
-        //  5. If not very much time has elapsed, then loop back and repeat
-        //     the same process adding the previous ledger to the FetchPack.
-        do
+        auto wantLedger = getLedgerByHash (haveLedger->info().parentHash);
+        if (!wantLedger)
         {
-            std::uint32_t lSeq = wantLedger->info().seq;
-
-            protocol::TMIndexedObject& newObj = *reply.add_objects ();
-            newObj.set_hash (
-                wantLedger->info().hash.data(), 256 / 8);
-            Serializer s (256);
-            s.add32 (HashPrefix::ledgerMaster);
-            addRaw(wantLedger->info(), s);
-            newObj.set_data (s.getDataPtr (), s.getLength ());
-            newObj.set_ledgerseq (lSeq);
-
-            wantLedger->stateMap().getFetchPack
-                (&haveLedger->stateMap(), true, 16384,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (wantLedger->info().txHash.isNonZero ())
-                wantLedger->txMap().getFetchPack (
-                    nullptr, true, 512,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (reply.objects ().size () >= 512)
-                break;
+            finishFetchPack (*stream);
+            return;
+        }
+
+        std::uint32_t lSeq = wantLedger->info().seq;
+
+        Serializer s (256);
+        s.add32 (HashPrefix::ledgerMaster);
+        addRaw(wantLedger->info(), s);
+        stream->add (lSeq, wantLedger->info().hash,
+            s.getDataPtr (), s.getLength ());
+
+        stream->addMap (lSeq, wantLedger->stateMap(),
+            &haveLedger->stateMap(), 16384);
 
-            // move may save a ref/unref
-            haveLedger = std::move (wantLedger);
-            wantLedger = getLedgerByHash (haveLedger->info().parentHash);
+        if (wantLedger->info().txHash.isNonZero ())
+            stream->addMap (lSeq, wantLedger->txMap(), nullptr, 512);
+
+        if ((stream->getObjects () >= 512) ||
+            wPeer.expired () ||
+            (UptimeTimer::getInstance ().getElapsedSeconds () > uUptime + 1) ||
+            (fetch_pack_bytes_.load () >= FETCH_PACK_BUDGET_BYTES) ||
+            app_.getFeeTrack ().isLoadedLocal ())
+        {
+            finishFetchPack (*stream);
+            return;
         }
-        while (wantLedger &&
-               UptimeTimer::getInstance ().getElapsedSeconds () <= uUptime + 1);
 
-        JLOG(m_journal.info())
-            << "Built fetch pack with " << reply.objects ().size () << " nodes";
-        auto msg = std::make_shared<Message> (reply, protocol::mtGET_OBJECTS);
-        peer->send (msg);
+        app_.getJobQueue ().addJob (
+            jtPACK, "MakeFetchPack",
+            [this, wPeer, stream,
+                haveLedger = std::move (wantLedger), uUptime] (Job&)
+            {
+                streamFetchPack (wPeer, stream, haveLedger, uUptime);
+            });
     }
     catch (std::exception const&)
     {
         JLOG(m_journal.warn()) << "Exception building fetch pach";
+        finishFetchPack (*stream);
     }
 }
 
+void
+LedgerMaster::finishFetchPack (FetchPackStream& stream)
+{
+    stream.flush ();
+    fetch_pack_bytes_ -= stream.getBytes ();
+
+    JLOG(m_journal.info())
+        << "Built fetch pack with " << stream.getObjects () << " nodes in "
+        << stream.getChunks () << " chunks";
+}
+
 std::size_t
 LedgerMaster::getFetchPackCacheSize () const
 {
@@ -173,8 +173,8 @@ void TransactionAcquire::trigger (std::shared_ptr<Peer> const& peer)
     }
 }
 
-SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNodeID>& nodeIDs,
-        const std::list< Blob >& data, std::shared_ptr<Peer> const& peer)
+SHAMapAddNode TransactionAcquire::takeNodes (const std::vector<SHAMapNodeID>& nodeIDs,
+        const std::vector< Slice >& data, std::shared_ptr<Peer> const& peer)
 {
     ScopedLockType sl (mLock);
 
@@ -195,8 +195,8 @@ SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNodeID>& node
         if (nodeIDs.empty ())
             return SHAMapAddNode::invalid ();
 
-        std::list<SHAMapNodeID>::const_iterator nodeIDit = nodeIDs.begin ();
-        std::list< Blob >::const_iterator nodeDatait = data.begin ();
+        auto nodeIDit = nodeIDs.cbegin ();
+        auto nodeDatait = data.cbegin ();
         ConsensusTransSetSF sf (app_, app_.getTempNodeCache ());
 
         while (nodeIDit != nodeIDs.end ())
@@ -206,14 +206,14 @@ SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNodeID>& node
                 if (mHaveRoot)
                     JLOG (j_.debug()) << "Got root TXS node, already have it";
                 else if (!mMap->addRootNode (SHAMapHash{getHash ()},
-                                             makeSlice(*nodeDatait), snfWIRE, nullptr).isGood())
+                                             *nodeDatait, snfWIRE, nullptr).isGood())
                 {
                     JLOG (j_.warn()) << "TX acquire got bad root node";
                 }
                 else
                     mHaveRoot = true;
             }
-            else if (!mMap->addKnownNode (*nodeIDit, makeSlice(*nodeDatait), &sf).isGood())
+            else if (!mMap->addKnownNode (*nodeIDit, *nodeDatait, &sf).isGood())
             {
                 JLOG (j_.warn()) << "TX acquire got bad non-root node";
                 return SHAMapAddNode::invalid ();
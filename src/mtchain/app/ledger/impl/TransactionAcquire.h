@@ -38,8 +38,8 @@ public:
         return mMap;
     }
 
-    SHAMapAddNode takeNodes (const std::list<SHAMapNodeID>& IDs,
-                             const std::list< Blob >& data, std::shared_ptr<Peer> const&);
+    SHAMapAddNode takeNodes (const std::vector<SHAMapNodeID>& IDs,
+                             const std::vector< Slice >& data, std::shared_ptr<Peer> const&);
 
     void init (int startPeers);
 
@@ -16,6 +16,7 @@
 #include <mtchain/app/main/Tuning.h>
 #include <mtchain/app/ledger/AcceptedLedger.h>
 #include <mtchain/app/ledger/InboundLedgers.h>
+#include <mtchain/app/ledger/LedgerHandles.h>
 #include <mtchain/app/ledger/LedgerMaster.h>
 #include <mtchain/app/ledger/LedgerToJson.h>
 #include <mtchain/app/ledger/OpenLedger.h>
@@ -67,6 +68,7 @@
 #include <mtchain/resource/Fees.h>
 #include <mtchain/rpc/Context.h>
 #include <mtchain/rpc/RPCHandler.h>
+#include <mtchain/rpc/impl/MethodStats.h>
 #include <mtchain/shamap/Family.h>
 #include <mtchain/crypto/csprng.h>
 #include <mtchain/beast/asio/io_latency_probe.h>
@@ -328,6 +330,8 @@ public:
     std::unique_ptr <CollectorManager> m_collectorManager;
     detail::AppFamily family_;
     CachedSLEs cachedSLEs_;
+    LedgerHandles ledgerHandles_;
+    RPC::MethodStats methodStats_;
     std::pair<PublicKey, SecretKey> nodeIdentity_;
 
     std::unique_ptr <Resource::Manager> m_resourceManager;
@@ -430,6 +434,12 @@ public:
 
         , cachedSLEs_ (std::chrono::minutes(1), stopwatch())
 
+        , ledgerHandles_ (stopwatch(), cachedSLEs_, {
+            ledgerHandlesMax, ledgerHandlesPerClient, ledgerHandlesBytes,
+                std::chrono::seconds (ledgerHandlesMaxSeconds)})
+
+        , methodStats_ (*m_collectorManager, logs_->journal("RPC"))
+
         , m_resourceManager (Resource::make_Manager (
             m_collectorManager->collector(), logs_->journal("Resource")))
 
@@ -683,6 +693,18 @@ public:
         return cachedSLEs_;
     }
 
+    LedgerHandles&
+    getLedgerHandles () override
+    {
+        return ledgerHandles_;
+    }
+
+    RPC::MethodStats&
+    getMethodStats () override
+    {
+        return methodStats_;
+    }
+
     AmendmentTable& getAmendmentTable() override
     {
         return *m_amendmentTable;
@@ -954,6 +976,7 @@ public:
         m_acceptedLedgerCache.sweep();
         family().treecache().sweep();
         cachedSLEs_.expire();
+        ledgerHandles_.expire();
 
         // VFALCO NOTE does the call to sweep() happen on another thread?
         m_sweepTimer.setExpiration (
@@ -1737,6 +1760,38 @@ bool ApplicationImp::loadOldLedger (
             return false;
         }
 
+        {
+            // Read the maps with many fetches outstanding, rather than
+            // one node at a time as the walk below would
+            using namespace std::chrono;
+            auto const start = steady_clock::now ();
+            auto nextReport = start + seconds (5);
+            auto const prefetch = [&](SHAMap const& map, char const* name)
+            {
+                auto const missing = map.prefetch ([&](std::size_t loaded)
+                {
+                    auto const now = steady_clock::now ();
+                    if (now < nextReport)
+                        return;
+                    nextReport = now + seconds (5);
+                    JLOG(m_journal.info()) <<
+                        "Prefetched " << loaded << " " << name << " nodes";
+                });
+                if (missing)
+                    JLOG(m_journal.warn()) << "Prefetch of the " << name <<
+                        " map found " << missing << " nodes missing";
+            };
+
+            prefetch (loadLedger->stateMap (), "state");
+            prefetch (loadLedger->txMap (), "transaction");
+            if (replayLedger)
+                prefetch (replayLedger->txMap (), "transaction");
+
+            JLOG(m_journal.info()) << "Prefetch took " <<
+                duration_cast <seconds> (steady_clock::now () - start).count () <<
+                " seconds";
+        }
+
         if (!loadLedger->walkLedger (journal ("Ledger")))
         {
             JLOG(m_journal.fatal()) << "Ledger is missing nodes.";
@@ -2051,7 +2106,8 @@ bool ApplicationImp::updateTables ()
             << "Node import from '" << source->getName () << "' to '"
             << getNodeStore ().getName () << "'.";
 
-        getNodeStore().import (*source);
+        getNodeStore().import (*source, NodeStore::setup_ImportOptions (
+            config_->section (ConfigSection::importNodeDatabase ())));
     }
 
     return true;
@@ -31,6 +31,7 @@ namespace mtchain {
 
 namespace unl { class Manager; }
 namespace Resource { class Manager; }
+namespace RPC { class MethodStats; }
 namespace NodeStore { class Database; }
 
 // VFALCO TODO Fix forward declares required for header dependency loops
@@ -45,6 +46,7 @@ class JobQueue;
 class InboundLedgers;
 class InboundTransactions;
 class AcceptedLedger;
+class LedgerHandles;
 class LedgerMaster;
 class LoadManager;
 class ManifestCache;
@@ -142,6 +144,8 @@ public:
 
     virtual Resource::Manager&      getResourceManager () = 0;
     virtual PathRequests&           getPathRequests () = 0;
+    virtual LedgerHandles&          getLedgerHandles () = 0;
+    virtual RPC::MethodStats&       getMethodStats () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
     virtual PendingSaves&           pendingSaves() = 0;
     virtual AccountIDCache const&   accountIDCache() const = 0;
@@ -12,6 +12,7 @@
 #include <mtchain/basics/Log.h>
 #include <mtchain/protocol/digest.h>
 #include <mtchain/app/main/Application.h>
+#include <mtchain/app/misc/SnapshotExport.h>
 #include <mtchain/basics/CheckLibraryVersions.h>
 #include <mtchain/basics/contract.h>
 #include <mtchain/basics/StringUtilities.h>
@@ -28,6 +29,7 @@
 #include <mtchain/protocol/BuildInfo.h>
 #include <mtchain/beast/clock/basic_seconds_clock.h>
 #include <mtchain/beast/core/CurrentThreadName.h>
+#include <mtchain/beast/core/LexicalCast.h>
 #include <mtchain/beast/core/Time.h>
 #include <mtchain/beast/utility/Debug.h>
 #include <beast/unit_test/dstream.hpp>
@@ -39,6 +41,7 @@
 #include <boost/program_options.hpp>
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 #include <utility>
 #include <mtchain/rpc/handlers/WalletPropose.h>
 #include <mtchain/net/RPCErr.h>
@@ -145,6 +148,7 @@ void printHelp (const po::options_description& desc)
            "     peers\n"
            "     ping\n"
            "     random\n"
+           "     rpc_stats\n"
            "     mtchain ...\n"
            "     mtchain_path_find <json> [<ledger>]\n"
            "     version\n"
@@ -154,6 +158,7 @@ void printHelp (const po::options_description& desc)
            "     stop\n"
            "     submit <tx_blob>|[<private_key> <tx_json>]\n"
            "     submit_multisigned <tx_json>\n"
+           "     traffic_histograms [peers]\n"
            "     tx <id>\n"
            "     validation_create [<seed>|<pass_phrase>|<key>]\n"
            "     validation_seed [<seed>|<pass_phrase>|<key>]\n"
@@ -257,6 +262,8 @@ int run (int argc, char** argv)
     ("debug", "Enable normally suppressed debug logging")
     ("fg", "Run in the foreground.")
     ("import", importText.c_str ())
+    ("snapshot", po::value<std::string> (), "Export the ledgers given by --snapshot_range to a read-only snapshot in the specified directory, then exit.")
+    ("snapshot_range", po::value<std::string> (), "Ledger range for --snapshot. Format: <first>-<last>")
     ("version", "Display the build version.")
 #ifdef IPFS_ENABLE
     ("ipfs_ip", po::value <std::string> (), "Specify the IPFS API ip address.")
@@ -399,6 +406,25 @@ int run (int argc, char** argv)
         config->START_VALID = true;
     }
 
+    std::uint32_t snapshotFirst = 0;
+    std::uint32_t snapshotLast = 0;
+    if (vm.count ("snapshot"))
+    {
+        auto const range = vm.count ("snapshot_range") ?
+            vm["snapshot_range"].as<std::string> () : std::string ();
+        auto const dash = range.find ('-');
+        if (dash == std::string::npos ||
+            ! beast::lexicalCastChecked (
+                snapshotFirst, range.substr (0, dash)) ||
+            ! beast::lexicalCastChecked (
+                snapshotLast, range.substr (dash + 1)) ||
+            snapshotFirst > snapshotLast)
+        {
+            std::cerr << "Invalid snapshot_range = " << range << std::endl;
+            return -1;
+        }
+    }
+
     if (vm.count ("net"))
     {
         if ((config->START_UP == Config::LOAD) ||
@@ -539,7 +565,8 @@ int run (int argc, char** argv)
         if (!adjustDescriptorLimit(1024, logs->journal("Application")))
             return -1;
 
-        if (HaveSustain() && !vm.count ("fg") && !config->standalone())
+        if (HaveSustain() && !vm.count ("fg") && !vm.count ("snapshot") &&
+            !config->standalone())
         {
             auto const ret = DoSustain ();
 
@@ -572,6 +599,14 @@ int run (int argc, char** argv)
         app->setIpfsAddress(ipfs_ip, ipfs_port);
         #endif
 
+        if (vm.count ("snapshot"))
+        {
+            auto const ok = exportSnapshot (*app,
+                vm["snapshot"].as<std::string> (), snapshotFirst,
+                snapshotLast, std::thread::hardware_concurrency ());
+            return ok ? 0 : -1;
+        }
+
         // With our configuration parsed, ensure we have
         // enough file descriptors available:
         if (!adjustDescriptorLimit(
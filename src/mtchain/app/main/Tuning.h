@@ -17,6 +17,12 @@ enum
 {
      fullBelowTargetSize = 524288
     ,fullBelowExpirationSeconds = 600
+
+    // Limits of the ledger handles held for RPC clients
+    ,ledgerHandlesMax = 1024
+    ,ledgerHandlesPerClient = 16
+    ,ledgerHandlesBytes = 128 * 1024 * 1024
+    ,ledgerHandlesMaxSeconds = 300
 };
 
 }
@@ -29,10 +29,12 @@
 #include <mtchain/app/main/LoadManager.h>
 #include <mtchain/app/misc/HashRouter.h>
 #include <mtchain/app/misc/LoadFeeTrack.h>
+#include <mtchain/app/misc/SHAMapStore.h>
 #include <mtchain/app/misc/Transaction.h>
 #include <mtchain/app/misc/TxQ.h>
 #include <mtchain/app/misc/Validations.h>
 #include <mtchain/app/misc/ValidatorList.h>
+#include <mtchain/app/misc/impl/AccountSubscriptions.h>
 #include <mtchain/app/misc/impl/AccountTxPaging.h>
 #include <mtchain/app/tx/apply.h>
 #include <mtchain/basics/contract.h>
@@ -69,7 +71,9 @@
 #include <mtchain/basics/make_lock.h>
 #include <beast/core/detail/base64.hpp>
 #include <boost/optional.hpp>
+#include <array>
 #include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <tuple>
@@ -171,6 +175,55 @@ class NetworkOPsImp final
         Json::Value json() const;
     };
 
+    /**
+     * Tracks how long events take to reach the subscribers of each
+     * stream, from when the event happened to when every subscriber
+     * has it queued.
+     */
+    class PublishAccounting
+    {
+    public:
+        enum Stream
+        {
+            ledger = 0,
+            transactions,
+            transactionsProposed,
+            accounts,
+            accountsProposed,
+            ledgerBatches
+        };
+
+        /**
+         * Record an event sent to subscribers.
+         *
+         * @param stream The stream the event was published on.
+         * @param messages The number of subscribers sent the event.
+         * @param lag The time from the event to the last subscriber.
+         */
+        void record (Stream stream, std::size_t messages,
+            std::chrono::microseconds lag);
+
+        /**
+         * Output stream counters in JSON format.
+         *
+         * @return JSON object.
+         */
+        Json::Value json() const;
+
+    private:
+        struct Counters
+        {
+            std::uint64_t events = 0;
+            std::uint64_t messages = 0;
+            std::chrono::microseconds lag {0};      // smoothed
+            std::chrono::microseconds maxLag {0};
+        };
+
+        std::array<Counters, 6> counters_;
+        mutable std::mutex mutex_;
+        static std::array<Json::StaticString const, 6> const streams_;
+    };
+
     //! Server fees published on `server` subscription
     struct ServerFeeSummary
     {
@@ -413,6 +466,21 @@ public:
         std::int32_t maxLedger, bool forward, Json::Value& token, int limit,
         bool bUnlimited) override;
 
+    void getTxsAccount (
+        AccountID const& account, std::int32_t minLedger,
+        std::int32_t maxLedger, bool forward, Json::Value& token, int limit,
+        bool bUnlimited, AccountTxFn const& onTransaction) override;
+
+    // Reads a page of an account's transactions a chunk at a time,
+    // passing on each chunk once the database is released, until
+    // `onTransaction` returns false
+    void forEachTxAccount (
+        AccountID const& account, std::int32_t minLedger,
+        std::int32_t maxLedger, bool forward, Json::Value& token, int limit,
+        bool bUnlimited, std::uint32_t pageLength,
+        std::function <bool (std::uint32_t, std::string const&,
+            Blob const&, Blob const&)> const& onTransaction);
+
     using NetworkOPs::txnMetaLedgerType;
     using NetworkOPs::MetaTxsList;
 
@@ -428,6 +496,13 @@ public:
         std::int32_t maxLedger,  bool forward, Json::Value& token,
         int limit, bool bUnlimited) override;
 
+    void
+    getTxsAccountRaw (
+        AccountID const& account, std::int32_t minLedger,
+        std::int32_t maxLedger,  bool forward, Json::Value& token,
+        int limit, bool bUnlimited,
+        RawTxFn const& onTransaction) override;
+
     //
     // Monitoring: publisher side.
     //
@@ -515,13 +590,29 @@ private:
         const STTx& stTxn, TER terResult, bool bValidated,
         std::shared_ptr<ReadView const> const& lpCurrent);
 
+    // The transactions of a validated ledger for each subscriber that
+    // takes them in one message, by subscriber.
+    using AccountBatch = std::map <std::uint64_t,
+        std::pair <InfoSub::pointer, Json::Value>>;
+
     void pubValidatedTransaction (
         std::shared_ptr<ReadView const> const& alAccepted,
-        const AcceptedLedgerTx& alTransaction);
+        const AcceptedLedgerTx& alTransaction,
+        clock_type::time_point start,
+        AccountBatch& batch);
     void pubAccountTransaction (
         std::shared_ptr<ReadView const> const& lpCurrent,
         const AcceptedLedgerTx& alTransaction,
-        bool isAccepted);
+        bool isAccepted,
+        clock_type::time_point start,
+        AccountBatch* batch);
+
+    // Sends the event to the listeners and records how long it took
+    // since `start` for them all to have it.
+    void publish (PublishAccounting::Stream stream,
+        Json::Value const& jvObj,
+        std::vector <InfoSub::pointer> const& listeners,
+        clock_type::time_point start);
 
     void pubServer ();
 
@@ -529,9 +620,15 @@ private:
 
 private:
     using SubMapType = hash_map <std::uint64_t, InfoSub::wptr>;
-    using SubInfoMapType = hash_map <AccountID, SubMapType>;
     using subRpcMapType = hash_map<std::string, InfoSub::pointer>;
 
+    // Appends the live subscribers in `subs` to `listeners` and forgets
+    // the others. The caller must hold mSubLock.
+    static
+    void
+    getListeners (SubMapType& subs,
+        std::vector <InfoSub::pointer>& listeners);
+
     // XXX Split into more locks.
     using ScopedLockType = std::lock_guard <std::recursive_mutex>;
 
@@ -557,8 +654,8 @@ private:
     LedgerMaster& m_ledgerMaster;
     std::shared_ptr<InboundLedger> mAcquiringLedger;
 
-    SubInfoMapType mSubAccount;
-    SubInfoMapType mSubRTAccount;
+    AccountSubscriptions mSubAccount;
+    AccountSubscriptions mSubRTAccount;
 
     subRpcMapType mRpcSubMap;
 
@@ -588,6 +685,7 @@ private:
     std::vector <TransactionStatus> mTransactions;
 
     StateAccounting accounting_;
+    PublishAccounting publishAccounting_;
 };
 
 //------------------------------------------------------------------------------
@@ -617,6 +715,15 @@ NetworkOPsImp::StateAccounting::states_ = {{
     Json::StaticString(stateNames[3]),
     Json::StaticString(stateNames[4])}};
 
+std::array<Json::StaticString const, 6> const
+NetworkOPsImp::PublishAccounting::streams_ = {{
+    Json::StaticString("ledger"),
+    Json::StaticString("transactions"),
+    Json::StaticString("transactions_proposed"),
+    Json::StaticString("accounts"),
+    Json::StaticString("accounts_proposed"),
+    Json::StaticString("ledger_batches")}};
+
 //------------------------------------------------------------------------------
 std::string
 NetworkOPsImp::getHostId (bool forAdmin)
@@ -1124,9 +1231,7 @@ std::shared_ptr<OpenView const> NetworkOPsImp::apply (std::unique_lock<std::mute
                     tx.set_receivetimestamp (app_.timeKeeper().now().time_since_epoch().count());
                     tx.set_deferred(e.result == terQUEUED);
                     // FIXME: This should be when we received it
-                    app_.overlay().foreach (send_if_not (
-                        std::make_shared<Message> (tx, protocol::mtTRANSACTION),
-                        peer_in_set(*toSkip)));
+                    app_.overlay().relay (tx, *toSkip);
                 }
             }
         }
@@ -2062,29 +2167,102 @@ NetworkOPsImp::getTxsAccount (
     AccountID const& account, std::int32_t minLedger,
     std::int32_t maxLedger, bool forward, Json::Value& token,
     int limit, bool bUnlimited)
+{
+    NetworkOPsImp::AccountTxs ret;
+    getTxsAccount (account, minLedger, maxLedger, forward, token, limit,
+        bUnlimited, [&ret](AccountTx const& tx)
+        {
+            ret.push_back (tx);
+            return true;
+        });
+    return ret;
+}
+
+void
+NetworkOPsImp::getTxsAccount (
+    AccountID const& account, std::int32_t minLedger,
+    std::int32_t maxLedger, bool forward, Json::Value& token,
+    int limit, bool bUnlimited, AccountTxFn const& onTransaction)
 {
     static std::uint32_t const page_length (200);
 
     Application& app = app_;
-    NetworkOPsImp::AccountTxs ret;
+    NetworkOPsImp::AccountTxs txs;
 
-    auto bound = [&ret, &app](
+    auto bound = [&txs, &app, &onTransaction](
         std::uint32_t ledger_index,
         std::string const& status,
         Blob const& rawTxn,
         Blob const& rawMeta)
     {
         convertBlobsToTxResult (
-            ret, ledger_index, status, rawTxn, rawMeta, app);
+            txs, ledger_index, status, rawTxn, rawMeta, app);
+        auto const more = onTransaction (txs.back ());
+        txs.clear ();
+        return more;
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    forEachTxAccount (account, minLedger, maxLedger, forward, token,
+        limit, bUnlimited, page_length, bound);
+}
 
-    return ret;
+void
+NetworkOPsImp::forEachTxAccount (
+    AccountID const& account, std::int32_t minLedger,
+    std::int32_t maxLedger, bool forward, Json::Value& token,
+    int limit, bool bUnlimited, std::uint32_t pageLength,
+    std::function <bool (std::uint32_t, std::string const&,
+        Blob const&, Blob const&)> const& onTransaction)
+{
+    static std::uint32_t const chunk_length (32);
+
+    struct Row
+    {
+        std::uint32_t ledgerIndex;
+        std::string status;
+        Blob rawTxn;
+        Blob rawMeta;
+    };
+    std::vector <Row> rows;
+    rows.reserve (chunk_length);
+
+    auto bound = [&rows](
+        std::uint32_t ledgerIndex,
+        std::string const& status,
+        Blob const& rawTxn,
+        Blob const& rawMeta)
+    {
+        rows.push_back ({ledgerIndex, status, rawTxn, rawMeta});
+    };
+
+    // The same page accountTxPage would return in one query
+    std::uint32_t remaining = pageLength;
+    if (limit > 0 &&
+            (static_cast <std::uint32_t> (limit) <= pageLength || bUnlimited))
+        remaining = limit;
+
+    while (remaining != 0)
+    {
+        rows.clear ();
+        accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token,
+                        std::min (remaining, chunk_length), bUnlimited,
+                            pageLength);
+
+        for (auto const& row : rows)
+        {
+            if (! onTransaction (
+                    row.ledgerIndex, row.status, row.rawTxn, row.rawMeta))
+                return;
+        }
+
+        // The token now marks where the next chunk starts
+        remaining -= std::min <std::uint32_t> (remaining, rows.size ());
+        if (rows.empty () || ! token)
+            break;
+    }
 }
 
 NetworkOPsImp::MetaTxsList
@@ -2114,6 +2292,27 @@ NetworkOPsImp::getTxsAccountB (
     return ret;
 }
 
+void
+NetworkOPsImp::getTxsAccountRaw (
+    AccountID const& account, std::int32_t minLedger,
+    std::int32_t maxLedger,  bool forward, Json::Value& token,
+    int limit, bool bUnlimited, RawTxFn const& onTransaction)
+{
+    static const std::uint32_t page_length (500);
+
+    auto bound = [&onTransaction](
+        std::uint32_t ledgerIndex,
+        std::string const& status,
+        Blob const& rawTxn,
+        Blob const& rawMeta)
+    {
+        return onTransaction (ledgerIndex, rawTxn, rawMeta);
+    };
+
+    forEachTxAccount (account, minLedger, maxLedger, forward, token,
+        limit, bUnlimited, page_length, bound);
+}
+
 bool NetworkOPsImp::recvValidation (
     STValidation::ref val, std::string const& source)
 {
@@ -2200,8 +2399,21 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     //  info[jss::consensus] = mLedgerConsensus->getJson();
 
     if (admin)
+    {
         info[jss::load] = m_job_queue.getJson ();
 
+        auto onlineDelete = app_.getSHAMapStore ().getJson ();
+        if (! onlineDelete.isNull ())
+            info[jss::online_delete] = std::move (onlineDelete);
+
+        auto& subscriptions = info[jss::subscriptions] =
+            publishAccounting_.json ();
+        subscriptions[jss::accounts][jss::watched] =
+            static_cast<Json::UInt> (mSubAccount.size ());
+        subscriptions[jss::accounts_proposed][jss::watched] =
+            static_cast<Json::UInt> (mSubRTAccount.size ());
+    }
+
     auto const escalationMetrics = app_.getTxQ().getMetrics(
         *app_.openLedger().current());
 
@@ -2372,31 +2584,21 @@ void NetworkOPsImp::pubProposedTransaction (
     std::shared_ptr<ReadView const> const& lpCurrent,
     std::shared_ptr<STTx const> const& stTxn, TER terResult)
 {
+    auto const start = m_clock.now ();
     Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
 
+    std::vector <InfoSub::pointer> listeners;
     {
         ScopedLockType sl (mSubLock);
-
-        auto it = mSubRTTransactions.begin ();
-        while (it != mSubRTTransactions.end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-            {
-                it = mSubRTTransactions.erase (it);
-            }
-        }
+        getListeners (mSubRTTransactions, listeners);
     }
+    publish (PublishAccounting::transactionsProposed,
+        jvObj, listeners, start);
+
     AcceptedLedgerTx alt (lpCurrent, stTxn, terResult,
         app_.accountIDCache(), app_.logs());
     JLOG(m_journal.trace()) << "pubProposed: " << alt.getJson ();
-    pubAccountTransaction (lpCurrent, alt, false);
+    pubAccountTransaction (lpCurrent, alt, false, start, nullptr);
 }
 
 void NetworkOPsImp::pubLedger (
@@ -2405,6 +2607,7 @@ void NetworkOPsImp::pubLedger (
     // Ledgers are published only when they acquire sufficient validations
     // Holes are filled across connection loss or other catastrophe
 
+    auto const start = m_clock.now ();
     std::shared_ptr<AcceptedLedger> alpAccepted =
         app_.getAcceptedLedgerCache().fetch (lpAccepted->info().hash);
     if (! alpAccepted)
@@ -2415,53 +2618,65 @@ void NetworkOPsImp::pubLedger (
             lpAccepted->info().hash, alpAccepted);
     }
 
+    std::vector <InfoSub::pointer> listeners;
     {
         ScopedLockType sl (mSubLock);
+        getListeners (mSubLedger, listeners);
+    }
 
-        if (!mSubLedger.empty ())
-        {
-            Json::Value jvObj (Json::objectValue);
-
-            jvObj[jss::type] = "ledgerClosed";
-            jvObj[jss::ledger_index] = lpAccepted->info().seq;
-            jvObj[jss::ledger_hash] = to_string (lpAccepted->info().hash);
-            jvObj[jss::ledger_time]
-                    = Json::Value::UInt (lpAccepted->info().closeTime.time_since_epoch().count());
+    if (! listeners.empty ())
+    {
+        Json::Value jvObj (Json::objectValue);
 
-            jvObj[jss::fee_ref]
-                    = Json::UInt (lpAccepted->fees().units);
-            jvObj[jss::fee_base] = Json::UInt (lpAccepted->fees().base);
-            jvObj[jss::reserve_base] = Json::UInt (lpAccepted->fees().accountReserve(0).drops());
-            jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->fees().increment);
+        jvObj[jss::type] = "ledgerClosed";
+        jvObj[jss::ledger_index] = lpAccepted->info().seq;
+        jvObj[jss::ledger_hash] = to_string (lpAccepted->info().hash);
+        jvObj[jss::ledger_time]
+                = Json::Value::UInt (lpAccepted->info().closeTime.time_since_epoch().count());
 
-            jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
+        jvObj[jss::fee_ref]
+                = Json::UInt (lpAccepted->fees().units);
+        jvObj[jss::fee_base] = Json::UInt (lpAccepted->fees().base);
+        jvObj[jss::reserve_base] = Json::UInt (lpAccepted->fees().accountReserve(0).drops());
+        jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->fees().increment);
 
-            if (mMode >= omSYNCING)
-            {
-                jvObj[jss::validated_ledgers]
-                        = app_.getLedgerMaster ().getCompleteLedgers ();
-            }
+        jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
 
-            auto it = mSubLedger.begin ();
-            while (it != mSubLedger.end ())
-            {
-                InfoSub::pointer p = it->second.lock ();
-                if (p)
-                {
-                    p->send (jvObj, true);
-                    ++it;
-                }
-                else
-                    it = mSubLedger.erase (it);
-            }
+        if (mMode >= omSYNCING)
+        {
+            jvObj[jss::validated_ledgers]
+                    = app_.getLedgerMaster ().getCompleteLedgers ();
         }
+
+        publish (PublishAccounting::ledger, jvObj, listeners, start);
     }
 
     // Don't lock since pubAcceptedTransaction is locking.
+    AccountBatch batch;
     for (auto const& vt : alpAccepted->getMap ())
     {
         JLOG(m_journal.trace()) << "pubAccepted: " << vt.second->getJson ();
-        pubValidatedTransaction (lpAccepted, *vt.second);
+        pubValidatedTransaction (lpAccepted, *vt.second, start, batch);
+    }
+
+    if (! batch.empty ())
+    {
+        for (auto& entry : batch)
+        {
+            Json::Value jvObj (Json::objectValue);
+
+            jvObj[jss::type] = "ledgerTransactions";
+            jvObj[jss::ledger_index] = lpAccepted->info().seq;
+            jvObj[jss::ledger_hash] = to_string (lpAccepted->info().hash);
+            jvObj[jss::validated] = true;
+            jvObj[jss::transactions] = std::move (entry.second.second);
+
+            entry.second.first->send (jvObj, true);
+        }
+
+        publishAccounting_.record (PublishAccounting::ledgerBatches,
+            batch.size (), std::chrono::duration_cast<
+                std::chrono::microseconds> (m_clock.now () - start));
     }
 }
 
@@ -2536,138 +2751,124 @@ Json::Value NetworkOPsImp::transJson(
 
 void NetworkOPsImp::pubValidatedTransaction (
     std::shared_ptr<ReadView const> const& alAccepted,
-    const AcceptedLedgerTx& alTx)
+    const AcceptedLedgerTx& alTx,
+    clock_type::time_point start,
+    AccountBatch& batch)
 {
     Json::Value jvObj = transJson (
         *alTx.getTxn (), alTx.getResult (), true, alAccepted);
     jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
+    std::vector <InfoSub::pointer> listeners;
     {
         ScopedLockType sl (mSubLock);
-
-        auto it = mSubTransactions.begin ();
-        while (it != mSubTransactions.end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-                it = mSubTransactions.erase (it);
-        }
-
-        it = mSubRTTransactions.begin ();
-
-        while (it != mSubRTTransactions.end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-                it = mSubRTTransactions.erase (it);
-        }
+        getListeners (mSubTransactions, listeners);
+        getListeners (mSubRTTransactions, listeners);
     }
+    publish (PublishAccounting::transactions, jvObj, listeners, start);
+
     app_.getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
-    pubAccountTransaction (alAccepted, alTx, true);
+    pubAccountTransaction (alAccepted, alTx, true, start, &batch);
 }
 
 void NetworkOPsImp::pubAccountTransaction (
     std::shared_ptr<ReadView const> const& lpCurrent,
     const AcceptedLedgerTx& alTx,
-    bool bAccepted)
+    bool bAccepted,
+    clock_type::time_point start,
+    AccountBatch* batch)
 {
-    hash_set<InfoSub::pointer>  notify;
-    int                             iProposed   = 0;
-    int                             iAccepted   = 0;
-
-    {
-        ScopedLockType sl (mSubLock);
+    if (!bAccepted && mSubRTAccount.empty ()) return;
 
-        if (!bAccepted && mSubRTAccount.empty ()) return;
+    AccountSubscriptions::Listeners listeners;
+    mSubRTAccount.find (alTx.getAffected (), listeners);
+    if (bAccepted)
+        mSubAccount.find (alTx.getAffected (), listeners);
 
-        if (!mSubAccount.empty () || (!mSubRTAccount.empty ()) )
-        {
-            for (auto const& affectedAccount: alTx.getAffected ())
-            {
-                auto simiIt
-                        = mSubRTAccount.find (affectedAccount);
-                if (simiIt != mSubRTAccount.end ())
-                {
-                    auto it = simiIt->second.begin ();
+    JLOG(m_journal.trace()) << "pubAccountTransaction:" <<
+        " accepted=" << bAccepted <<
+        " listeners=" << listeners.size ();
 
-                    while (it != simiIt->second.end ())
-                    {
-                        InfoSub::pointer p = it->second.lock ();
+    if (listeners.empty ())
+        return;
 
-                        if (p)
-                        {
-                            notify.insert (p);
-                            ++it;
-                            ++iProposed;
-                        }
-                        else
-                            it = simiIt->second.erase (it);
-                    }
-                }
+    Json::Value jvObj = transJson (
+        *alTx.getTxn (), alTx.getResult (), bAccepted, lpCurrent);
 
-                if (bAccepted)
-                {
-                    simiIt  = mSubAccount.find (affectedAccount);
+    if (alTx.isApplied ())
+        jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-                    if (simiIt != mSubAccount.end ())
-                    {
-                        auto it = simiIt->second.begin ();
-                        while (it != simiIt->second.end ())
-                        {
-                            InfoSub::pointer p = it->second.lock ();
-
-                            if (p)
-                            {
-                                notify.insert (p);
-                                ++it;
-                                ++iAccepted;
-                            }
-                            else
-                                it = simiIt->second.erase (it);
-                        }
-                    }
-                }
+    if (batch)
+    {
+        // Hold the transaction for the subscribers that take the
+        // whole ledger at once.
+        auto const batched = std::partition (
+            listeners.begin (), listeners.end (),
+            [](InfoSub::pointer const& p)
+            {
+                return ! p->getLedgerBatch ();
+            });
+        for (auto it = batched; it != listeners.end (); ++it)
+        {
+            auto& entry = (*batch)[(*it)->getSeq ()];
+            if (! entry.first)
+            {
+                entry.first = *it;
+                entry.second = Json::arrayValue;
             }
+            entry.second.append (jvObj);
         }
+        listeners.erase (batched, listeners.end ());
     }
-    JLOG(m_journal.trace()) << "pubAccountTransaction:" <<
-        " iProposed=" << iProposed <<
-        " iAccepted=" << iAccepted;
 
-    if (!notify.empty ())
-    {
-        Json::Value jvObj = transJson (
-            *alTx.getTxn (), alTx.getResult (), bAccepted, lpCurrent);
+    publish (bAccepted ? PublishAccounting::accounts
+        : PublishAccounting::accountsProposed, jvObj, listeners, start);
+}
 
-        if (alTx.isApplied ())
-            jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
+void NetworkOPsImp::publish (PublishAccounting::Stream stream,
+    Json::Value const& jvObj,
+    std::vector <InfoSub::pointer> const& listeners,
+    clock_type::time_point start)
+{
+    if (listeners.empty ())
+        return;
 
-        for (InfoSub::ref isrListener : notify)
-            isrListener->send (jvObj, true);
-    }
+    InfoSub::Event const event (jvObj);
+    for (auto const& p : listeners)
+        p->publish (event);
+
+    publishAccounting_.record (stream, listeners.size (),
+        std::chrono::duration_cast<std::chrono::microseconds> (
+            m_clock.now () - start));
 }
 
 //
 // Monitoring
 //
 
+void NetworkOPsImp::getListeners (SubMapType& subs,
+    std::vector <InfoSub::pointer>& listeners)
+{
+    auto it = subs.begin ();
+    while (it != subs.end ())
+    {
+        if (auto p = it->second.lock ())
+        {
+            listeners.push_back (std::move (p));
+            ++it;
+        }
+        else
+        {
+            it = subs.erase (it);
+        }
+    }
+}
+
 void NetworkOPsImp::subAccount (
     InfoSub::ref isrListener,
     hash_set<AccountID> const& vnaAccountIDs, bool rt)
 {
-    SubInfoMapType& subMap = rt ? mSubRTAccount : mSubAccount;
+    auto& subs = rt ? mSubRTAccount : mSubAccount;
 
     for (auto const& naAccountID : vnaAccountIDs)
     {
@@ -2675,27 +2876,7 @@ void NetworkOPsImp::subAccount (
             "subAccount: account: " << toBase58(naAccountID);
 
         isrListener->insertSubAccountInfo (naAccountID, rt);
-    }
-
-    ScopedLockType sl (mSubLock);
-
-    for (auto const& naAccountID : vnaAccountIDs)
-    {
-        auto simIterator = subMap.find (naAccountID);
-        if (simIterator == subMap.end ())
-        {
-            // Not found, note that account has a new single listner.
-            SubMapType  usisElement;
-            usisElement[isrListener->getSeq ()] = isrListener;
-            // VFALCO NOTE This is making a needless copy of naAccountID
-            subMap.insert (simIterator,
-                make_pair(naAccountID, usisElement));
-        }
-        else
-        {
-            // Found, note that the account has another listener.
-            simIterator->second[isrListener->getSeq ()] = isrListener;
-        }
+        subs.add (naAccountID, isrListener);
     }
 }
 
@@ -2719,26 +2900,10 @@ void NetworkOPsImp::unsubAccountInternal (
     hash_set<AccountID> const& vnaAccountIDs,
     bool rt)
 {
-    ScopedLockType sl (mSubLock);
-
-    SubInfoMapType& subMap = rt ? mSubRTAccount : mSubAccount;
+    auto& subs = rt ? mSubRTAccount : mSubAccount;
 
     for (auto const& naAccountID : vnaAccountIDs)
-    {
-        auto simIterator = subMap.find (naAccountID);
-
-        if (simIterator != subMap.end ())
-        {
-            // Found
-            simIterator->second.erase (uSeq);
-
-            if (simIterator->second.empty ())
-            {
-                // Don't need hash entry.
-                subMap.erase (simIterator);
-            }
-        }
-    }
+        subs.remove (naAccountID, uSeq);
 }
 
 bool NetworkOPsImp::subBook (InfoSub::ref isrListener, Book const& book)
@@ -3340,6 +3505,39 @@ Json::Value NetworkOPsImp::StateAccounting::json() const
 
 //------------------------------------------------------------------------------
 
+void NetworkOPsImp::PublishAccounting::record (Stream stream,
+    std::size_t messages, std::chrono::microseconds lag)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto& counters = counters_[stream];
+    counters.lag = counters.events == 0 ? lag : (counters.lag * 3 + lag) / 4;
+    counters.maxLag = std::max (counters.maxLag, lag);
+    ++counters.events;
+    counters.messages += messages;
+}
+
+Json::Value NetworkOPsImp::PublishAccounting::json() const
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+    auto const counters = counters_;
+    lock.unlock();
+
+    Json::Value ret = Json::objectValue;
+
+    for (std::size_t i = 0; i < counters.size(); ++i)
+    {
+        auto& stream = ret[streams_[i]] = Json::objectValue;
+        stream[jss::events] = std::to_string (counters[i].events);
+        stream[jss::messages] = std::to_string (counters[i].messages);
+        stream[jss::lag_us] = std::to_string (counters[i].lag.count());
+        stream[jss::lag_max_us] = std::to_string (counters[i].maxLag.count());
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
 std::unique_ptr<NetworkOPs>
 make_NetworkOPs (Application& app, NetworkOPs::clock_type& clock, bool standalone,
     std::size_t network_quorum, bool startvalid,
@@ -20,6 +20,7 @@
 #include <memory>
 #include <mtchain/core/Stoppable.h>
 #include <deque>
+#include <functional>
 #include <tuple>
 
 #include "mtchain.pb.h"
@@ -207,6 +208,21 @@ public:
         std::int32_t minLedger, std::int32_t maxLedger, bool forward,
         Json::Value& token, int limit, bool bUnlimited) = 0;
 
+    /** Passes each transaction of the page to `onTransaction`.
+
+        The page is read a few transactions at a time and no database
+        lock is held during the calls, so `onTransaction` may block.
+        Once `onTransaction` returns `false` nothing more is read, and
+        `token` no longer marks where the rest of the page starts.
+    */
+    using AccountTxFn = std::function <bool (AccountTx const&)>;
+
+    virtual void getTxsAccount (
+        AccountID const& account,
+        std::int32_t minLedger, std::int32_t maxLedger, bool forward,
+        Json::Value& token, int limit, bool bUnlimited,
+        AccountTxFn const& onTransaction) = 0;
+
     using txnMetaLedgerType = std::tuple<std::string, std::string, std::uint32_t>;
     using MetaTxsList       = std::vector<txnMetaLedgerType>;
 
@@ -218,6 +234,19 @@ public:
         std::int32_t minLedger, std::int32_t maxLedger,  bool forward,
         Json::Value& token, int limit, bool bUnlimited) = 0;
 
+    /** Passes each transaction of the page to `onTransaction` as stored.
+
+        As with getTxsAccount, no database lock is held during the calls,
+        and returning `false` stops the reading.
+    */
+    using RawTxFn = std::function <bool (std::uint32_t ledgerIndex,
+        Blob const& rawTxn, Blob const& rawMeta)>;
+
+    virtual void getTxsAccountRaw (AccountID const& account,
+        std::int32_t minLedger, std::int32_t maxLedger,  bool forward,
+        Json::Value& token, int limit, bool bUnlimited,
+        RawTxFn const& onTransaction) = 0;
+
     //--------------------------------------------------------------------------
     //
     // Monitoring: publisher side
@@ -17,6 +17,7 @@
 #include <mtchain/nodestore/Scheduler.h>
 #include <mtchain/protocol/ErrorCodes.h>
 #include <mtchain/core/Stoppable.h>
+#include <mtchain/json/json_value.h>
 
 namespace mtchain {
 
@@ -41,6 +42,7 @@ public:
         std::uint32_t deleteBatch = 100;
         std::uint32_t backOff = 100;
         std::int32_t ageThreshold = 60;
+        std::uint32_t copyThreads = 4;
     };
 
     SHAMapStore (Stoppable& parent) : Stoppable ("SHAMapStore", parent) {}
@@ -69,6 +71,9 @@ public:
 
     /** The number of files that are needed. */
     virtual int fdlimit() const = 0;
+
+    /** Progress of online delete, or null if it is not configured. */
+    virtual Json::Value getJson() const = 0;
 };
 
 //------------------------------------------------------------------------------
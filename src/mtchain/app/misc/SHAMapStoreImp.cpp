@@ -16,12 +16,15 @@
 #include <mtchain/app/main/Application.h>
 #include <mtchain/basics/contract.h>
 #include <mtchain/core/ConfigSections.h>
+#include <mtchain/protocol/JsonFields.h>
 #include <mtchain/beast/core/CurrentThreadName.h>
 #include <boost/format.hpp>
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
 #include <memory>
 #include <chrono>
+#include <exception>
+#include <vector>
 
 namespace mtchain {
 void SHAMapStoreImp::SavedStateDB::init (BasicConfig const& config,
@@ -271,12 +274,46 @@ SHAMapStoreImp::fdlimit () const
     return fdlimit_;
 }
 
+Json::Value
+SHAMapStoreImp::getJson() const
+{
+    if (! setup_.deleteInterval)
+        return Json::nullValue;
+
+    static char const* const steps[] =
+        {"idle", "clearing", "copying", "freshening", "rotating"};
+
+    Json::Value ret (Json::objectValue);
+    ret[jss::state] = steps[static_cast<int>(step_.load())];
+    ret[jss::last_rotated] = lastRotated_.load();
+    ret[jss::nodes_visited] = static_cast<Json::UInt>(nodesVisited_);
+    ret[jss::nodes_copied] = static_cast<Json::UInt>(nodesCopied_);
+    ret[jss::nodes_skipped] = static_cast<Json::UInt>(nodesSkipped_);
+
+    std::chrono::duration<double> elapsed {0};
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (copyFinished_ >= copyStarted_)
+            elapsed = copyFinished_ - copyStarted_;
+        else
+            elapsed = std::chrono::steady_clock::now() - copyStarted_;
+    }
+    if (elapsed.count() > 0)
+        ret[jss::nodes_per_second] = nodesVisited_ / elapsed.count();
+
+    return ret;
+}
+
 bool
-SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
-        SHAMapAbstractNode const& node)
+SHAMapStoreImp::copyNode (std::uint64_t& nodeCount, uint256 const& hash)
 {
-    // Copy a single record from node to database_
-    database_->fetchNode (node.getNodeHash().as_uint256());
+    // Copy a single record to the writable backend of database_
+    if (database_->copyToWritable (hash))
+        ++nodesCopied_;
+    else
+        ++nodesSkipped_;
+    ++nodesVisited_;
+
     if (! (++nodeCount % checkHealthInterval_))
     {
         if (health())
@@ -286,11 +323,78 @@ SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
     return false;
 }
 
+void
+SHAMapStoreImp::copyState (SHAMap const& map)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        copyStarted_ = std::chrono::steady_clock::now();
+    }
+    nodesVisited_ = 0;
+    nodesCopied_ = 0;
+    nodesSkipped_ = 0;
+
+    std::uint64_t rootCount = 0;
+    if (copyNode (rootCount, map.getHash().as_uint256()))
+        return;
+
+    // Branches of the root share no nodes, so each is copied by
+    // whichever thread claims it next.
+    std::atomic<int> next {0};
+    std::atomic<bool> stop {false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto const walk = [&]
+    {
+        beast::setCurrentThreadName ("SHAMapStore copy");
+        std::uint64_t nodeCount = 0;
+        try
+        {
+            for (int branch = next++; branch < 16 && ! stop; branch = next++)
+            {
+                map.visitBranch (branch,
+                    [&](SHAMapAbstractNode& node)
+                    {
+                        if (! stop && copyNode (
+                                nodeCount, node.getNodeHash().as_uint256()))
+                            stop = true;
+                        return stop.load();
+                    });
+            }
+        }
+        catch (...)
+        {
+            stop = true;
+            std::lock_guard<std::mutex> lock (errorMutex);
+            if (! error)
+                error = std::current_exception();
+        }
+    };
+
+    auto const threads = std::max (1u,
+        std::min (setup_.copyThreads, maximumCopyThreads_));
+    std::vector<std::thread> workers;
+    for (std::uint32_t i = 0; i < threads; ++i)
+        workers.emplace_back (walk);
+    for (auto& t : workers)
+        t.join();
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        copyFinished_ = std::chrono::steady_clock::now();
+    }
+
+    if (error)
+        std::rethrow_exception (error);
+}
+
 void
 SHAMapStoreImp::run()
 {
     beast::setCurrentThreadName ("SHAMapStore");
     LedgerIndex lastRotated = state_db_.getState().lastRotated;
+    lastRotated_ = lastRotated;
     netOPs_ = &app_.getOPs();
     ledgerMaster_ = &app_.getLedgerMaster();
     fullBelowCache_ = &app_.family().fullbelow();
@@ -304,6 +408,7 @@ SHAMapStoreImp::run()
     while (1)
     {
         healthy_ = true;
+        step_ = Step::idle;
         std::shared_ptr<Ledger const> validatedLedger;
 
         {
@@ -328,6 +433,7 @@ SHAMapStoreImp::run()
         if (!lastRotated)
         {
             lastRotated = validatedSeq;
+            lastRotated_ = lastRotated;
             state_db_.setLastRotated (lastRotated);
         }
 
@@ -351,6 +457,7 @@ SHAMapStoreImp::run()
                     ;
             }
 
+            step_ = Step::clearing;
             clearPrior (lastRotated);
             switch (health())
             {
@@ -364,13 +471,11 @@ SHAMapStoreImp::run()
                     ;
             }
 
-            std::uint64_t nodeCount = 0;
-            validatedLedger->stateMap().snapShot (
-                    false)->visitNodes (
-                    std::bind (&SHAMapStoreImp::copyNode, this,
-                    std::ref(nodeCount), std::placeholders::_1));
+            step_ = Step::copying;
+            copyState (*validatedLedger->stateMap().snapShot (false));
             JLOG(journal_.debug()) << "copied ledger " << validatedSeq
-                    << " nodecount " << nodeCount;
+                    << " nodecount " << nodesVisited_
+                    << " copied " << nodesCopied_;
             switch (health())
             {
                 case Health::stopping:
@@ -383,6 +488,7 @@ SHAMapStoreImp::run()
                     ;
             }
 
+            step_ = Step::freshening;
             freshenCaches();
             JLOG(journal_.debug()) << validatedSeq << " freshened caches";
             switch (health())
@@ -397,6 +503,7 @@ SHAMapStoreImp::run()
                     ;
             }
 
+            step_ = Step::rotating;
             std::shared_ptr <NodeStore::Backend> newBackend =
                     makeBackendRotating();
             JLOG(journal_.debug()) << validatedSeq << " new backend "
@@ -419,6 +526,7 @@ SHAMapStoreImp::run()
             std::string nextArchiveDir =
                     database_->getWritableBackend()->getName();
             lastRotated = validatedSeq;
+            lastRotated_ = lastRotated;
             {
                 std::lock_guard <std::mutex> lock (database_->peekMutex());
 
@@ -821,6 +929,7 @@ setup_SHAMapStore (Config const& c)
     get_if_exists (setup.nodeDatabase, "delete_batch", setup.deleteBatch);
     get_if_exists (setup.nodeDatabase, "backOff", setup.backOff);
     get_if_exists (setup.nodeDatabase, "age_threshold", setup.ageThreshold);
+    get_if_exists (setup.nodeDatabase, "copy_threads", setup.copyThreads);
 
     return setup;
 }
@@ -41,6 +41,16 @@ private:
         unhealthy
     };
 
+    // Step of the online delete cycle, reported by getJson
+    enum class Step : std::uint8_t
+    {
+        idle = 0,
+        clearing,
+        copying,
+        freshening,
+        rotating
+    };
+
     class SavedStateDB
     {
     public:
@@ -74,6 +84,8 @@ private:
     static std::uint32_t const minimumDeletionInterval_ = 256;
     // minimum # of ledgers required for standalone mode.
     static std::uint32_t const minimumDeletionIntervalSA_ = 8;
+    // most threads copying the state map, one per root branch
+    std::uint32_t const maximumCopyThreads_ = 16;
 
     Setup setup_;
     NodeStore::Scheduler& scheduler_;
@@ -83,7 +95,7 @@ private:
     SavedStateDB state_db_;
     std::thread thread_;
     bool stop_ = false;
-    bool healthy_ = true;
+    std::atomic<bool> healthy_ {true};
     mutable std::condition_variable cond_;
     mutable std::condition_variable rendezvous_;
     mutable std::mutex mutex_;
@@ -101,6 +113,16 @@ private:
     DatabaseCon* ledgerDb_ = nullptr;
     int fdlimit_ = 0;
 
+    // progress of the current or most recent rotation
+    std::atomic<Step> step_ {Step::idle};
+    std::atomic<LedgerIndex> lastRotated_ {0};
+    std::atomic<std::uint64_t> nodesVisited_ {0};
+    std::atomic<std::uint64_t> nodesCopied_ {0};
+    std::atomic<std::uint64_t> nodesSkipped_ {0};
+    // guarded by mutex_
+    std::chrono::steady_clock::time_point copyStarted_;
+    std::chrono::steady_clock::time_point copyFinished_;
+
 public:
     SHAMapStoreImp (Application& app,
             Setup const& setup,
@@ -161,10 +183,13 @@ public:
 
     void rendezvous() const override;
     int fdlimit() const override;
+    Json::Value getJson() const override;
 
 private:
-    // callback for visitNodes
-    bool copyNode (std::uint64_t& nodeCount, SHAMapAbstractNode const &node);
+    // copy one node, returns true if the copy should stop
+    bool copyNode (std::uint64_t& nodeCount, uint256 const& hash);
+    // copy the nodes of a state map not yet in the writable backend
+    void copyState (SHAMap const& map);
     void run();
     void dbPaths();
     std::shared_ptr <NodeStore::Backend> makeBackendRotating (
@@ -194,7 +219,7 @@ private:
 
         for (auto const& key: cache.getKeys())
         {
-            database_->fetchNode (key);
+            database_->copyToWritable (key);
             if (! (++check % checkHealthInterval_) && health())
                 return true;
         }
@@ -0,0 +1,43 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_APP_MISC_SNAPSHOTEXPORT_H_INCLUDED
+#define MTCHAIN_APP_MISC_SNAPSHOTEXPORT_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+namespace mtchain {
+
+class Application;
+
+/** Export a range of stored ledgers to a read-only snapshot.
+
+    The range is split into contiguous chunks walked by `threads`
+    workers. Within a chunk each ledger only contributes the state nodes
+    that differ from the previous ledger, so shared subtrees are visited
+    once. Ledger headers, state maps and transaction maps are written.
+
+    The result is served by the `Snapshot` node store backend.
+
+    @param path Directory in which to create the snapshot.
+    @return `true` if every ledger in the range was exported completely.
+*/
+bool
+exportSnapshot (
+    Application& app,
+    std::string const& path,
+    std::uint32_t firstSeq,
+    std::uint32_t lastSeq,
+    unsigned threads);
+
+}
+
+#endif
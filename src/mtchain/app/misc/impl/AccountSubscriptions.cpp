@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/misc/impl/AccountSubscriptions.h>
+#include <algorithm>
+
+namespace mtchain {
+
+AccountSubscriptions::AccountSubscriptions (std::size_t shards)
+    : shards_ (shards)
+    , accounts_ (0)
+{
+}
+
+AccountSubscriptions::Shard&
+AccountSubscriptions::shard (AccountID const& account)
+{
+    return shards_[hasher_ (account) % shards_.size ()];
+}
+
+void
+AccountSubscriptions::add (AccountID const& account, InfoSub::ref listener)
+{
+    auto& s = shard (account);
+    std::lock_guard <std::mutex> lock (s.mutex);
+    auto& subs = s.accounts[account];
+    if (subs.empty ())
+        ++accounts_;
+    subs[listener->getSeq ()] = listener;
+}
+
+void
+AccountSubscriptions::remove (AccountID const& account, std::uint64_t seq)
+{
+    auto& s = shard (account);
+    std::lock_guard <std::mutex> lock (s.mutex);
+    auto const it = s.accounts.find (account);
+    if (it == s.accounts.end ())
+        return;
+    it->second.erase (seq);
+    if (it->second.empty ())
+    {
+        s.accounts.erase (it);
+        --accounts_;
+    }
+}
+
+void
+AccountSubscriptions::find (
+    boost::container::flat_set <AccountID> const& accounts,
+    Listeners& listeners)
+{
+    auto const before = listeners.size ();
+    for (auto const& account : accounts)
+    {
+        auto& s = shard (account);
+        std::lock_guard <std::mutex> lock (s.mutex);
+        auto const found = s.accounts.find (account);
+        if (found == s.accounts.end ())
+            continue;
+
+        auto& subs = found->second;
+        for (auto it = subs.begin (); it != subs.end ();)
+        {
+            if (auto p = it->second.lock ())
+            {
+                listeners.push_back (std::move (p));
+                ++it;
+            }
+            else
+            {
+                it = subs.erase (it);
+            }
+        }
+        if (subs.empty ())
+        {
+            s.accounts.erase (found);
+            --accounts_;
+        }
+    }
+
+    if (listeners.size () != before)
+    {
+        std::sort (listeners.begin (), listeners.end ());
+        listeners.erase (std::unique (listeners.begin (), listeners.end ()),
+            listeners.end ());
+    }
+}
+
+} //
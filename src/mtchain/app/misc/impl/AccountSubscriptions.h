@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_APP_MISC_IMPL_ACCOUNTSUBSCRIPTIONS_H_INCLUDED
+#define MTCHAIN_APP_MISC_IMPL_ACCOUNTSUBSCRIPTIONS_H_INCLUDED
+
+#include <mtchain/basics/UnorderedContainers.h>
+#include <mtchain/net/InfoSub.h>
+#include <mtchain/protocol/AccountID.h>
+#include <boost/container/flat_set.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mtchain {
+
+/** The subscribers watching each account.
+
+    The accounts are spread over shards, each with its own lock, so
+    that subscribing and publishing on different accounts do not wait
+    on each other, nor on the locks of the other streams.
+*/
+class AccountSubscriptions
+{
+public:
+    using Listeners = std::vector <InfoSub::pointer>;
+
+    explicit AccountSubscriptions (std::size_t shards = 32);
+
+    AccountSubscriptions (AccountSubscriptions const&) = delete;
+    AccountSubscriptions& operator= (AccountSubscriptions const&) = delete;
+
+    /** Start sending the listener what affects the account. */
+    void
+    add (AccountID const& account, InfoSub::ref listener);
+
+    /** Stop sending the listener what affects the account. */
+    void
+    remove (AccountID const& account, std::uint64_t seq);
+
+    /** Append the subscribers to any of the accounts to `listeners`.
+
+        Each subscriber appears in `listeners` once, however many of
+        the accounts it watches and whatever was in `listeners`
+        before. Subscribers that have gone away are forgotten.
+    */
+    void
+    find (boost::container::flat_set <AccountID> const& accounts,
+        Listeners& listeners);
+
+    /** Returns `true` if no account is watched. */
+    bool
+    empty () const
+    {
+        return accounts_ == 0;
+    }
+
+    /** Returns the number of accounts watched. */
+    std::size_t
+    size () const
+    {
+        return accounts_;
+    }
+
+private:
+    using SubMapType = hash_map <std::uint64_t, InfoSub::wptr>;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        hash_map <AccountID, SubMapType> accounts;
+    };
+
+    Shard&
+    shard (AccountID const& account);
+
+    hardened_hash <> hasher_;
+    std::vector <Shard> shards_;
+    std::atomic <std::size_t> accounts_;
+};
+
+} //
+
+#endif
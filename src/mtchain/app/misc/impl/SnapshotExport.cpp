@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/misc/SnapshotExport.h>
+#include <mtchain/app/ledger/Ledger.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/basics/contract.h>
+#include <mtchain/basics/Log.h>
+#include <mtchain/beast/core/CurrentThreadName.h>
+#include <mtchain/nodestore/Database.h>
+#include <mtchain/nodestore/SnapshotWriter.h>
+#include <mtchain/shamap/SHAMapMissingNode.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace mtchain {
+
+bool
+exportSnapshot (
+    Application& app,
+    std::string const& path,
+    std::uint32_t firstSeq,
+    std::uint32_t lastSeq,
+    unsigned threads)
+{
+    auto const j = app.journal ("Snapshot");
+    assert (firstSeq <= lastSeq);
+
+    NodeStore::SnapshotWriter writer (path);
+    std::atomic<std::uint32_t> exported {0};
+    std::atomic<std::uint32_t> failed {0};
+
+    auto const count = lastSeq - firstSeq + 1;
+    threads = std::max (1u, std::min (threads, count));
+    auto const chunk = (count + threads - 1) / threads;
+
+    JLOG (j.info()) << "Exporting ledgers " << firstSeq << "-" << lastSeq
+        << " to " << path << " using " << threads << " threads";
+
+    auto const walk = [&](std::uint32_t first, std::uint32_t last)
+    {
+        beast::setCurrentThreadName ("snapshot");
+
+        auto const add = [&writer](NodeObjectType type)
+        {
+            return [&writer, type](SHAMapHash const& hash, Blob const& data)
+            {
+                writer.insert (NodeObject::createObject (
+                    type, Blob (data), hash.as_uint256()));
+            };
+        };
+
+        // Nodes shared with the previous ledger were already written
+        std::shared_ptr<Ledger> prev;
+        for (auto seq = first; seq <= last; ++seq)
+        {
+            auto ledger = loadByIndex (seq, app);
+            if (! ledger)
+            {
+                JLOG (j.warn()) << "Ledger " << seq << " is not stored";
+                ++failed;
+                prev.reset();
+                continue;
+            }
+
+            try
+            {
+                auto header = app.getNodeStore().fetch (ledger->info().hash);
+                if (! header)
+                    Throw<std::runtime_error> ("missing ledger header");
+                writer.insert (header);
+
+                ledger->stateMap().getFetchPack (
+                    prev ? &prev->stateMap() : nullptr, true,
+                    std::numeric_limits<int>::max(), add (hotACCOUNT_NODE));
+                ledger->txMap().getFetchPack (nullptr, true,
+                    std::numeric_limits<int>::max(), add (hotTRANSACTION_NODE));
+                prev = std::move (ledger);
+                ++exported;
+            }
+            catch (std::exception const& e)
+            {
+                JLOG (j.warn()) << "Ledger " << seq <<
+                    " is incomplete: " << e.what();
+                ++failed;
+                prev.reset();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::uint64_t first = firstSeq; first <= lastSeq; first += chunk)
+    {
+        auto const last = std::min<std::uint64_t> (lastSeq, first + chunk - 1);
+        workers.emplace_back (walk, static_cast<std::uint32_t>(first),
+            static_cast<std::uint32_t>(last));
+    }
+    for (auto& t : workers)
+        t.join();
+
+    auto const objects = writer.finish ();
+
+    JLOG (j.info()) << "Snapshot complete: " << exported << " ledgers, "
+        << objects << " objects, " << writer.bytes() << " bytes";
+    if (failed)
+    {
+        JLOG (j.error()) << failed << " ledgers could not be exported";
+    }
+    return failed == 0;
+}
+
+}
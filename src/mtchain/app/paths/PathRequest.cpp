@@ -435,6 +435,7 @@ Json::Value PathRequest::doClose (Json::Value const&)
 {
     JLOG(m_journal.debug()) << iIdentifier << " closed";
     ScopedLockType sl (mLock);
+    Json::Arena::Suspend heap;
     jvStatus[jss::closed] = true;
     return jvStatus;
 }
@@ -442,6 +443,7 @@ Json::Value PathRequest::doClose (Json::Value const&)
 Json::Value PathRequest::doStatus (Json::Value const&)
 {
     ScopedLockType sl (mLock);
+    Json::Arena::Suspend heap;
     jvStatus[jss::status] = jss::success;
     return jvStatus;
 }
@@ -197,6 +197,9 @@ PathRequests::makePathRequest(
     std::shared_ptr<ReadView const> const& inLedger,
     Json::Value const& requestJson)
 {
+    // The request keeps its state for as long as the client subscribes
+    Json::Arena::Suspend heap;
+
     auto req = std::make_shared<PathRequest> (
         app_, subscriber, ++mLastIdentifier, *this, mJournal);
 
@@ -221,6 +224,9 @@ PathRequests::makeLegacyPathRequest(
     std::shared_ptr<ReadView const> const& inLedger,
     Json::Value const& request)
 {
+    // The request outlives this call, so its state is not in an arena
+    Json::Arena::Suspend heap;
+
     // This assignment must take place before the
     // completion function is called
     req = std::make_shared<PathRequest> (
@@ -154,6 +154,8 @@ public:
     // Node storage configuration
     std::uint32_t                      LEDGER_HISTORY = 256;
     std::uint32_t                      FETCH_DEPTH = 1000000000;
+    // Ledger node requests each peer may have outstanding
+    std::uint32_t                      FETCH_PIPELINE = 4;
     int                         NODE_SIZE = 0;
 
     bool                        SSL_VERIFY = true;
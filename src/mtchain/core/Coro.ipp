@@ -75,7 +75,10 @@ post()
             auto saved = detail::getLocalValues().release();
             detail::getLocalValues().reset(&lvs_);
             std::lock_guard<std::mutex> lock(mutex_);
+            // arena_ belongs to whichever job runs the coroutine
+            auto const savedArena = Json::Arena::exchange(arena_);
             coro_();
+            arena_ = Json::Arena::exchange(savedArena);
             detail::getLocalValues().release();
             detail::getLocalValues().reset(saved);
             std::lock_guard<std::mutex> lk(mutex_run_);
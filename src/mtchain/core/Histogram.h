@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_CORE_HISTOGRAM_H_INCLUDED
+#define MTCHAIN_CORE_HISTOGRAM_H_INCLUDED
+
+#include <mtchain/json/json_value.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace mtchain {
+
+/** A histogram of values that any thread may record without locking.
+
+    Values are counted in buckets a quarter of a power of two wide, so
+    a percentile read back is within 25% of the true value whatever its
+    magnitude. Recording costs a few relaxed atomic operations.
+*/
+class Histogram
+{
+public:
+    /** Values this large or larger share the last bucket. */
+    static std::uint64_t const maxValue = std::uint64_t (1) << 40;
+
+    static std::size_t const subBuckets = 4;
+
+    Histogram () = default;
+    Histogram (Histogram const&) = delete;
+    Histogram& operator= (Histogram const&) = delete;
+
+    void
+    record (std::uint64_t value);
+
+    std::uint64_t
+    count () const
+    {
+        return count_.load (std::memory_order_relaxed);
+    }
+
+    std::uint64_t
+    max () const
+    {
+        return max_.load (std::memory_order_relaxed);
+    }
+
+    double
+    mean () const;
+
+    /** Returns the value at or below which `fraction` of the values lie. */
+    std::uint64_t
+    percentile (double fraction) const;
+
+    /** Returns the count, mean, maximum, median, 90th and 99th
+        percentiles, and the non-empty buckets as pairs of the largest
+        value the bucket holds and its count.
+    */
+    Json::Value
+    getJson () const;
+
+    /** Returns the bucket a value is counted in. */
+    static
+    std::size_t
+    bucket (std::uint64_t value);
+
+    /** Returns the largest value counted in a bucket. */
+    static
+    std::uint64_t
+    upperBound (std::size_t bucket);
+
+private:
+    static std::size_t const buckets_ = 156;   // bucket (maxValue - 1) + 1
+
+    std::array <std::atomic <std::uint64_t>, buckets_> counts_ {};
+    std::atomic <std::uint64_t> count_ {0};
+    std::atomic <std::uint64_t> sum_ {0};
+    std::atomic <std::uint64_t> max_ {0};
+};
+
+} //
+
+#endif
@@ -52,6 +52,7 @@ public:
     {
     private:
         detail::LocalValues lvs_;
+        Json::Arena* arena_ = nullptr;
         JobQueue& jq_;
         JobType type_;
         std::string name_;
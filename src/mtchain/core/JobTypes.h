@@ -29,7 +29,7 @@ public:
     {
         int maxLimit = std::numeric_limits <int>::max ();
 
-add(    jtPACK,          "makeFetchPack",           1,        false, 0,     0);
+add(    jtPACK,          "makeFetchPack",           4,        false, 0,     0);
 add(    jtPUBOLDLEDGER,  "publishAcqLedger",        2,        false, 30000, 45000);
 add(    jtVALIDATION_ut, "untrustedValidation",     maxLimit, false, 2000,  5000);
 add(    jtTRANSACTION_l, "localTransaction",        maxLimit, false, 100,   500);
@@ -418,6 +418,16 @@ void Config::loadFromString (std::string const& fileContents)
             FETCH_DEPTH = 10;
     }
 
+    if (getSingleSection (secConfig, SECTION_FETCH_PIPELINE, strTemp, j_))
+    {
+        FETCH_PIPELINE = beast::lexicalCastThrow <std::uint32_t> (strTemp);
+
+        if (FETCH_PIPELINE < 1)
+            FETCH_PIPELINE = 1;
+        else if (FETCH_PIPELINE > 16)
+            FETCH_PIPELINE = 16;
+    }
+
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH_OLD, strTemp, j_))
         PATH_SEARCH_OLD     = beast::lexicalCastThrow <int> (strTemp);
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH, strTemp, j_))
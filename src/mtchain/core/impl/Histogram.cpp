@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/core/Histogram.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mtchain {
+
+static
+Json::UInt
+toJson (std::uint64_t value)
+{
+    return static_cast <Json::UInt> (std::min <std::uint64_t> (
+        value, std::numeric_limits <Json::UInt>::max ()));
+}
+
+std::size_t
+Histogram::bucket (std::uint64_t value)
+{
+    if (value >= maxValue)
+        value = maxValue - 1;
+    if (value < subBuckets)
+        return static_cast <std::size_t> (value);
+
+    // The position of the highest set bit
+    std::size_t msb = 0;
+    for (std::size_t shift = 32; shift != 0; shift /= 2)
+    {
+        if (value >> (msb + shift))
+            msb += shift;
+    }
+
+    // The two bits below it pick the quarter
+    auto const sub = (value >> (msb - 2)) & (subBuckets - 1);
+    return (msb - 1) * subBuckets + static_cast <std::size_t> (sub);
+}
+
+std::uint64_t
+Histogram::upperBound (std::size_t bucket)
+{
+    if (bucket < subBuckets)
+        return bucket;
+    auto const msb = bucket / subBuckets + 1;
+    auto const sub = bucket % subBuckets;
+    auto const width = std::uint64_t (1) << (msb - 2);
+    return (subBuckets + sub) * width + width - 1;
+}
+
+void
+Histogram::record (std::uint64_t value)
+{
+    counts_[bucket (value)].fetch_add (1, std::memory_order_relaxed);
+    count_.fetch_add (1, std::memory_order_relaxed);
+    sum_.fetch_add (value, std::memory_order_relaxed);
+
+    auto max = max_.load (std::memory_order_relaxed);
+    while (value > max && ! max_.compare_exchange_weak (
+            max, value, std::memory_order_relaxed))
+        ;
+}
+
+double
+Histogram::mean () const
+{
+    auto const count = count_.load (std::memory_order_relaxed);
+    if (count == 0)
+        return 0;
+    return static_cast <double> (sum_.load (std::memory_order_relaxed)) /
+        count;
+}
+
+std::uint64_t
+Histogram::percentile (double fraction) const
+{
+    std::uint64_t total = 0;
+    for (auto const& c : counts_)
+        total += c.load (std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+
+    auto const target = std::max <std::uint64_t> (1,
+        static_cast <std::uint64_t> (std::ceil (fraction * total)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets_; ++i)
+    {
+        seen += counts_[i].load (std::memory_order_relaxed);
+        if (seen >= target)
+            return std::min (upperBound (i), max ());
+    }
+    return max ();
+}
+
+Json::Value
+Histogram::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::count] = toJson (count ());
+    ret[jss::mean] = mean ();
+    ret[jss::max] = toJson (max ());
+    ret[jss::p50] = toJson (percentile (0.50));
+    ret[jss::p90] = toJson (percentile (0.90));
+    ret[jss::p99] = toJson (percentile (0.99));
+
+    auto& buckets = (ret[jss::buckets] = Json::arrayValue);
+    for (std::size_t i = 0; i < buckets_; ++i)
+    {
+        auto const count = counts_[i].load (std::memory_order_relaxed);
+        if (count == 0)
+            continue;
+        Json::Value entry (Json::arrayValue);
+        entry.append (toJson (upperBound (i)));
+        entry.append (toJson (count));
+        buckets.append (std::move (entry));
+    }
+    return ret;
+}
+
+} //
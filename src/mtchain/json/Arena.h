@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_JSON_ARENA_H_INCLUDED
+#define MTCHAIN_JSON_ARENA_H_INCLUDED
+
+#include <cstddef>
+
+namespace Json {
+
+/** Carves the memory of Json::Value trees out of large blocks.
+
+    While an arena is in use on a thread, the strings, member names and
+    object and array nodes of the Values built there are taken from its
+    current block by bumping a pointer. A block goes back to the heap in
+    one piece once everything carved from it has been destroyed, so the
+    tree built for an RPC request costs a handful of heap calls instead
+    of one or two per member.
+
+    Values may outlive the arena and may be destroyed on any thread, each
+    block lives until its last Value is gone. A long lived Value built in
+    an arena keeps its whole block alive, so an arena should only be in
+    use while building short lived trees. Values that outlive the request
+    they are built for, such as those kept in caches or in function-local
+    statics first used during a request, are built under a Suspend instead.
+
+    Only memory carved from a block carries a header, allocations made
+    without an arena cost what they would on the heap.
+
+    An arena is put in use by a Scope. Coroutines carry the arena in use
+    with them when they are suspended and resumed on another thread.
+*/
+class Arena
+{
+public:
+    class Scope;
+    class Suspend;
+
+    /** Counts of the allocations made on a thread. */
+    struct Stats
+    {
+        std::size_t allocations = 0;
+        std::size_t heap = 0;       // made directly on the heap
+        std::size_t blocks = 0;     // arena blocks taken from the heap
+    };
+
+    Arena () = default;
+    ~Arena ();
+
+    Arena (Arena const&) = delete;
+    Arena& operator= (Arena const&) = delete;
+
+    /** Puts `arena` in use on this thread and returns the one replaced. */
+    static
+    Arena*
+    exchange (Arena* arena);
+
+    /** Allocate memory for a Value, from the arena in use if there is one.
+
+        The memory is suitably aligned for any type aligned to 8 bytes.
+        Memory is only carved from the arena for allocations of a few
+        kilobytes at most.
+    */
+    static
+    void*
+    allocate (std::size_t bytes);
+
+    /** Release memory returned by allocate, on any thread. */
+    static
+    void
+    deallocate (void* p);
+
+    /** Returns the counts of allocations made on this thread. */
+    static
+    Stats&
+    getStats ();
+
+private:
+    struct Block;
+
+    void*
+    carve (std::size_t bytes);
+
+    void
+    retire ();
+
+    Block* block_ = nullptr;
+    std::size_t carved_ = 0;
+};
+
+/** Puts a new arena in use on this thread for its lifetime. */
+class Arena::Scope
+{
+public:
+    Scope ();
+    ~Scope ();
+
+    Scope (Scope const&) = delete;
+    Scope& operator= (Scope const&) = delete;
+
+private:
+    Arena arena_;
+    Arena* saved_;
+};
+
+/** Takes the arena out of use on this thread for its lifetime.
+
+    Values built meanwhile are on the heap, so they keep no block alive.
+*/
+class Arena::Suspend
+{
+public:
+    Suspend ();
+    ~Suspend ();
+
+    Suspend (Suspend const&) = delete;
+    Suspend& operator= (Suspend const&) = delete;
+
+private:
+    Arena* saved_;
+};
+
+/** A standard allocator for the containers of a Json::Value. */
+template <class T>
+class ArenaAllocator
+{
+public:
+    static_assert (alignof (T) <= 8, "");
+
+    using value_type = T;
+
+    ArenaAllocator () = default;
+
+    template <class U>
+    ArenaAllocator (ArenaAllocator<U> const&)
+    {
+    }
+
+    T*
+    allocate (std::size_t n)
+    {
+        return static_cast<T*> (Arena::allocate (n * sizeof (T)));
+    }
+
+    void
+    deallocate (T* p, std::size_t)
+    {
+        Arena::deallocate (p);
+    }
+
+    template <class U>
+    bool
+    operator== (ArenaAllocator<U> const&) const
+    {
+        return true;
+    }
+
+    template <class U>
+    bool
+    operator!= (ArenaAllocator<U> const&) const
+    {
+        return false;
+    }
+};
+
+} // Json
+
+#endif
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_JSON_FASTREADER_H_INCLUDED
+#define MTCHAIN_JSON_FASTREADER_H_INCLUDED
+
+#include <mtchain/json/json_reader.h>
+#include <mtchain/json/json_value.h>
+#include <boost/asio/buffer.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Json
+{
+
+/** Reads a JSON document into a Value in two passes.
+
+    The first pass finds the structural characters of the whole document
+    sixty-four bytes at a time, using SSE2 where it is available, and
+    leaves out those inside strings. The second builds the Value visiting
+    only those positions, so whitespace and the bodies of strings are
+    never looked at a character at a time.
+
+    The Value is the same as the one Json::Reader produces. A document
+    that is not strict JSON, such as one with comments or duplicate keys,
+    is handed to Json::Reader, which also reports the errors.
+*/
+class FastReader
+{
+public:
+    /** Read a Value from a JSON document.
+        @return `true` if the document was parsed.
+    */
+    bool
+    parse (std::string const& document, Value& root);
+
+    bool
+    parse (char const* begin, char const* end, Value& root);
+
+    /** Read a Value from a JSON document held in a buffer sequence. */
+    template <class BufferSequence>
+    bool
+    parse (Value& root, BufferSequence const& bs);
+
+    /** Returns the errors of the last parse, formatted as by Json::Reader. */
+    std::string
+    getFormatedErrorMessages () const
+    {
+        return reader_.getFormatedErrorMessages ();
+    }
+
+    /** Returns `true` if the last document was handed to Json::Reader. */
+    bool
+    fellBack () const
+    {
+        return fellBack_;
+    }
+
+private:
+    bool
+    index ();
+
+    char
+    at (std::uint32_t pos) const
+    {
+        return pos < size_ ? begin_[pos] : 0;
+    }
+
+    bool
+    readValue (Value& value);
+
+    bool
+    readObject (Value& value);
+
+    bool
+    readArray (Value& value);
+
+    bool
+    readNumber (std::uint32_t pos, Value& value);
+
+    bool
+    readLiteral (std::uint32_t pos, char const* literal, std::size_t size);
+
+    // Positions of the structural characters, then two past the end
+    std::unique_ptr<std::uint32_t[]> indexes_;
+    std::size_t capacity_ = 0;
+    std::size_t next_ = 0;
+    char const* begin_ = nullptr;
+    std::uint32_t size_ = 0;
+    std::string key_;
+    std::string buffer_;
+    Reader reader_;
+    bool fellBack_ = false;
+};
+
+template <class BufferSequence>
+bool
+FastReader::parse (Value& root, BufferSequence const& bs)
+{
+    using namespace boost::asio;
+    auto it = bs.begin ();
+    if (it != bs.end () && std::next (it) == bs.end ())
+    {
+        auto const p = buffer_cast<char const*> (*it);
+        return parse (p, p + buffer_size (*it), root);
+    }
+
+    buffer_.clear ();
+    buffer_.reserve (buffer_size (bs));
+    for (auto const& b : bs)
+        buffer_.append (buffer_cast<char const*> (b), buffer_size (b));
+    return parse (buffer_.data (), buffer_.data () + buffer_.size (), root);
+}
+
+} // Json
+
+#endif
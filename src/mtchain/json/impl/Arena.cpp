@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/basics/contract.h>
+#include <mtchain/json/Arena.h>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace Json {
+
+namespace {
+
+// A carved allocation starts with the block it was carved from. Carved
+// memory is 8 bytes past a 16 byte boundary and memory from the heap is
+// on one, so allocations from the heap need no header.
+std::size_t constexpr headerBytes = 8;
+std::uintptr_t constexpr carvedBit = 8;
+static_assert (sizeof (void*) == 8,
+    "malloc aligns to 16 bytes on 64-bit platforms only");
+
+// The size of a block, and of the largest allocation carved from one
+std::size_t constexpr blockBytes = 64 * 1024;
+std::size_t constexpr maxCarveBytes = 4 * 1024;
+
+// Added to the count of a block while it is open, so that it is not
+// freed before the arena has finished carving it
+std::size_t constexpr openRefs = std::size_t (1) << 30;
+
+Arena*&
+current ()
+{
+    thread_local Arena* arena = nullptr;
+    return arena;
+}
+
+void*
+allocateHeap (std::size_t bytes)
+{
+    void* const p = std::malloc (bytes);
+    if (! p)
+        mtchain::Throw<std::bad_alloc> ();
+    assert ((reinterpret_cast<std::uintptr_t> (p) & carvedBit) == 0);
+    return p;
+}
+
+}
+
+struct Arena::Block
+{
+    // The allocations carved from the block and not yet released
+    std::atomic<std::size_t> refs;
+    std::size_t used;
+};
+
+Arena::~Arena ()
+{
+    retire ();
+}
+
+Arena*
+Arena::exchange (Arena* arena)
+{
+    auto& arenaInUse = current ();
+    auto const replaced = arenaInUse;
+    arenaInUse = arena;
+    return replaced;
+}
+
+void*
+Arena::allocate (std::size_t bytes)
+{
+    auto& stats = getStats ();
+    ++stats.allocations;
+
+    auto const arena = current ();
+    auto const carved = (bytes + headerBytes + 15) & ~std::size_t (15);
+    if (! arena || carved > maxCarveBytes)
+    {
+        ++stats.heap;
+        return allocateHeap (bytes);
+    }
+
+    auto const p = arena->carve (carved);
+    *static_cast<Block**> (p) = arena->block_;
+    return static_cast<char*> (p) + headerBytes;
+}
+
+void
+Arena::deallocate (void* p)
+{
+    if ((reinterpret_cast<std::uintptr_t> (p) & carvedBit) == 0)
+    {
+        std::free (p);
+        return;
+    }
+
+    auto const base = static_cast<char*> (p) - headerBytes;
+    auto const block = *reinterpret_cast<Block**> (base);
+    if (block->refs.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        std::free (block);
+}
+
+Arena::Stats&
+Arena::getStats ()
+{
+    thread_local Stats stats;
+    return stats;
+}
+
+void*
+Arena::carve (std::size_t bytes)
+{
+    static_assert (sizeof (Block*) <= headerBytes, "");
+    static_assert (sizeof (Block) % 16 == 0, "");
+
+    if (! block_ || block_->used + bytes > blockBytes)
+    {
+        retire ();
+        block_ = new (allocateHeap (blockBytes)) Block;
+        block_->refs.store (openRefs, std::memory_order_relaxed);
+        block_->used = sizeof (Block);
+        ++getStats ().blocks;
+    }
+
+    // The count is settled when the block is retired
+    auto const p = reinterpret_cast<char*> (block_) + block_->used;
+    block_->used += bytes;
+    ++carved_;
+    return p;
+}
+
+void
+Arena::retire ()
+{
+    if (! block_)
+        return;
+
+    auto const open = openRefs - carved_;
+    if (block_->refs.fetch_sub (open, std::memory_order_acq_rel) == open)
+        std::free (block_);
+    block_ = nullptr;
+    carved_ = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Arena::Scope::Scope ()
+    : saved_ (exchange (&arena_))
+{
+}
+
+Arena::Scope::~Scope ()
+{
+    exchange (saved_);
+}
+
+Arena::Suspend::Suspend ()
+    : saved_ (exchange (nullptr))
+{
+}
+
+Arena::Suspend::~Suspend ()
+{
+    exchange (saved_);
+}
+
+} // Json
@@ -0,0 +1,574 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/json/FastReader.h>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MTCHAIN_JSON_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Json
+{
+
+namespace detail {
+
+// One bit per byte of a 64 byte block
+struct BlockMasks
+{
+    std::uint64_t backslash = 0;
+    std::uint64_t quote = 0;
+    std::uint64_t op = 0;
+    std::uint64_t space = 0;
+};
+
+#if MTCHAIN_JSON_SSE2
+
+static
+std::uint64_t
+matches (__m128i v, char c, int shift)
+{
+    return std::uint64_t (static_cast<std::uint16_t> (_mm_movemask_epi8 (
+        _mm_cmpeq_epi8 (v, _mm_set1_epi8 (c))))) << shift;
+}
+
+static
+BlockMasks
+classify (char const* p)
+{
+    BlockMasks m;
+    for (int i = 0; i < 4; ++i)
+    {
+        auto const v = _mm_loadu_si128 (
+            reinterpret_cast<__m128i const*> (p + 16 * i));
+        // Setting 0x20 folds '[' and ']' onto '{' and '}'
+        auto const folded = _mm_or_si128 (v, _mm_set1_epi8 (0x20));
+        int const shift = 16 * i;
+        m.backslash |= matches (v, '\\', shift);
+        m.quote |= matches (v, '"', shift);
+        m.op |= matches (folded, '{', shift) | matches (folded, '}', shift) |
+            matches (v, ':', shift) | matches (v, ',', shift);
+        m.space |= matches (v, ' ', shift) | matches (v, '\n', shift) |
+            matches (v, '\r', shift) | matches (v, '\t', shift);
+    }
+    return m;
+}
+
+#else
+
+static
+BlockMasks
+classify (char const* p)
+{
+    BlockMasks m;
+    for (int i = 0; i < 64; ++i)
+    {
+        auto const bit = std::uint64_t (1) << i;
+        switch (p[i])
+        {
+        case '\\':
+            m.backslash |= bit;
+            break;
+        case '"':
+            m.quote |= bit;
+            break;
+        case '{': case '}': case '[': case ']': case ':': case ',':
+            m.op |= bit;
+            break;
+        case ' ': case '\n': case '\r': case '\t':
+            m.space |= bit;
+            break;
+        }
+    }
+    return m;
+}
+
+#endif
+
+static
+int
+trailingZeros (std::uint64_t x)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64 (&i, x);
+    return static_cast<int> (i);
+#else
+    return __builtin_ctzll (x);
+#endif
+}
+
+// Sets every bit from each set bit up to the next one
+static
+std::uint64_t
+prefixXor (std::uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Returns the characters escaped by an odd run of backslashes.
+// `carry` is set if the block ends in an escape.
+static
+std::uint64_t
+escapedBy (std::uint64_t backslash, std::uint64_t& carry)
+{
+    std::uint64_t const even = 0x5555555555555555ULL;
+    backslash &= ~carry;
+    auto const follows = (backslash << 1) | carry;
+    auto const oddStarts = backslash & ~even & ~follows;
+    auto const sum = oddStarts + backslash;
+    carry = sum < oddStarts ? 1 : 0;
+    return (even ^ (sum << 1)) & follows;
+}
+
+static
+bool
+isDelimiter (char c)
+{
+    switch (c)
+    {
+    case ' ': case '\n': case '\r': case '\t':
+    case '{': case '}': case '[': case ']': case ':': case ',':
+        return true;
+    }
+    return false;
+}
+
+static
+void
+appendCodePoint (std::string& s, unsigned int cp)
+{
+    if (cp <= 0x7f)
+    {
+        s += static_cast<char> (cp);
+    }
+    else if (cp <= 0x7FF)
+    {
+        s += static_cast<char> (0xC0 | (0x1f & (cp >> 6)));
+        s += static_cast<char> (0x80 | (0x3f & cp));
+    }
+    else if (cp <= 0xFFFF)
+    {
+        s += static_cast<char> (0xE0 | (0xf & (cp >> 12)));
+        s += static_cast<char> (0x80 | (0x3f & (cp >> 6)));
+        s += static_cast<char> (0x80 | (0x3f & cp));
+    }
+    else if (cp <= 0x10FFFF)
+    {
+        s += static_cast<char> (0xF0 | (0x7 & (cp >> 18)));
+        s += static_cast<char> (0x80 | (0x3f & (cp >> 12)));
+        s += static_cast<char> (0x80 | (0x3f & (cp >> 6)));
+        s += static_cast<char> (0x80 | (0x3f & cp));
+    }
+}
+
+static
+bool
+readHex4 (char const*& p, char const* end, unsigned int& unicode)
+{
+    if (end - p < 4)
+        return false;
+
+    unicode = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        char const c = *p++;
+        unicode *= 16;
+        if (c >= '0' && c <= '9')
+            unicode += c - '0';
+        else if (c >= 'a' && c <= 'f')
+            unicode += c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            unicode += c - 'A' + 10;
+        else
+            return false;
+    }
+    return true;
+}
+
+// Decodes the body of a string the way Json::Reader does
+static
+bool
+unescape (char const* p, char const* end, std::string& decoded)
+{
+    decoded.clear ();
+    decoded.reserve (end - p);
+    while (p != end)
+    {
+        auto const escape = static_cast<char const*> (
+            std::memchr (p, '\\', end - p));
+        if (! escape)
+        {
+            decoded.append (p, end);
+            return true;
+        }
+        decoded.append (p, escape);
+        p = escape + 1;
+        if (p == end)
+            return false;
+
+        switch (*p++)
+        {
+        case '"':  decoded += '"'; break;
+        case '/':  decoded += '/'; break;
+        case '\\': decoded += '\\'; break;
+        case 'b':  decoded += '\b'; break;
+        case 'f':  decoded += '\f'; break;
+        case 'n':  decoded += '\n'; break;
+        case 'r':  decoded += '\r'; break;
+        case 't':  decoded += '\t'; break;
+        case 'u':
+        {
+            unsigned int unicode;
+            if (! readHex4 (p, end, unicode))
+                return false;
+            if (unicode >= 0xD800 && unicode <= 0xDBFF)
+            {
+                unsigned int low;
+                if (end - p < 6 || p[0] != '\\' || p[1] != 'u')
+                    return false;
+                p += 2;
+                if (! readHex4 (p, end, low))
+                    return false;
+                unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (low & 0x3FF);
+            }
+            appendCodePoint (decoded, unicode);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+bool
+FastReader::parse (std::string const& document, Value& root)
+{
+    return parse (document.data (), document.data () + document.size (), root);
+}
+
+bool
+FastReader::parse (char const* begin, char const* end, Value& root)
+{
+    fellBack_ = false;
+    begin_ = begin;
+    if (end - begin < std::numeric_limits<std::uint32_t>::max ())
+    {
+        size_ = static_cast<std::uint32_t> (end - begin);
+        if (index ())
+        {
+            auto const c = at (indexes_[0]);
+            if ((c == '{' || c == '[') && readValue (root) &&
+                    indexes_[next_] == size_)
+                return true;
+        }
+    }
+
+    fellBack_ = true;
+    return reader_.parse (begin, end, root);
+}
+
+bool
+FastReader::index ()
+{
+    if (capacity_ < size_ + 2)
+    {
+        capacity_ = size_ + 2;
+        indexes_.reset (new std::uint32_t[capacity_]);
+    }
+
+    auto out = indexes_.get ();
+    std::uint64_t escapeCarry = 0;
+    std::uint64_t inString = 0;
+    std::uint64_t inScalar = 0;
+    char tail[64];
+    for (std::uint32_t base = 0; base < size_; base += 64)
+    {
+        auto p = begin_ + base;
+        if (size_ - base < 64)
+        {
+            std::memset (tail, ' ', sizeof (tail));
+            std::memcpy (tail, p, size_ - base);
+            p = tail;
+        }
+
+        auto const m = detail::classify (p);
+        auto const quote = m.quote &
+            ~detail::escapedBy (m.backslash, escapeCarry);
+
+        // From each opening quote up to its closing quote
+        auto const string = detail::prefixXor (quote) ^ inString;
+        inString = static_cast<std::uint64_t> (
+            static_cast<std::int64_t> (string) >> 63);
+
+        // Numbers and literals are found by their first character
+        auto const scalar = ~(m.op | m.space | quote | string);
+        auto const starts = scalar & ~((scalar << 1) | inScalar);
+        inScalar = scalar >> 63;
+
+        auto bits = (m.op & ~string) | quote | starts;
+        while (bits != 0)
+        {
+            *out++ = base + detail::trailingZeros (bits);
+            bits &= bits - 1;
+        }
+    }
+
+    // An unterminated string
+    if (inString != 0)
+        return false;
+
+    *out++ = size_;
+    *out++ = size_;
+    next_ = 0;
+    return true;
+}
+
+bool
+FastReader::readValue (Value& value)
+{
+    auto const pos = indexes_[next_++];
+    switch (at (pos))
+    {
+    case '{':
+        return readObject (value);
+
+    case '[':
+        return readArray (value);
+
+    case '"':
+    {
+        auto const first = begin_ + pos + 1;
+        auto const last = begin_ + indexes_[next_++];
+        if (! std::memchr (first, '\\', last - first))
+        {
+            value = Value (first, last);
+            return true;
+        }
+        if (! detail::unescape (first, last, key_))
+            return false;
+        value = key_;
+        return true;
+    }
+
+    case 't':
+        if (! readLiteral (pos, "true", 4))
+            return false;
+        value = true;
+        return true;
+
+    case 'f':
+        if (! readLiteral (pos, "false", 5))
+            return false;
+        value = false;
+        return true;
+
+    case 'n':
+        if (! readLiteral (pos, "null", 4))
+            return false;
+        value = Value ();
+        return true;
+
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return readNumber (pos, value);
+    }
+
+    return false;
+}
+
+bool
+FastReader::readObject (Value& value)
+{
+    value = Value (objectValue);
+    if (at (indexes_[next_]) == '}')
+    {
+        ++next_;
+        return true;
+    }
+
+    for (;;)
+    {
+        auto const pos = indexes_[next_++];
+        if (at (pos) != '"')
+            return false;
+
+        auto const first = begin_ + pos + 1;
+        auto const last = begin_ + indexes_[next_++];
+        if (std::memchr (first, '\\', last - first))
+        {
+            if (! detail::unescape (first, last, key_))
+                return false;
+        }
+        else
+        {
+            key_.assign (first, last);
+        }
+
+        if (at (indexes_[next_++]) != ':')
+            return false;
+
+        // Duplicate names are rejected by Json::Reader
+        auto const size = value.size ();
+        Value& member = value[key_];
+        if (value.size () == size)
+            return false;
+
+        if (! readValue (member))
+            return false;
+
+        auto const c = at (indexes_[next_++]);
+        if (c == '}')
+            return true;
+        if (c != ',')
+            return false;
+    }
+}
+
+bool
+FastReader::readArray (Value& value)
+{
+    value = Value (arrayValue);
+    if (at (indexes_[next_]) == ']')
+    {
+        ++next_;
+        return true;
+    }
+
+    for (Value::UInt index = 0;; ++index)
+    {
+        if (! readValue (value[index]))
+            return false;
+
+        auto const c = at (indexes_[next_++]);
+        if (c == ']')
+            return true;
+        if (c != ',')
+            return false;
+    }
+}
+
+bool
+FastReader::readNumber (std::uint32_t pos, Value& value)
+{
+    auto const start = begin_ + pos;
+    auto const end = begin_ + size_;
+    auto p = start;
+    bool const negative = *p == '-';
+    if (negative)
+        ++p;
+
+    auto const digits = p;
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+    if (*p == '0')
+        ++p;
+    else
+        while (p != end && *p >= '0' && *p <= '9')
+            ++p;
+    auto const integerEnd = p;
+
+    bool integer = true;
+    if (p != end && *p == '.')
+    {
+        integer = false;
+        if (++p == end || *p < '0' || *p > '9')
+            return false;
+        while (p != end && *p >= '0' && *p <= '9')
+            ++p;
+    }
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        integer = false;
+        if (++p != end && (*p == '+' || *p == '-'))
+            ++p;
+        if (p == end || *p < '0' || *p > '9')
+            return false;
+        while (p != end && *p >= '0' && *p <= '9')
+            ++p;
+    }
+    if (p != end && ! detail::isDelimiter (*p))
+        return false;
+
+    if (! integer)
+    {
+        // As Json::Reader converts them, from a terminated copy
+        char copy[32];
+        auto const length = static_cast<std::size_t> (p - start);
+        if (length < sizeof (copy))
+        {
+            std::memcpy (copy, start, length);
+            copy[length] = 0;
+            value = std::strtod (copy, nullptr);
+        }
+        else
+        {
+            value = std::strtod (std::string (start, p).c_str (), nullptr);
+        }
+        return true;
+    }
+
+    // Json::Reader rejects what does not fit in 32 bits
+    if (integerEnd - digits > 10)
+        return false;
+    std::int64_t n = 0;
+    for (auto d = digits; d != integerEnd; ++d)
+        n = n * 10 + (*d - '0');
+
+    if (negative)
+    {
+        n = -n;
+        if (n < Value::minInt)
+            return false;
+        value = static_cast<Value::Int> (n);
+    }
+    else if (n <= Value::maxInt)
+    {
+        value = static_cast<Value::Int> (n);
+    }
+    else if (n <= Value::maxUInt)
+    {
+        value = static_cast<Value::UInt> (n);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool
+FastReader::readLiteral (std::uint32_t pos, char const* literal,
+    std::size_t size)
+{
+    if (size_ - pos < size || std::memcmp (begin_ + pos, literal, size) != 0)
+        return false;
+    return size_ - pos == size || detail::isDelimiter (begin_[pos + size]);
+}
+
+} // Json
@@ -53,7 +53,7 @@ public:
         if ( length == unknown )
             length = (unsigned int)strlen (value);
 
-        char* newString = static_cast<char*> ( malloc ( length + 1 ) );
+        char* newString = static_cast<char*> ( Arena::allocate ( length + 1 ) );
         memcpy ( newString, value, length );
         newString[length] = 0;
         return newString;
@@ -61,8 +61,7 @@ public:
 
     virtual void releaseStringValue ( char* value )
     {
-        if ( value )
-            free ( value );
+        Arena::deallocate ( value );
     }
 };
 
@@ -72,6 +71,22 @@ static ValueAllocator*& valueAllocator ()
     return valueAllocator;
 }
 
+// Makes the members of an array or object in the arena in use, if any.
+template <class Map, class... Args>
+static Map* makeMap ( Args const&... args )
+{
+    void* const p = Arena::allocate ( sizeof ( Map ) );
+    try
+    {
+        return new ( p ) Map ( args... );
+    }
+    catch ( ... )
+    {
+        Arena::deallocate ( p );
+        mtchain::Rethrow ();
+    }
+}
+
 static struct DummyValueAllocatorInitializer
 {
     DummyValueAllocatorInitializer ()
@@ -208,7 +223,7 @@ Value::Value ( ValueType type )
 
     case arrayValue:
     case objectValue:
-        value_.map_ = new ObjectValues ();
+        value_.map_ = makeMap<ObjectValues> ();
         break;
 
     case booleanValue:
@@ -307,7 +322,7 @@ Value::Value ( const Value& other )
 
     case arrayValue:
     case objectValue:
-        value_.map_ = new ObjectValues ( *other.value_.map_ );
+        value_.map_ = makeMap<ObjectValues> ( *other.value_.map_ );
         break;
 
     default:
@@ -335,7 +350,8 @@ Value::~Value ()
 
     case arrayValue:
     case objectValue:
-        delete value_.map_;
+        value_.map_->~ObjectValues ();
+        Arena::deallocate ( value_.map_ );
         break;
 
     default:
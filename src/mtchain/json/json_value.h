@@ -11,6 +11,7 @@
 #ifndef MTCHAIN_JSON_JSON_VALUE_H_INCLUDED
 #define MTCHAIN_JSON_JSON_VALUE_H_INCLUDED
 
+#include <mtchain/json/Arena.h>
 #include <mtchain/json/json_forwards.h>
 #include <cstring>
 #include <functional>
@@ -184,7 +185,8 @@ private:
     };
 
 public:
-    using ObjectValues = std::map<CZString, Value>;
+    using ObjectValues = std::map<CZString, Value, std::less<CZString>,
+        ArenaAllocator<std::pair<CZString const, Value>>>;
 
 public:
     /** \brief Create a default Value of the given type.
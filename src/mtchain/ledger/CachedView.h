@@ -46,6 +46,14 @@ public:
     {
     }
 
+    /** Returns the number of entries read through this view. */
+    std::size_t
+    size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.size();
+    }
+
     //
     // ReadView
     //
@@ -17,7 +17,10 @@
 #include <mtchain/resource/Consumer.h>
 #include <mtchain/protocol/Book.h>
 #include <mtchain/core/Stoppable.h>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace mtchain {
 
@@ -108,6 +111,35 @@ public:
         virtual pointer addRpcSub (std::string const& strUrl, ref rspEntry) = 0;
     };
 
+    /** An event published to many subscribers.
+
+        The event is serialized once, the first time a subscriber asks
+        for its text, and every subscriber then shares that text.
+    */
+    class Event
+    {
+    public:
+        explicit Event (Json::Value const& jvObj);
+
+        Event (Event const&) = delete;
+        Event& operator= (Event const&) = delete;
+
+        Json::Value const&
+        getJson () const
+        {
+            return jvObj_;
+        }
+
+        /** Returns the event as compact JSON. */
+        std::shared_ptr <std::string const> const&
+        getText () const;
+
+    private:
+        Json::Value const& jvObj_;
+        mutable std::once_flag once_;
+        mutable std::shared_ptr <std::string const> text_;
+    };
+
 public:
     InfoSub (Source& source);
     InfoSub (Source& source, Consumer consumer);
@@ -118,6 +150,11 @@ public:
 
     virtual void send (Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send an event that other subscribers are sent too.
+        By default this sends the event's JSON.
+    */
+    virtual void publish (Event const& event);
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
@@ -130,6 +167,13 @@ public:
         AccountID const& account,
         bool rt);
 
+    /** Set whether the transactions of a validated ledger that affect
+        the accounts watched are sent together in one message.
+    */
+    void setLedgerBatch (bool batch);
+
+    bool getLedgerBatch () const;
+
     void clearPathRequest ();
 
     void setPathRequest (const std::shared_ptr<PathRequest>& req);
@@ -148,6 +192,7 @@ private:
     hash_set <AccountID> normalSubscriptions_;
     std::shared_ptr <PathRequest> mPathRequest;
     std::uint64_t                 mSeq;
+    std::atomic <bool>            ledgerBatch_;
 
     static
     int
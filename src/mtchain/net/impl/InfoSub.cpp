@@ -34,9 +34,34 @@ InfoSub::Source::Source (char const* name, Stoppable& parent)
 
 //------------------------------------------------------------------------------
 
+InfoSub::Event::Event (Json::Value const& jvObj)
+    : jvObj_ (jvObj)
+{
+}
+
+std::shared_ptr <std::string const> const&
+InfoSub::Event::getText () const
+{
+    std::call_once (once_,
+        [this]
+        {
+            auto text = std::make_shared <std::string> ();
+            Json::stream (jvObj_,
+                [&text] (void const* data, std::size_t n)
+                {
+                    text->append (static_cast <char const*> (data), n);
+                });
+            text_ = std::move (text);
+        });
+    return text_;
+}
+
+//------------------------------------------------------------------------------
+
 InfoSub::InfoSub(Source& source)
     : m_source(source)
     , mSeq(assign_id())
+    , ledgerBatch_(false)
 {
 }
 
@@ -44,6 +69,7 @@ InfoSub::InfoSub(Source& source, Consumer consumer)
     : m_consumer(consumer)
     , m_source(source)
     , mSeq(assign_id())
+    , ledgerBatch_(false)
 {
 }
 
@@ -73,6 +99,11 @@ Resource::Consumer& InfoSub::getConsumer()
     return m_consumer;
 }
 
+void InfoSub::publish (Event const& event)
+{
+    send (event.getJson (), true);
+}
+
 std::uint64_t InfoSub::getSeq ()
 {
     return mSeq;
@@ -102,6 +133,16 @@ void InfoSub::deleteSubAccountInfo (AccountID const& account, bool rt)
         normalSubscriptions_.erase (account);
 }
 
+void InfoSub::setLedgerBatch (bool batch)
+{
+    ledgerBatch_ = batch;
+}
+
+bool InfoSub::getLedgerBatch () const
+{
+    return ledgerBatch_;
+}
+
 void InfoSub::clearPathRequest ()
 {
     mPathRequest.reset ();
@@ -1444,6 +1444,7 @@ public:
             {   "print",                &RPCParser::parseAsIs,                  0,  1   },
     //      {   "profile",              &RPCParser::parseProfile,               1,  9   },
             {   "random",               &RPCParser::parseAsIs,                  0,  0   },
+            {   "rpc_stats",            &RPCParser::parseAsIs,                  0,  0   },
             {   "mtchain_path_find",    &RPCParser::parseMTChainPathFind,       1,  2   },
             {   "sign",                 &RPCParser::parseSignSubmit,            2,  3   },
             {   "sign_for",             &RPCParser::parseSignFor,               3,  4   },
@@ -1452,6 +1453,7 @@ public:
             {   "server_info",          &RPCParser::parseAsIs,                  0,  0   },
             {   "server_state",         &RPCParser::parseAsIs,                  0,  0   },
             {   "stop",                 &RPCParser::parseAsIs,                  0,  0   },
+            {   "traffic_histograms",   &RPCParser::parseFetchInfo,             0,  1   },
     //      {   "transaction_entry",    &RPCParser::parseTransactionEntry,     -1,  -1  },
             {   "tx",                   &RPCParser::parseTx,                    1,  2   },
             {   "sc",                   &RPCParser::parseSc,                    1,  4   },
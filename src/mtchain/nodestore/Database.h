@@ -13,6 +13,7 @@
 
 #include <mtchain/nodestore/NodeObject.h>
 #include <mtchain/nodestore/Backend.h>
+#include <mtchain/nodestore/Import.h>
 #include <mtchain/basics/TaggedCache.h>
 
 namespace mtchain {
@@ -110,7 +111,15 @@ public:
     virtual void for_each(std::function <void(std::shared_ptr<NodeObject>)> f) = 0;
 
     /** Import objects from another database. */
-    virtual void import (Database& source) = 0;
+    void import (Database& source)
+    {
+        import (source, ImportOptions {});
+    }
+
+    /** Import objects from another database.
+        @see importObjects
+    */
+    virtual void import (Database& source, ImportOptions const& options) = 0;
 
     /** Retrieve the estimated number of pending write operations.
         This is used for diagnostics.
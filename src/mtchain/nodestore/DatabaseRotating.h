@@ -39,6 +39,17 @@ public:
 
     /** Ensure that node is in writableBackend */
     virtual std::shared_ptr<NodeObject> fetchNode (uint256 const& hash) = 0;
+
+    /** Ensure that node is in writableBackend, without reading it back.
+
+        Nodes stored or copied since the last rotation are remembered and
+        skipped. Otherwise the node is copied from the archive backend if
+        it is there.
+
+        @note This may be called concurrently.
+        @return `true` if the node was copied.
+    */
+    virtual bool copyToWritable (uint256 const& hash) = 0;
 };
 
 }
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_NODESTORE_IMPORT_H_INCLUDED
+#define MTCHAIN_NODESTORE_IMPORT_H_INCLUDED
+
+#include <mtchain/nodestore/Backend.h>
+#include <mtchain/basics/BasicConfig.h>
+#include <mtchain/beast/utility/Journal.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace mtchain {
+namespace NodeStore {
+
+class Database;
+
+/** Tuning for copying one node database into another. */
+struct ImportOptions
+{
+    // Threads writing to the destination backend
+    int threads = 4;
+
+    // Objects handed to a writer at once
+    std::size_t batchSize = 1024;
+
+    // Batches read ahead of the writers
+    std::size_t queueDepth = 16;
+
+    // Most payload bytes written per second, zero for no limit
+    std::uint64_t bytesPerSecond = 0;
+
+    // File recording how far the import got, empty for none
+    std::string checkpoint;
+
+    // How often progress is logged and the checkpoint saved
+    std::chrono::seconds reportInterval {10};
+};
+
+/** Totals from an import. */
+struct ImportResult
+{
+    // Objects written to the destination
+    std::uint64_t objects = 0;
+
+    // Payload bytes written to the destination
+    std::uint64_t bytes = 0;
+
+    // Objects skipped because a checkpoint showed them already imported
+    std::uint64_t skipped = 0;
+};
+
+/** Read the import options from the [import_db] section.
+
+    Recognized keys, besides those of the backend itself:
+        import_threads, import_batch, import_queue,
+        import_mb_per_sec, import_checkpoint, import_report_seconds
+*/
+ImportOptions
+setup_ImportOptions (Section const& section);
+
+/** Copy every object in `source` into `dest`.
+
+    One thread visits the source, since @ref Backend::for_each may not run
+    concurrently, and hands batches to `options.threads` writers through a
+    bounded queue. Each object is re-encoded by the destination backend as
+    it is stored, so the copy uses the current compression.
+
+    With a checkpoint file, the number of source objects known to be
+    written is saved periodically. A later import from the same source
+    skips that many objects, which works because a backend visits an
+    unchanged database in the same order each time.
+
+    @note Backends may not run storeBatch concurrently but allow
+          concurrent calls to store. A lone writer stores each batch
+          with one call to storeBatch, while several writers store
+          objects individually so that they encode and write in parallel.
+*/
+ImportResult
+importObjects (Database& source, Backend& dest,
+    ImportOptions const& options, beast::Journal journal);
+
+}
+}
+
+#endif
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_NODESTORE_SNAPSHOTWRITER_H_INCLUDED
+#define MTCHAIN_NODESTORE_SNAPSHOTWRITER_H_INCLUDED
+
+#include <mtchain/nodestore/NodeObject.h>
+#include <nudb/native_file.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mtchain {
+namespace NodeStore {
+
+/** Builds a read-only snapshot file for the Snapshot backend.
+
+    Objects may be inserted concurrently from any number of threads; the
+    expensive encoding and compression happens outside the lock. Values
+    are appended to the file as they arrive while the key index is kept
+    in memory and written, sorted, by @ref finish.
+
+    Duplicate keys are allowed and collapse to a single index entry.
+
+    @see SnapshotFormat.h
+*/
+class SnapshotWriter
+{
+public:
+    /** Create the snapshot in the directory `path`.
+        An existing snapshot in that directory is an error.
+    */
+    explicit
+    SnapshotWriter (std::string const& path);
+
+    /** Destroy the writer.
+        If @ref finish was not called the incomplete file is removed.
+    */
+    ~SnapshotWriter ();
+
+    SnapshotWriter (SnapshotWriter const&) = delete;
+    SnapshotWriter& operator= (SnapshotWriter const&) = delete;
+
+    /** Add an object to the snapshot.
+        @note This may be called concurrently.
+    */
+    void
+    insert (std::shared_ptr<NodeObject> const& object);
+
+    /** Write the index and footer and close the file.
+        @return The number of distinct objects in the snapshot.
+    */
+    std::uint64_t
+    finish ();
+
+    /** Number of objects inserted so far, including duplicates. */
+    std::uint64_t
+    inserted () const
+    {
+        return inserted_;
+    }
+
+    /** Number of value bytes written so far. */
+    std::uint64_t
+    bytes () const
+    {
+        return bytes_;
+    }
+
+private:
+    struct Entry
+    {
+        uint256 key;
+        std::uint64_t offset;
+        std::uint32_t size;
+    };
+
+    void
+    flush ();
+
+    std::string path_;
+    std::mutex mutex_;
+    nudb::native_file file_;
+    std::vector<std::uint8_t> buffer_;
+    std::uint64_t flushed_ = 0;
+    std::vector<Entry> index_;
+    std::atomic<std::uint64_t> inserted_ {0};
+    std::atomic<std::uint64_t> bytes_ {0};
+    bool finished_ = false;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,350 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+
+#include <mtchain/basics/contract.h>
+#include <mtchain/basics/Log.h>
+#include <mtchain/nodestore/Factory.h>
+#include <mtchain/nodestore/Manager.h>
+#include <mtchain/nodestore/impl/codec.h>
+#include <mtchain/nodestore/impl/DecodedBlob.h>
+#include <mtchain/nodestore/impl/SnapshotFormat.h>
+#include <nudb/detail/buffer.hpp>
+#include <nudb/detail/field.hpp>
+#include <nudb/detail/stream.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+namespace mtchain {
+namespace NodeStore {
+
+/** Read-only backend serving a frozen snapshot through a memory mapping.
+
+    Lookups never take a lock or touch a write path: the two leading key
+    bytes select a range of the sorted index, which is binary searched in
+    place. Uncompressed values are copied straight out of the mapping into
+    the NodeObject without an intermediate buffer.
+
+    Snapshots are produced by SnapshotWriter.
+*/
+class SnapshotBackend
+    : public Backend
+{
+public:
+    beast::Journal journal_;
+    std::size_t const keyBytes_;
+    std::string const name_;
+    std::string file_name_;
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    std::uint8_t const* base_;
+    std::uint8_t const* index_;
+    std::uint64_t count_;
+    std::vector<std::uint64_t> prefix_;
+    std::atomic <bool> deletePath_;
+
+    SnapshotBackend (size_t keyBytes, Section const& keyValues,
+            beast::Journal journal)
+        : journal_ (journal)
+        , keyBytes_ (keyBytes)
+        , name_ (get<std::string>(keyValues, "path"))
+        , base_ (nullptr)
+        , index_ (nullptr)
+        , count_ (0)
+        , deletePath_ (false)
+    {
+        if (name_.empty())
+            Throw<std::runtime_error> (
+                "nodestore: Missing path in Snapshot backend");
+
+        auto const path =
+            boost::filesystem::path (name_) / snapshotFileName();
+        if (! boost::filesystem::exists (path))
+            Throw<std::runtime_error> (
+                "nodestore: Missing snapshot file " + path.string());
+        file_name_ = path.string();
+
+        using namespace boost::interprocess;
+        file_ = file_mapping (file_name_.c_str(), read_only);
+        region_ = mapped_region (file_, read_only);
+        // Lookups land on unrelated pages, read-ahead only wastes cache
+        region_.advise (mapped_region::advice_random);
+        base_ = static_cast<std::uint8_t const*>(region_.get_address());
+        open (region_.get_size());
+    }
+
+    ~SnapshotBackend ()
+    {
+        close();
+    }
+
+    std::string
+    getName() override
+    {
+        return name_;
+    }
+
+    void
+    close() override
+    {
+        if (base_ != nullptr)
+        {
+            base_ = nullptr;
+            index_ = nullptr;
+            region_ = boost::interprocess::mapped_region ();
+            file_ = boost::interprocess::file_mapping ();
+            if (deletePath_)
+                boost::filesystem::remove_all (name_);
+        }
+    }
+
+    Status
+    fetch (void const* key, std::shared_ptr<NodeObject>* pno) override
+    {
+        pno->reset();
+        std::uint64_t offset;
+        std::uint32_t size;
+        if (! find (key, offset, size))
+            return notFound;
+        return decode (key, base_ + offset, size, pno);
+    }
+
+    bool
+    canFetchBatch() override
+    {
+        return false;
+    }
+
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch (std::size_t n, void const* const* keys) override
+    {
+        Throw<std::runtime_error> ("pure virtual called");
+        return {};
+    }
+
+    void
+    store (std::shared_ptr <NodeObject> const& no) override
+    {
+        Throw<std::runtime_error> (
+            "nodestore: Snapshot backend is read-only");
+    }
+
+    void
+    storeBatch (Batch const& batch) override
+    {
+        Throw<std::runtime_error> (
+            "nodestore: Snapshot backend is read-only");
+    }
+
+    void
+    for_each (std::function <void(std::shared_ptr<NodeObject>)> f) override
+    {
+        for (std::uint64_t i = 0; i < count_; ++i)
+        {
+            std::uint8_t const* key;
+            std::uint64_t offset;
+            std::uint32_t size;
+            entry (i, key, offset, size);
+            std::shared_ptr<NodeObject> no;
+            if (decode (key, base_ + offset, size, &no) != ok)
+                Throw<std::runtime_error> (
+                    "nodestore: corrupt snapshot value");
+            f (std::move (no));
+        }
+    }
+
+    int
+    getWriteLoad () override
+    {
+        return 0;
+    }
+
+    void
+    setDeletePath() override
+    {
+        deletePath_ = true;
+    }
+
+    void
+    verify() override
+    {
+        for (std::uint64_t i = 1; i < count_; ++i)
+        {
+            if (std::memcmp (key (i - 1), key (i), keyBytes_) >= 0)
+                Throw<std::runtime_error> (
+                    "nodestore: snapshot index out of order");
+        }
+        for_each ([](std::shared_ptr<NodeObject>) {});
+    }
+
+    /** Returns the number of file handles the backend expects to need */
+    int
+    fdlimit() const override
+    {
+        return 1;
+    }
+
+private:
+    void
+    open (std::size_t fileSize)
+    {
+        using namespace nudb::detail;
+
+        if (fileSize < snapshotFooterBytes)
+            Throw<std::runtime_error> (
+                "nodestore: short snapshot file");
+
+        istream is (base_ + fileSize - snapshotFooterBytes,
+            snapshotFooterBytes);
+        if (std::memcmp (is (8), snapshotMagic(), 8) != 0)
+            Throw<std::runtime_error> (
+                "nodestore: bad snapshot magic");
+        std::uint16_t version;
+        std::uint16_t keyBytes;
+        std::uint64_t indexOffset;
+        std::uint64_t prefixOffset;
+        read<std::uint16_t> (is, version);
+        read<std::uint16_t> (is, keyBytes);
+        read<std::uint64_t> (is, count_);
+        read<std::uint64_t> (is, indexOffset);
+        read<std::uint64_t> (is, prefixOffset);
+        if (version != snapshotVersion)
+            Throw<std::runtime_error> (
+                "nodestore: unknown snapshot version");
+        if (keyBytes != keyBytes_)
+            Throw<std::runtime_error> (
+                "nodestore: snapshot key size mismatch");
+
+        auto const prefixBytes =
+            snapshotPrefixEntries * field<std::uint64_t>::size;
+        if (indexOffset + count_ * entryBytes() != prefixOffset ||
+            prefixOffset + prefixBytes + snapshotFooterBytes != fileSize)
+            Throw<std::runtime_error> (
+                "nodestore: inconsistent snapshot layout");
+
+        index_ = base_ + indexOffset;
+
+        // The prefix table is small, decode it once
+        prefix_.resize (snapshotPrefixEntries);
+        istream ps (base_ + prefixOffset, prefixBytes);
+        for (auto& v : prefix_)
+            read<std::uint64_t> (ps, v);
+        if (prefix_.back() != count_)
+            Throw<std::runtime_error> (
+                "nodestore: inconsistent snapshot prefix table");
+
+        JLOG(journal_.info()) <<
+            "Snapshot " << file_name_ << ": " << count_ << " objects";
+    }
+
+    std::size_t
+    entryBytes () const
+    {
+        return keyBytes_ + snapshotEntryExtraBytes;
+    }
+
+    std::uint8_t const*
+    key (std::uint64_t i) const
+    {
+        return index_ + i * entryBytes();
+    }
+
+    void
+    entry (std::uint64_t i, std::uint8_t const*& k,
+        std::uint64_t& offset, std::uint32_t& size) const
+    {
+        k = key (i);
+        nudb::detail::readp<std::uint64_t> (k + keyBytes_, offset);
+        nudb::detail::readp<std::uint32_t> (k + keyBytes_ + 8, size);
+    }
+
+    bool
+    find (void const* k, std::uint64_t& offset, std::uint32_t& size) const
+    {
+        if (index_ == nullptr)
+            return false;
+        auto const p = snapshotPrefix (k);
+        auto lo = prefix_[p];
+        auto hi = prefix_[p + 1];
+        while (lo < hi)
+        {
+            auto const mid = lo + (hi - lo) / 2;
+            auto const c = std::memcmp (key (mid), k, keyBytes_);
+            if (c == 0)
+            {
+                std::uint8_t const* unused;
+                entry (mid, unused, offset, size);
+                return true;
+            }
+            if (c < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return false;
+    }
+
+    Status
+    decode (void const* key, void const* data, std::size_t size,
+        std::shared_ptr<NodeObject>* pno) const
+    {
+        nudb::detail::buffer bf;
+        auto const result = nodeobject_decompress (data, size, bf);
+        DecodedBlob decoded (key, result.first, result.second);
+        if (! decoded.wasOk ())
+            return dataCorrupt;
+        *pno = decoded.createObject();
+        return ok;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+class SnapshotFactory : public Factory
+{
+public:
+    SnapshotFactory()
+    {
+        Manager::instance().insert(*this);
+    }
+
+    ~SnapshotFactory()
+    {
+        Manager::instance().erase(*this);
+    }
+
+    std::string
+    getName() const
+    {
+        return "Snapshot";
+    }
+
+    std::unique_ptr <Backend>
+    createInstance (
+        size_t keyBytes,
+        Section const& keyValues,
+        Scheduler&,
+        beast::Journal journal)
+    {
+        return std::make_unique <SnapshotBackend> (
+            keyBytes, keyValues, journal);
+    }
+};
+
+static SnapshotFactory snapshotFactory;
+
+}
+}
@@ -13,8 +13,8 @@
 
 #include <mtchain/nodestore/Database.h>
 #include <mtchain/nodestore/Scheduler.h>
+#include <mtchain/nodestore/impl/NegativeCache.h>
 #include <mtchain/nodestore/impl/Tuning.h>
-#include <mtchain/basics/KeyCache.h>
 #include <mtchain/basics/Log.h>
 #include <mtchain/basics/chrono.h>
 #include <mtchain/protocol/digest.h>
@@ -42,7 +42,7 @@ protected:
     TaggedCache <uint256, NodeObject> m_cache;
 
     // Negative cache
-    KeyCache <uint256> m_negCache;
+    NegativeCache m_negCache;
 private:
     std::mutex                m_readLock;
     std::condition_variable   m_readCondVar;
@@ -65,8 +65,7 @@ public:
         , m_backend (std::move (backend))
         , m_cache ("NodeStore", cacheTargetSize, cacheTargetSeconds,
             stopwatch(), journal)
-        , m_negCache ("NodeStore", stopwatch(),
-            cacheTargetSize, cacheTargetSeconds)
+        , m_negCache (stopwatch(), cacheTargetSize, cacheTargetSeconds)
         , m_readShut (false)
         , m_readGen (0)
         , fdlimit_ (0)
@@ -216,6 +215,9 @@ public:
         }
         else
         {
+            // The negative cache may have sent us here to verify a hit
+            m_negCache.erase (hash);
+
             // Ensure all threads get the same object
             //
             m_cache.canonicalize (hash, obj);
@@ -374,33 +376,19 @@ public:
         m_backend->for_each (f);
     }
 
-    void import (Database& source) override
+    using Database::import;
+
+    void import (Database& source, ImportOptions const& options) override
     {
-        importInternal (source, *m_backend.get());
+        importInternal (source, *m_backend.get(), options);
     }
 
-    void importInternal (Database& source, Backend& dest)
+    void importInternal (Database& source, Backend& dest,
+        ImportOptions const& options)
     {
-        Batch b;
-        b.reserve (batchWritePreallocationSize);
-
-        source.for_each ([&](std::shared_ptr<NodeObject> object)
-        {
-            if (b.size() >= batchWritePreallocationSize)
-            {
-                dest.storeBatch (b);
-                b.clear();
-                b.reserve (batchWritePreallocationSize);
-            }
-
-            b.push_back (object);
-            ++m_storeCount;
-            if (object)
-                m_storeSize += object->getData().size();
-        });
-
-        if (! b.empty())
-            dest.storeBatch (b);
+        auto const result = importObjects (source, dest, options, m_journal);
+        m_storeCount += result.objects;
+        m_storeSize += result.bytes;
     }
 
     std::uint32_t getStoreCount () const override
@@ -21,10 +21,48 @@ std::shared_ptr <Backend> DatabaseRotatingImp::rotateBackends (
     std::shared_ptr <Backend> oldBackend = archiveBackend_;
     archiveBackend_ = writableBackend_;
     writableBackend_ = newBackend;
+    {
+        std::lock_guard <std::mutex> lock (writtenMutex_);
+        written_.clear();
+        writtenFor_ = newBackend.get();
+    }
 
     return oldBackend;
 }
 
+void DatabaseRotatingImp::markWritten (
+    uint256 const& hash, Backend const* backend)
+{
+    std::lock_guard <std::mutex> lock (writtenMutex_);
+    // A write which raced a rotation went to the old backend
+    if (backend == writtenFor_ && written_.size() < rotatingWrittenLimit)
+        written_.insert (hash);
+}
+
+bool DatabaseRotatingImp::copyToWritable (uint256 const& hash)
+{
+    std::shared_ptr <Backend> writableBackend;
+    std::shared_ptr <Backend> archiveBackend;
+    {
+        std::lock_guard <std::mutex> lock (rotateMutex_);
+        writableBackend = writableBackend_;
+        archiveBackend = archiveBackend_;
+    }
+
+    {
+        std::lock_guard <std::mutex> lock (writtenMutex_);
+        if (writtenFor_ == writableBackend.get() && written_.count (hash))
+            return false;
+    }
+
+    // A node missing from the archive is already writable, or nowhere
+    auto const object = fetchInternal (*archiveBackend, hash);
+    if (object)
+        writableBackend->store (object);
+    markWritten (hash, writableBackend.get());
+    return object != nullptr;
+}
+
 std::shared_ptr<NodeObject> DatabaseRotatingImp::fetchFrom (uint256 const& hash)
 {
     Backends b = getBackends();
@@ -34,7 +72,9 @@ std::shared_ptr<NodeObject> DatabaseRotatingImp::fetchFrom (uint256 const& hash)
         object = fetchInternal (*b.archiveBackend, hash);
         if (object)
         {
-            getWritableBackend()->store (object);
+            auto const backend = writable();
+            backend->store (object);
+            markWritten (hash, backend.get());
             m_negCache.erase (hash);
         }
     }
@@ -13,6 +13,7 @@
 
 #include <mtchain/nodestore/impl/DatabaseImp.h>
 #include <mtchain/nodestore/DatabaseRotating.h>
+#include <mtchain/basics/UnorderedContainers.h>
 
 namespace mtchain {
 namespace NodeStore {
@@ -26,6 +27,12 @@ private:
     std::shared_ptr <Backend> archiveBackend_;
     mutable std::mutex rotateMutex_;
 
+    // Keys known to be in the writable backend, so a rotation
+    // need not copy them again. Cleared by each rotation.
+    std::mutex writtenMutex_;
+    hash_set <uint256> written_;
+    Backend const* writtenFor_;
+
     struct Backends {
         std::shared_ptr <Backend> const& writableBackend;
         std::shared_ptr <Backend> const& archiveBackend;
@@ -37,6 +44,14 @@ private:
         return Backends {writableBackend_, archiveBackend_};
     }
 
+    std::shared_ptr <Backend> writable() const
+    {
+        std::lock_guard <std::mutex> lock (rotateMutex_);
+        return writableBackend_;
+    }
+
+    void markWritten (uint256 const& hash, Backend const* backend);
+
 public:
     DatabaseRotatingImp (std::string const& name,
                  Scheduler& scheduler,
@@ -52,6 +67,7 @@ public:
                 journal)
             , writableBackend_ (writableBackend)
             , archiveBackend_ (archiveBackend)
+            , writtenFor_ (writableBackend_.get())
     {}
 
     std::shared_ptr <Backend> const& getWritableBackend() const override
@@ -97,17 +113,20 @@ public:
         b.writableBackend->for_each (f);
     }
 
-    void import (Database& source) override
+    using Database::import;
+
+    void import (Database& source, ImportOptions const& options) override
     {
-        importInternal (source, *getWritableBackend());
+        importInternal (source, *writable(), options);
     }
 
     void store (NodeObjectType type,
                 Blob&& data,
                 uint256 const& hash) override
     {
-        storeInternal (type, std::move(data), hash,
-                *getWritableBackend());
+        auto const backend = writable();
+        storeInternal (type, std::move(data), hash, *backend);
+        markWritten (hash, backend.get());
     }
 
     std::shared_ptr<NodeObject> fetchNode (uint256 const& hash) override
@@ -115,6 +134,8 @@ public:
         return fetchFrom (hash);
     }
 
+    bool copyToWritable (uint256 const& hash) override;
+
     std::shared_ptr<NodeObject> fetchFrom (uint256 const& hash) override;
     TaggedCache <uint256, NodeObject>& getPositiveCache() override
     {
@@ -0,0 +1,364 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/nodestore/Import.h>
+#include <mtchain/nodestore/Database.h>
+#include <mtchain/basics/Log.h>
+#include <mtchain/beast/core/CurrentThreadName.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mtchain {
+namespace NodeStore {
+
+namespace {
+
+// Remembers how many source objects are known to be written
+class ImportCheckpoint
+{
+private:
+    std::string path_;
+    std::string source_;
+
+public:
+    ImportCheckpoint (std::string const& path, std::string const& source)
+        : path_ (path)
+        , source_ (source)
+    {
+    }
+
+    // Returns the saved position, or zero
+    std::uint64_t
+    load (beast::Journal journal) const
+    {
+        if (path_.empty() || ! boost::filesystem::exists (path_))
+            return 0;
+
+        std::ifstream in (path_);
+        std::string source;
+        std::uint64_t position = 0;
+        if (! std::getline (in, source) || ! (in >> position))
+        {
+            JLOG(journal.warn()) <<
+                "Import checkpoint " << path_ << " is unreadable";
+            return 0;
+        }
+        if (source != source_)
+        {
+            JLOG(journal.warn()) << "Import checkpoint " << path_ <<
+                " is for '" << source << "', not '" << source_ << "'";
+            return 0;
+        }
+        return position;
+    }
+
+    void
+    save (std::uint64_t position) const
+    {
+        if (path_.empty())
+            return;
+
+        // Replace the file atomically so a crash leaves a valid checkpoint
+        auto const temp = path_ + ".tmp";
+        {
+            std::ofstream out (temp, std::ios::trunc);
+            out << source_ << '\n' << position << '\n';
+        }
+        boost::system::error_code ec;
+        boost::filesystem::rename (temp, path_, ec);
+    }
+
+    void
+    remove () const
+    {
+        if (path_.empty())
+            return;
+        boost::system::error_code ec;
+        boost::filesystem::remove (path_, ec);
+    }
+};
+
+// Paces writers so that together they stay under a byte rate
+class ImportThrottle
+{
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    std::mutex mutex_;
+    std::uint64_t const bytesPerSecond_;
+    clock_type::time_point next_;
+
+public:
+    explicit
+    ImportThrottle (std::uint64_t bytesPerSecond)
+        : bytesPerSecond_ (bytesPerSecond)
+    {
+    }
+
+    void
+    wait (std::size_t bytes)
+    {
+        if (! bytesPerSecond_)
+            return;
+
+        clock_type::time_point start;
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            start = std::max (clock_type::now(), next_);
+            next_ = start + std::chrono::duration_cast <clock_type::duration> (
+                std::chrono::duration <double> (
+                    static_cast <double> (bytes) / bytesPerSecond_));
+        }
+        std::this_thread::sleep_until (start);
+    }
+};
+
+}
+
+ImportOptions
+setup_ImportOptions (Section const& section)
+{
+    ImportOptions options;
+
+    get_if_exists (section, "import_threads", options.threads);
+    get_if_exists (section, "import_batch", options.batchSize);
+    get_if_exists (section, "import_queue", options.queueDepth);
+    get_if_exists (section, "import_checkpoint", options.checkpoint);
+
+    std::uint64_t mb = 0;
+    if (get_if_exists (section, "import_mb_per_sec", mb))
+        options.bytesPerSecond = mb * 1024 * 1024;
+
+    int seconds = 0;
+    if (get_if_exists (section, "import_report_seconds", seconds) &&
+            seconds > 0)
+        options.reportInterval = std::chrono::seconds (seconds);
+
+    options.threads = std::max (1, options.threads);
+    options.batchSize = std::max <std::size_t> (1, options.batchSize);
+    options.queueDepth = std::max <std::size_t> (1, options.queueDepth);
+    return options;
+}
+
+ImportResult
+importObjects (Database& source, Backend& dest,
+    ImportOptions const& options, beast::Journal journal)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    auto const threads = std::max (1, options.threads);
+    auto const batchSize = std::max <std::size_t> (1, options.batchSize);
+    auto const queueDepth = std::max <std::size_t> (1, options.queueDepth);
+
+    ImportCheckpoint const checkpoint (options.checkpoint, source.getName());
+    auto const resume = checkpoint.load (journal);
+    if (resume)
+    {
+        JLOG(journal.info()) <<
+            "Import resuming after " << resume << " objects";
+    }
+
+    struct Work
+    {
+        Batch batch;
+        std::uint64_t id;
+        // Source position following the last object in the batch
+        std::uint64_t end;
+    };
+
+    std::mutex mutex;
+    std::condition_variable readable;
+    std::condition_variable writable;
+    std::deque <Work> queue;
+    bool done = false;
+    std::atomic <bool> failed {false};
+    std::exception_ptr error;
+
+    // Batches finish out of order, so the checkpoint only advances
+    // past those whose predecessors have all been written.
+    std::map <std::uint64_t, std::uint64_t> finished;
+    std::uint64_t nextId = 0;
+    std::uint64_t position = resume;
+
+    std::atomic <std::uint64_t> objects {0};
+    std::atomic <std::uint64_t> bytes {0};
+    ImportThrottle throttle (options.bytesPerSecond);
+
+    auto const writer = [&]
+    {
+        beast::setCurrentThreadName ("import");
+        for (;;)
+        {
+            Work work;
+            {
+                std::unique_lock <std::mutex> lock (mutex);
+                readable.wait (lock, [&]
+                {
+                    return ! queue.empty() || done || failed;
+                });
+                if (failed || queue.empty())
+                    return;
+                work = std::move (queue.front());
+                queue.pop_front();
+            }
+            writable.notify_one();
+
+            try
+            {
+                std::size_t size = 0;
+                for (auto const& object : work.batch)
+                    size += object->getData().size();
+                throttle.wait (size);
+
+                // Backends forbid concurrent calls to storeBatch, but
+                // each store may run alongside the others.
+                if (threads == 1)
+                {
+                    dest.storeBatch (work.batch);
+                }
+                else
+                {
+                    for (auto const& object : work.batch)
+                        dest.store (object);
+                }
+                objects += work.batch.size();
+                bytes += size;
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard <std::mutex> lock (mutex);
+                    if (! error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+                readable.notify_all();
+                writable.notify_all();
+                return;
+            }
+
+            std::lock_guard <std::mutex> lock (mutex);
+            finished.emplace (work.id, work.end);
+            for (auto iter = finished.begin(); iter != finished.end() &&
+                iter->first == nextId; iter = finished.erase (iter))
+            {
+                position = iter->second;
+                ++nextId;
+            }
+        }
+    };
+
+    std::vector <std::thread> workers;
+    workers.reserve (threads);
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back (writer);
+
+    auto const start = clock_type::now();
+    auto nextReport = start + options.reportInterval;
+
+    auto const report = [&]
+    {
+        std::uint64_t saved;
+        std::size_t queued;
+        {
+            std::lock_guard <std::mutex> lock (mutex);
+            saved = position;
+            queued = queue.size();
+        }
+        checkpoint.save (saved);
+
+        auto const elapsed = std::chrono::duration <double> (
+            clock_type::now() - start).count();
+        JLOG(journal.info()) << "Import: " << objects << " objects, " <<
+            (bytes / (1024 * 1024)) << " MB, " <<
+            static_cast <std::uint64_t> (objects / std::max (elapsed, 1.0)) <<
+            " objects/s, " << queued << " batches queued";
+    };
+
+    std::uint64_t seen = 0;
+    std::uint64_t id = 0;
+    Batch batch;
+    batch.reserve (batchSize);
+
+    auto const push = [&]
+    {
+        {
+            std::unique_lock <std::mutex> lock (mutex);
+            writable.wait (lock, [&]
+            {
+                return queue.size() < queueDepth || failed;
+            });
+            if (! failed)
+                queue.push_back (Work {std::move (batch), id++, seen});
+        }
+        readable.notify_one();
+        batch = Batch();
+        batch.reserve (batchSize);
+
+        if (clock_type::now() >= nextReport)
+        {
+            report();
+            nextReport = clock_type::now() + options.reportInterval;
+        }
+    };
+
+    // The visit cannot be interrupted, so after a failure the
+    // remaining objects are passed over.
+    source.for_each ([&](std::shared_ptr<NodeObject> object)
+    {
+        if (failed || ! object)
+            return;
+        if (seen++ < resume)
+            return;
+        batch.push_back (std::move (object));
+        if (batch.size() >= batchSize)
+            push();
+    });
+    if (! batch.empty())
+        push();
+
+    {
+        std::lock_guard <std::mutex> lock (mutex);
+        done = true;
+    }
+    readable.notify_all();
+    for (auto& t : workers)
+        t.join();
+
+    if (error)
+    {
+        checkpoint.save (position);
+        std::rethrow_exception (error);
+    }
+    checkpoint.remove();
+
+    ImportResult result;
+    result.objects = objects;
+    result.bytes = bytes;
+    result.skipped = std::min (resume, seen);
+
+    JLOG(journal.info()) << "Import complete: " << result.objects <<
+        " objects, " << result.bytes << " bytes, " << result.skipped <<
+        " skipped";
+    return result;
+}
+
+}
+}
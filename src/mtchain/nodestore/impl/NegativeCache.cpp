@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/nodestore/impl/NegativeCache.h>
+#include <mtchain/basics/random.h>
+#include <algorithm>
+#include <cstring>
+
+namespace mtchain {
+namespace NodeStore {
+
+std::size_t const NegativeCache::ways;
+
+namespace {
+
+// Slots hold the fingerprint above a 16-bit timestamp
+int const stampBits = 16;
+std::uint64_t const stampMask = (1 << stampBits) - 1;
+
+// Ages beyond this are ambiguous once the timestamp wraps
+int const maximumAge = stampMask / 2;
+
+std::uint64_t
+mix (std::uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}
+
+NegativeCache::Table::Table (std::size_t buckets)
+    : storage (new std::atomic <std::uint64_t>[buckets * ways + ways]())
+    , mask (buckets - 1)
+{
+    // A bucket fills one cache line
+    auto const lineBytes = ways * sizeof (std::uint64_t);
+    auto const address = reinterpret_cast <std::uintptr_t> (storage.get());
+    auto const pad = (lineBytes - address % lineBytes) % lineBytes;
+    slots = storage.get() + pad / sizeof (std::uint64_t);
+}
+
+NegativeCache::NegativeCache (clock_type& clock, std::size_t size, int age,
+        std::uint32_t verify)
+    : clock_ (clock)
+    , seed0_ (rand_int <std::uint64_t> ())
+    , seed1_ (rand_int <std::uint64_t> ())
+    , verify_ (verify)
+    , age_ (std::max (1, std::min (age, maximumAge)))
+    , table_ (nullptr)
+{
+    setTargetSize (size);
+}
+
+NegativeCache::Hashed
+NegativeCache::hash (uint256 const& key, Table const& table) const
+{
+    std::uint64_t w[4];
+    std::memcpy (w, key.data(), sizeof (w));
+
+    Hashed result;
+    result.bucket = mix (w[0] ^ seed0_) & table.mask;
+    result.fingerprint = mix (w[1] ^ w[2] ^ w[3] ^ seed1_) >> stampBits;
+    if (result.fingerprint == 0)
+        result.fingerprint = 1;
+    return result;
+}
+
+std::uint64_t
+NegativeCache::stamp () const
+{
+    using namespace std::chrono;
+    return duration_cast <seconds> (
+        clock_.now().time_since_epoch()).count() & stampMask;
+}
+
+bool
+NegativeCache::expired (std::uint64_t slot, std::uint64_t now) const
+{
+    if (slot == 0)
+        return true;
+    auto const age = (now - (slot & stampMask)) & stampMask;
+    return age >= static_cast <std::uint64_t> (
+        age_.load (std::memory_order_relaxed));
+}
+
+bool
+NegativeCache::touch_if_exists (uint256 const& key)
+{
+    auto const table = table_.load (std::memory_order_acquire);
+    auto const h = hash (key, *table);
+    auto const now = stamp ();
+    auto const bucket = table->slots + h.bucket * ways;
+
+    for (std::size_t i = 0; i < ways; ++i)
+    {
+        auto slot = bucket[i].load (std::memory_order_relaxed);
+        if ((slot >> stampBits) != h.fingerprint || expired (slot, now))
+            continue;
+
+        // Write at most once a second, so readers rarely share a dirty line
+        auto const fresh = (h.fingerprint << stampBits) | now;
+        if (slot != fresh)
+            bucket[i].compare_exchange_strong (
+                slot, fresh, std::memory_order_relaxed);
+
+        // Occasionally let the caller check the backend
+        thread_local std::uint32_t hits = 0;
+        return verify_ == 0 || ++hits % verify_ != 0;
+    }
+    return false;
+}
+
+void
+NegativeCache::insert (uint256 const& key)
+{
+    auto const table = table_.load (std::memory_order_acquire);
+    auto const h = hash (key, *table);
+    auto const now = stamp ();
+    auto const bucket = table->slots + h.bucket * ways;
+    auto const fresh = (h.fingerprint << stampBits) | now;
+
+    // Refresh the key if present, otherwise replace the oldest slot
+    std::size_t victim = 0;
+    std::uint64_t victimSlot = 0;
+    std::uint64_t victimAge = 0;
+    for (std::size_t i = 0; i < ways; ++i)
+    {
+        auto slot = bucket[i].load (std::memory_order_relaxed);
+        if (slot != 0 && (slot >> stampBits) == h.fingerprint)
+        {
+            if (slot != fresh)
+                bucket[i].compare_exchange_strong (
+                    slot, fresh, std::memory_order_relaxed);
+            return;
+        }
+
+        auto const age = expired (slot, now) ? stampMask + 1 :
+            (now - (slot & stampMask)) & stampMask;
+        if (age > victimAge || i == 0)
+        {
+            victim = i;
+            victimSlot = slot;
+            victimAge = age;
+        }
+    }
+
+    // Losing a race only means this key is not remembered
+    bucket[victim].compare_exchange_strong (
+        victimSlot, fresh, std::memory_order_relaxed);
+}
+
+bool
+NegativeCache::erase (uint256 const& key)
+{
+    auto const table = table_.load (std::memory_order_acquire);
+    auto const h = hash (key, *table);
+    auto const bucket = table->slots + h.bucket * ways;
+
+    // Concurrent inserts may have left the key in more than one slot
+    bool erased = false;
+    for (std::size_t i = 0; i < ways; ++i)
+    {
+        auto slot = bucket[i].load (std::memory_order_relaxed);
+        if (slot != 0 && (slot >> stampBits) == h.fingerprint)
+            erased |= bucket[i].compare_exchange_strong (
+                slot, 0, std::memory_order_relaxed);
+    }
+    return erased;
+}
+
+void
+NegativeCache::setTargetSize (std::size_t size)
+{
+    auto const wanted = (std::max (size, ways) + ways - 1) / ways;
+    std::size_t buckets = 1;
+    while (buckets < wanted)
+        buckets <<= 1;
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const current = table_.load (std::memory_order_relaxed);
+    if (current && current->mask + 1 == buckets)
+        return;
+    tables_.push_back (std::make_unique <Table> (buckets));
+    table_.store (tables_.back().get(), std::memory_order_release);
+}
+
+void
+NegativeCache::setTargetAge (int age)
+{
+    age_ = std::max (1, std::min (age, maximumAge));
+}
+
+void
+NegativeCache::sweep ()
+{
+    auto const table = table_.load (std::memory_order_acquire);
+    auto const now = stamp ();
+    auto const count = (table->mask + 1) * ways;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto slot = table->slots[i].load (std::memory_order_relaxed);
+        if (slot != 0 && expired (slot, now))
+            table->slots[i].compare_exchange_strong (
+                slot, 0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t
+NegativeCache::capacity () const
+{
+    return (table_.load (std::memory_order_acquire)->mask + 1) * ways;
+}
+
+std::size_t
+NegativeCache::size () const
+{
+    auto const table = table_.load (std::memory_order_acquire);
+    auto const now = stamp ();
+    auto const count = (table->mask + 1) * ways;
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (! expired (table->slots[i].load (
+                std::memory_order_relaxed), now))
+            ++result;
+    }
+    return result;
+}
+
+}
+}
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_NODESTORE_NEGATIVECACHE_H_INCLUDED
+#define MTCHAIN_NODESTORE_NEGATIVECACHE_H_INCLUDED
+
+#include <mtchain/basics/base_uint.h>
+#include <mtchain/beast/clock/abstract_clock.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mtchain {
+namespace NodeStore {
+
+/** Remembers keys recently found missing from the node store.
+
+    Lookups, inserts and erases never take a lock. Keys are kept in a
+    fixed table of cache-line sized buckets. Each slot holds one 64-bit
+    word, made of a 48-bit fingerprint of the key and a 16-bit timestamp
+    in seconds. When a bucket is full, the oldest entry is replaced.
+
+    The cache is probabilistic. Two keys can share a fingerprint, so a
+    stored object could be reported as missing. Three safeguards limit
+    the damage:
+    - the fingerprint is seeded per instance and wide enough that a
+      collision is about one in 2^45 lookups
+    - storing an object erases its key
+    - every `verify` hits on a thread, one is reported as absent so the
+      caller reads the backend and corrects a wrong entry
+*/
+class NegativeCache
+{
+public:
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+    /** Slots sharing a cache line. */
+    static std::size_t const ways = 8;
+
+    /** Create the cache.
+        @param size The number of keys to hold.
+        @param age Seconds after which a key expires.
+        @param verify One hit in this many falls through, zero for none.
+    */
+    NegativeCache (clock_type& clock, std::size_t size, int age,
+        std::uint32_t verify = 1024);
+
+    NegativeCache (NegativeCache const&) = delete;
+    NegativeCache& operator= (NegativeCache const&) = delete;
+
+    /** Returns `true` if the key is known to be missing.
+        A found key has its timestamp refreshed.
+    */
+    bool
+    touch_if_exists (uint256 const& key);
+
+    /** Remember that the key is missing. */
+    void
+    insert (uint256 const& key);
+
+    /** Forget the key.
+        @return `true` if the key was present.
+    */
+    bool
+    erase (uint256 const& key);
+
+    /** Change the capacity.
+        Existing entries are discarded. Tables in use by concurrent callers
+        stay valid until the cache is destroyed.
+    */
+    void
+    setTargetSize (std::size_t size);
+
+    /** Change the expiration time in seconds. */
+    void
+    setTargetAge (int age);
+
+    /** Clear expired entries. */
+    void
+    sweep ();
+
+    /** Number of keys the table can hold. */
+    std::size_t
+    capacity () const;
+
+    /** Number of unexpired keys. This is a linear scan. */
+    std::size_t
+    size () const;
+
+private:
+    struct Table
+    {
+        explicit
+        Table (std::size_t buckets);
+
+        std::unique_ptr <std::atomic <std::uint64_t>[]> storage;
+        // Start of the first bucket, aligned to a cache line
+        std::atomic <std::uint64_t>* slots;
+        std::size_t mask;
+    };
+
+    struct Hashed
+    {
+        std::size_t bucket;
+        std::uint64_t fingerprint;
+    };
+
+    Hashed
+    hash (uint256 const& key, Table const& table) const;
+
+    std::uint64_t
+    stamp () const;
+
+    bool
+    expired (std::uint64_t slot, std::uint64_t now) const;
+
+    clock_type& clock_;
+    std::uint64_t const seed0_;
+    std::uint64_t const seed1_;
+    std::uint32_t const verify_;
+    std::atomic <int> age_;
+    std::atomic <Table*> table_;
+
+    // Every table ever used, so that none is freed while in use
+    std::mutex mutex_;
+    std::vector <std::unique_ptr <Table>> tables_;
+};
+
+}
+}
+
+#endif
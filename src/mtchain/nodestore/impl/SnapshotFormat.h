@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_NODESTORE_SNAPSHOTFORMAT_H_INCLUDED
+#define MTCHAIN_NODESTORE_SNAPSHOTFORMAT_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace mtchain {
+namespace NodeStore {
+
+/*  Snapshot file format
+
+    A snapshot is a frozen, sorted key/value file holding node objects
+    for ledgers which will never change again. It is written once by
+    SnapshotWriter and then served read-only through a memory mapping.
+    All integers are big endian.
+
+    Data records    The values, each the output of nodeobject_compress
+                    applied to an EncodedBlob, stored back to back.
+
+    Key index       `count` fixed-size entries sorted by key:
+                        key         keyBytes
+                        offset      uint64, file offset of the value
+                        size        uint32, size of the value
+
+    Prefix table    prefixEntries uint64 entries. Entry i is the index
+                    of the first key whose two leading bytes are >= i,
+                    the final entry is `count`.
+
+    Footer          footerBytes bytes:
+                        magic       8 bytes, "MTSNAP01"
+                        version     uint16
+                        keyBytes    uint16
+                        count       uint64
+                        indexOffset uint64
+                        prefixOff   uint64
+                        reserved    4 bytes, zero
+*/
+
+enum
+{
+    snapshotVersion = 1,
+
+    // Two leading key bytes select the range of the index to search
+    snapshotPrefixEntries = 65536 + 1,
+
+    snapshotFooterBytes = 8 + 2 + 2 + 8 + 8 + 8 + 4,
+
+    // Bytes in an index entry, excluding the key
+    snapshotEntryExtraBytes = 8 + 4
+};
+
+inline
+char const*
+snapshotMagic ()
+{
+    return "MTSNAP01";
+}
+
+/** Name of the snapshot file inside the backend's path. */
+inline
+char const*
+snapshotFileName ()
+{
+    return "snapshot.dat";
+}
+
+/** Returns the two leading bytes of a key as an index prefix. */
+inline
+std::size_t
+snapshotPrefix (void const* key)
+{
+    auto const p = static_cast<std::uint8_t const*>(key);
+    return (static_cast<std::size_t>(p[0]) << 8) | p[1];
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/nodestore/SnapshotWriter.h>
+#include <mtchain/nodestore/impl/codec.h>
+#include <mtchain/nodestore/impl/EncodedBlob.h>
+#include <mtchain/nodestore/impl/SnapshotFormat.h>
+#include <mtchain/basics/contract.h>
+#include <nudb/detail/buffer.hpp>
+#include <nudb/detail/field.hpp>
+#include <nudb/detail/stream.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+
+namespace mtchain {
+namespace NodeStore {
+
+// Values are staged in memory and written in large chunks
+static std::size_t const snapshotWriteBufferBytes = 4 * 1024 * 1024;
+
+SnapshotWriter::SnapshotWriter (std::string const& path)
+{
+    if (path.empty())
+        Throw<std::runtime_error> (
+            "nodestore: Missing path for snapshot");
+    auto const folder = boost::filesystem::path (path);
+    boost::filesystem::create_directories (folder);
+    path_ = (folder / snapshotFileName()).string();
+
+    nudb::error_code ec;
+    file_.create (nudb::file_mode::append, path_, ec);
+    if (ec)
+        Throw<nudb::system_error> (ec);
+    buffer_.reserve (snapshotWriteBufferBytes);
+}
+
+SnapshotWriter::~SnapshotWriter ()
+{
+    if (! finished_)
+    {
+        file_.close();
+        nudb::error_code ec;
+        nudb::native_file::erase (path_, ec);
+    }
+}
+
+void
+SnapshotWriter::insert (std::shared_ptr<NodeObject> const& object)
+{
+    EncodedBlob e;
+    e.prepare (object);
+    nudb::detail::buffer bf;
+    auto const result = nodeobject_compress (
+        e.getData(), e.getSize(), bf);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (buffer_.size() + result.second > snapshotWriteBufferBytes)
+        flush ();
+    Entry entry;
+    entry.key = object->getHash();
+    entry.offset = flushed_ + buffer_.size();
+    entry.size = static_cast<std::uint32_t>(result.second);
+    auto const p = static_cast<std::uint8_t const*>(result.first);
+    buffer_.insert (buffer_.end(), p, p + result.second);
+    index_.push_back (entry);
+    ++inserted_;
+    bytes_ += result.second;
+}
+
+void
+SnapshotWriter::flush ()
+{
+    if (buffer_.empty())
+        return;
+    nudb::error_code ec;
+    file_.write (flushed_, buffer_.data(), buffer_.size(), ec);
+    if (ec)
+        Throw<nudb::system_error> (ec);
+    flushed_ += buffer_.size();
+    buffer_.clear();
+}
+
+std::uint64_t
+SnapshotWriter::finish ()
+{
+    using namespace nudb::detail;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    assert (! finished_);
+    flush ();
+
+    std::sort (index_.begin(), index_.end(),
+        [](Entry const& lhs, Entry const& rhs)
+        {
+            return lhs.key < rhs.key;
+        });
+    index_.erase (std::unique (index_.begin(), index_.end(),
+        [](Entry const& lhs, Entry const& rhs)
+        {
+            return lhs.key == rhs.key;
+        }), index_.end());
+
+    auto const keyBytes = uint256::bytes;
+    auto const entryBytes = keyBytes + snapshotEntryExtraBytes;
+    auto const indexOffset = flushed_;
+
+    // Key index
+    std::vector<std::uint64_t> prefix (snapshotPrefixEntries, 0);
+    for (std::size_t i = 0; i < index_.size(); ++i)
+    {
+        auto const& entry = index_[i];
+        if (buffer_.size() + entryBytes > snapshotWriteBufferBytes)
+            flush ();
+        auto const pos = buffer_.size();
+        buffer_.resize (pos + entryBytes);
+        ostream os (&buffer_[pos], entryBytes);
+        std::memcpy (os.data (keyBytes), entry.key.data(), keyBytes);
+        write<std::uint64_t> (os, entry.offset);
+        write<std::uint32_t> (os, entry.size);
+        ++prefix[snapshotPrefix (entry.key.data()) + 1];
+    }
+
+    // Prefix table, converted from counts to starting positions
+    for (std::size_t i = 1; i < prefix.size(); ++i)
+        prefix[i] += prefix[i - 1];
+    flush ();
+    auto const prefixOffset = flushed_;
+    buffer_.resize (prefix.size() * field<std::uint64_t>::size);
+    {
+        ostream os (buffer_.data(), buffer_.size());
+        for (auto const v : prefix)
+            write<std::uint64_t> (os, v);
+    }
+    flush ();
+
+    // Footer
+    buffer_.resize (snapshotFooterBytes);
+    {
+        ostream os (buffer_.data(), buffer_.size());
+        std::memcpy (os.data (8), snapshotMagic(), 8);
+        write<std::uint16_t> (os, snapshotVersion);
+        write<std::uint16_t> (os, keyBytes);
+        write<std::uint64_t> (os, index_.size());
+        write<std::uint64_t> (os, indexOffset);
+        write<std::uint64_t> (os, prefixOffset);
+        std::memset (os.data (4), 0, 4);
+    }
+    flush ();
+
+    nudb::error_code ec;
+    file_.sync (ec);
+    if (ec)
+        Throw<nudb::system_error> (ec);
+    file_.close ();
+    finished_ = true;
+
+    auto const count = index_.size();
+    index_.clear();
+    index_.shrink_to_fit();
+    return count;
+}
+
+}
+}
@@ -24,6 +24,9 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Most keys remembered as written since the last rotation
+    ,rotatingWrittenLimit = 1024 * 1024
 };
 
 }
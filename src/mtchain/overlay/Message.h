@@ -18,7 +18,9 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <type_traits>
+#include <vector>
 
 namespace mtchain {
 
@@ -34,6 +36,10 @@ namespace mtchain {
 // a string prepended by a header specifying the message length.
 // MessageType should be a Message class generated by the protobuf compiler.
 //
+// A Message may also be packed compressed, for peers which negotiated
+// compression. The compressed form is built at most once and shared by
+// every peer the message is sent to.
+//
 
 class Message : public std::enable_shared_from_this <Message>
 {
@@ -45,14 +51,30 @@ public:
     */
     static size_t const kHeaderBytes = 6;
 
+    /** Number of bytes in a compressed message header.
+        The uncompressed payload size follows the regular header.
+    */
+    static size_t const kCompressedHeaderBytes = 10;
+
+    /** Largest payload a compressed message header can describe. */
+    static std::size_t const kMaximumPayloadBytes = 0x03FFFFFF;
+
     Message (::google::protobuf::Message const& message, int type);
 
-    /** Retrieve the packed message data. */
+    /** Largest payload a compressed message of the type expands to.
+        Zero if messages of the type are never compressed.
+    */
+    static
+    std::size_t
+    maximumUncompressedBytes (int type);
+
+    /** Retrieve the packed message data.
+        @param compressed `true` if the recipient accepts compressed
+                          messages. The uncompressed data is returned
+                          when compression would not pay.
+    */
     std::vector <uint8_t> const&
-    getBuffer () const
-    {
-        return mBuffer;
-    }
+    getBuffer (bool compressed = false) const;
 
     /** Get the traffic category */
     int
@@ -145,9 +167,16 @@ private:
     //
     void encodeHeader (unsigned size, int type);
 
+    // Fills in mBufferCompressed, if the message shrinks enough
+    void compress () const;
+
     std::vector <uint8_t> mBuffer;
 
     int mCategory;
+
+    bool mCompressible;
+    mutable std::once_flag mCompressOnce;
+    mutable std::vector <uint8_t> mBufferCompressed;
 };
 
 }
@@ -20,6 +20,7 @@
 #include <mtchain/core/Stoppable.h>
 #include <mtchain/beast/utility/PropertyStream.h>
 #include <memory>
+#include <set>
 #include <type_traits>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -59,6 +60,12 @@ public:
         bool expire = false;
         beast::IP::Address public_ip;
         int ipLimit = 0;
+        // Offer and accept compressed peer messages
+        bool compression = true;
+        // Ask redundant peers to stop relaying validators
+        bool squelch = true;
+        // Relay transactions to capable peers in batches
+        bool batchTransactions = true;
     };
 
     using PeerSequence = std::vector <std::shared_ptr<Peer>>;
@@ -105,6 +112,13 @@ public:
     Json::Value
     json () = 0;
 
+    /** Returns the distributions of the messages received, by traffic
+        category, over all peers and, if `peers` is set, for each peer.
+    */
+    virtual
+    Json::Value
+    histograms (bool peers) = 0;
+
     /** Returns a sequence representing the current list of peers.
         The snapshot is made at the time of the call.
     */
@@ -150,7 +164,13 @@ public:
     virtual
     void
     relay (protocol::TMValidation& m,
-        uint256 const& uid) = 0;
+        uint256 const& uid, PublicKey const& validator) = 0;
+
+    /** Relay a transaction to every peer not in `toSkip`. */
+    virtual
+    void
+    relay (protocol::TMTransaction& m,
+        std::set<Peer::id_t> const& toSkip) = 0;
 
     /** Visit every active peer and return a value
         The functor must:
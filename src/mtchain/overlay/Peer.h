@@ -16,6 +16,7 @@
 #include <mtchain/json/json_value.h>
 #include <mtchain/protocol/PublicKey.h>
 #include <mtchain/beast/net/IPEndpoint.h>
+#include <chrono>
 
 namespace mtchain {
 
@@ -46,6 +47,19 @@ public:
     void
     send (Message::pointer const& m) = 0;
 
+    /** Send a TMGetObjectByHash query, timing the peer's reply. */
+    virtual
+    void
+    sendObjectQuery (protocol::TMGetObjectByHash const& query) = 0;
+
+    /** Returns the expected wait for the peer to answer a new
+        object query, from its past replies and the queries it has
+        not answered yet.
+    */
+    virtual
+    std::chrono::milliseconds
+    getObjectQueryWait () const = 0;
+
     virtual
     beast::IP::Endpoint
     getRemoteAddress() const = 0;
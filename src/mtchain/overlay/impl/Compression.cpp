@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/Compression.h>
+#include <lz4/lib/lz4.h>
+#include <algorithm>
+#include <limits>
+
+namespace mtchain {
+
+namespace compression {
+
+char const*
+name (Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case Algorithm::LZ4:    return "lz4";
+    case Algorithm::None:   break;
+    };
+    return "identity";
+}
+
+std::size_t
+lz4CompressBound (std::size_t size)
+{
+    if (size > LZ4_MAX_INPUT_SIZE)
+        return 0;
+    return LZ4_compressBound (static_cast<int>(size));
+}
+
+std::size_t
+lz4Compress (void const* in, std::size_t inSize,
+    void* out, std::size_t outSize)
+{
+    if (inSize > LZ4_MAX_INPUT_SIZE)
+        return 0;
+    auto const result = LZ4_compress_default (
+        static_cast<char const*>(in), static_cast<char*>(out),
+        static_cast<int>(inSize), static_cast<int>(std::min<std::size_t> (
+            outSize, std::numeric_limits<int>::max())));
+    return result > 0 ? result : 0;
+}
+
+bool
+lz4Decompress (void const* in, std::size_t inSize,
+    void* out, std::size_t outSize)
+{
+    if (inSize > std::numeric_limits<int>::max() ||
+            outSize > std::numeric_limits<int>::max())
+        return false;
+    auto const result = LZ4_decompress_safe (
+        static_cast<char const*>(in), static_cast<char*>(out),
+        static_cast<int>(inSize), static_cast<int>(outSize));
+    return result >= 0 && static_cast<std::size_t>(result) == outSize;
+}
+
+} // compression
+
+} //
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_OVERLAY_COMPRESSION_H_INCLUDED
+#define MTCHAIN_OVERLAY_COMPRESSION_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtchain {
+
+namespace compression {
+
+/** Compression algorithms, as encoded in a message header. */
+enum class Algorithm : std::uint8_t
+{
+    None = 0x00,
+    LZ4  = 0x01
+};
+
+/** The name used for an algorithm in the handshake headers. */
+char const*
+name (Algorithm algorithm);
+
+/** Largest compressed size of `size` bytes. */
+std::size_t
+lz4CompressBound (std::size_t size);
+
+/** Compress a buffer with LZ4.
+    @return The number of bytes written to `out`, or zero on failure.
+*/
+std::size_t
+lz4Compress (void const* in, std::size_t inSize,
+    void* out, std::size_t outSize);
+
+/** Decompress LZ4 data.
+    @return `true` if the data decompressed to exactly `outSize` bytes.
+*/
+bool
+lz4Decompress (void const* in, std::size_t inSize,
+    void* out, std::size_t outSize);
+
+} // compression
+
+} //
+
+#endif
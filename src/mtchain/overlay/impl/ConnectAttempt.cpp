@@ -10,6 +10,7 @@
 
 #include <BeastConfig.h>
 #include <mtchain/overlay/Cluster.h>
+#include <mtchain/overlay/impl/Compression.h>
 #include <mtchain/overlay/impl/ConnectAttempt.h>
 #include <mtchain/overlay/impl/PeerImp.h>
 #include <mtchain/overlay/impl/Tuning.h>
@@ -206,7 +207,7 @@ ConnectAttempt::onHandshake (error_code ec)
         return close(); // makeSharedValue logs
 
     req_ = makeRequest(! overlay_.peerFinder().config().peerPrivate,
-        remote_endpoint_.address());
+        overlay_.setup().compression, remote_endpoint_.address());
     auto const hello = buildHello (
         *sharedValue,
         overlay_.setup().public_ip,
@@ -276,7 +277,7 @@ ConnectAttempt::onShutdown (error_code ec)
 //--------------------------------------------------------------------------
 
 auto
-ConnectAttempt::makeRequest (bool crawl,
+ConnectAttempt::makeRequest (bool crawl, bool offerCompression,
     boost::asio::ip::address const& remote_address) ->
         request_type
 {
@@ -285,11 +286,13 @@ ConnectAttempt::makeRequest (bool crawl,
     m.url = "/";
     m.version = 11;
     m.fields.insert ("User-Agent", BuildInfo::getFullVersionString());
-    m.fields.insert ("Upgrade", "RTXP/1.2");
-        //std::string("RTXP/") + to_string (BuildInfo::getCurrentProtocol()));
+    m.fields.insert ("Upgrade", makeProtocolVersions ());
     m.fields.insert ("Connection", "Upgrade");
     m.fields.insert ("Connect-As", "Peer");
     m.fields.insert ("Crawl", crawl ? "public" : "private");
+    if (offerCompression)
+        m.fields.insert ("Accept-Encoding", std::string ("identity, ") +
+            compression::name (compression::Algorithm::LZ4));
     return m;
 }
 
@@ -99,7 +99,7 @@ private:
 
     static
     request_type
-    makeRequest (bool crawl,
+    makeRequest (bool crawl, bool offerCompression,
         boost::asio::ip::address const& remote_address);
 
     void processResponse();
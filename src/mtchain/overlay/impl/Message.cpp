@@ -10,11 +10,42 @@
 
 #include <BeastConfig.h>
 #include <mtchain/overlay/Message.h>
+#include <mtchain/overlay/impl/Compression.h>
 #include <mtchain/overlay/impl/TrafficCount.h>
+#include <mtchain/overlay/impl/Tuning.h>
 #include <cstdint>
 
 namespace mtchain {
 
+// Returns `true` if messages of this type and size are worth compressing
+static
+bool
+isCompressible (int type, std::size_t messageBytes)
+{
+    return messageBytes >= Tuning::compressionMinimumBytes &&
+        messageBytes <= Message::maximumUncompressedBytes (type);
+}
+
+std::size_t
+Message::maximumUncompressedBytes (int type)
+{
+    switch (type)
+    {
+    case protocol::mtLEDGER_DATA:
+    case protocol::mtGET_OBJECTS:
+        return kMaximumPayloadBytes;
+    case protocol::mtMANIFESTS:
+    case protocol::mtENDPOINTS:
+    case protocol::mtTRANSACTION:
+    case protocol::mtTRANSACTIONS:
+    case protocol::mtGET_LEDGER:
+        return Tuning::compressionMaximumBytes;
+    default:
+        break;
+    }
+    return 0;
+}
+
 Message::Message (::google::protobuf::Message const& message, int type)
 {
     unsigned const messageBytes = message.ByteSize ();
@@ -32,6 +63,59 @@ Message::Message (::google::protobuf::Message const& message, int type)
 
     mCategory = static_cast<int>(TrafficCount::categorize
         (message, type, false));
+
+    mCompressible = isCompressible (type, messageBytes);
+}
+
+std::vector <uint8_t> const&
+Message::getBuffer (bool compressed) const
+{
+    if (! compressed || ! mCompressible)
+        return mBuffer;
+
+    std::call_once (mCompressOnce, &Message::compress, this);
+    if (mBufferCompressed.empty ())
+        return mBuffer;
+    return mBufferCompressed;
+}
+
+void
+Message::compress () const
+{
+    auto const messageBytes = mBuffer.size () - kHeaderBytes;
+
+    std::vector <uint8_t> buffer (kCompressedHeaderBytes +
+        compression::lz4CompressBound (messageBytes));
+    auto const compressedBytes = compression::lz4Compress (
+        &mBuffer [kHeaderBytes], messageBytes,
+        &buffer [kCompressedHeaderBytes],
+        buffer.size () - kCompressedHeaderBytes);
+
+    // Only send the compressed form when it saves more
+    // than the longer header costs.
+    if (compressedBytes == 0 ||
+            compressedBytes + kCompressedHeaderBytes >= mBuffer.size ())
+        return;
+
+    // The top bit marks a compressed payload, the next three the algorithm
+    // and the low 26 bits its size. The type follows, as in a regular
+    // header, and then the uncompressed size.
+    auto const algorithm = static_cast<std::uint8_t> (
+        compression::Algorithm::LZ4);
+    buffer[0] = static_cast<std::uint8_t> (
+        0x80 | (algorithm << 4) | ((compressedBytes >> 24) & 0x03));
+    buffer[1] = static_cast<std::uint8_t> ((compressedBytes >> 16) & 0xFF);
+    buffer[2] = static_cast<std::uint8_t> ((compressedBytes >> 8) & 0xFF);
+    buffer[3] = static_cast<std::uint8_t> (compressedBytes & 0xFF);
+    buffer[4] = mBuffer[4];
+    buffer[5] = mBuffer[5];
+    buffer[6] = static_cast<std::uint8_t> ((messageBytes >> 24) & 0xFF);
+    buffer[7] = static_cast<std::uint8_t> ((messageBytes >> 16) & 0xFF);
+    buffer[8] = static_cast<std::uint8_t> ((messageBytes >> 8) & 0xFF);
+    buffer[9] = static_cast<std::uint8_t> (messageBytes & 0xFF);
+
+    buffer.resize (kCompressedHeaderBytes + compressedBytes);
+    mBufferCompressed = std::move (buffer);
 }
 
 bool Message::operator== (Message const& other) const
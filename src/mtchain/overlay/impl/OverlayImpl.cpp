@@ -9,6 +9,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <mtchain/app/main/CollectorManager.h>
 #include <mtchain/app/misc/HashRouter.h>
 #include <mtchain/app/misc/NetworkOPs.h>
 #include <mtchain/app/misc/ValidatorList.h>
@@ -21,6 +22,7 @@
 #include <mtchain/rpc/json_body.h>
 #include <mtchain/server/SimpleWriter.h>
 #include <mtchain/overlay/Cluster.h>
+#include <mtchain/overlay/impl/Compression.h>
 #include <mtchain/overlay/impl/ConnectAttempt.h>
 #include <mtchain/overlay/impl/OverlayImpl.h>
 #include <mtchain/overlay/impl/PeerImp.h>
@@ -115,6 +117,12 @@ OverlayImpl::Timer::on_timer (error_code ec)
     if ((++overlay_.timer_count_ % Tuning::checkSeconds) == 0)
         overlay_.check();
 
+    overlay_.slots_.expire();
+
+    auto const saved = overlay_.txMessagesSaved();
+    overlay_.txSavedPerSecond_ = saved - overlay_.txSaved_;
+    overlay_.txSaved_ = saved;
+
     timer_.expires_from_now (std::chrono::seconds(1));
     timer_.async_wait(overlay_.strand_.wrap(std::bind(
         &Timer::on_timer, shared_from_this(),
@@ -143,15 +151,33 @@ OverlayImpl::OverlayImpl (
     , m_resourceManager (resourceManager)
     , m_peerFinder (PeerFinder::make_Manager (*this, io_service,
         stopwatch(), app_.journal("PeerFinder"), config))
+    , slots_ (*this, stopwatch())
     , m_resolver (resolver)
     , next_id_(1)
     , timer_count_(0)
 {
     beast::PropertyStream::Source::add (m_peerFinder.get());
+
+    auto const& group (app_.getCollectorManager ().group ("traffic"));
+    for (std::size_t i = 0; i < static_cast <std::size_t> (
+        TrafficCount::category::CT_unknown); ++i)
+    {
+        std::string const name = TrafficCount::getName (
+            static_cast <TrafficCount::category> (i));
+        gauges_.push_back (group->make_gauge (name, "size_p50"));
+        gauges_.push_back (group->make_gauge (name, "size_p99"));
+        gauges_.push_back (group->make_gauge (name, "interarrival_p50"));
+        gauges_.push_back (group->make_gauge (name, "processing_p50"));
+        gauges_.push_back (group->make_gauge (name, "processing_p99"));
+    }
+    hook_ = group->make_hook (std::bind (&OverlayImpl::collectMetrics, this));
 }
 
 OverlayImpl::~OverlayImpl ()
 {
+    // Must unhook before destroying
+    hook_ = beast::insight::Hook ();
+
     stop();
 
     // Block until dependent objects have been destroyed.
@@ -330,6 +356,26 @@ OverlayImpl::isPeerUpgrade(http_response_type const& response)
     return true;
 }
 
+bool
+OverlayImpl::isCompressionRequested (http_request_type const& request)
+{
+    auto const encodings = beast::rfc2616::split_commas(
+        request.fields["Accept-Encoding"]);
+    return std::find_if(encodings.begin(), encodings.end(),
+        [](std::string const& s)
+        {
+            return beast::detail::ci_equal(s,
+                compression::name (compression::Algorithm::LZ4));
+        }) != encodings.end();
+}
+
+bool
+OverlayImpl::isCompressionAccepted (http_response_type const& response)
+{
+    return beast::detail::ci_equal(response.fields["Transfer-Encoding"],
+        compression::name (compression::Algorithm::LZ4));
+}
+
 std::string
 OverlayImpl::makePrefix (std::uint32_t id)
 {
@@ -594,10 +640,42 @@ OverlayImpl::onWrite (beast::PropertyStream::Map& stream)
         item["bytes_out"] =
             beast::lexicalCast<std::string>
                 (i.second.bytesOut.load());
+        item["raw_bytes_in"] =
+            beast::lexicalCast<std::string>
+                (i.second.rawBytesIn.load());
+        item["raw_bytes_out"] =
+            beast::lexicalCast<std::string>
+                (i.second.rawBytesOut.load());
         item["messages_out"] =
             beast::lexicalCast<std::string>
                 (i.second.messagesOut.load());
     }
+
+    beast::PropertyStream::Set squelch ("squelch", stream);
+    for (auto const& stats : slots_.getStats())
+    {
+        beast::PropertyStream::Map item (squelch);
+        item["validator"] = toBase58 (
+            TokenType::TOKEN_NODE_PUBLIC, stats.validator);
+        item["selected"] = stats.selected;
+        item["peers"] = stats.peers;
+        item["selected_peers"] = stats.selectedPeers;
+        item["squelched_peers"] = stats.squelchedPeers;
+        item["messages"] = stats.messages;
+        item["duplicates"] = stats.duplicates;
+        item["relayed"] = stats.relayed;
+        item["suppressed"] = stats.suppressed;
+        item["squelches"] = stats.squelches;
+        item["unsquelches"] = stats.unsquelches;
+    }
+
+    beast::PropertyStream::Map batches ("transaction_batches", stream);
+    batches["batches_out"] = txBatchesOut_.load();
+    batches["transactions_out"] = txBatchedOut_.load();
+    batches["batches_in"] = txBatchesIn_.load();
+    batches["transactions_in"] = txBatchedIn_.load();
+    batches["messages_saved"] = txMessagesSaved();
+    batches["messages_saved_per_second"] = txSavedPerSecond_.load();
 }
 
 //------------------------------------------------------------------------------
@@ -634,8 +712,11 @@ OverlayImpl::activate (std::shared_ptr<PeerImp> const& peer)
 void
 OverlayImpl::onPeerDeactivate (Peer::id_t id)
 {
-    std::lock_guard <decltype(mutex_)> lock (mutex_);
-    ids_.erase(id);
+    {
+        std::lock_guard <decltype(mutex_)> lock (mutex_);
+        ids_.erase(id);
+    }
+    slots_.deletePeer (id);
 }
 
 void
@@ -715,9 +796,10 @@ void
 OverlayImpl::reportTraffic (
     TrafficCount::category cat,
     bool isInbound,
-    int number)
+    int number,
+    int raw)
 {
-    m_traffic.addCount (cat, isInbound, number);
+    m_traffic.addCount (cat, isInbound, number, raw);
 }
 
 std::size_t
@@ -814,6 +896,44 @@ OverlayImpl::json ()
     return foreach (get_peer_json());
 }
 
+Json::Value
+OverlayImpl::histograms (bool peers)
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::traffic] = histograms_.getJson ();
+    if (peers)
+    {
+        auto& list = (ret[jss::peers] = Json::arrayValue);
+        for_each ([&list](std::shared_ptr<PeerImp>&& peer)
+        {
+            Json::Value entry (Json::objectValue);
+            entry[jss::id] = peer->id ();
+            entry[jss::address] = peer->getRemoteAddress ().to_string ();
+            entry[jss::public_key] = toBase58 (
+                TokenType::TOKEN_NODE_PUBLIC, peer->getNodePublic ());
+            entry[jss::traffic] = peer->histograms ().getJson ();
+            list.append (std::move (entry));
+        });
+    }
+    return ret;
+}
+
+void
+OverlayImpl::collectMetrics ()
+{
+    auto gauge = gauges_.begin ();
+    for (std::size_t i = 0; i < static_cast <std::size_t> (
+        TrafficCount::category::CT_unknown); ++i)
+    {
+        auto const& h = histograms_[static_cast <TrafficCount::category> (i)];
+        (gauge++)->set (h.size.percentile (0.50));
+        (gauge++)->set (h.size.percentile (0.99));
+        (gauge++)->set (h.interarrival.percentile (0.50));
+        (gauge++)->set (h.processing.percentile (0.50));
+        (gauge++)->set (h.processing.percentile (0.99));
+    }
+}
+
 bool
 OverlayImpl::processRequest (http_request_type const& req,
     Handoff& handoff)
@@ -916,20 +1036,34 @@ OverlayImpl::relay (protocol::TMProposeSet& m,
     auto const toSkip = app_.getHashRouter().shouldRelay(uid);
     if (!toSkip)
         return;
+    if (! publicKeyType (makeSlice (m.nodepubkey())))
+        return;
+    PublicKey const validator (makeSlice (m.nodepubkey()));
     auto const sm = std::make_shared<Message>(
         m, protocol::mtPROPOSE_LEDGER);
+    std::size_t sent = 0;
+    std::size_t suppressed = 0;
     for_each([&](std::shared_ptr<PeerImp>&& p)
     {
         if (toSkip->find(p->id()) != toSkip->end())
             return;
+        if (p->isSquelched (validator))
+        {
+            ++suppressed;
+            return;
+        }
         if (! m.has_hops() || p->hopsAware())
+        {
             p->send(sm);
+            ++sent;
+        }
     });
+    slots_.onRelay (validator, sent, suppressed);
 }
 
 void
 OverlayImpl::relay (protocol::TMValidation& m,
-    uint256 const& uid)
+    uint256 const& uid, PublicKey const& validator)
 {
     if (m.has_hops() && m.hops() >= maxTTL)
         return;
@@ -938,13 +1072,163 @@ OverlayImpl::relay (protocol::TMValidation& m,
         return;
     auto const sm = std::make_shared<Message>(
         m, protocol::mtVALIDATION);
+    std::size_t sent = 0;
+    std::size_t suppressed = 0;
     for_each([&](std::shared_ptr<PeerImp>&& p)
     {
         if (toSkip->find(p->id()) != toSkip->end())
             return;
+        if (p->isSquelched (validator))
+        {
+            ++suppressed;
+            return;
+        }
         if (! m.has_hops() || p->hopsAware())
+        {
             p->send(sm);
+            ++sent;
+        }
     });
+    slots_.onRelay (validator, sent, suppressed);
+}
+
+void
+OverlayImpl::relay (protocol::TMTransaction& m,
+    std::set<Peer::id_t> const& toSkip)
+{
+    // Both forms are built at most once and shared by the peers
+    std::shared_ptr<Message> sm;
+    std::shared_ptr<protocol::TMTransaction const> tx;
+    for_each([&](std::shared_ptr<PeerImp>&& p)
+    {
+        if (toSkip.find(p->id()) != toSkip.end())
+            return;
+        if (p->txBatchEnabled())
+        {
+            if (! tx)
+                tx = std::make_shared<protocol::TMTransaction const>(m);
+            p->sendTransaction(tx);
+        }
+        else
+        {
+            if (! sm)
+                sm = std::make_shared<Message>(m, protocol::mtTRANSACTION);
+            p->send(sm);
+        }
+    });
+}
+
+void
+OverlayImpl::onTransactionBatch (bool inbound, std::size_t count)
+{
+    if (inbound)
+    {
+        ++txBatchesIn_;
+        txBatchedIn_ += count;
+    }
+    else
+    {
+        ++txBatchesOut_;
+        txBatchedOut_ += count;
+    }
+}
+
+std::shared_ptr<Message>
+OverlayImpl::makeTransactionBatch (TxBatch::list_type const& txs)
+{
+    auto const key = TxBatch::hash (txs);
+    {
+        std::lock_guard<std::mutex> lock (txBatchMutex_);
+        auto const iter = txBatches_.find (key);
+        if (iter != txBatches_.end())
+        {
+            // Relayed transactions are shared by all the peers, so equal
+            // pointers mean equal transactions.
+            auto m = iter->second.second.lock();
+            if (m && iter->second.first == txs)
+                return m;
+        }
+    }
+
+    auto m = TxBatch::makeMessage (txs);
+
+    std::lock_guard<std::mutex> lock (txBatchMutex_);
+    if (txBatches_.size() >= Tuning::txBatchShared)
+    {
+        // Forget the batches every peer has finished sending
+        for (auto iter = txBatches_.begin(); iter != txBatches_.end();)
+        {
+            if (iter->second.second.expired())
+                iter = txBatches_.erase (iter);
+            else
+                ++iter;
+        }
+        if (txBatches_.size() >= Tuning::txBatchShared)
+            txBatches_.clear();
+    }
+    txBatches_[key] = std::make_pair (txs, m);
+    return m;
+}
+
+bool
+OverlayImpl::startObjectQuery ()
+{
+    if (++objectQueryJobs_ <= Tuning::maxObjectQueryJobs)
+        return true;
+    --objectQueryJobs_;
+    return false;
+}
+
+void
+OverlayImpl::finishObjectQuery ()
+{
+    --objectQueryJobs_;
+}
+
+std::uint64_t
+OverlayImpl::txMessagesSaved () const
+{
+    return (txBatchedOut_.load() - txBatchesOut_.load()) +
+        (txBatchedIn_.load() - txBatchesIn_.load());
+}
+
+void
+OverlayImpl::updateSlotAndSquelch (PublicKey const& validator,
+    Peer::id_t id, bool unique)
+{
+    if (setup_.squelch)
+        slots_.update (validator, id, unique);
+}
+
+void
+OverlayImpl::squelch (PublicKey const& validator, Peer::id_t id,
+    std::chrono::seconds duration)
+{
+    auto const peer = findPeerByShortID (id);
+    if (! peer)
+        return;
+    JLOG(journal_.debug()) << "Squelching " << toBase58 (
+        TokenType::TOKEN_NODE_PUBLIC, validator) << " on peer " << id <<
+        " for " << duration.count() << "s";
+    protocol::TMSquelch m;
+    m.set_squelch (true);
+    m.set_validatorpubkey (validator.data(), validator.size());
+    m.set_squelchduration (static_cast<std::uint32_t>(duration.count()));
+    peer->send (std::make_shared<Message> (m, protocol::mtSQUELCH));
+}
+
+void
+OverlayImpl::unsquelch (PublicKey const& validator, Peer::id_t id)
+{
+    auto const peer = findPeerByShortID (id);
+    if (! peer)
+        return;
+    JLOG(journal_.debug()) << "Unsquelching " << toBase58 (
+        TokenType::TOKEN_NODE_PUBLIC, validator) << " on peer " << id;
+    protocol::TMSquelch m;
+    m.set_squelch (false);
+    m.set_validatorpubkey (validator.data(), validator.size());
+    peer->send (std::make_shared<Message> (m, protocol::mtSQUELCH));
 }
 
 //------------------------------------------------------------------------------
@@ -1024,6 +1308,10 @@ setup_Overlay (BasicConfig const& config)
     auto const& section = config.section("overlay");
     setup.context = make_SSLContext("");
     setup.expire = get<bool>(section, "expire", false);
+    setup.compression = get<bool>(section, "compression", setup.compression);
+    setup.squelch = get<bool>(section, "squelch", setup.squelch);
+    setup.batchTransactions = get<bool>(section, "batch_transactions",
+        setup.batchTransactions);
 
     set (setup.ipLimit, "ip_limit", section);
     if (setup.ipLimit < 0)
@@ -14,12 +14,16 @@
 #include <mtchain/app/main/Application.h>
 #include <mtchain/core/Job.h>
 #include <mtchain/overlay/Overlay.h>
+#include <mtchain/overlay/impl/Squelch.h>
 #include <mtchain/overlay/impl/TrafficCount.h>
+#include <mtchain/overlay/impl/TrafficHistograms.h>
+#include <mtchain/overlay/impl/TxBatch.h>
 #include <mtchain/server/Handoff.h>
 #include <mtchain/rpc/ServerHandler.h>
 #include <mtchain/basics/Resolver.h>
 #include <mtchain/basics/chrono.h>
 #include <mtchain/basics/UnorderedContainers.h>
+#include <mtchain/beast/insight/Insight.h>
 #include <mtchain/peerfinder/PeerfinderManager.h>
 #include <mtchain/resource/ResourceManager.h>
 #include <boost/asio/ip/tcp.hpp>
@@ -34,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace mtchain {
 
@@ -45,7 +50,9 @@ enum
     maxTTL = 2
 };
 
-class OverlayImpl : public Overlay
+class OverlayImpl
+    : public Overlay
+    , public squelch::SquelchHandler
 {
 public:
     class Child
@@ -103,12 +110,33 @@ private:
     Resource::Manager& m_resourceManager;
     std::unique_ptr <PeerFinder::Manager> m_peerFinder;
     TrafficCount m_traffic;
+    TrafficHistograms histograms_;
+    // Percentiles of the histograms, published to the collector
+    std::vector <beast::insight::Gauge> gauges_;
+    beast::insight::Hook hook_;
+    squelch::Slots slots_;
     hash_map <PeerFinder::Slot::ptr,
         std::weak_ptr <PeerImp>> m_peers;
     hash_map<Peer::id_t, std::weak_ptr<PeerImp>> ids_;
     Resolver& m_resolver;
     std::atomic <Peer::id_t> next_id_;
     int timer_count_;
+    // Transaction batches sent and received, and the
+    // transactions they carried
+    std::atomic <std::uint64_t> txBatchesOut_ {0};
+    std::atomic <std::uint64_t> txBatchedOut_ {0};
+    std::atomic <std::uint64_t> txBatchesIn_ {0};
+    std::atomic <std::uint64_t> txBatchedIn_ {0};
+    // Messages saved by batching, sampled once a second by the timer
+    std::uint64_t txSaved_ = 0;
+    std::atomic <std::uint64_t> txSavedPerSecond_ {0};
+    // Peers' object queries waiting for or running on a job
+    std::atomic <int> objectQueryJobs_ {0};
+    // Batches recently sent by their hash, shared by peers sending the
+    // same transactions
+    std::mutex txBatchMutex_;
+    hash_map <std::size_t, std::pair <TxBatch::list_type,
+        std::weak_ptr <Message>>> txBatches_;
 
     //--------------------------------------------------------------------------
 
@@ -176,7 +204,22 @@ public:
 
     void
     relay (protocol::TMValidation& m,
-        uint256 const& uid) override;
+        uint256 const& uid, PublicKey const& validator) override;
+
+    void
+    relay (protocol::TMTransaction& m,
+        std::set<Peer::id_t> const& toSkip) override;
+
+    //
+    // SquelchHandler
+    //
+
+    void
+    squelch (PublicKey const& validator, Peer::id_t id,
+        std::chrono::seconds duration) override;
+
+    void
+    unsquelch (PublicKey const& validator, Peer::id_t id) override;
 
     //--------------------------------------------------------------------------
     //
@@ -243,6 +286,16 @@ public:
     bool
     isPeerUpgrade (http_response_type const& response);
 
+    /** Returns `true` if the request offers LZ4 message compression. */
+    static
+    bool
+    isCompressionRequested (http_request_type const& request);
+
+    /** Returns `true` if the response selects LZ4 message compression. */
+    static
+    bool
+    isCompressionAccepted (http_response_type const& response);
+
     static
     std::string
     makePrefix (std::uint32_t id);
@@ -251,9 +304,49 @@ public:
     reportTraffic (
         TrafficCount::category cat,
         bool isInbound,
-        int bytes);
+        int bytes,
+        int rawBytes);
+
+    /** Returns the distributions of the messages received from all peers. */
+    TrafficHistograms&
+    trafficHistograms ()
+    {
+        return histograms_;
+    }
+
+    /** Called when a trusted validator's message arrives from a peer.
+        Peers found to relay the validator redundantly are squelched.
+    */
+    void
+    updateSlotAndSquelch (PublicKey const& validator,
+        Peer::id_t id, bool unique);
+
+    /** Called when a peer sends or receives a batch of transactions. */
+    void
+    onTransactionBatch (bool inbound, std::size_t count);
+
+    /** Reserves a job to answer a peer's object query.
+        @return `false` if too many queries are pending already.
+    */
+    bool
+    startObjectQuery ();
+
+    /** Releases the job reserved by startObjectQuery. */
+    void
+    finishObjectQuery ();
+
+    /** Returns the message carrying a batch of relayed transactions.
+        Peers whose batches hold the same transactions are given the
+        same message, so each batch is serialized once.
+    */
+    std::shared_ptr<Message>
+    makeTransactionBatch (TxBatch::list_type const& txs);
 
 private:
+    // Messages not sent or received because transactions were batched
+    std::uint64_t
+    txMessagesSaved () const;
+
     std::shared_ptr<Writer>
     makeRedirectResponse (PeerFinder::Slot::ptr const& slot,
         http_request_type const& request, address_type remote_address);
@@ -286,6 +379,9 @@ private:
     Json::Value
     json() override;
 
+    Json::Value
+    histograms (bool peers) override;
+
     //--------------------------------------------------------------------------
 
     //
@@ -295,6 +391,9 @@ private:
     void
     checkStopped();
 
+    void
+    collectMetrics();
+
     void
     onPrepare() override;
 
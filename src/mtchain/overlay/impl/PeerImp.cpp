@@ -83,6 +83,14 @@ PeerImp::PeerImp (Application& app, id_t id, endpoint_type remote_endpoint,
     , slot_ (slot)
     , request_(std::move(request))
     , headers_(request_.fields)
+    , compressionEnabled_ (overlay.setup().compression &&
+        OverlayImpl::isCompressionRequested (request_))
+    , squelch_ (stopwatch())
+    , objectQueries_ (stopwatch())
+    , protocol_ (negotiateProtocolVersion (hello))
+    , txBatchEnabled_ (overlay.setup().batchTransactions &&
+        supportsTransactionBatches (protocol_))
+    , txBatchTimer_ (socket_.get_io_service())
 {
 }
 
@@ -188,13 +196,15 @@ PeerImp::send (Message::pointer const& m)
     if(detaching_)
         return;
 
+    auto const size = m->getBuffer(compressionEnabled_).size();
     overlay_.reportTraffic (
         static_cast<TrafficCount::category>(m->getCategory()),
-        false, static_cast<int>(m->getBuffer().size()));
+        false, static_cast<int>(size),
+        static_cast<int>(m->getBuffer().size()));
 
-    auto sendq_size = send_queue_.size();
+    auto const bytes = sendQueueBytes_.load(std::memory_order_relaxed);
 
-    if (sendq_size < Tuning::targetSendQueue)
+    if (bytes < Tuning::targetSendQueueBytes)
     {
         // To detect a peer that does not read from their
         // side of the connection, we expect a peer to have
@@ -202,16 +212,69 @@ PeerImp::send (Message::pointer const& m)
         large_sendq_ = 0;
     }
 
-    send_queue_.push(m);
+    if (bytes + size > Tuning::maxSendQueueBytes)
+        return fail("Send queue overflow");
 
-    if(sendq_size != 0)
+    send_queue_.push(m, size, clock_type::now());
+    sendQueueBytes_.store(send_queue_.bytes(), std::memory_order_relaxed);
+    sendQueueSize_.store(send_queue_.size(), std::memory_order_relaxed);
+    if (bytes + size > sendQueuePeak_.load(std::memory_order_relaxed))
+        sendQueuePeak_.store(bytes + size, std::memory_order_relaxed);
+
+    if (send_queue_.writing().empty())
+        write();
+}
+
+void
+PeerImp::sendObjectQuery (protocol::TMGetObjectByHash const& query)
+{
+    assert(query.query());
+    objectQueries_.onQuery (query.type());
+    send (std::make_shared<Message> (query, protocol::mtGET_OBJECTS));
+}
+
+std::chrono::milliseconds
+PeerImp::getObjectQueryWait () const
+{
+    // Until the peer has answered, assume a query takes a round trip
+    std::chrono::milliseconds latency;
+    {
+        std::lock_guard<std::mutex> sl (recentLock_);
+        latency = latency_;
+    }
+    if (latency == std::chrono::milliseconds (-1))
+        latency = std::chrono::milliseconds (Tuning::peerHighLatency);
+    return objectQueries_.expectedWait (latency);
+}
+
+void
+PeerImp::sendTransaction (
+    std::shared_ptr<protocol::TMTransaction const> const& tx)
+{
+    if (! strand_.running_in_this_thread())
+        return strand_.post(std::bind (
+            &PeerImp::sendTransaction, shared_from_this(), tx));
+    if(gracefulClose_)
+        return;
+    if(detaching_)
         return;
 
-    boost::asio::async_write (stream_, boost::asio::buffer(
-        send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-            &PeerImp::onWriteMessage, shared_from_this(),
-                beast::asio::placeholders::error,
-                    beast::asio::placeholders::bytes_transferred)));
+    if (txBatch_.add (tx, clock_type::now()))
+        return flushTransactions();
+
+    if (txBatch_.size() == 1)
+    {
+        error_code ec;
+        txBatchTimer_.expires_at (txBatch_.deadline(), ec);
+        if (ec)
+        {
+            JLOG(journal_.error()) << "sendTransaction: " << ec.message();
+            return flushTransactions();
+        }
+        txBatchTimer_.async_wait(strand_.wrap(std::bind(
+            &PeerImp::onTxBatchTimer, shared_from_this(),
+                beast::asio::placeholders::error)));
+    }
 }
 
 void
@@ -257,6 +320,9 @@ PeerImp::json()
     if (m_inbound)
         ret[jss::inbound] = true;
 
+    if (compressionEnabled_)
+        ret[jss::compression] = true;
+
     if (cluster())
     {
         ret[jss::cluster] = true;
@@ -289,6 +355,35 @@ PeerImp::json()
             ret[jss::latency] = static_cast<Json::UInt> (latency.count());
     }
 
+    ret[jss::send_queue] = static_cast<Json::UInt> (sendQueueSize_.load());
+    ret[jss::send_queue_bytes] =
+        static_cast<Json::UInt> (sendQueueBytes_.load());
+    ret[jss::send_queue_peak] =
+        static_cast<Json::UInt> (sendQueuePeak_.load());
+    ret[jss::send_latency] =
+        static_cast<Json::UInt> (sendLatency_.load() / 1000);
+    ret[jss::writes] = static_cast<Json::UInt> (writes_.load());
+    ret[jss::messages_written] =
+        static_cast<Json::UInt> (messagesWritten_.load());
+    ret[jss::object_queries] = objectQueries_.getJson();
+    {
+        auto& lanes = (ret[jss::send_lanes] = Json::objectValue);
+        for (std::size_t i = 0; i < SendQueue::lanes; ++i)
+        {
+            auto const lane = static_cast<SendQueue::Lane>(i);
+            auto const stats = send_queue_.getStats(lane);
+            auto& entry = (lanes[SendQueue::getName(lane)] =
+                Json::objectValue);
+            entry[jss::send_queue] = static_cast<Json::UInt> (stats.messages);
+            entry[jss::send_queue_bytes] =
+                static_cast<Json::UInt> (stats.bytes);
+            entry[jss::send_latency] =
+                static_cast<Json::UInt> (stats.delay.count() / 1000);
+            entry[jss::messages_written] =
+                static_cast<Json::UInt> (stats.written);
+        }
+    }
+
     ret[jss::uptime] = static_cast<Json::UInt>(
         std::chrono::duration_cast<std::chrono::seconds>(uptime()).count());
 
@@ -412,6 +507,7 @@ PeerImp::close()
         detaching_ = true; // DEPRECATED
         error_code ec;
         timer_.cancel(ec);
+        txBatchTimer_.cancel(ec);
         socket_.close(ec);
         if(m_inbound)
         {
@@ -456,12 +552,7 @@ PeerImp::gracefulClose()
     assert(socket_.is_open());
     assert(! gracefulClose_);
     gracefulClose_ = true;
-#if 0
-    // Flush messages
-    while(send_queue_.size() > 1)
-        send_queue_.pop_back();
-#endif
-    if (send_queue_.size() > 0)
+    if (! send_queue_.empty())
         return;
     setTimer();
     stream_.async_shutdown(strand_.wrap(std::bind(&PeerImp::onShutdown,
@@ -502,6 +593,12 @@ PeerImp::makePrefix(id_t id)
     return ss.str();
 }
 
+bool
+PeerImp::supportsTransactionBatches (ProtocolVersion const& protocol)
+{
+    return protocol >= ProtocolVersion (1, 3);
+}
+
 void
 PeerImp::onTimer (error_code const& ec)
 {
@@ -530,6 +627,8 @@ PeerImp::onTimer (error_code const& ec)
         return;
     }
 
+    objectQueries_.expire (std::chrono::seconds (Tuning::objectQueryTimeout));
+
     if (lastPingSeq_ == 0)
     {
         // Make sequence unpredictable enough that a peer
@@ -644,10 +743,13 @@ PeerImp::makeResponse (bool crawl,
     resp.reason = "Switching Protocols";
     resp.version = req.version;
     resp.fields.insert("Connection", "Upgrade");
-    resp.fields.insert("Upgrade", "RTXP/1.2");
+    resp.fields.insert("Upgrade", "RTXP/" + to_string (protocol_));
     resp.fields.insert("Connect-AS", "Peer");
     resp.fields.insert("Server", BuildInfo::getFullVersionString());
     resp.fields.insert("Crawl", crawl ? "public" : "private");
+    if (compressionEnabled_)
+        resp.fields.insert("Transfer-Encoding",
+            compression::name (compression::Algorithm::LZ4));
     protocol::TMHello hello = buildHello(sharedValue,
         overlay_.setup().public_ip, remote, app_);
     appendHello(resp.fields, hello);
@@ -740,7 +842,7 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
     {
         std::size_t bytes_consumed;
         std::tie(bytes_consumed, ec) = invokeProtocolMessage(
-            read_buffer_.data(), *this);
+            read_buffer_.data(), *this, compressionEnabled_);
         if (ec)
             return fail("onReadMessage", ec);
         if (! stream_.next_layer().is_open())
@@ -758,6 +860,31 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
                 beast::asio::placeholders::bytes_transferred)));
 }
 
+void
+PeerImp::write()
+{
+    assert(send_queue_.writing().empty());
+    assert(! send_queue_.empty());
+
+    // Gather the next messages, highest priority lanes first, into
+    // one buffer sequence so that bursts take a single write
+    write_buffers_.clear();
+    for (auto const& queued : send_queue_.next(
+        Tuning::writeBatchMessages, Tuning::writeBatchBytes))
+    {
+        auto const& buffer = queued.message->getBuffer(compressionEnabled_);
+        write_buffers_.emplace_back(buffer.data(), buffer.size());
+    }
+    ++writes_;
+
+    // Timeout on writes only
+    boost::asio::async_write (stream_, write_buffers_,
+        strand_.wrap(std::bind(
+            &PeerImp::onWriteMessage, shared_from_this(),
+                beast::asio::placeholders::error,
+                    beast::asio::placeholders::bytes_transferred)));
+}
+
 void
 PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
 {
@@ -776,17 +903,23 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
             stream << "onWriteMessage";
     }
 
-    assert(! send_queue_.empty());
-    send_queue_.pop();
-    if (! send_queue_.empty())
+    assert(! send_queue_.writing().empty());
+    auto const now = clock_type::now();
+    auto latency = sendLatency_.load(std::memory_order_relaxed);
+    for (auto const& queued : send_queue_.writing())
     {
-        // Timeout on writes only
-        return boost::asio::async_write (stream_, boost::asio::buffer(
-            send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-                &PeerImp::onWriteMessage, shared_from_this(),
-                    beast::asio::placeholders::error,
-                        beast::asio::placeholders::bytes_transferred)));
+        // Exponentially weighted average of the time spent queued
+        latency += (std::chrono::duration_cast<std::chrono::microseconds>(
+            now - queued.queued).count() - latency) / 8;
+        ++messagesWritten_;
     }
+    send_queue_.onWritten(now);
+    sendLatency_.store(latency, std::memory_order_relaxed);
+    sendQueueBytes_.store(send_queue_.bytes(), std::memory_order_relaxed);
+    sendQueueSize_.store(send_queue_.size(), std::memory_order_relaxed);
+
+    if (! send_queue_.empty())
+        return write();
 
     if (gracefulClose_)
     {
@@ -796,6 +929,31 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
     }
 }
 
+void
+PeerImp::flushTransactions ()
+{
+    assert(strand_.running_in_this_thread());
+    error_code ec;
+    txBatchTimer_.cancel(ec);
+    if (txBatch_.empty())
+        return;
+
+    auto const txs = txBatch_.take();
+    send (overlay_.makeTransactionBatch (txs));
+    if (txs.size() > 1)
+        overlay_.onTransactionBatch (false, txs.size());
+}
+
+void
+PeerImp::onTxBatchTimer (error_code const& ec)
+{
+    if (! socket_.is_open())
+        return;
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+    flushTransactions();
+}
+
 //------------------------------------------------------------------------------
 //
 // ProtocolHandler
@@ -813,13 +971,18 @@ PeerImp::onMessageUnknown (std::uint16_t type)
 PeerImp::error_code
 PeerImp::onMessageBegin (std::uint16_t type,
     std::shared_ptr <::google::protobuf::Message> const& m,
-    std::size_t size)
+    std::size_t size, std::size_t uncompressedSize)
 {
     load_event_ = app_.getJobQueue ().getLoadEventAP (
         jtPEER, protocolMessageName(type));
     fee_ = Resource::feeLightPeer;
-    overlay_.reportTraffic (TrafficCount::categorize (*m, type, true),
-        true, static_cast<int>(size));
+    messageCategory_ = TrafficCount::categorize (*m, type, true);
+    messageBegin_ = clock_type::now();
+    overlay_.reportTraffic (messageCategory_,
+        true, static_cast<int>(size), static_cast<int>(uncompressedSize));
+    histograms_.onMessage (messageCategory_, size, messageBegin_);
+    overlay_.trafficHistograms().onMessage (
+        messageCategory_, size, messageBegin_);
     return error_code{};
 }
 
@@ -827,6 +990,10 @@ void
 PeerImp::onMessageEnd (std::uint16_t,
     std::shared_ptr <::google::protobuf::Message> const&)
 {
+    auto const elapsed = std::chrono::duration_cast<
+        std::chrono::microseconds>(clock_type::now() - messageBegin_);
+    histograms_.onProcessed (messageCategory_, elapsed);
+    overlay_.trafficHistograms().onProcessed (messageCategory_, elapsed);
     load_event_.reset();
     charge (fee_);
 }
@@ -1042,7 +1209,78 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         return;
     }
 
-    SerialIter sit (makeSlice(m->rawtransaction()));
+    auto const tx = receiveTransaction (*m);
+    if (! tx || ! canCheckTransactions ())
+        return;
+
+    app_.getJobQueue ().addJob (
+        jtTRANSACTION, "recvTransaction->checkTransaction",
+        [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+        tx = *tx] (Job&) {
+            if (auto peer = weak.lock())
+                peer->checkTransaction(tx.flags,
+                    tx.checkSignature, tx.stx);
+        });
+}
+
+void
+PeerImp::onMessage (std::shared_ptr <protocol::TMTransactions> const& m)
+{
+    if (sanity_.load() == Sanity::insane)
+        return;
+
+    if (app_.getOPs().isNeedNetworkLedger ())
+        return;
+
+    if (m->transactions_size () > Tuning::txBatchMaxTransactions)
+    {
+        JLOG(p_journal_.warn()) << "Transaction batch too large";
+        fee_ = Resource::feeInvalidRequest;
+        return;
+    }
+    overlay_.onTransactionBatch (true, m->transactions_size ());
+
+    std::vector<ReceivedTransaction> txs;
+    txs.reserve (m->transactions_size ());
+    auto const received = receiveTransactions (*m,
+        [&](protocol::TMTransaction const& tm)
+        {
+            fee_ = Resource::feeLightPeer;
+            if (auto tx = receiveTransaction (tm))
+                txs.push_back (std::move (*tx));
+        },
+        [&]
+        {
+            charge (fee_);
+            return ! usage_.disconnect ();
+        });
+    if (! received)
+    {
+        JLOG(p_journal_.info()) <<
+            "Transaction batch: resource limit reached";
+        return;
+    }
+    if (txs.empty () || ! canCheckTransactions ())
+        return;
+
+    // One job checks the whole batch
+    app_.getJobQueue ().addJob (
+        jtTRANSACTION, "recvTransactions->checkTransaction",
+        [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+        txs = std::move (txs)] (Job&) {
+            if (auto peer = weak.lock())
+            {
+                for (auto const& tx : txs)
+                    peer->checkTransaction(tx.flags,
+                        tx.checkSignature, tx.stx);
+            }
+        });
+}
+
+boost::optional<PeerImp::ReceivedTransaction>
+PeerImp::receiveTransaction (protocol::TMTransaction const& m)
+{
+    SerialIter sit (makeSlice(m.rawtransaction()));
 
     try
     {
@@ -1058,11 +1296,11 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             if (flags & SF_BAD)
             {
                 fee_ = Resource::feeInvalidSignature;
-                return;
+                return boost::none;
             }
 
             if (!(flags & SF_RETRY))
-                return;
+                return boost::none;
         }
 
         JLOG(p_journal_.debug()) << "Got tx " << txID;
@@ -1070,7 +1308,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         bool checkSignature = true;
         if (cluster())
         {
-            if (! m->has_deferred () || ! m->deferred ())
+            if (! m.has_deferred () || ! m.deferred ())
             {
                 // Skip local checks if a server we trust
                 // put the transaction in its open ledger
@@ -1085,31 +1323,30 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             }
         }
 
-        if (app_.getJobQueue().getJobCount(jtTRANSACTION) > 100)
-        {
-            JLOG(p_journal_.info()) << "Transaction queue is full";
-        }
-        else if (app_.getLedgerMaster().getValidatedLedgerAge() > 4min)
-        {
-            JLOG(p_journal_.warn()) << "No new transactions until synchronized";
-        }
-        else
-        {
-            app_.getJobQueue ().addJob (
-                jtTRANSACTION, "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                flags, checkSignature, stx] (Job&) {
-                    if (auto peer = weak.lock())
-                        peer->checkTransaction(flags,
-                            checkSignature, stx);
-                });
-        }
+        return ReceivedTransaction {stx, flags, checkSignature};
     }
     catch (std::exception const&)
     {
         JLOG(p_journal_.warn()) << "Transaction invalid: " <<
-            strHex(m->rawtransaction ());
+            strHex(m.rawtransaction ());
     }
+    return boost::none;
+}
+
+bool
+PeerImp::canCheckTransactions ()
+{
+    if (app_.getJobQueue().getJobCount(jtTRANSACTION) > 100)
+    {
+        JLOG(p_journal_.info()) << "Transaction queue is full";
+        return false;
+    }
+    if (app_.getLedgerMaster().getValidatedLedgerAge() > 4min)
+    {
+        JLOG(p_journal_.warn()) << "No new transactions until synchronized";
+        return false;
+    }
+    return true;
 }
 
 void
@@ -1233,7 +1470,15 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
         proposeHash, prevLedger, set.proposeseq(),
         closeTime, publicKey.slice(), signature);
 
-    if (! app_.getHashRouter ().addSuppressionPeer (suppression, id_))
+    auto const isTrusted = app_.validators().trusted (publicKey);
+
+    // Count duplicates too, they show which peers relay the validator
+    bool const unique =
+        app_.getHashRouter ().addSuppressionPeer (suppression, id_);
+    if (isTrusted)
+        overlay_.updateSlotAndSquelch (publicKey, id_, unique);
+
+    if (! unique)
     {
         JLOG(p_journal_.trace()) << "Proposal: duplicate";
         return;
@@ -1246,8 +1491,6 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
         return;
     }
 
-    auto const isTrusted = app_.validators().trusted (publicKey);
-
     if (!isTrusted)
     {
         if (sanity_.load() == Sanity::insane)
@@ -1566,16 +1809,21 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
             return;
         }
 
-        if (! app_.getHashRouter ().addSuppressionPeer(
-            sha512Half(makeSlice(m->validation())), id_))
+        auto const isTrusted =
+            app_.validators().trusted(val->getSignerPublic ());
+
+        bool const unique = app_.getHashRouter ().addSuppressionPeer(
+            sha512Half(makeSlice(m->validation())), id_);
+        if (isTrusted)
+            overlay_.updateSlotAndSquelch (
+                val->getSignerPublic (), id_, unique);
+
+        if (! unique)
         {
             JLOG(p_journal_.trace()) << "Validation: duplicate";
             return;
         }
 
-        auto const isTrusted =
-            app_.validators().trusted(val->getSignerPublic ());
-
         if (!isTrusted && (sanity_.load () == Sanity::insane))
         {
             JLOG(p_journal_.debug()) <<
@@ -1618,7 +1866,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
     if (packet.query ())
     {
         // this is a query
-        if (send_queue_.size() >= Tuning::dropSendQueue)
+        if (sendQueueBytes_.load() >= Tuning::dropSendQueueBytes)
         {
             JLOG(p_journal_.debug()) << "GetObject: Large send queue";
             return;
@@ -1631,57 +1879,30 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
             return;
         }
 
-        fee_ = Resource::feeMediumBurdenPeer;
-
-        protocol::TMGetObjectByHash reply;
-
-        reply.set_query (false);
-
-        if (packet.has_seq ())
-            reply.set_seq (packet.seq ());
-
-        reply.set_type (packet.type ());
-
-        if (packet.has_ledgerhash ())
-            reply.set_ledgerhash (packet.ledgerhash ());
-
-        // This is a very minimal implementation
-        for (int i = 0; i < packet.objects_size (); ++i)
+        // Reading the node store can block, so the reply is built
+        // on a job. Refuse queries the jobs can't keep up with, which
+        // costs the peer no more than any other message.
+        if (! overlay_.startObjectQuery ())
         {
-            uint256 hash;
-            const protocol::TMIndexedObject& obj = packet.objects (i);
-
-            if (obj.has_hash () && (obj.hash ().size () == (256 / 8)))
-            {
-                memcpy (hash.begin (), obj.hash ().data (), 256 / 8);
-                // VFALCO TODO Move this someplace more sensible so we dont
-                //             need to inject the NodeStore interfaces.
-                std::shared_ptr<NodeObject> hObj =
-                    app_.getNodeStore ().fetch (hash);
-
-                if (hObj)
-                {
-                    protocol::TMIndexedObject& newObj = *reply.add_objects ();
-                    newObj.set_hash (hash.begin (), hash.size ());
-                    newObj.set_data (&hObj->getData ().front (),
-                        hObj->getData ().size ());
-
-                    if (obj.has_nodeid ())
-                        newObj.set_index (obj.nodeid ());
-
-                    // VFALCO NOTE "seq" in the message is obsolete
-                }
-            }
+            JLOG(p_journal_.info()) << "GetObject: Too busy";
+            return;
         }
 
-        JLOG(p_journal_.trace()) <<
-            "GetObj: " << reply.objects_size () <<
-                " of " << packet.objects_size ();
-        send (std::make_shared<Message> (reply, protocol::mtGET_OBJECTS));
+        fee_ = Resource::feeMediumBurdenPeer;
+        std::weak_ptr<PeerImp> weak = shared_from_this();
+        app_.getJobQueue().addJob (
+            jtLEDGER_REQ, "recvGetObjectByHash",
+            [weak, m, &overlay = overlay_] (Job&) {
+                if (auto peer = weak.lock())
+                    peer->getObjects(m);
+                overlay.finishObjectQuery ();
+            });
     }
     else
     {
         // this is a reply
+        objectQueries_.onReply (packet.type ());
+
         std::uint32_t pLSeq = 0;
         bool pLDo = true;
         bool progress = false;
@@ -1738,6 +1959,31 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
     }
 }
 
+void
+PeerImp::onMessage (std::shared_ptr <protocol::TMSquelch> const& m)
+{
+    if (! publicKeyType (makeSlice (m->validatorpubkey ())))
+    {
+        JLOG(p_journal_.debug()) << "Squelch: malformed";
+        fee_ = Resource::feeBadData;
+        return;
+    }
+
+    PublicKey const validator (makeSlice (m->validatorpubkey ()));
+    if (! m->squelch ())
+    {
+        squelch_.removeSquelch (validator);
+        return;
+    }
+
+    if (! squelch_.addSquelch (validator,
+        std::chrono::seconds (m->squelchduration ())))
+    {
+        JLOG(p_journal_.debug()) << "Squelch: invalid duration";
+        fee_ = Resource::feeBadData;
+    }
+}
+
 //--------------------------------------------------------------------------
 
 void
@@ -1757,6 +2003,75 @@ PeerImp::addLedger (uint256 const& hash)
     recentLedgers_.push_back (hash);
 }
 
+void
+PeerImp::getObjects (std::shared_ptr<protocol::TMGetObjectByHash> const& m)
+{
+    protocol::TMGetObjectByHash& packet = *m;
+
+    protocol::TMGetObjectByHash reply;
+
+    reply.set_query (false);
+
+    if (packet.has_seq ())
+        reply.set_seq (packet.seq ());
+
+    reply.set_type (packet.type ());
+
+    if (packet.has_ledgerhash ())
+        reply.set_ledgerhash (packet.ledgerhash ());
+
+    auto const count = std::min<std::size_t> (
+        packet.objects_size (), Tuning::maxReplyNodes);
+    std::vector<uint256> hashes (count);
+    std::vector<std::shared_ptr<NodeObject>> objects (count);
+
+    // Start every read before waiting on any, so that objects in
+    // the cache are found at once and the rest are read together
+    // VFALCO TODO Move this someplace more sensible so we dont
+    //             need to inject the NodeStore interfaces.
+    auto& db = app_.getNodeStore ();
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const protocol::TMIndexedObject& obj = packet.objects (i);
+
+        if (obj.has_hash () && (obj.hash ().size () == (256 / 8)))
+        {
+            memcpy (hashes[i].begin (), obj.hash ().data (), 256 / 8);
+            if (! db.asyncFetch (hashes[i], objects[i]))
+                pending.push_back (i);
+        }
+    }
+
+    if (! pending.empty ())
+    {
+        db.waitReads ();
+        for (auto i : pending)
+            objects[i] = db.fetch (hashes[i]);
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (auto const& hObj = objects[i])
+        {
+            protocol::TMIndexedObject& newObj = *reply.add_objects ();
+            newObj.set_hash (hashes[i].begin (), hashes[i].size ());
+            newObj.set_data (&hObj->getData ().front (),
+                hObj->getData ().size ());
+
+            if (packet.objects (i).has_nodeid ())
+                newObj.set_index (packet.objects (i).nodeid ());
+
+            // VFALCO NOTE "seq" in the message is obsolete
+        }
+    }
+
+    JLOG(p_journal_.trace()) <<
+        "GetObj: " << reply.objects_size () <<
+            " of " << packet.objects_size ();
+    send (std::make_shared<Message> (reply, protocol::mtGET_OBJECTS));
+}
+
 void
 PeerImp::doFetchPack (const std::shared_ptr<protocol::TMGetObjectByHash>& packet)
 {
@@ -1927,7 +2242,7 @@ PeerImp::checkValidation (STValidation::pointer val,
 
         if (app_.getOPs ().recvValidation(
                 val, std::to_string(id())))
-            overlay_.relay(*packet, signingHash);
+            overlay_.relay(*packet, signingHash, val->getSignerPublic());
     }
     catch (std::exception const&)
     {
@@ -2058,7 +2373,7 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
     }
     else
     {
-        if (send_queue_.size() >= Tuning::dropSendQueue)
+        if (sendQueueBytes_.load() >= Tuning::dropSendQueueBytes)
         {
             JLOG(p_journal_.debug()) << "GetLedger: Large send queue";
             return;
@@ -17,6 +17,12 @@
 #include <mtchain/overlay/predicates.h>
 #include <mtchain/overlay/impl/ProtocolMessage.h>
 #include <mtchain/overlay/impl/OverlayImpl.h>
+#include <mtchain/overlay/impl/QueryTracker.h>
+#include <mtchain/overlay/impl/SendQueue.h>
+#include <mtchain/overlay/impl/TrafficHistograms.h>
+#include <mtchain/overlay/impl/Squelch.h>
+#include <mtchain/overlay/impl/TMHello.h>
+#include <mtchain/overlay/impl/TxBatch.h>
 #include <mtchain/resource/Fees.h>
 #include <mtchain/core/Config.h>
 #include <mtchain/core/Job.h>
@@ -32,9 +38,11 @@
 #include <beast/http/message.hpp>
 #include <beast/http/parser_v1.hpp>
 #include <mtchain/beast/utility/WrappedSink.h>
+#include <boost/optional.hpp>
+#include <atomic>
 #include <cstdint>
 #include <deque>
-#include <queue>
+#include <vector>
 
 namespace mtchain {
 
@@ -90,6 +98,14 @@ private:
     // The length of the smallest valid finished message
     static const size_t sslMinimumFinishedLength = 12;
 
+    // A relayed transaction waiting to be checked
+    struct ReceivedTransaction
+    {
+        std::shared_ptr<STTx const> stx;
+        int flags;
+        bool checkSignature;
+    };
+
     Application& app_;
     id_t const id_;
     beast::WrappedSink sink_;
@@ -147,12 +163,39 @@ private:
     http_response_type response_;
     beast::http::fields const& headers_;
     beast::streambuf write_buffer_;
-    std::queue<Message::pointer> send_queue_;
+    // Messages waiting to be written, in lanes by priority
+    SendQueue send_queue_;
+    std::vector<boost::asio::const_buffer> write_buffers_;
+    // Send queue metrics, updated on the strand and read by json()
+    std::atomic<std::size_t> sendQueueBytes_ {0};
+    std::atomic<std::size_t> sendQueuePeak_ {0};
+    std::atomic<std::size_t> sendQueueSize_ {0};
+    std::atomic<std::uint64_t> writes_ {0};
+    std::atomic<std::uint64_t> messagesWritten_ {0};
+    std::atomic<std::chrono::microseconds::rep> sendLatency_ {0};
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     int no_ping_ = 0;
     std::unique_ptr <LoadEvent> load_event_;
+    // The message being processed, recorded in the histograms
+    TrafficCount::category messageCategory_ = TrafficCount::category::CT_unknown;
+    clock_type::time_point messageBegin_;
+    TrafficHistograms histograms_;
     bool hopsAware_ = false;
+    // Messages to and from this peer may be compressed
+    bool compressionEnabled_ = false;
+    // Validators this peer asked us not to relay
+    squelch::Squelch squelch_;
+    // How quickly this peer answers our object queries
+    QueryTracker objectQueries_;
+    // The protocol version spoken on this connection
+    ProtocolVersion const protocol_;
+    // Relayed transactions are sent to this peer in batches
+    bool const txBatchEnabled_;
+    // Transactions waiting for the next batch, flushed on size or timer
+    TxBatch txBatch_;
+    boost::asio::basic_waitable_timer<
+        std::chrono::steady_clock> txBatchTimer_;
 
     friend class OverlayImpl;
 
@@ -208,6 +251,19 @@ public:
     void
     send (Message::pointer const& m) override;
 
+    void
+    sendObjectQuery (protocol::TMGetObjectByHash const& query) override;
+
+    std::chrono::milliseconds
+    getObjectQueryWait () const override;
+
+    /** Send a relayed transaction in the next batch.
+        Only valid if txBatchEnabled() returns `true`.
+    */
+    void
+    sendTransaction (
+        std::shared_ptr<protocol::TMTransaction const> const& tx);
+
     /** Send a set of PeerFinder endpoints as a protocol message. */
     template <class FwdIt, class = typename std::enable_if_t<std::is_same<
         typename std::iterator_traits<FwdIt>::value_type,
@@ -249,6 +305,20 @@ public:
         return hopsAware_;
     }
 
+    /** Returns `true` if relayed transactions are sent in batches. */
+    bool
+    txBatchEnabled() const
+    {
+        return txBatchEnabled_;
+    }
+
+    /** Returns `true` if the peer asked us not to relay the validator. */
+    bool
+    isSquelched (PublicKey const& validator)
+    {
+        return squelch_.isSquelched (validator);
+    }
+
     void
     check();
 
@@ -281,6 +351,13 @@ public:
     Json::Value
     json() override;
 
+    /** Returns the distributions of the messages received from this peer. */
+    TrafficHistograms const&
+    histograms() const
+    {
+        return histograms_;
+    }
+
     //
     // Ledger
     //
@@ -339,6 +416,11 @@ private:
     std::string
     makePrefix(id_t id);
 
+    // Returns `true` if the protocol carries TMTransactions
+    static
+    bool
+    supportsTransactionBatches (ProtocolVersion const& protocol);
+
     // Called when the timer wait completes
     void
     onTimer (boost::system::error_code const& ec);
@@ -370,10 +452,22 @@ private:
     void
     onReadMessage (error_code ec, std::size_t bytes_transferred);
 
+    // Writes as many queued messages as fit in one batch
+    void
+    write();
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage (error_code ec, std::size_t bytes_transferred);
 
+    // Sends the transactions waiting for the next batch
+    void
+    flushTransactions ();
+
+    // Called when a transaction batch has waited long enough
+    void
+    onTxBatchTimer (error_code const& ec);
+
 public:
     //--------------------------------------------------------------------------
     //
@@ -395,7 +489,7 @@ public:
     error_code
     onMessageBegin (std::uint16_t type,
         std::shared_ptr <::google::protobuf::Message> const& m,
-        std::size_t size);
+        std::size_t size, std::size_t uncompressedSize);
 
     void
     onMessageEnd (std::uint16_t type,
@@ -416,6 +510,8 @@ public:
     void onMessage (std::shared_ptr <protocol::TMHaveTransactionSet> const& m);
     void onMessage (std::shared_ptr <protocol::TMValidation> const& m);
     void onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m);
+    void onMessage (std::shared_ptr <protocol::TMSquelch> const& m);
+    void onMessage (std::shared_ptr <protocol::TMTransactions> const& m);
 
 private:
     State state() const
@@ -436,6 +532,19 @@ private:
     void
     doFetchPack (const std::shared_ptr<protocol::TMGetObjectByHash>& packet);
 
+    // Answers an object query from the node store
+    void
+    getObjects (std::shared_ptr<protocol::TMGetObjectByHash> const& packet);
+
+    // Deserializes a relayed transaction, returning nothing if it is
+    // malformed or was already seen
+    boost::optional<ReceivedTransaction>
+    receiveTransaction (protocol::TMTransaction const& m);
+
+    // Returns `true` if received transactions can be checked now
+    bool
+    canCheckTransactions ();
+
     void
     checkTransaction (int flags, bool checkSignature,
         std::shared_ptr<STTx const> const& stx);
@@ -494,6 +603,14 @@ PeerImp::PeerImp (Application& app, std::unique_ptr<beast::asio::ssl_bundle>&& s
     , slot_ (std::move(slot))
     , response_(std::move(response))
     , headers_(response_.fields)
+    , compressionEnabled_ (overlay.setup().compression &&
+        OverlayImpl::isCompressionAccepted (response_))
+    , squelch_ (stopwatch())
+    , objectQueries_ (stopwatch())
+    , protocol_ (negotiateProtocolVersion (hello))
+    , txBatchEnabled_ (overlay.setup().batchTransactions &&
+        supportsTransactionBatches (protocol_))
+    , txBatchTimer_ (socket_.get_io_service())
 {
     read_buffer_.commit (boost::asio::buffer_copy(read_buffer_.prepare(
         boost::asio::buffer_size(buffers)), buffers));
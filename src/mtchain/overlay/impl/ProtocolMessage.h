@@ -13,12 +13,15 @@
 
 #include "mtchain.pb.h"
 #include <mtchain/overlay/Message.h>
+#include <mtchain/overlay/impl/Compression.h>
 #include <mtchain/overlay/impl/ZeroCopyStream.h>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -48,33 +51,160 @@ protocolMessageName (int type)
     case protocol::mtHAVE_SET:          return "have_set";
     case protocol::mtVALIDATION:        return "validation";
     case protocol::mtGET_OBJECTS:       return "get_objects";
+    case protocol::mtSQUELCH:           return "squelch";
+    case protocol::mtTRANSACTIONS:      return "transactions";
     default:
         break;
     };
     return "unknown";
 }
 
+/** The fields of a packed message header. */
+struct MessageHeader
+{
+    // Bytes in the header itself
+    std::size_t headerBytes = 0;
+
+    // Bytes of payload following the header
+    std::size_t payloadBytes = 0;
+
+    // Bytes of payload once decompressed
+    std::size_t uncompressedBytes = 0;
+
+    int type = 0;
+
+    compression::Algorithm algorithm = compression::Algorithm::None;
+};
+
+/** Parse the header at the start of the passed buffers.
+
+    @param compressionEnabled `true` if the peer negotiated compression.
+                              Otherwise all 32 bits of the size belong
+                              to an uncompressed payload.
+    @return `false` if there are too few bytes for a header. If the header
+            is invalid, `ec` is set.
+*/
+template <class Buffers>
+bool
+parseMessageHeader (Buffers const& buffers, bool compressionEnabled,
+    MessageHeader& header, boost::system::error_code& ec)
+{
+    auto const available = boost::asio::buffer_size(buffers);
+    if (available < Message::kHeaderBytes)
+        return false;
+
+    std::uint8_t h[Message::kCompressedHeaderBytes];
+    boost::asio::buffer_copy(boost::asio::buffer(h), buffers);
+
+    auto const read32 = [&h](int i)
+    {
+        return (std::size_t{h[i]} << 24) | (std::size_t{h[i + 1]} << 16) |
+            (std::size_t{h[i + 2]} << 8) | std::size_t{h[i + 3]};
+    };
+
+    header.type = (int{h[4]} << 8) | h[5];
+
+    if (! compressionEnabled || (h[0] & 0x80) == 0)
+    {
+        header.headerBytes = Message::kHeaderBytes;
+        header.payloadBytes = read32 (0);
+        header.uncompressedBytes = header.payloadBytes;
+        header.algorithm = compression::Algorithm::None;
+        return true;
+    }
+
+    if (available < Message::kCompressedHeaderBytes)
+        return false;
+
+    header.algorithm = static_cast<compression::Algorithm>((h[0] >> 4) & 0x07);
+    if (header.algorithm != compression::Algorithm::LZ4 || (h[0] & 0x0C) != 0)
+    {
+        ec = boost::system::errc::make_error_code(
+            boost::system::errc::protocol_error);
+        return false;
+    }
+
+    header.headerBytes = Message::kCompressedHeaderBytes;
+    header.payloadBytes = read32 (0) & Message::kMaximumPayloadBytes;
+    header.uncompressedBytes = read32 (6);
+
+    // Checked before anything is allocated for the payload
+    if (header.uncompressedBytes >
+        Message::maximumUncompressedBytes (header.type))
+    {
+        ec = boost::system::errc::make_error_code(
+            boost::system::errc::message_size);
+        return false;
+    }
+    return true;
+}
+
 namespace detail {
 
+// Decompress the payload that follows the header
+template <class Buffers>
+bool
+decompress (ZeroCopyInputStream<Buffers>& stream,
+    MessageHeader const& header, std::vector<std::uint8_t>& payload)
+{
+    payload.resize (header.uncompressedBytes);
+
+    void const* data;
+    int size;
+    if (! stream.Next(&data, &size))
+        return false;
+
+    // The payload usually lies in one buffer, otherwise gather it
+    if (static_cast<std::size_t>(size) >= header.payloadBytes)
+        return compression::lz4Decompress (data, header.payloadBytes,
+            payload.data(), payload.size());
+
+    std::vector<std::uint8_t> compressed (header.payloadBytes);
+    std::size_t copied = 0;
+    do
+    {
+        auto const n = std::min<std::size_t> (size, compressed.size() - copied);
+        std::memcpy (&compressed[copied], data, n);
+        copied += n;
+    }
+    while (copied < compressed.size() && stream.Next(&data, &size));
+
+    return copied == compressed.size() && compression::lz4Decompress (
+        compressed.data(), compressed.size(), payload.data(), payload.size());
+}
+
 template <class T, class Buffers, class Handler>
 std::enable_if_t<std::is_base_of<
     ::google::protobuf::Message, T>::value,
         boost::system::error_code>
-invoke (int type, Buffers const& buffers,
+invoke (MessageHeader const& header, Buffers const& buffers,
     Handler& handler)
 {
     ZeroCopyInputStream<Buffers> stream(buffers);
-    stream.Skip(Message::kHeaderBytes);
+    stream.Skip(header.headerBytes);
     auto const m (std::make_shared<T>());
-    if (! m->ParseFromZeroCopyStream(&stream))
+    if (header.algorithm != compression::Algorithm::None)
+    {
+        std::vector<std::uint8_t> payload;
+        if (! decompress (stream, header, payload) ||
+                ! m->ParseFromArray(payload.data(), payload.size()))
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+    }
+    else if (! m->ParseFromZeroCopyStream(&stream))
+    {
         return boost::system::errc::make_error_code(
             boost::system::errc::invalid_argument);
-    auto ec = handler.onMessageBegin (type, m,
-       Message::kHeaderBytes + Message::size (buffers));
+    }
+    // The message as received and as it is without compression,
+    // headers included
+    auto ec = handler.onMessageBegin (header.type, m,
+       header.headerBytes + header.payloadBytes,
+       Message::kHeaderBytes + header.uncompressedBytes);
     if (! ec)
     {
         handler.onMessage (m);
-        handler.onMessageEnd (type, m);
+        handler.onMessageEnd (header.type, m);
     }
     return ec;
 }
@@ -86,41 +216,47 @@ invoke (int type, Buffers const& buffers,
     If there is insufficient data to produce a complete protocol
     message, zero is returned for the number of bytes consumed.
 
+    @param compressionEnabled `true` if the peer negotiated compression.
     @return The number of bytes consumed, or the error code if any.
 */
 template <class Buffers, class Handler>
 std::pair <std::size_t, boost::system::error_code>
-invokeProtocolMessage (Buffers const& buffers, Handler& handler)
+invokeProtocolMessage (Buffers const& buffers, Handler& handler,
+    bool compressionEnabled = false)
 {
     std::pair<std::size_t,boost::system::error_code> result = { 0, {} };
     boost::system::error_code& ec = result.second;
 
-    auto const type = Message::type(buffers);
-    if (type == 0)
+    MessageHeader header;
+    if (! parseMessageHeader (buffers, compressionEnabled, header, ec))
         return result;
-    auto const size = Message::kHeaderBytes + Message::size(buffers);
+    if (header.type == 0)
+        return result;
+    auto const size = header.headerBytes + header.payloadBytes;
     if (boost::asio::buffer_size(buffers) < size)
         return result;
 
-    switch (type)
+    switch (header.type)
     {
-    case protocol::mtHELLO:         ec = detail::invoke<protocol::TMHello> (type, buffers, handler); break;
-    case protocol::mtMANIFESTS:     ec = detail::invoke<protocol::TMManifests> (type, buffers, handler); break;
-    case protocol::mtPING:          ec = detail::invoke<protocol::TMPing> (type, buffers, handler); break;
-    case protocol::mtCLUSTER:       ec = detail::invoke<protocol::TMCluster> (type, buffers, handler); break;
-    case protocol::mtGET_PEERS:     ec = detail::invoke<protocol::TMGetPeers> (type, buffers, handler); break;
-    case protocol::mtPEERS:         ec = detail::invoke<protocol::TMPeers> (type, buffers, handler); break;
-    case protocol::mtENDPOINTS:     ec = detail::invoke<protocol::TMEndpoints> (type, buffers, handler); break;
-    case protocol::mtTRANSACTION:   ec = detail::invoke<protocol::TMTransaction> (type, buffers, handler); break;
-    case protocol::mtGET_LEDGER:    ec = detail::invoke<protocol::TMGetLedger> (type, buffers, handler); break;
-    case protocol::mtLEDGER_DATA:   ec = detail::invoke<protocol::TMLedgerData> (type, buffers, handler); break;
-    case protocol::mtPROPOSE_LEDGER:ec = detail::invoke<protocol::TMProposeSet> (type, buffers, handler); break;
-    case protocol::mtSTATUS_CHANGE: ec = detail::invoke<protocol::TMStatusChange> (type, buffers, handler); break;
-    case protocol::mtHAVE_SET:      ec = detail::invoke<protocol::TMHaveTransactionSet> (type, buffers, handler); break;
-    case protocol::mtVALIDATION:    ec = detail::invoke<protocol::TMValidation> (type, buffers, handler); break;
-    case protocol::mtGET_OBJECTS:   ec = detail::invoke<protocol::TMGetObjectByHash> (type, buffers, handler); break;
+    case protocol::mtHELLO:         ec = detail::invoke<protocol::TMHello> (header, buffers, handler); break;
+    case protocol::mtMANIFESTS:     ec = detail::invoke<protocol::TMManifests> (header, buffers, handler); break;
+    case protocol::mtPING:          ec = detail::invoke<protocol::TMPing> (header, buffers, handler); break;
+    case protocol::mtCLUSTER:       ec = detail::invoke<protocol::TMCluster> (header, buffers, handler); break;
+    case protocol::mtGET_PEERS:     ec = detail::invoke<protocol::TMGetPeers> (header, buffers, handler); break;
+    case protocol::mtPEERS:         ec = detail::invoke<protocol::TMPeers> (header, buffers, handler); break;
+    case protocol::mtENDPOINTS:     ec = detail::invoke<protocol::TMEndpoints> (header, buffers, handler); break;
+    case protocol::mtTRANSACTION:   ec = detail::invoke<protocol::TMTransaction> (header, buffers, handler); break;
+    case protocol::mtGET_LEDGER:    ec = detail::invoke<protocol::TMGetLedger> (header, buffers, handler); break;
+    case protocol::mtLEDGER_DATA:   ec = detail::invoke<protocol::TMLedgerData> (header, buffers, handler); break;
+    case protocol::mtPROPOSE_LEDGER:ec = detail::invoke<protocol::TMProposeSet> (header, buffers, handler); break;
+    case protocol::mtSTATUS_CHANGE: ec = detail::invoke<protocol::TMStatusChange> (header, buffers, handler); break;
+    case protocol::mtHAVE_SET:      ec = detail::invoke<protocol::TMHaveTransactionSet> (header, buffers, handler); break;
+    case protocol::mtVALIDATION:    ec = detail::invoke<protocol::TMValidation> (header, buffers, handler); break;
+    case protocol::mtGET_OBJECTS:   ec = detail::invoke<protocol::TMGetObjectByHash> (header, buffers, handler); break;
+    case protocol::mtSQUELCH:       ec = detail::invoke<protocol::TMSquelch> (header, buffers, handler); break;
+    case protocol::mtTRANSACTIONS:  ec = detail::invoke<protocol::TMTransactions> (header, buffers, handler); break;
     default:
-        ec = handler.onMessageUnknown (type);
+        ec = handler.onMessageUnknown (header.type);
         break;
     }
     if (! ec)
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/QueryTracker.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace mtchain {
+
+QueryTracker::QueryTracker (clock_type& clock)
+    : clock_ (clock)
+{
+}
+
+void
+QueryTracker::onQuery (int type)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    queries_.push_back ({type, clock_.now ()});
+}
+
+bool
+QueryTracker::onReply (int type)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const iter = std::find_if (queries_.begin (), queries_.end (),
+        [type](Query const& q)
+        {
+            return q.type == type;
+        });
+    if (iter == queries_.end ())
+        return false;
+
+    sample (std::chrono::duration_cast <std::chrono::milliseconds> (
+        clock_.now () - iter->sent));
+    ++replies_;
+    queries_.erase (iter);
+    return true;
+}
+
+void
+QueryTracker::expire (std::chrono::milliseconds timeout)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const now = clock_.now ();
+    while (! queries_.empty () && now - queries_.front ().sent > timeout)
+    {
+        sample (timeout);
+        ++timeouts_;
+        queries_.pop_front ();
+    }
+}
+
+std::chrono::milliseconds
+QueryTracker::expectedWait (std::chrono::milliseconds latency) const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const each = (replies_ + timeouts_ == 0)
+        ? static_cast <double> (latency.count ())
+        : latency_;
+    return std::chrono::milliseconds (static_cast <std::int64_t> (
+        each * (queries_.size () + 1)));
+}
+
+std::size_t
+QueryTracker::outstanding () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return queries_.size ();
+}
+
+Json::Value
+QueryTracker::getJson () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    Json::Value ret (Json::objectValue);
+    ret[jss::outstanding] = static_cast <Json::UInt> (queries_.size ());
+    ret[jss::latency] = static_cast <Json::UInt> (latency_);
+    ret[jss::replies] = static_cast <Json::UInt> (replies_);
+    ret[jss::timeouts] = static_cast <Json::UInt> (timeouts_);
+    return ret;
+}
+
+void
+QueryTracker::sample (std::chrono::milliseconds elapsed)
+{
+    // The first sample sets the average, later ones move it a quarter
+    if (replies_ + timeouts_ == 0)
+        latency_ = elapsed.count ();
+    else
+        latency_ += (elapsed.count () - latency_) / 4;
+}
+
+} //
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_OVERLAY_QUERYTRACKER_H_INCLUDED
+#define MTCHAIN_OVERLAY_QUERYTRACKER_H_INCLUDED
+
+#include <mtchain/basics/chrono.h>
+#include <mtchain/json/json_value.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace mtchain {
+
+/** How quickly a peer answers the object queries sent to it.
+
+    Each query is remembered until a reply of the same type arrives,
+    replies being matched to queries in the order they were sent. A
+    reply with no query waiting, such as the later chunks of a fetch
+    pack, is ignored. The smoothed time to reply, and the queries still
+    waiting, give the expected wait for the next query, which requesters
+    use to route their queries to the fastest peers.
+*/
+class QueryTracker
+{
+public:
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+    explicit
+    QueryTracker (clock_type& clock);
+
+    /** Record a query of the given TMGetObjectByHash type. */
+    void
+    onQuery (int type);
+
+    /** Record a reply.
+        @return `true` if it answered a waiting query.
+    */
+    bool
+    onReply (int type);
+
+    /** Give up on queries waiting longer than `timeout`.
+        Each counts as a reply that took the whole timeout.
+    */
+    void
+    expire (std::chrono::milliseconds timeout);
+
+    /** Returns the expected wait for a reply to a new query.
+        @param latency The time to reply assumed until one is measured.
+    */
+    std::chrono::milliseconds
+    expectedWait (std::chrono::milliseconds latency) const;
+
+    std::size_t
+    outstanding () const;
+
+    Json::Value
+    getJson () const;
+
+private:
+    struct Query
+    {
+        int type;
+        clock_type::time_point sent;
+    };
+
+    void
+    sample (std::chrono::milliseconds elapsed);
+
+    clock_type& clock_;
+    std::mutex mutable mutex_;
+    std::deque <Query> queries_;
+    double latency_ = 0;            // milliseconds, smoothed
+    std::uint64_t replies_ = 0;
+    std::uint64_t timeouts_ = 0;
+};
+
+} //
+
+#endif
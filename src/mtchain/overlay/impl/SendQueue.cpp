@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/SendQueue.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <cassert>
+
+namespace mtchain {
+
+static
+std::size_t
+weight (SendQueue::Lane lane)
+{
+    switch (lane)
+    {
+    case SendQueue::Lane::consensus:    return Tuning::consensusLaneWeight;
+    case SendQueue::Lane::transaction:  return Tuning::transactionLaneWeight;
+    case SendQueue::Lane::ledger:       return Tuning::ledgerLaneWeight;
+    case SendQueue::Lane::discovery:    break;
+    }
+    return Tuning::discoveryLaneWeight;
+}
+
+SendQueue::Lane
+SendQueue::getLane (TrafficCount::category category)
+{
+    switch (category)
+    {
+    case TrafficCount::category::CT_base:
+    case TrafficCount::category::CT_proposal:
+    case TrafficCount::category::CT_validation:
+        return Lane::consensus;
+
+    case TrafficCount::category::CT_transaction:
+        return Lane::transaction;
+
+    case TrafficCount::category::CT_get_ledger:
+    case TrafficCount::category::CT_share_ledger:
+    case TrafficCount::category::CT_get_trans:
+    case TrafficCount::category::CT_share_trans:
+        return Lane::ledger;
+
+    default:
+        break;
+    }
+    return Lane::discovery;
+}
+
+char const*
+SendQueue::getName (Lane lane)
+{
+    switch (lane)
+    {
+    case Lane::consensus:   return "consensus";
+    case Lane::transaction: return "transaction";
+    case Lane::ledger:      return "ledger";
+    case Lane::discovery:   break;
+    }
+    return "discovery";
+}
+
+void
+SendQueue::push (Message::pointer const& m, std::size_t size,
+    clock_type::time_point now)
+{
+    auto const lane = getLane (
+        static_cast <TrafficCount::category> (m->getCategory ()));
+    auto& state = lanes_[static_cast <std::size_t> (lane)];
+    state.queue.push_back ({m, size, lane, now});
+    state.messages.store (state.queue.size (), std::memory_order_relaxed);
+    state.bytes.store (state.bytes.load (std::memory_order_relaxed) + size,
+        std::memory_order_relaxed);
+    ++waiting_;
+    ++size_;
+    bytes_ += size;
+}
+
+std::vector <SendQueue::Entry> const&
+SendQueue::next (std::size_t maxMessages, std::size_t maxBytes)
+{
+    assert (writing_.empty ());
+
+    std::size_t bytes = 0;
+    bool full = false;
+    while (waiting_ != 0)
+    {
+        auto& state = lanes_[current_];
+        if (! state.queue.empty ())
+        {
+            if (! credited_)
+            {
+                state.deficit += weight (static_cast <Lane> (current_)) *
+                    Tuning::sendLaneQuantum;
+                credited_ = true;
+            }
+
+            std::size_t taken = 0;
+            while (! state.queue.empty ())
+            {
+                auto const size = state.queue.front ().size;
+                if (size > state.deficit)
+                    break;
+                if (! writing_.empty () &&
+                    (writing_.size () >= maxMessages ||
+                        bytes + size > maxBytes))
+                {
+                    full = true;
+                    break;
+                }
+                state.deficit -= size;
+                bytes += size;
+                taken += size;
+                writing_.push_back (std::move (state.queue.front ()));
+                state.queue.pop_front ();
+                --waiting_;
+            }
+
+            // An idle lane does not bank credit
+            if (state.queue.empty ())
+                state.deficit = 0;
+            state.messages.store (state.queue.size (),
+                std::memory_order_relaxed);
+            state.bytes.store (state.bytes.load (
+                std::memory_order_relaxed) - taken,
+                    std::memory_order_relaxed);
+        }
+
+        // A full write ends the call, not the lane's turn
+        if (full)
+            break;
+        current_ = (current_ + 1) % lanes;
+        credited_ = false;
+
+        // Keep writes to one round so that the next one
+        // starts from the consensus lane without waiting long
+        if (current_ == 0 && ! writing_.empty ())
+            break;
+    }
+    return writing_;
+}
+
+std::size_t
+SendQueue::onWritten (clock_type::time_point now)
+{
+    std::size_t bytes = 0;
+    for (auto const& entry : writing_)
+    {
+        auto& state = lanes_[static_cast <std::size_t> (entry.lane)];
+        // Exponentially weighted average of the time spent queued
+        auto delay = state.delay.load (std::memory_order_relaxed);
+        delay += (std::chrono::duration_cast <std::chrono::microseconds> (
+            now - entry.queued).count () - delay) / 8;
+        state.delay.store (delay, std::memory_order_relaxed);
+        ++state.written;
+        bytes += entry.size;
+    }
+    size_ -= writing_.size ();
+    bytes_ -= bytes;
+    writing_.clear ();
+    return bytes;
+}
+
+SendQueue::Stats
+SendQueue::getStats (Lane lane) const
+{
+    auto const& state = lanes_[static_cast <std::size_t> (lane)];
+    Stats stats;
+    stats.messages = state.messages.load ();
+    stats.bytes = state.bytes.load ();
+    stats.written = state.written.load ();
+    stats.delay = std::chrono::microseconds (state.delay.load ());
+    return stats;
+}
+
+} //
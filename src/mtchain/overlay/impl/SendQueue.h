@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_OVERLAY_SENDQUEUE_H_INCLUDED
+#define MTCHAIN_OVERLAY_SENDQUEUE_H_INCLUDED
+
+#include <mtchain/overlay/Message.h>
+#include <mtchain/overlay/impl/TrafficCount.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace mtchain {
+
+/** The messages waiting to be written to a peer.
+
+    Messages wait in lanes chosen by their traffic category: consensus,
+    then transactions, then ledger data, then peer discovery. The lanes
+    are drained by deficit round robin. Each round visits the lanes in
+    order and a lane may send its weight in quanta of bytes. A write
+    takes no more than what is left of the current round, so a backlog
+    of ledger data holds a validation back for about one round while
+    the lower lanes still make steady progress. A turn cut short by a
+    full write resumes on the next call.
+
+    Not thread safe, the owner serializes access. The statistics may be
+    read from any thread.
+*/
+class SendQueue
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum class Lane
+    {
+        consensus,
+        transaction,
+        ledger,
+        discovery
+    };
+
+    static std::size_t const lanes = 4;
+
+    struct Entry
+    {
+        Message::pointer message;
+        std::size_t size;
+        Lane lane;
+        clock_type::time_point queued;
+    };
+
+    struct Stats
+    {
+        std::size_t messages;           // waiting, not in flight
+        std::size_t bytes;
+        std::uint64_t written;
+        std::chrono::microseconds delay;  // time spent queued, smoothed
+    };
+
+    SendQueue () = default;
+    SendQueue (SendQueue const&) = delete;
+    SendQueue& operator= (SendQueue const&) = delete;
+
+    /** Returns the lane for a traffic category. */
+    static
+    Lane
+    getLane (TrafficCount::category category);
+
+    static
+    char const*
+    getName (Lane lane);
+
+    /** Queue a message taking `size` bytes on the wire. */
+    void
+    push (Message::pointer const& m, std::size_t size,
+        clock_type::time_point now);
+
+    /** Choose the next messages to write.
+
+        At least one message is chosen when any are waiting. The choice
+        ends with the current round, and no more than `maxMessages` are
+        chosen, nor more than `maxBytes` unless the first is larger. The chosen messages are in flight until
+        onWritten is called.
+    */
+    std::vector <Entry> const&
+    next (std::size_t maxMessages, std::size_t maxBytes);
+
+    /** Record that the messages in flight were written.
+        @return The number of bytes written.
+    */
+    std::size_t
+    onWritten (clock_type::time_point now);
+
+    /** Returns the messages in flight. */
+    std::vector <Entry> const&
+    writing () const
+    {
+        return writing_;
+    }
+
+    /** Returns `true` if no messages are waiting or in flight. */
+    bool
+    empty () const
+    {
+        return size_ == 0;
+    }
+
+    /** Returns the messages waiting or in flight. */
+    std::size_t
+    size () const
+    {
+        return size_;
+    }
+
+    /** Returns the bytes waiting or in flight. */
+    std::size_t
+    bytes () const
+    {
+        return bytes_;
+    }
+
+    Stats
+    getStats (Lane lane) const;
+
+private:
+    struct LaneState
+    {
+        std::deque <Entry> queue;
+        std::size_t deficit = 0;
+
+        std::atomic <std::size_t> messages {0};
+        std::atomic <std::size_t> bytes {0};
+        std::atomic <std::uint64_t> written {0};
+        std::atomic <std::chrono::microseconds::rep> delay {0};
+    };
+
+    std::array <LaneState, lanes> lanes_;
+    std::vector <Entry> writing_;
+    std::size_t current_ = 0;       // the lane whose turn it is
+    bool credited_ = false;         // current_ had its quantum this turn
+    std::size_t waiting_ = 0;
+    std::size_t size_ = 0;
+    std::size_t bytes_ = 0;
+};
+
+} //
+
+#endif
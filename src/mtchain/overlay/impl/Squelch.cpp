@@ -0,0 +1,265 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/Squelch.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <mtchain/basics/random.h>
+
+namespace mtchain {
+
+namespace squelch {
+
+Squelch::Squelch (clock_type& clock)
+    : clock_ (clock)
+{
+}
+
+bool
+Squelch::addSquelch (PublicKey const& validator,
+    std::chrono::seconds duration)
+{
+    if (duration <= std::chrono::seconds (0) ||
+            duration > std::chrono::seconds (Tuning::squelchMaxSeconds))
+        return false;
+
+    auto const now = clock_.now ();
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    // Lapsed entries are otherwise only removed when looked up
+    for (auto iter = squelched_.begin (); iter != squelched_.end ();)
+    {
+        if (iter->second <= now)
+            iter = squelched_.erase (iter);
+        else
+            ++iter;
+    }
+    squelched_[validator] = now + duration;
+    return true;
+}
+
+void
+Squelch::removeSquelch (PublicKey const& validator)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    squelched_.erase (validator);
+}
+
+bool
+Squelch::isSquelched (PublicKey const& validator)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const iter = squelched_.find (validator);
+    if (iter == squelched_.end ())
+        return false;
+    if (iter->second > clock_.now ())
+        return true;
+    squelched_.erase (iter);
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+Slots::Slots (SquelchHandler& handler, clock_type& clock)
+    : handler_ (handler)
+    , clock_ (clock)
+{
+}
+
+void
+Slots::update (PublicKey const& validator, Peer::id_t id, bool unique)
+{
+    std::vector <Action> actions;
+    {
+        auto const now = clock_.now ();
+        std::lock_guard <std::mutex> lock (mutex_);
+        auto& slot = slots_[validator];
+        slot.stats.validator = validator;
+        slot.lastMessage = now;
+        ++slot.stats.messages;
+        if (! unique)
+            ++slot.stats.duplicates;
+
+        auto& peer = slot.peers[id];
+        peer.lastMessage = now;
+
+        if (slot.selected)
+        {
+            // A new peer, or one whose squelch lapsed
+            if (! peer.selected && peer.squelchedUntil <= now)
+                squelchPeer (slot, peer, id, now, actions);
+        }
+        else if (++peer.count == Tuning::squelchMessageThreshold)
+        {
+            peer.selected = true;
+            if (++slot.candidates == Tuning::squelchSelectedPeers)
+            {
+                slot.selected = true;
+                slot.selectedAt = now;
+                for (auto& other : slot.peers)
+                {
+                    if (! other.second.selected)
+                        squelchPeer (slot, other.second,
+                            other.first, now, actions);
+                }
+            }
+        }
+    }
+    perform (actions);
+}
+
+void
+Slots::onRelay (PublicKey const& validator,
+    std::size_t sent, std::size_t suppressed)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const iter = slots_.find (validator);
+    if (iter == slots_.end ())
+        return;
+    iter->second.stats.relayed += sent;
+    iter->second.stats.suppressed += suppressed;
+}
+
+void
+Slots::deletePeer (Peer::id_t id)
+{
+    std::vector <Action> actions;
+    {
+        auto const now = clock_.now ();
+        std::lock_guard <std::mutex> lock (mutex_);
+        for (auto& entry : slots_)
+        {
+            auto& slot = entry.second;
+            auto const iter = slot.peers.find (id);
+            if (iter == slot.peers.end ())
+                continue;
+            bool const selected = iter->second.selected;
+            slot.peers.erase (iter);
+            if (! selected)
+                continue;
+            if (slot.selected)
+                reset (slot, now, actions);
+            else
+                --slot.candidates;
+        }
+    }
+    perform (actions);
+}
+
+void
+Slots::expire ()
+{
+    using namespace std::chrono;
+    std::vector <Action> actions;
+    {
+        auto const now = clock_.now ();
+        auto const idle = seconds (Tuning::squelchIdleSeconds);
+        auto const lapse = seconds (Tuning::squelchMaxSeconds);
+        std::lock_guard <std::mutex> lock (mutex_);
+        for (auto iter = slots_.begin (); iter != slots_.end ();)
+        {
+            auto& slot = iter->second;
+            if (slot.selected)
+            {
+                bool drop = now - slot.selectedAt >= lapse;
+                for (auto const& peer : slot.peers)
+                {
+                    if (peer.second.selected &&
+                            now - peer.second.lastMessage > idle)
+                        drop = true;
+                }
+                if (drop)
+                    reset (slot, now, actions);
+            }
+            else if (now - slot.lastMessage > lapse)
+            {
+                // The validator went silent
+                iter = slots_.erase (iter);
+                continue;
+            }
+            ++iter;
+        }
+    }
+    perform (actions);
+}
+
+std::vector <Slots::Stats>
+Slots::getStats () const
+{
+    auto const now = clock_.now ();
+    std::lock_guard <std::mutex> lock (mutex_);
+    std::vector <Stats> result;
+    result.reserve (slots_.size ());
+    for (auto const& entry : slots_)
+    {
+        auto const& slot = entry.second;
+        result.push_back (slot.stats);
+        auto& stats = result.back ();
+        stats.selected = slot.selected;
+        stats.peers = slot.peers.size ();
+        for (auto const& peer : slot.peers)
+        {
+            if (peer.second.selected)
+                ++stats.selectedPeers;
+            if (peer.second.squelchedUntil > now)
+                ++stats.squelchedPeers;
+        }
+    }
+    return result;
+}
+
+void
+Slots::squelchPeer (Slot& slot, PeerState& peer, Peer::id_t id,
+    clock_type::time_point now, std::vector <Action>& actions)
+{
+    // Spread out the moment squelched peers resume relaying
+    std::chrono::seconds const duration (rand_int <int> (
+        Tuning::squelchMinSeconds, Tuning::squelchMaxSeconds));
+    peer.squelchedUntil = now + duration;
+    ++slot.stats.squelches;
+    actions.push_back ({ slot.stats.validator, id, duration });
+}
+
+void
+Slots::reset (Slot& slot, clock_type::time_point now,
+    std::vector <Action>& actions)
+{
+    for (auto& entry : slot.peers)
+    {
+        auto& peer = entry.second;
+        if (peer.squelchedUntil > now)
+        {
+            ++slot.stats.unsquelches;
+            actions.push_back ({ slot.stats.validator, entry.first,
+                std::chrono::seconds (0) });
+        }
+        peer.count = 0;
+        peer.selected = false;
+        peer.squelchedUntil = {};
+    }
+    slot.selected = false;
+    slot.candidates = 0;
+}
+
+void
+Slots::perform (std::vector <Action> const& actions)
+{
+    for (auto const& action : actions)
+    {
+        if (action.duration.count () != 0)
+            handler_.squelch (action.validator, action.id, action.duration);
+        else
+            handler_.unsquelch (action.validator, action.id);
+    }
+}
+
+} // squelch
+
+} //
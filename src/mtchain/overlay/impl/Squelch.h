@@ -0,0 +1,181 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_OVERLAY_SQUELCH_H_INCLUDED
+#define MTCHAIN_OVERLAY_SQUELCH_H_INCLUDED
+
+#include <mtchain/basics/chrono.h>
+#include <mtchain/basics/UnorderedContainers.h>
+#include <mtchain/overlay/Peer.h>
+#include <mtchain/protocol/PublicKey.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace mtchain {
+
+namespace squelch {
+
+using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+/** Validators whose messages a peer asked us not to relay to it.
+
+    Each squelch lapses on its own after the requested duration, so a
+    lost unsquelch request never silences a validator for good.
+*/
+class Squelch
+{
+public:
+    explicit
+    Squelch (clock_type& clock);
+
+    /** Stop relaying a validator's messages to the peer.
+        @return `false` if the duration is out of range.
+    */
+    bool
+    addSquelch (PublicKey const& validator,
+        std::chrono::seconds duration);
+
+    /** Resume relaying a validator's messages to the peer. */
+    void
+    removeSquelch (PublicKey const& validator);
+
+    /** Returns `true` if the validator's messages should not be relayed. */
+    bool
+    isSquelched (PublicKey const& validator);
+
+private:
+    clock_type& clock_;
+    std::mutex mutex_;
+    hash_map <PublicKey, clock_type::time_point> squelched_;
+};
+
+//------------------------------------------------------------------------------
+
+/** Sends squelch requests on behalf of Slots. */
+class SquelchHandler
+{
+public:
+    virtual ~SquelchHandler() = default;
+
+    /** Ask a peer to stop relaying a validator's messages. */
+    virtual
+    void
+    squelch (PublicKey const& validator, Peer::id_t id,
+        std::chrono::seconds duration) = 0;
+
+    /** Ask a peer to resume relaying a validator's messages. */
+    virtual
+    void
+    unsquelch (PublicKey const& validator, Peer::id_t id) = 0;
+};
+
+/** Chooses which peers keep relaying each validator's messages.
+
+    Every peer relaying a validator is counted until enough of them
+    have each delivered Tuning::squelchMessageThreshold messages. Those
+    peers are selected and the rest are asked to squelch the validator
+    for a random duration. The selection is dropped, and the squelched
+    peers released, when a selected peer disconnects or goes idle, or
+    once the longest squelch has lapsed.
+*/
+class Slots
+{
+public:
+    /** Relay counters for one validator. */
+    struct Stats
+    {
+        PublicKey validator;
+        bool selected = false;
+        std::size_t peers = 0;
+        std::size_t selectedPeers = 0;
+        std::size_t squelchedPeers = 0;
+
+        std::uint64_t messages = 0;     // received from any peer
+        std::uint64_t duplicates = 0;   // received, already seen
+        std::uint64_t relayed = 0;      // sent to peers
+        std::uint64_t suppressed = 0;   // not sent, squelched by the peer
+        std::uint64_t squelches = 0;    // squelch requests sent
+        std::uint64_t unsquelches = 0;  // unsquelch requests sent
+    };
+
+    Slots (SquelchHandler& handler, clock_type& clock);
+
+    /** Record a validator's message received from a peer.
+        @param unique `false` if another peer already delivered it.
+    */
+    void
+    update (PublicKey const& validator, Peer::id_t id, bool unique);
+
+    /** Record how many peers a validator's message was relayed to. */
+    void
+    onRelay (PublicKey const& validator,
+        std::size_t sent, std::size_t suppressed);
+
+    /** Forget a disconnected peer. */
+    void
+    deletePeer (Peer::id_t id);
+
+    /** Drop idle and lapsed selections. Called periodically. */
+    void
+    expire ();
+
+    std::vector <Stats>
+    getStats () const;
+
+private:
+    struct PeerState
+    {
+        std::size_t count = 0;
+        bool selected = false;
+        clock_type::time_point lastMessage;
+        clock_type::time_point squelchedUntil;
+    };
+
+    struct Slot
+    {
+        hash_map <Peer::id_t, PeerState> peers;
+        bool selected = false;
+        std::size_t candidates = 0;
+        clock_type::time_point selectedAt;
+        clock_type::time_point lastMessage;
+        Stats stats;
+    };
+
+    struct Action
+    {
+        PublicKey validator;
+        Peer::id_t id;
+        std::chrono::seconds duration;   // zero to unsquelch
+    };
+
+    void
+    squelchPeer (Slot& slot, PeerState& peer, Peer::id_t id,
+        clock_type::time_point now, std::vector <Action>& actions);
+
+    void
+    reset (Slot& slot, clock_type::time_point now,
+        std::vector <Action>& actions);
+
+    void
+    perform (std::vector <Action> const& actions);
+
+    SquelchHandler& handler_;
+    clock_type& clock_;
+    std::mutex mutable mutex_;
+    hash_map <PublicKey, Slot> slots_;
+};
+
+} // squelch
+
+} //
+
+#endif
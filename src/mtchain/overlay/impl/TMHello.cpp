@@ -212,6 +212,24 @@ parse_ProtocolVersions(boost::string_ref const& value)
     return result;
 }
 
+std::string
+makeProtocolVersions ()
+{
+    auto const& minimum = BuildInfo::getMinimumProtocol ();
+    auto const& current = BuildInfo::getCurrentProtocol ();
+    std::string result = "RTXP/" + to_string (minimum);
+    if (current != minimum)
+        result += ", RTXP/" + to_string (current);
+    return result;
+}
+
+ProtocolVersion
+negotiateProtocolVersion (protocol::TMHello const& hello)
+{
+    return std::min (BuildInfo::make_protocol (hello.protoversion ()),
+        BuildInfo::getCurrentProtocol ());
+}
+
 boost::optional<protocol::TMHello>
 parseHello (bool request, beast::http::fields const& h, beast::Journal journal)
 {
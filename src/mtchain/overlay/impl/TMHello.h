@@ -77,6 +77,17 @@ verifyHello (protocol::TMHello const& h, uint256 const& sharedValue,
 std::vector<ProtocolVersion>
 parse_ProtocolVersions(boost::string_ref const& s);
 
+/** Returns the protocol versions we speak, as an Upgrade field value. */
+std::string
+makeProtocolVersions ();
+
+/** Returns the protocol version spoken with a peer.
+    The peer's hello holds the highest version it offered, or the one
+    it selected from our offer.
+*/
+ProtocolVersion
+negotiateProtocolVersion (protocol::TMHello const& hello);
+
 }
 
 #endif
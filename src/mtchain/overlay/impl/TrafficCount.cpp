@@ -57,10 +57,12 @@ TrafficCount::category TrafficCount::categorize (
     if ((type == protocol::mtMANIFESTS) ||
             (type == protocol::mtENDPOINTS) ||
             (type == protocol::mtPEERS) ||
-            (type == protocol::mtGET_PEERS))
+            (type == protocol::mtGET_PEERS) ||
+            (type == protocol::mtSQUELCH))
         return TrafficCount::category::CT_overlay;
 
-    if (type == protocol::mtTRANSACTION)
+    if ((type == protocol::mtTRANSACTION) ||
+            (type == protocol::mtTRANSACTIONS))
         return TrafficCount::category::CT_transaction;
 
     if (type == protocol::mtVALIDATION)
@@ -29,18 +29,27 @@ public:
     {
         public:
 
+        // Bytes on the wire, after any compression
         count_t bytesIn;
         count_t bytesOut;
+
+        // Bytes before compression
+        count_t rawBytesIn;
+        count_t rawBytesOut;
+
         count_t messagesIn;
         count_t messagesOut;
 
         TrafficStats() : bytesIn(0), bytesOut(0),
+            rawBytesIn(0), rawBytesOut(0),
             messagesIn(0), messagesOut(0)
         { ; }
 
         TrafficStats(const TrafficStats& ts)
             : bytesIn (ts.bytesIn.load())
             , bytesOut (ts.bytesOut.load())
+            , rawBytesIn (ts.rawBytesIn.load())
+            , rawBytesOut (ts.rawBytesOut.load())
             , messagesIn (ts.messagesIn.load())
             , messagesOut (ts.messagesOut.load())
         { ; }
@@ -72,16 +81,22 @@ public:
         ::google::protobuf::Message const& message,
         int type, bool inbound);
 
-    void addCount (category cat, bool inbound, int number)
+    /** Account for one message.
+        @param number The bytes sent or received.
+        @param raw The bytes without compression, header included.
+    */
+    void addCount (category cat, bool inbound, int number, int raw)
     {
         if (inbound)
         {
             counts_[cat].bytesIn += number;
+            counts_[cat].rawBytesIn += raw;
             ++counts_[cat].messagesIn;
         }
         else
         {
             counts_[cat].bytesOut += number;
+            counts_[cat].rawBytesOut += raw;
             ++counts_[cat].messagesOut;
         }
     }
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/TrafficHistograms.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace mtchain {
+
+void
+TrafficHistograms::onMessage (TrafficCount::category cat,
+    std::size_t size, clock_type::time_point now)
+{
+    auto& h = categories_[static_cast <std::size_t> (cat)];
+    h.size.record (size);
+
+    auto const last = h.last.exchange (
+        now.time_since_epoch ().count (), std::memory_order_relaxed);
+    if (last != 0 && now.time_since_epoch ().count () > last)
+    {
+        h.interarrival.record (std::chrono::duration_cast <
+            std::chrono::microseconds> (now - clock_type::time_point (
+                clock_type::duration (last))).count ());
+    }
+}
+
+void
+TrafficHistograms::onProcessed (TrafficCount::category cat,
+    std::chrono::microseconds elapsed)
+{
+    categories_[static_cast <std::size_t> (cat)].processing.record (
+        std::max <std::chrono::microseconds::rep> (elapsed.count (), 0));
+}
+
+Json::Value
+TrafficHistograms::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    for (std::size_t i = 0; i < static_cast <std::size_t> (
+        TrafficCount::category::CT_unknown); ++i)
+    {
+        auto const& h = categories_[i];
+        if (h.size.count () == 0)
+            continue;
+        auto& entry = ret[TrafficCount::getName (
+            static_cast <TrafficCount::category> (i))];
+        entry[jss::size] = h.size.getJson ();
+        entry[jss::interarrival] = h.interarrival.getJson ();
+        entry[jss::processing] = h.processing.getJson ();
+    }
+    return ret;
+}
+
+} //
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_OVERLAY_TRAFFICHISTOGRAMS_H_INCLUDED
+#define MTCHAIN_OVERLAY_TRAFFICHISTOGRAMS_H_INCLUDED
+
+#include <mtchain/core/Histogram.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/overlay/impl/TrafficCount.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace mtchain {
+
+/** Distributions of the messages received, by traffic category.
+
+    For each category this records the message sizes in bytes, the time
+    between consecutive messages and the time taken to process each one,
+    both in microseconds.
+*/
+class TrafficHistograms
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    struct Histograms
+    {
+        Histogram size;
+        Histogram interarrival;
+        Histogram processing;
+        std::atomic <clock_type::rep> last {0};
+    };
+
+    Histograms const&
+    operator[] (TrafficCount::category cat) const
+    {
+        return categories_[static_cast <std::size_t> (cat)];
+    }
+
+    /** Record a message of `size` bytes arriving at `now`. */
+    void
+    onMessage (TrafficCount::category cat, std::size_t size,
+        clock_type::time_point now);
+
+    /** Record the time taken to process a message. */
+    void
+    onProcessed (TrafficCount::category cat,
+        std::chrono::microseconds elapsed);
+
+    /** Returns the histograms of the categories that saw traffic. */
+    Json::Value
+    getJson () const;
+
+private:
+    std::array <Histograms,
+        static_cast <std::size_t> (TrafficCount::category::CT_unknown) + 1>
+            categories_;
+};
+
+} //
+
+#endif
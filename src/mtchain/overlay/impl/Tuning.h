@@ -57,11 +57,77 @@ enum
     /** How many timer intervals we can go without a ping reply */
     noPing              =   10,
 
-    /** How many messages on a send queue before we refuse queries */
-    dropSendQueue       =    8,
+    /** How many bytes on a send queue before we refuse queries */
+    dropSendQueueBytes  = 1024 * 1024,
 
-    /** How many messages we consider reasonable sustained on a send queue */
-    targetSendQueue     =   16,
+    /** How many bytes we consider reasonable sustained on a send queue */
+    targetSendQueueBytes = 2 * 1024 * 1024,
+
+    /** How many bytes on a send queue before we disconnect */
+    maxSendQueueBytes   = 64 * 1024 * 1024,
+
+    /** The most messages gathered into a single write */
+    writeBatchMessages  =   64,
+
+    /** The most bytes gathered into a single write, unless
+        the first message is larger */
+    writeBatchBytes     = 256 * 1024,
+
+    /** Bytes a send queue lane may write per round for each
+        unit of its weight */
+    sendLaneQuantum     = 4096,
+
+    /** Relative shares of a busy connection given to each send
+        queue lane */
+    consensusLaneWeight =    8,
+    transactionLaneWeight =  4,
+    ledgerLaneWeight    =    2,
+    discoveryLaneWeight =    1,
+
+    /** How many object queries may wait for a job before
+        more are refused */
+    maxObjectQueryJobs  =   16,
+
+    /** How long an object query may go unanswered before it
+        counts against the peer (seconds) */
+    objectQueryTimeout  =    8,
+
+    /** Smallest message payload worth compressing */
+    compressionMinimumBytes = 70,
+
+    /** Largest compressed payload, once decompressed, of messages
+        other than ledger data and objects */
+    compressionMaximumBytes = 4 * 1024 * 1024,
+
+    /** How many messages a peer must relay from a validator
+        before it is selected as a source for that validator */
+    squelchMessageThreshold = 20,
+
+    /** How many peers keep relaying a validator once the
+        others are squelched */
+    squelchSelectedPeers =    5,
+
+    /** Range of squelch durations requested from peers (seconds) */
+    squelchMinSeconds   =  300,
+    squelchMaxSeconds   =  600,
+
+    /** How long a selected peer can go without relaying
+        a validator before the selection is dropped (seconds) */
+    squelchIdleSeconds  =    8,
+
+    /** The most transactions relayed in a single batch */
+    txBatchMaxTransactions = 256,
+
+    /** How many bytes of transactions fill a batch */
+    txBatchBytes        = 64 * 1024,
+
+    /** How long a transaction waits for its batch to fill
+        (milliseconds) */
+    txBatchMilliseconds =   50,
+
+    /** How many recently built batches are kept for
+        other peers sending the same transactions */
+    txBatchShared       =   16,
 };
 
 } // Tuning
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/TxBatch.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <boost/functional/hash.hpp>
+
+namespace mtchain {
+
+bool
+TxBatch::add (std::shared_ptr<protocol::TMTransaction const> const& tx,
+    clock_type::time_point now)
+{
+    if (txs_.empty())
+        deadline_ = now + std::chrono::milliseconds (
+            Tuning::txBatchMilliseconds);
+    txs_.push_back (tx);
+    bytes_ += tx->rawtransaction().size();
+    return txs_.size() >= Tuning::txBatchMaxTransactions ||
+        bytes_ >= Tuning::txBatchBytes;
+}
+
+auto
+TxBatch::take () -> list_type
+{
+    list_type txs;
+    txs.swap (txs_);
+    bytes_ = 0;
+    return txs;
+}
+
+std::shared_ptr<Message>
+TxBatch::makeMessage (list_type const& txs)
+{
+    if (txs.size() == 1)
+        return std::make_shared<Message> (
+            *txs.front(), protocol::mtTRANSACTION);
+
+    protocol::TMTransactions batch;
+    for (auto const& tx : txs)
+        batch.add_transactions()->CopyFrom (*tx);
+    return std::make_shared<Message> (batch, protocol::mtTRANSACTIONS);
+}
+
+std::size_t
+TxBatch::hash (list_type const& txs)
+{
+    std::size_t seed = 0;
+    for (auto const& tx : txs)
+        boost::hash_combine (seed, tx.get());
+    return seed;
+}
+
+} //
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_OVERLAY_TXBATCH_H_INCLUDED
+#define MTCHAIN_OVERLAY_TXBATCH_H_INCLUDED
+
+#include <mtchain/overlay/Message.h>
+#include "mtchain.pb.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace mtchain {
+
+/** Relayed transactions waiting to be sent to a peer together.
+
+    A batch is sent once it holds Tuning::txBatchMaxTransactions
+    transactions or Tuning::txBatchBytes bytes of them, or once its first
+    transaction has waited Tuning::txBatchMilliseconds. The owner keeps
+    the timer and serializes access.
+*/
+class TxBatch
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using list_type = std::vector<
+        std::shared_ptr<protocol::TMTransaction const>>;
+
+    /** Add a transaction to the batch.
+
+        @return `true` if the batch is full and should be sent now.
+    */
+    bool
+    add (std::shared_ptr<protocol::TMTransaction const> const& tx,
+        clock_type::time_point now);
+
+    /** Returns the time by which the batch should be sent.
+
+        Only valid if the batch is not empty.
+    */
+    clock_type::time_point
+    deadline () const
+    {
+        return deadline_;
+    }
+
+    std::size_t
+    size () const
+    {
+        return txs_.size();
+    }
+
+    bool
+    empty () const
+    {
+        return txs_.empty();
+    }
+
+    /** Remove and return the transactions, oldest first. */
+    list_type
+    take ();
+
+    /** Returns the message carrying a batch.
+
+        A batch of one is sent as a plain transaction message, since
+        nothing is saved by wrapping it.
+    */
+    static
+    std::shared_ptr<Message>
+    makeMessage (list_type const& txs);
+
+    /** Returns a hash of the transactions in a batch.
+
+        Relayed transactions are shared by all the peers, so batches
+        holding the same transactions hash alike.
+    */
+    static
+    std::size_t
+    hash (list_type const& txs);
+
+private:
+    list_type txs_;
+    std::size_t bytes_ = 0;
+    clock_type::time_point deadline_;
+};
+
+/** Visit the transactions of a batch received from a peer.
+
+    Each transaction costs as much as one sent alone. `charge` is called
+    after every transaction but the last, which is charged with the
+    message as a whole, and returns `false` once the peer should be
+    disconnected.
+
+    @return `false` if the batch was abandoned part way.
+*/
+template <class Receive, class Charge>
+bool
+receiveTransactions (protocol::TMTransactions const& m,
+    Receive&& receive, Charge&& charge)
+{
+    auto const count = m.transactions_size();
+    for (int i = 0; i < count; ++i)
+    {
+        receive (m.transactions (i));
+        if (i + 1 != count && ! charge ())
+            return false;
+    }
+    return true;
+}
+
+} //
+
+#endif
@@ -89,14 +89,17 @@ JSS ( binary );                     // in: AccountTX, LedgerEntry,
 JSS ( books );                      // in: Subscribe, Unsubscribe
 JSS ( both );                       // in: Subscribe, Unsubscribe
 JSS ( both_sides );                 // in: Subscribe, Unsubscribe
+JSS ( buckets );                    // out: TrafficHistograms
 JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
+JSS ( bytes );                      // out: LedgerHandles
 JSS ( cancel_after );               // out: AccountChannels
 JSS ( can_delete );                 // out: CanDelete
 JSS ( channel_id );                 // out: AccountChannels
 JSS ( channels );                   // out: AccountChannels
 JSS ( check_nodes );                // in: LedgerCleaner
 JSS ( clear );                      // in/out: FetchInfo
+JSS ( clients );                    // out: LedgerHandles
 JSS ( close_flags );                // out: LedgerToJson
 JSS ( close_time );                 // in: Application, out: NetworkOPs,
                                     //      LedgerProposal, LedgerToJson
@@ -112,6 +115,7 @@ JSS ( code );                       // out: errors
 JSS ( command );                    // in: RPCHandler
 JSS ( complete );                   // out: NetworkOPs, InboundLedger
 JSS ( complete_ledgers );           // out: NetworkOPs, PeerImp
+JSS ( compression );                // out: PeerImp
 JSS ( consensus );                  // out: NetworkOPs, LedgerConsensus
 JSS ( converge_time );              // out: NetworkOPs
 JSS ( converge_time_s );            // out: NetworkOPs
@@ -141,6 +145,7 @@ JSS ( dir_index );                  // out: DirectoryEntryIterator
 JSS ( dir_root );                   // out: DirectoryEntryIterator
 JSS ( directory );                  // in: LedgerEntry
 JSS ( drops );                      // out: TxQ
+JSS ( dropped );                    // out: MethodStats
 JSS ( duration_us );                // out: NetworkOPs
 JSS ( enabled );                    // out: AmendmentTable
 JSS ( engine_result );              // out: NetworkOPs, TransactionSign, Submit
@@ -150,6 +155,7 @@ JSS ( error );                      // out: error
 JSS ( error_code );                 // out: error
 JSS ( error_exception );            // out: Submit
 JSS ( error_message );              // out: error
+JSS ( events );                     // out: NetworkOPs
 JSS ( expand );                     // in: handler/Ledger
 JSS ( expected_ledger_size );       // out: TxQ
 JSS ( expiration );                 // out: AccountOffers, AccountChannels
@@ -177,6 +183,7 @@ JSS ( full_reply );                 // out: PathFind
 JSS ( fullbelow_size );             // in: GetCounts
 JSS ( generator );                  // in: LedgerEntry
 JSS ( good );                       // out: RPCVersion
+JSS ( handles );                    // out: LedgerHandles
 JSS ( hash );                       // out: NetworkOPs, InboundLedger,
                                     //      LedgerToJson, STTx; field
 JSS ( hashes );                     // in: AccountObjects
@@ -196,6 +203,7 @@ JSS ( index );                      // in: LedgerEntry; out: PathState,
                                     //     TxHistory, LedgerData;
                                     // field
 JSS ( info );                       // out: ServerInfo, ConsensusInfo, FetchInfo
+JSS ( interarrival );               // out: TrafficHistograms
 JSS ( internal_command );           // in: Internal
 JSS ( io_latency_ms );              // out: NetworkOPs
 JSS ( ip );                         // in: Connect, out: OverlayImpl
@@ -205,15 +213,22 @@ JSS ( issuer );                     // in: MTChainPathFind, Subscribe,
 JSS ( jsonrpc );                    // json version
 JSS ( key );                        // out: WalletSeed
 JSS ( key_type );                   // in/out: WalletPropose, TransactionSign
-JSS ( latency );                    // out: PeerImp
+JSS ( lag_max_us );                 // out: NetworkOPs
+JSS ( lag_us );                     // out: NetworkOPs
+JSS ( latency );                    // out: PeerImp, FetchPipeline
 JSS ( last );                       // out: RPCVersion
 JSS ( last_close );                 // out: NetworkOPs
+JSS ( last_rotated );               // out: SHAMapStoreImp
 JSS ( ledger );                     // in: NetworkOPs, LedgerCleaner,
                                     //     RPCHelpers
                                     // out: NetworkOPs, PeerImp
+JSS ( ledger_batch );               // in: Subscribe
 JSS ( ledger_current_index );       // out: NetworkOPs, RPCHelpers,
                                     //      LedgerCurrent, LedgerAccept
 JSS ( ledger_data );                // out: LedgerHeader
+JSS ( ledger_handle );              // in: RPCHelpers, LedgerHandle
+                                    // out: LedgerHandle
+JSS ( ledger_handles );             // out: GetCounts
 JSS ( ledger_hash );                // in: RPCHelpers, LedgerRequest,
                                     //     MTChainPathFind, TransactionEntry,
                                     //     handlers/Ledger
@@ -259,17 +274,22 @@ JSS ( master_key );                 // out: WalletPropose
 JSS ( master_seed );                // out: WalletPropose
 JSS ( master_seed_hex );            // out: WalletPropose
 JSS ( master_signature );           // out: pubManifest
+JSS ( max );                        // out: TrafficHistograms
 JSS ( max_ledger );                 // in/out: LedgerCleaner
 JSS ( max_queue_size );             // out: TxQ
 JSS ( max_spend_drops );            // out: AccountInfo
 JSS ( max_spend_drops_total );      // out: AccountInfo
+JSS ( mean );                       // out: TrafficHistograms
 JSS ( median_fee );                 // out: TxQ
 JSS ( median_level );               // out: TxQ
 JSS ( message );                    // error.
+JSS ( messages );                   // out: NetworkOPs
+JSS ( messages_written );           // out: PeerImp
 JSS ( meta );                       // out: NetworkOPs, AccountTx*, Tx
 JSS ( metaData );
 JSS ( metadata );                   // out: TransactionEntry
 JSS ( method );                     // RPC
+JSS ( methods );                    // out: MethodStats
 JSS ( min_count );                  // in: GetCounts
 JSS ( min_ledger );                 // in: LedgerCleaner
 JSS ( minimum_fee );                // out: TxQ
@@ -290,16 +310,26 @@ JSS ( node_reads_total );           // out: GetCounts
 JSS ( node_writes );                // out: GetCounts
 JSS ( node_written_bytes );         // out: GetCounts
 JSS ( nodes );                      // out: PathState
+JSS ( nodes_copied );               // out: SHAMapStoreImp
+JSS ( nodes_per_second );           // out: SHAMapStoreImp, InboundLedger
+JSS ( nodes_skipped );              // out: SHAMapStoreImp
+JSS ( nodes_visited );              // out: SHAMapStoreImp
+JSS ( object_queries );             // out: PeerImp
 JSS ( obligations );                // out: GatewayBalances
 JSS ( offer );                      // in: LedgerEntry
 JSS ( offers );                     // out: NetworkOPs, AccountOffers, Subscribe
 JSS ( offline );                    // in: TransactionSign
 JSS ( offset );                     // in/out: AccountTxOld
+JSS ( online_delete );              // out: NetworkOPs
 JSS ( open );                       // out: handlers/Ledger
 JSS ( open_ledger_fee );            // out: TxQ
 JSS ( open_ledger_level );          // out: TxQ
+JSS ( outstanding );                // out: FetchPipeline
 JSS ( owner );                      // in: LedgerEntry, out: NetworkOPs
 JSS ( owner_funds );                // in/out: Ledger, NetworkOPs, AcceptedLedgerTx
+JSS ( p50 );                        // out: TrafficHistograms
+JSS ( p90 );                        // out: TrafficHistograms
+JSS ( p99 );                        // out: TrafficHistograms
 JSS ( params );                     // RPC
 JSS ( parent_close_time );          // out: LedgerToJson
 JSS ( parent_hash );                // out: LedgerToJson
@@ -313,8 +343,10 @@ JSS ( peer );                       // in: AccountLines
 JSS ( peer_authorized );            // out: AccountLines
 JSS ( peer_id );                    // out: LedgerProposal
 JSS ( peers );                      // out: InboundLedger, handlers/Peers, Overlay
+JSS ( pipeline );                   // out: InboundLedger
 JSS ( port );                       // in: Connect
 JSS ( previous_ledger );            // out: LedgerPropose
+JSS ( processing );                 // out: TrafficHistograms
 JSS ( proof );                      // in: BookOffers
 JSS ( propose_seq );                // out: LedgerPropose
 JSS ( proposers );                  // out: NetworkOPs, LedgerConsensus
@@ -334,8 +366,12 @@ JSS ( raw_meta );                   // out: AcceptedLedgerTx
 JSS ( receive_currencies );         // out: AccountCurrencies
 JSS ( reference_level );            // out: TxQ
 JSS ( regular_seed );               // in/out: LedgerEntry
+JSS ( release );                    // in: LedgerHandle
+JSS ( released );                   // out: LedgerHandle
 JSS ( remote );                     // out: Logic.h
+JSS ( replies );                    // out: QueryTracker
 JSS ( request );                    // RPC
+JSS ( requests );                   // out: FetchPipeline
 JSS ( reserve_base );               // out: NetworkOPs
 JSS ( reserve_base_fpa )   ;          // out: NetworkOPs
 JSS ( reserve_inc );                // out: NetworkOPs
@@ -355,7 +391,12 @@ JSS ( secret );                     // in: TransactionSign, WalletSeed,
 JSS ( seed );                       // in: WalletAccounts, out: WalletSeed
 JSS ( seed_hex );                   // in: WalletPropose, TransactionSign
 JSS ( send_currencies );            // out: AccountCurrencies
+JSS ( send_lanes );                 // out: PeerImp
 JSS ( send_max );                   // in: PathRequest, MTChainPathFind
+JSS ( send_latency );               // out: PeerImp
+JSS ( send_queue );                 // out: PeerImp
+JSS ( send_queue_bytes );           // out: PeerImp
+JSS ( send_queue_peak );            // out: PeerImp
 JSS ( seq );                        // in: LedgerEntry;
                                     // out: NetworkOPs, RPCSub, AccountOffers
 JSS ( seqNum );                     // out: LedgerToJson
@@ -369,6 +410,8 @@ JSS ( signing_key );                // out: NetworkOPs
 JSS ( signing_time );               // out: NetworkOPs
 JSS ( signer_list );                // in: AccountObjects
 JSS ( signer_lists );               // in/out: AccountInfo
+JSS ( slow );                       // out: MethodStats
+JSS ( slow_requests );              // out: MethodStats
 JSS ( snapshot );                   // in: Subscribe
 JSS ( source_account );             // in: PathRequest, MTChainPathFind
 JSS ( source_amount );              // in: PathRequest, MTChainPathFind
@@ -385,6 +428,7 @@ JSS ( streams );                    // in: Subscribe, Unsubscribe
 JSS ( strict );                     // in: AccountCurrencies, AccountInfo
 JSS ( sub_index );                  // in: LedgerEntry
 JSS ( subcommand );                 // in: PathFind
+JSS ( subscriptions );              // out: NetworkOPs
 JSS ( success );                    // rpc
 JSS ( supported );                  // out: AmendmentTableImpl
 JSS ( system_time_offset );         // out: NetworkOPs
@@ -396,8 +440,10 @@ JSS ( taker_pays );                 // in: Subscribe, Unsubscribe, BookOffers
 JSS ( taker_pays_funded );          // out: NetworkOPs
 JSS ( threshold );                  // in: Blacklist
 JSS ( ticket );                     // in: AccountObjects
+JSS ( time );                       // out: MethodStats
 JSS ( timeouts );                   // out: InboundLedger
 JSS ( traffic );                    // out: Overlay
+JSS ( ttl );                        // in/out: LedgerHandle
 JSS ( totalCoins );                 // out: LedgerToJson
 JSS ( total_coins );                // out: LedgerToJson
 JSS ( fee_pool );					// out: LedgerToJson
@@ -448,7 +494,9 @@ JSS ( version );                    // out: RPCVersion
 JSS ( vetoed );                     // out: AmendmentTableImpl
 JSS ( vote );                       // in: Feature
 JSS ( warning );                    // rpc:
+JSS ( watched );                    // out: NetworkOPs
 JSS ( write_load );                 // out: GetCounts
+JSS ( writes );                     // out: PeerImp
 JSS ( smart_contract );             // out: SmartContract
 JSS ( Payees );                     // in: TransactionSign
 JSS ( Payee );                      // in: TransactionSign
@@ -52,7 +52,7 @@ getCurrentProtocol ()
     // The protocol version we speak and prefer (edit this if necessary)
     //
         1,  // major
-        2   // minor
+        3   // minor
     //
     //--------------------------------------------------------------------------
     );
@@ -17,12 +17,15 @@
 #include <mtchain/rpc/Role.h>
 #include <mtchain/json/Output.h>
 #include <mtchain/beast/utility/Journal.h>
+#include <functional>
+#include <memory>
 
 namespace mtchain {
 
 class Application;
 class NetworkOPs;
 class LedgerMaster;
+class ReadView;
 
 namespace RPC {
 
@@ -38,6 +41,18 @@ struct Context
         std::string forwardedFor;
     };
 
+    /**
+     * The ledgers that "current", "closed" and "validated" name.
+     * Requests of a batch all see the ledgers of its start. A null
+     * ledger is looked up in the ledger master.
+     */
+    struct Ledgers
+    {
+        std::shared_ptr<ReadView const> current;
+        std::shared_ptr<ReadView const> closed;
+        std::shared_ptr<ReadView const> validated;
+    };
+
     beast::Journal j;
     Json::Value params;
     Application& app;
@@ -52,6 +67,10 @@ struct Context
     Json::Output *output;
     bool noReply;
     bool closeSess;
+    Ledgers ledgers;
+
+    /** Returns `true` once nobody will read the result. May be empty. */
+    std::function<bool (void)> stopped;
 };
 
 } // RPC
@@ -16,6 +16,10 @@
 #include <mtchain/rpc/Context.h>
 #include <mtchain/rpc/Status.h>
 
+namespace Json {
+class Object;
+}
+
 namespace mtchain {
 namespace RPC {
 
@@ -24,6 +28,24 @@ struct Context;
 /** Execute an RPC command and store the results in a Json::Value. */
 Status doCommand (RPC::Context&, Json::Value&);
 
+/** Execute an RPC command and write the results to a Json::Object.
+
+    The results are written as they are produced, by the commands for
+    which canWriteResult returns `true`. Exceptions thrown by the command
+    are not caught, since part of the results may be sent already.
+*/
+Status doCommand (RPC::Context&, Json::Object&);
+
+/** Returns `true` if the command can write its results as it goes. */
+bool canWriteResult (std::string const& method);
+
+/** Returns why the command in the context's parameters cannot run now.
+
+    This makes the checks of doCommand, on busy servers, permissions and
+    the state of the network and ledgers, without running the command.
+*/
+error_code_i checkCommand (RPC::Context&);
+
 /** Execute an RPC command and store the results in an std::string. */
 void executeRPC (RPC::Context&, std::string&);
 
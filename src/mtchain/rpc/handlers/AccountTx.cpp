@@ -9,61 +9,62 @@
 //==============================================================================
 
 #include <BeastConfig.h>
-#include <mtchain/app/ledger/LedgerMaster.h>
-#include <mtchain/app/main/Application.h>
-#include <mtchain/app/misc/NetworkOPs.h>
-#include <mtchain/app/misc/Transaction.h>
-#include <mtchain/json/json_value.h>
+#include <mtchain/rpc/handlers/AccountTx.h>
 #include <mtchain/ledger/ReadView.h>
 #include <mtchain/net/RPCErr.h>
 #include <mtchain/protocol/ErrorCodes.h>
-#include <mtchain/protocol/JsonFields.h>
-#include <mtchain/protocol/types.h>
 #include <mtchain/resource/Fees.h>
-#include <mtchain/rpc/Context.h>
-#include <mtchain/rpc/impl/RPCHelpers.h>
-#include <mtchain/rpc/Role.h>
 
 namespace mtchain {
+namespace RPC {
 
-// {
-//   account: account,
-//   ledger_index_min: ledger_index  // optional, defaults to earliest
-//   ledger_index_max: ledger_index, // optional, defaults to latest
-//   binary: boolean,                // optional, defaults to false
-//   forward: boolean,               // optional, defaults to false
-//   limit: integer,                 // optional
-//   marker: opaque                  // optional, resume previous query
-// }
-Json::Value doAccountTx (RPC::Context& context)
+AccountTxHandler::AccountTxHandler (Context& context) : context_ (context)
 {
-    auto& params = context.params;
+}
+
+Status AccountTxHandler::check ()
+{
+    auto& params = context_.params;
+
+    // Temporary switching code until the old account_tx is removed
+    if (params.isMember(jss::offset) ||
+        params.isMember(jss::count) ||
+        params.isMember(jss::descending) ||
+        params.isMember(jss::ledger_max) ||
+        params.isMember(jss::ledger_min))
+    {
+        isOld_ = true;
+        old_ = doAccountTxOld (context_);
+        if (! old_.isMember (jss::error))
+            return Status::OK;
+        return {error_code_i (old_[jss::error_code].asInt ()),
+            old_[jss::error_message].asString ()};
+    }
 
-    int limit = params.isMember (jss::limit) ?
+    limit_ = params.isMember (jss::limit) ?
             params[jss::limit].asUInt () : -1;
-    bool bBinary = params.isMember (jss::binary) && params[jss::binary].asBool ();
-    bool bForward = params.isMember (jss::forward) && params[jss::forward].asBool ();
-    std::uint32_t   uLedgerMin;
-    std::uint32_t   uLedgerMax;
+    binary_ = params.isMember (jss::binary) && params[jss::binary].asBool ();
+    forward_ = params.isMember (jss::forward) && params[jss::forward].asBool ();
     std::uint32_t   uValidatedMin;
     std::uint32_t   uValidatedMax;
-    bool bValidated = context.ledgerMaster.getValidatedRange (uValidatedMin, uValidatedMax);
+    bool bValidated = context_.ledgerMaster.getValidatedRange (uValidatedMin, uValidatedMax);
 
     if (!bValidated)
     {
         // Don't have a validated ledger range.
-        return rpcError (rpcLGR_IDXS_INVALID);
+        return rpcLGR_IDXS_INVALID;
     }
 
     if (!params.isMember (jss::account))
-        return rpcError (rpcINVALID_PARAMS);
+        return rpcINVALID_PARAMS;
 
     auto const account = parseBase58<AccountID>(
         params[jss::account].asString());
     if (! account)
-        return rpcError (rpcACT_MALFORMED);
+        return rpcACT_MALFORMED;
+    account_ = *account;
 
-    context.loadType = Resource::feeMediumBurdenRPC;
+    context_.loadType = Resource::feeMediumBurdenRPC;
 
     if (params.isMember (jss::ledger_index_min) ||
         params.isMember (jss::ledger_index_max))
@@ -73,115 +74,35 @@ Json::Value doAccountTx (RPC::Context& context)
         std::int64_t iLedgerMax  = params.isMember (jss::ledger_index_max)
                 ? params[jss::ledger_index_max].asInt () : -1;
 
-        uLedgerMin  = iLedgerMin == -1 ? uValidatedMin :
+        ledgerMin_  = iLedgerMin == -1 ? uValidatedMin :
             ((iLedgerMin >= uValidatedMin) ? iLedgerMin : uValidatedMin);
-        uLedgerMax  = iLedgerMax == -1 ? uValidatedMax :
+        ledgerMax_  = iLedgerMax == -1 ? uValidatedMax :
             ((iLedgerMax <= uValidatedMax) ? iLedgerMax : uValidatedMax);
 
-        if (uLedgerMax < uLedgerMin)
-            return rpcError (rpcLGR_IDXS_INVALID);
+        if (ledgerMax_ < ledgerMin_)
+            return rpcLGR_IDXS_INVALID;
     }
     else
     {
         std::shared_ptr<ReadView const> ledger;
-        auto ret = RPC::lookupLedger (ledger, context);
-
-        if (! ledger)
-            return ret;
+        Json::Value ret;
+        if (auto s = lookupLedger (ledger, context_, ret))
+            return s;
 
-	JLOG(context.j.warn()) << ledger->info().seq << " " << ret[jss::validated].asBool();
-        if (! ret[jss::validated].asBool() || !context.ledgerMaster.haveLedger(ledger->info().seq)           /*(ledger->info().seq > uValidatedMax) || (ledger->info().seq < uValidatedMin)*/)
+        if (! ret[jss::validated].asBool() ||
+            ! context_.ledgerMaster.haveLedger(ledger->info().seq))
         {
-            return rpcError (rpcLGR_NOT_VALIDATED);
+            return rpcLGR_NOT_VALIDATED;
         }
 
-        uLedgerMin = uLedgerMax = ledger->info().seq;
+        ledgerMin_ = ledgerMax_ = ledger->info().seq;
     }
 
-    Json::Value resumeToken;
-
     if (params.isMember(jss::marker))
-         resumeToken = params[jss::marker];
-
-#ifndef BEAST_DEBUG
-
-    try
-    {
-#endif
-        Json::Value ret (Json::objectValue);
-
-        ret[jss::account] = context.app.accountIDCache().toBase58(*account);
-        Json::Value& jvTxns = (ret[jss::transactions] = Json::arrayValue);
-
-        if (bBinary)
-        {
-            auto txns = context.netOps.getTxsAccountB (
-                *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                isUnlimited (context.role));
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                jvObj[jss::tx_blob] = std::get<0> (it);
-                jvObj[jss::meta] = std::get<1> (it);
-
-                std::uint32_t uLedgerIndex = std::get<2> (it);
-
-                jvObj[jss::ledger_index] = uLedgerIndex;
-                jvObj[jss::validated] = bValidated &&
-		  /*uValidatedMin <= uLedgerIndex &&
-		    uValidatedMax >= uLedgerIndex;*/
-		  context.ledgerMaster.haveLedger(uLedgerIndex);
-            }
-        }
-        else
-        {
-            auto txns = context.netOps.getTxsAccount (
-                *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                isUnlimited (context.role));
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                if (it.first)
-                    jvObj[jss::tx] = it.first->getJson (1);
-
-                if (it.second)
-                {
-                    auto meta = it.second->getJson (1);
-                    addPaymentDeliveredAmount (meta, context, it.first, it.second);
-                    jvObj[jss::meta] = std::move(meta);
-
-                    std::uint32_t uLedgerIndex = it.second->getLgrSeq ();
-
-                    jvObj[jss::validated] = bValidated &&
-		      /*uValidatedMin <= uLedgerIndex &&
-                        uValidatedMax >= uLedgerIndex;*/
-		      context.ledgerMaster.haveLedger(uLedgerIndex);
-                }
-
-            }
-        }
-
-        //Add information about the original query
-        ret[jss::ledger_index_min] = uLedgerMin;
-        ret[jss::ledger_index_max] = uLedgerMax;
-        if (params.isMember (jss::limit))
-            ret[jss::limit]        = limit;
-        if (resumeToken)
-            ret[jss::marker] = resumeToken;
-
-        return ret;
-#ifndef BEAST_DEBUG
-    }
-    catch (std::exception const&)
-    {
-        return rpcError (rpcINTERNAL);
-    }
+         resumeToken_ = params[jss::marker];
 
-#endif
+    return Status::OK;
 }
 
+} // RPC
 } //
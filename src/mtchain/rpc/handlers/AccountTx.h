@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_RPC_HANDLERS_ACCOUNTTX_H_INCLUDED
+#define MTCHAIN_RPC_HANDLERS_ACCOUNTTX_H_INCLUDED
+
+#include <mtchain/app/ledger/LedgerMaster.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/app/misc/NetworkOPs.h>
+#include <mtchain/app/misc/Transaction.h>
+#include <mtchain/json/Object.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/protocol/types.h>
+#include <mtchain/rpc/Context.h>
+#include <mtchain/rpc/Status.h>
+#include <mtchain/rpc/handlers/Handlers.h>
+#include <mtchain/rpc/impl/Handler.h>
+#include <mtchain/rpc/impl/RPCHelpers.h>
+#include <mtchain/rpc/Role.h>
+
+namespace mtchain {
+namespace RPC {
+
+// {
+//   account: account,
+//   ledger_index_min: ledger_index  // optional, defaults to earliest
+//   ledger_index_max: ledger_index, // optional, defaults to latest
+//   binary: boolean,                // optional, defaults to false
+//   forward: boolean,               // optional, defaults to false
+//   limit: integer,                 // optional
+//   marker: opaque                  // optional, resume previous query
+// }
+//
+// The transactions are read from the database a few at a time and each
+// is written as soon as it is converted.
+class AccountTxHandler
+{
+public:
+    explicit AccountTxHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static const char* const name()
+    {
+        return "account_tx";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NO_CONDITION;
+    }
+
+private:
+    Context& context_;
+
+    // The result of a request in the old style
+    Json::Value old_;
+    bool isOld_ = false;
+
+    AccountID account_;
+    std::uint32_t ledgerMin_ = 0;
+    std::uint32_t ledgerMax_ = 0;
+    Json::Value resumeToken_;
+    int limit_ = -1;
+    bool binary_ = false;
+    bool forward_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void AccountTxHandler::writeResult (Object& value)
+{
+    if (isOld_)
+    {
+        Json::copyFrom (value, old_);
+        return;
+    }
+
+    value[jss::account] = context_.app.accountIDCache().toBase58(account_);
+
+    auto const unlimited = isUnlimited (context_.role);
+
+    // Stop reading rows once nobody reads the result
+    auto const more = [this]
+    {
+        return ! context_.stopped || ! context_.stopped ();
+    };
+    {
+        auto&& jvTxns = Json::setArray (value, jss::transactions);
+        if (binary_)
+        {
+            context_.netOps.getTxsAccountRaw (
+                account_, ledgerMin_, ledgerMax_, forward_, resumeToken_,
+                limit_, unlimited,
+                [&](std::uint32_t ledgerIndex,
+                    Blob const& rawTxn, Blob const& rawMeta)
+                {
+                    Json::Value jvObj (Json::objectValue);
+
+                    jvObj[jss::tx_blob] = strHex (rawTxn);
+                    jvObj[jss::meta] = strHex (rawMeta);
+                    jvObj[jss::ledger_index] = ledgerIndex;
+                    jvObj[jss::validated] =
+                        context_.ledgerMaster.haveLedger(ledgerIndex);
+                    jvTxns.append (jvObj);
+                    return more ();
+                });
+        }
+        else
+        {
+            context_.netOps.getTxsAccount (
+                account_, ledgerMin_, ledgerMax_, forward_, resumeToken_,
+                limit_, unlimited,
+                [&](NetworkOPs::AccountTx const& it)
+                {
+                    Json::Value jvObj (Json::objectValue);
+
+                    if (it.first)
+                        jvObj[jss::tx] = it.first->getJson (1);
+
+                    if (it.second)
+                    {
+                        auto meta = it.second->getJson (1);
+                        addPaymentDeliveredAmount (
+                            meta, context_, it.first, it.second);
+                        jvObj[jss::meta] = std::move(meta);
+
+                        std::uint32_t uLedgerIndex = it.second->getLgrSeq ();
+
+                        jvObj[jss::validated] =
+                            context_.ledgerMaster.haveLedger(uLedgerIndex);
+                    }
+                    jvTxns.append (jvObj);
+                    return more ();
+                });
+        }
+    }
+
+    //Add information about the original query
+    value[jss::ledger_index_min] = ledgerMin_;
+    value[jss::ledger_index_max] = ledgerMax_;
+    if (context_.params.isMember (jss::limit))
+        value[jss::limit] = limit_;
+    if (resumeToken_)
+        value[jss::marker] = resumeToken_;
+}
+
+} // RPC
+} //
+
+#endif
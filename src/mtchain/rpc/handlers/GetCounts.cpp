@@ -11,6 +11,7 @@
 #include <BeastConfig.h>
 #include <mtchain/app/ledger/AcceptedLedger.h>
 #include <mtchain/app/ledger/InboundLedgers.h>
+#include <mtchain/app/ledger/LedgerHandles.h>
 #include <mtchain/app/ledger/LedgerMaster.h>
 #include <mtchain/app/main/Application.h>
 #include <mtchain/app/misc/NetworkOPs.h>
@@ -96,6 +97,7 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::node_hit_rate] = context.app.getNodeStore ().getCacheHitRate ();
     ret[jss::ledger_hit_rate] = context.app.getLedgerMaster ().getCacheHitRate ();
     ret[jss::AL_hit_rate] = context.app.getAcceptedLedgerCache ().getHitRate ();
+    ret[jss::ledger_handles] = context.app.getLedgerHandles ().getJson ();
 
     ret[jss::fullbelow_size] = static_cast<int>(context.app.family().fullbelow().size());
     ret[jss::treenode_cache_size] = context.app.family().treecache().getCacheSize();
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_RPC_HANDLERS_LEDGERDATA_H_INCLUDED
+#define MTCHAIN_RPC_HANDLERS_LEDGERDATA_H_INCLUDED
+
+#include <mtchain/app/ledger/LedgerToJson.h>
+#include <mtchain/json/Object.h>
+#include <mtchain/ledger/ReadView.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/rpc/Context.h>
+#include <mtchain/rpc/Status.h>
+#include <mtchain/rpc/impl/Handler.h>
+#include <mtchain/rpc/Role.h>
+#include <boost/optional.hpp>
+
+namespace mtchain {
+namespace RPC {
+
+// Get state nodes from a ledger
+//   Inputs:
+//     limit:        integer, maximum number of entries
+//     marker:       opaque, resume point
+//     binary:       boolean, format
+//   Outputs:
+//     ledger_hash:  chosen ledger's hash
+//     ledger_index: chosen ledger's index
+//     state:        array of state nodes
+//     marker:       resume point, if any
+//
+// The state nodes are written one at a time, so a page of any size
+// takes no more memory than one node.
+class LedgerDataHandler
+{
+public:
+    explicit LedgerDataHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static const char* const name()
+    {
+        return "ledger_data";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NO_CONDITION;
+    }
+
+private:
+    Context& context_;
+    std::shared_ptr<ReadView const> ledger_;
+    Json::Value result_;
+    ReadView::key_type key_;
+    bool isMarker_ = false;
+    bool isBinary_ = false;
+    int limit_ = -1;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void LedgerDataHandler::writeResult (Object& value)
+{
+    Json::copyFrom (value, result_);
+
+    if (! isMarker_)
+    {
+        // Return base ledger data on first query
+        value[jss::ledger] = getJson (
+            LedgerFill (*ledger_, isBinary_ ?
+                LedgerFill::Options::binary : 0));
+    }
+
+    boost::optional<ReadView::key_type> marker;
+    {
+        auto&& nodes = Json::setArray (value, jss::state);
+        auto limit = limit_;
+        auto e = ledger_->sles.end();
+        for (auto i = ledger_->sles.upper_bound(key_); i != e; ++i)
+        {
+            auto sle = ledger_->read(keylet::unchecked((*i)->key()));
+            if (limit-- <= 0)
+            {
+                // Stop processing before the current key.
+                auto k = sle->key();
+                marker = --k;
+                break;
+            }
+
+            Json::Value entry;
+            if (isBinary_)
+                entry[jss::data] = serializeHex(*sle);
+            else
+                entry = sle->getJson (0);
+            entry[jss::index] = to_string(sle->key());
+            nodes.append (entry);
+        }
+    }
+
+    if (marker)
+        value[jss::marker] = to_string (*marker);
+}
+
+} // RPC
+} //
+
+#endif
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/LedgerHandles.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/net/RPCErr.h>
+#include <mtchain/protocol/ErrorCodes.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/resource/Fees.h>
+#include <mtchain/rpc/Context.h>
+#include <mtchain/rpc/Role.h>
+#include <mtchain/rpc/impl/RPCHelpers.h>
+#include <mtchain/rpc/impl/Tuning.h>
+#include <algorithm>
+
+namespace mtchain {
+
+// Make a handle on a ledger:
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   ttl : <seconds>                // optional
+// }
+//
+// Keep a handle alive, or release it:
+// {
+//   ledger_handle : <handle>
+//   release : true                 // optional
+// }
+Json::Value doLedgerHandle (RPC::Context& context)
+{
+    auto& handles = context.app.getLedgerHandles ();
+    auto const& params = context.params;
+
+    if (params.isMember (jss::ledger_handle) &&
+        params[jss::release].asBool ())
+    {
+        uint256 handle;
+        if (! params[jss::ledger_handle].isString () ||
+            ! handle.SetHexExact (params[jss::ledger_handle].asString ()))
+            return RPC::invalid_field_error (jss::ledger_handle);
+
+        Json::Value ret;
+        ret[jss::released] = handles.release (handle);
+        return ret;
+    }
+
+    auto ttl = RPC::Tuning::ledgerHandleTTL.rdefault;
+    if (params.isMember (jss::ttl))
+    {
+        if (! params[jss::ttl].isIntegral () || params[jss::ttl].asInt () < 0)
+            return RPC::invalid_field_error (jss::ttl);
+        ttl = std::max (RPC::Tuning::ledgerHandleTTL.rmin,
+            std::min (RPC::Tuning::ledgerHandleTTL.rmax,
+                params[jss::ttl].asUInt ()));
+    }
+
+    // A handle passed in is found, and kept alive, by lookupLedger
+    std::shared_ptr<ReadView const> ledger;
+    auto ret = RPC::lookupLedger (ledger, context);
+    if (! ledger)
+        return ret;
+
+    if (params.isMember (jss::ledger_handle))
+    {
+        ret[jss::ledger_handle] = params[jss::ledger_handle];
+        return ret;
+    }
+
+    auto const handle = handles.make (ledger, context.consumer.to_string (),
+        std::chrono::seconds (ttl), isUnlimited (context.role));
+    if (! handle)
+        return rpcError (rpcTOO_BUSY);
+
+    context.loadType = Resource::feeMediumBurdenRPC;
+    ret[jss::ledger_handle] = to_string (*handle);
+    ret[jss::ttl] = ttl;
+    return ret;
+}
+
+} //
@@ -0,0 +1,24 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/rpc/Context.h>
+#include <mtchain/rpc/impl/MethodStats.h>
+
+namespace mtchain {
+
+Json::Value doRPCStats (RPC::Context& context)
+{
+    return context.app.getMethodStats ().getJson ();
+}
+
+} //
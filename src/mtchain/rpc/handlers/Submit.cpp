@@ -10,9 +10,7 @@
 
 #include <BeastConfig.h>
 #include <mtchain/app/ledger/LedgerMaster.h>
-#include <mtchain/app/misc/HashRouter.h>
 #include <mtchain/app/misc/Transaction.h>
-#include <mtchain/app/tx/apply.h>
 #include <mtchain/net/RPCErr.h>
 #include <mtchain/protocol/ErrorCodes.h>
 #include <mtchain/resource/Fees.h>
@@ -56,64 +54,19 @@ Json::Value doSubmit (RPC::Context& context)
     if (!ret.second || !ret.first.size ())
         return rpcError (rpcINVALID_PARAMS);
 
-    SerialIter sitTrans (makeSlice(ret.first));
-
-    std::shared_ptr<STTx const> stpTrans;
-
-    try
-    {
-        stpTrans = std::make_shared<STTx const> (std::ref (sitTrans));
-    }
-    catch (std::exception& e)
-    {
-        jvResult[jss::error]        = "invalidTransaction";
-        jvResult[jss::error_exception] = e.what ();
-
-        return jvResult;
-    }
-
-
-    {
-        if (!context.app.checkSigs())
-            forceValidity(context.app.getHashRouter(),
-                stpTrans->getTransactionID(), Validity::SigGoodOnly);
-        auto validity = checkValidity(context.app.getHashRouter(),
-            *stpTrans, context.ledgerMaster.getCurrentLedger()->rules(),
-                context.app.config());
-        if (validity.first != Validity::Valid)
-        {
-            jvResult[jss::error] = "invalidTransaction";
-            jvResult[jss::error_exception] = "fails local checks: " + validity.second;
-
-            return jvResult;
-        }
-    }
-
-    std::string reason;
-    auto tpTrans = std::make_shared<Transaction> (
-        stpTrans, reason, context.app);
-    if (tpTrans->getStatus() != NEW)
+    auto const submitted = RPC::submitBlob (makeSlice (ret.first),
+        getFailHard (context), context.role, context.app,
+        RPC::getProcessTxnFn (context.netOps));
+    if (submitted.error)
     {
-        jvResult[jss::error]            = "invalidTransaction";
-        jvResult[jss::error_exception] = "fails local checks: " + reason;
+        jvResult[jss::error]           = submitted.error;
+        jvResult[jss::error_exception] = submitted.exception;
 
         return jvResult;
     }
 
-    try
-    {
-        auto const failType = getFailHard (context);
-
-        context.netOps.processTransaction (
-            tpTrans, isUnlimited (context.role), true, failType);
-    }
-    catch (std::exception& e)
-    {
-        jvResult[jss::error]           = "internalSubmit";
-        jvResult[jss::error_exception] = e.what ();
-
-        return jvResult;
-    }
+    auto const& stpTrans = submitted.stTx;
+    auto const& tpTrans = submitted.transaction;
 
     try
     {
@@ -145,6 +145,13 @@ Json::Value doSubscribe (RPC::Context& context)
         }
     }
 
+    if (context.params.isMember(jss::ledger_batch))
+    {
+        if (! context.params[jss::ledger_batch].isBool())
+            return rpcError(rpcINVALID_PARAMS);
+        ispSub->setLedgerBatch(context.params[jss::ledger_batch].asBool());
+    }
+
     auto accountsProposed = context.params.isMember(jss::accounts_proposed)
         ? jss::accounts_proposed : jss::rt_accounts;  // DEPRECATED
     if (context.params.isMember(accountsProposed))
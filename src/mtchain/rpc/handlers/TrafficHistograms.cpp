@@ -0,0 +1,30 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/overlay/Overlay.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/rpc/Context.h>
+
+namespace mtchain {
+
+// {
+//   peers: <bool>      // optional, also report each peer
+// }
+Json::Value doTrafficHistograms (RPC::Context& context)
+{
+    bool const peers = context.params.isMember (jss::peers) &&
+        context.params[jss::peers].asBool ();
+    return context.app.overlay ().histograms (peers);
+}
+
+} //
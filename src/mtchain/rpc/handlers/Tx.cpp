@@ -258,6 +258,10 @@ Json::Value doFileDownload(RPC::Context &context)
 #ifdef IPFS_ENABLE
     Json::Value ret = Json::objectValue;
 
+    // The file is written straight to the HTTP reply
+    if (! context.output)
+        return rpcError (rpcNOT_SUPPORTED);
+
     if (!context.params.isMember (jss::transaction))
         return rpcError (rpcINVALID_PARAMS);
 
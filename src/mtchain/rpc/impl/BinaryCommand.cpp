@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/rpc/impl/BinaryCommand.h>
+#include <mtchain/app/ledger/LedgerMaster.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/app/misc/NetworkOPs.h>
+#include <mtchain/app/misc/Transaction.h>
+#include <mtchain/basics/Log.h>
+#include <mtchain/protocol/ErrorCodes.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/protocol/Serializer.h>
+#include <mtchain/protocol/STTx.h>
+#include <mtchain/resource/Fees.h>
+#include <mtchain/rpc/RPCHandler.h>
+#include <mtchain/rpc/Role.h>
+#include <mtchain/rpc/impl/TransactionSign.h>
+#include <mtchain/rpc/impl/Tuning.h>
+#include <vector>
+
+namespace mtchain {
+namespace RPC {
+
+namespace {
+
+std::string
+binaryError (std::uint8_t command, error_code_i code)
+{
+    Serializer s (3);
+    s.add8 (command);
+    s.add16 (static_cast<std::uint16_t> (code));
+    return s.getString ();
+}
+
+// Submits a transaction the way submit does a tx_blob, returning the
+// result code in place of the JSON error
+std::pair<TER, uint256>
+submitOne (Context& context, Slice const& blob)
+{
+    auto const submitted = submitBlob (blob, NetworkOPs::FailHard::no,
+        context.role, context.app, getProcessTxnFn (context.netOps));
+    if (! submitted.stTx)
+        return { temMALFORMED, uint256 () };
+
+    auto const id = submitted.stTx->getTransactionID ();
+    if (! submitted.transaction)
+        return { temINVALID, id };
+
+    if (submitted.error)
+    {
+        JLOG (context.j.info ()) << "Binary submit: " << submitted.exception;
+        return { tefEXCEPTION, id };
+    }
+
+    return { submitted.transaction->getResult (), id };
+}
+
+std::string
+doBinarySubmit (Context& context, SerialIter& sit)
+{
+    // Decode them all before submitting any
+    std::vector<Slice> blobs;
+    while (! sit.empty ())
+    {
+        if (blobs.size () >= Tuning::maxBinarySubmit)
+            return binaryError (BinaryCommand::submit, rpcINVALID_PARAMS);
+        auto const size = sit.get32 ();
+        blobs.push_back (sit.getSlice (size));
+    }
+    if (blobs.empty ())
+        return binaryError (BinaryCommand::submit, rpcINVALID_PARAMS);
+
+    Serializer results (36 * static_cast<int> (blobs.size ()));
+    std::uint32_t count = 0;
+    for (auto const& blob : blobs)
+    {
+        // Each transaction costs as much as a submit
+        if (&blob != &blobs.front ())
+        {
+            context.consumer.charge (context.loadType);
+            if (context.consumer.disconnect ())
+                break;
+        }
+
+        auto const result = submitOne (context, blob);
+        results.add32 (static_cast<std::uint32_t> (result.first));
+        results.add256 (result.second);
+        ++count;
+    }
+
+    Serializer s (7 + results.getDataLength ());
+    s.add8 (BinaryCommand::submit);
+    s.add16 (rpcSUCCESS);
+    s.add32 (count);
+    s.addRaw (results.peekData ());
+    return s.getString ();
+}
+
+std::string
+doBinaryAccountTx (Context& context, SerialIter& sit)
+{
+    auto const account = sit.getBitString<160, detail::AccountIDTag> ();
+    auto const ledgerMin = sit.get32 ();
+    auto const ledgerMax = sit.get32 ();
+    auto const limit = sit.get32 ();
+    auto const flags = sit.get8 ();
+    Json::Value token;
+    if (flags & 2)
+    {
+        token[jss::ledger] = sit.get32 ();
+        token[jss::seq] = sit.get32 ();
+    }
+    if (! sit.empty ())
+        return binaryError (BinaryCommand::accountTx, rpcINVALID_PARAMS);
+
+    std::uint32_t validatedMin;
+    std::uint32_t validatedMax;
+    if (! context.ledgerMaster.getValidatedRange (validatedMin, validatedMax))
+        return binaryError (BinaryCommand::accountTx, rpcLGR_IDXS_INVALID);
+
+    std::uint32_t const all = 0xFFFFFFFF;
+    auto const first = ledgerMin == all ?
+        validatedMin : std::max (ledgerMin, validatedMin);
+    auto const last = ledgerMax == all ?
+        validatedMax : std::min (ledgerMax, validatedMax);
+    if (last < first)
+        return binaryError (BinaryCommand::accountTx, rpcLGR_IDXS_INVALID);
+
+    Serializer records;
+    std::uint32_t count = 0;
+    context.netOps.getTxsAccountRaw (account, first, last, flags & 1,
+        token, limit == 0 ? -1 : static_cast<int> (limit),
+            isUnlimited (context.role),
+        [&records, &count](std::uint32_t ledgerIndex,
+            Blob const& rawTxn, Blob const& rawMeta)
+        {
+            records.add32 (ledgerIndex);
+            records.add32 (static_cast<std::uint32_t> (rawTxn.size ()));
+            records.addRaw (rawTxn);
+            records.add32 (static_cast<std::uint32_t> (rawMeta.size ()));
+            records.addRaw (rawMeta);
+            ++count;
+            return true;
+        });
+
+    Serializer s (24 + records.getDataLength ());
+    s.add8 (BinaryCommand::accountTx);
+    s.add16 (rpcSUCCESS);
+    s.add32 (first);
+    s.add32 (last);
+    s.add8 (token ? 1 : 0);
+    if (token)
+    {
+        s.add32 (token[jss::ledger].asUInt ());
+        s.add32 (token[jss::seq].asUInt ());
+    }
+    s.add32 (count);
+    s.addRaw (records);
+    return s.getString ();
+}
+
+} // namespace
+
+std::string
+doBinaryCommand (Context& context, Slice request)
+{
+    if (request.empty ())
+        return binaryError (0, rpcCOMMAND_MISSING);
+
+    auto const command = request[0];
+    char const* name;
+    switch (command)
+    {
+    case BinaryCommand::submit:
+        name = "submit";
+        break;
+    case BinaryCommand::accountTx:
+        name = "account_tx";
+        break;
+    default:
+        return binaryError (command, rpcUNKNOWN_COMMAND);
+    }
+
+    if (context.role == Role::FORBID)
+        return binaryError (command, rpcFORBIDDEN);
+
+    // The same checks as the JSON command gets
+    context.params[jss::command] = name;
+    if (auto const error = checkCommand (context))
+        return binaryError (command, error);
+
+    context.loadType = Resource::feeMediumBurdenRPC;
+    try
+    {
+        SerialIter sit (request.data () + 1, request.size () - 1);
+        if (command == BinaryCommand::submit)
+            return doBinarySubmit (context, sit);
+        return doBinaryAccountTx (context, sit);
+    }
+    catch (std::exception const& e)
+    {
+        // A request that ends early
+        JLOG (context.j.debug ()) << "Binary " << name << ": " << e.what ();
+        return binaryError (command, rpcINVALID_PARAMS);
+    }
+}
+
+} // RPC
+} //
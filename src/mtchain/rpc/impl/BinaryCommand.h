@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_RPC_BINARYCOMMAND_H_INCLUDED
+#define MTCHAIN_RPC_BINARYCOMMAND_H_INCLUDED
+
+#include <mtchain/basics/Slice.h>
+#include <mtchain/rpc/Context.h>
+#include <cstdint>
+#include <string>
+
+namespace mtchain {
+namespace RPC {
+
+/** Compact requests sent as binary WebSocket messages.
+
+    For clients that submit many pre-signed transactions or page through
+    an account's history, and want neither to build nor to parse JSON.
+    All integers are big-endian.
+
+    A request is a one byte command followed by its arguments:
+
+        submit      One or more transactions, each a 32-bit length
+                    followed by the serialized STTx. A request holding
+                    more than Tuning::maxBinarySubmit is refused.
+
+        account_tx  The 20 byte AccountID, then 32-bit ledger_index_min,
+                    ledger_index_max and limit, and a flags byte. Bit 0
+                    of the flags asks for the oldest first and bit 1
+                    means a 32-bit ledger and sequence marker follow.
+                    A ledger index of 0xFFFFFFFF is the validated bound
+                    and a limit of 0 the default.
+
+    The reply starts with the command and a 16-bit error_code_i, zero on
+    success; nothing follows an error. Then:
+
+        submit      A 32-bit count and, for each transaction, its 32-bit
+                    engine result code and 32 byte hash. A transaction
+                    that cannot be decoded has a zero hash and temMALFORMED,
+                    one that fails local checks temINVALID. Submitting
+                    stops once the client has used up its resource
+                    allowance, so the count may be less than the number
+                    of transactions sent.
+
+        account_tx  The 32-bit ledger range searched, a marker byte which,
+                    if set, is followed by the 32-bit ledger and sequence
+                    to resume from, and a 32-bit count. Each transaction
+                    is its 32-bit ledger index, then the transaction and
+                    its metadata, each as a 32-bit length and the bytes
+                    stored.
+*/
+namespace BinaryCommand {
+
+enum : std::uint8_t
+{
+    submit = 1,
+    accountTx = 2
+};
+
+} // BinaryCommand
+
+/** Execute a binary request, returning the binary reply. */
+std::string
+doBinaryCommand (Context& context, Slice request);
+
+} // RPC
+} //
+
+#endif
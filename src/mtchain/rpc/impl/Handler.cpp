@@ -10,7 +10,9 @@
 
 #include <BeastConfig.h>
 #include <mtchain/rpc/impl/Handler.h>
+#include <mtchain/rpc/handlers/AccountTx.h>
 #include <mtchain/rpc/handlers/Handlers.h>
+#include <mtchain/rpc/handlers/LedgerData.h>
 #include <mtchain/rpc/handlers/Version.h>
 
 namespace mtchain {
@@ -61,7 +63,9 @@ class HandlerTable {
         }
 
         // This is where the new-style handlers are added.
+        addHandler<AccountTxHandler>();
         addHandler<LedgerHandler>();
+        addHandler<LedgerDataHandler>();
         addHandler<VersionHandler>();
     }
 
@@ -70,6 +74,14 @@ class HandlerTable {
         return i == table_.end() ? nullptr : &i->second;
     }
 
+    std::vector <std::string> getHandlerNames() const {
+        std::vector <std::string> names;
+        names.reserve(table_.size());
+        for (auto const& entry : table_)
+            names.push_back(entry.first);
+        return names;
+    }
+
   private:
     std::map<std::string, Handler> table_;
 
@@ -98,7 +110,6 @@ Handler handlerArray[] {
     {   "account_channels",     byRef (&doAccountChannels),   Role::USER,  NO_CONDITION  },
     {   "account_objects",      byRef (&doAccountObjects),    Role::USER,  NO_CONDITION  },
     {   "account_offers",       byRef (&doAccountOffers),     Role::USER,  NO_CONDITION  },
-    {   "account_tx",           byRef (&doAccountTxSwitch),   Role::USER,  NO_CONDITION  },
     {   "blacklist",            byRef (&doBlackList),         Role::ADMIN, NO_CONDITION  },
     {   "book_offers",          byRef (&doBookOffers),        Role::USER,  NO_CONDITION  },
     {   "can_delete",           byRef (&doCanDelete),         Role::ADMIN, NO_CONDITION  },
@@ -116,9 +127,9 @@ Handler handlerArray[] {
     {   "ledger_cleaner",       byRef (&doLedgerCleaner),     Role::ADMIN, NEEDS_NETWORK_CONNECTION  },
     {   "ledger_closed",        byRef (&doLedgerClosed),      Role::USER,  NO_CONDITION   },
     {   "ledger_current",       byRef (&doLedgerCurrent),     Role::USER,  NEEDS_CURRENT_LEDGER  },
-    {   "ledger_data",          byRef (&doLedgerData),        Role::USER,  NO_CONDITION  },
     {   "ledger_entry",         byRef (&doLedgerEntry),       Role::USER,  NO_CONDITION  },
     {   "ledger_entry_index",   byRef (&doLedgerEntryIndex),  Role::USER,  NO_CONDITION  },
+    {   "ledger_handle",        byRef (&doLedgerHandle),      Role::USER,  NO_CONDITION  },
     {   "ledger_header",        byRef (&doLedgerHeader),      Role::USER,  NO_CONDITION  },
     {   "ledger_request",       byRef (&doLedgerRequest),     Role::USER,  NO_CONDITION  },
     {   "log_level",            byRef (&doLogLevel),          Role::ADMIN, NO_CONDITION  },
@@ -131,6 +142,7 @@ Handler handlerArray[] {
     {   "print",                byRef (&doPrint),             Role::ADMIN, NO_CONDITION  },
 //  {   "profile",              byRef (&doProfile),           Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "random",               byRef (&doRandom),            Role::USER,  NO_CONDITION  },
+    {   "rpc_stats",            byRef (&doRPCStats),          Role::ADMIN, NO_CONDITION  },
     {   "jss::FinPal_path_find",     byRef (&doMTChainPathFind),    Role::USER,  NO_CONDITION  },
     {   "sign",                 byRef (&doSign),              Role::USER,  NO_CONDITION  },
     {   "sign_for",             byRef (&doSignFor),           Role::USER,  NO_CONDITION  },
@@ -139,6 +151,7 @@ Handler handlerArray[] {
     {   "server_info",          byRef (&doServerInfo),        Role::USER,  NO_CONDITION  },
     {   "server_state",         byRef (&doServerState),       Role::USER,  NO_CONDITION  },
     {   "stop",                 byRef (&doStop),              Role::ADMIN, NO_CONDITION  },
+    {   "traffic_histograms",   byRef (&doTrafficHistograms), Role::ADMIN, NO_CONDITION  },
     {   "transaction_entry",    byRef (&doTransactionEntry),  Role::USER,  NO_CONDITION  },
     {   "tx",                   byRef (&doTx),                Role::USER,  NEEDS_NETWORK_CONNECTION  },
     {   "tx_history",           byRef (&doTxHistory),         Role::USER,  NO_CONDITION  },
@@ -163,11 +176,19 @@ Handler handlerArray[] {
     {  "get_account_all_token_info",    byRef (&doAccountAllTokenInfo),      Role::USER,  NO_CONDITION  },
 };
 
+HandlerTable const& getHandlerTable() {
+    static HandlerTable const handlers(handlerArray);
+    return handlers;
+}
+
 } // namespace
 
 const Handler* getHandler(std::string const& name) {
-    static HandlerTable const handlers(handlerArray);
-    return handlers.getHandler(name);
+    return getHandlerTable().getHandler(name);
+}
+
+std::vector <std::string> getHandlerNames() {
+    return getHandlerTable().getHandlerNames();
 }
 
 } // RPC
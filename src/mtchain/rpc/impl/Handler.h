@@ -14,6 +14,8 @@
 #include <mtchain/core/Config.h>
 #include <mtchain/rpc/RPCHandler.h>
 #include <mtchain/rpc/Status.h>
+#include <string>
+#include <vector>
 
 namespace Json {
 class Object;
@@ -44,6 +46,9 @@ struct Handler
 
 const Handler* getHandler (std::string const&);
 
+/** Returns the names of all the handlers. */
+std::vector <std::string> getHandlerNames ();
+
 /** Return a Json::objectValue with a single entry. */
 template <class Value>
 Json::Value makeObjectValue (
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/rpc/impl/MethodStats.h>
+#include <mtchain/app/main/CollectorManager.h>
+#include <mtchain/basics/Log.h>
+#include <mtchain/json/to_string.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/rpc/impl/Handler.h>
+#include <mtchain/rpc/impl/Tuning.h>
+
+namespace mtchain {
+namespace RPC {
+
+MethodStats::MethodStats (CollectorManager& collectorManager,
+        beast::Journal journal)
+    : j_ (journal)
+{
+    for (auto const& name : getHandlerNames ())
+        methods_[name];
+
+    auto const& group (collectorManager.group ("rpc"));
+    for (auto const& m : methods_)
+    {
+        gauges_.push_back (group->make_gauge (m.first, "time_p50"));
+        gauges_.push_back (group->make_gauge (m.first, "time_p90"));
+        gauges_.push_back (group->make_gauge (m.first, "time_p99"));
+        gauges_.push_back (group->make_gauge (m.first, "time_max"));
+        gauges_.push_back (group->make_gauge (m.first, "size_p50"));
+    }
+    hook_ = group->make_hook (std::bind (&MethodStats::collectMetrics, this));
+}
+
+MethodStats::~MethodStats ()
+{
+    // Must unhook before destroying
+    hook_ = beast::insight::Hook ();
+}
+
+void
+MethodStats::onRequest (std::string const& method,
+    Json::Value const& params, Json::Value const* result,
+    std::chrono::microseconds elapsed, std::size_t bytes)
+{
+    auto const iter = methods_.find (method);
+    if (iter == methods_.end ())
+        return;
+
+    auto& m = iter->second;
+    m.time.record (std::max <std::chrono::microseconds::rep> (
+        elapsed.count (), 0));
+    if (bytes != 0)
+        m.size.record (bytes);
+
+    if (elapsed >= Tuning::slowRequestTime)
+    {
+        m.slow.fetch_add (1, std::memory_order_relaxed);
+        onSlow (method, params, result, elapsed, bytes);
+    }
+}
+
+void
+MethodStats::onSlow (std::string const& method,
+    Json::Value const& params, Json::Value const* result,
+    std::chrono::microseconds elapsed, std::size_t bytes)
+{
+    auto const now = clock_type::now ();
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        if (now - second_ >= std::chrono::seconds (1))
+        {
+            second_ = now;
+            logged_ = 0;
+        }
+        if (logged_ >= Tuning::slowRequestsPerSecond)
+        {
+            ++dropped_;
+            return;
+        }
+        ++logged_;
+    }
+
+    SlowRequest entry;
+    entry.method = method;
+    entry.elapsed = elapsed;
+    entry.bytes = bytes;
+    entry.when = now;
+
+    // Keys and admin credentials are not logged
+    Json::Value redacted (params);
+    redacted.removeMember ("admin_user");
+    redacted.removeMember ("admin_password");
+    redacted.removeMember (jss::secret);
+    redacted.removeMember (jss::seed);
+    redacted.removeMember (jss::seed_hex);
+    redacted.removeMember (jss::passphrase);
+    redacted.removeMember (jss::password);
+    entry.params = to_string (redacted);
+    if (entry.params.size () > Tuning::slowRequestParamsSize)
+        entry.params.resize (Tuning::slowRequestParamsSize);
+
+    if (result)
+    {
+        if (result->isMember (jss::ledger_index))
+            entry.ledgerIndex = (*result)[jss::ledger_index].asString ();
+        if (result->isMember (jss::ledger_hash))
+            entry.ledgerHash = (*result)[jss::ledger_hash].asString ();
+        if (result->isMember (jss::ledger_current_index))
+            entry.ledgerCurrentIndex =
+                (*result)[jss::ledger_current_index].asString ();
+    }
+
+    JLOG (j_.warn ()) << "Slow request: " << method << " took " <<
+        elapsed.count () / 1000 << "ms: " << entry.params;
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    slow_.push_back (std::move (entry));
+    if (slow_.size () > Tuning::slowRequestLogSize)
+        slow_.pop_front ();
+}
+
+Json::Value
+MethodStats::getJson () const
+{
+    using namespace std::chrono;
+
+    Json::Value ret (Json::objectValue);
+    auto& methods = (ret[jss::methods] = Json::objectValue);
+    for (auto const& m : methods_)
+    {
+        if (m.second.time.count () == 0)
+            continue;
+        auto& entry = methods[m.first];
+        entry[jss::time] = m.second.time.getJson ();
+        entry[jss::size] = m.second.size.getJson ();
+        entry[jss::slow] = static_cast <Json::UInt> (
+            m.second.slow.load (std::memory_order_relaxed));
+    }
+
+    auto const now = clock_type::now ();
+    auto& slow = (ret[jss::slow_requests] = Json::arrayValue);
+    std::lock_guard <std::mutex> lock (mutex_);
+    for (auto const& s : slow_)
+    {
+        Json::Value entry (Json::objectValue);
+        entry[jss::method] = s.method;
+        entry[jss::params] = s.params;
+        entry[jss::time] = static_cast <Json::UInt> (s.elapsed.count ());
+        if (s.bytes != 0)
+            entry[jss::bytes] = static_cast <Json::UInt> (s.bytes);
+        if (! s.ledgerIndex.empty ())
+            entry[jss::ledger_index] = s.ledgerIndex;
+        if (! s.ledgerHash.empty ())
+            entry[jss::ledger_hash] = s.ledgerHash;
+        if (! s.ledgerCurrentIndex.empty ())
+            entry[jss::ledger_current_index] = s.ledgerCurrentIndex;
+        entry[jss::age] = static_cast <Json::UInt> (
+            duration_cast <seconds> (now - s.when).count ());
+        slow.append (std::move (entry));
+    }
+    ret[jss::dropped] = static_cast <Json::UInt> (dropped_);
+    return ret;
+}
+
+void
+MethodStats::collectMetrics ()
+{
+    auto gauge = gauges_.begin ();
+    for (auto const& m : methods_)
+    {
+        (gauge++)->set (m.second.time.percentile (0.50));
+        (gauge++)->set (m.second.time.percentile (0.90));
+        (gauge++)->set (m.second.time.percentile (0.99));
+        (gauge++)->set (m.second.time.max ());
+        (gauge++)->set (m.second.size.percentile (0.50));
+    }
+}
+
+} // RPC
+} //
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_RPC_METHODSTATS_H_INCLUDED
+#define MTCHAIN_RPC_METHODSTATS_H_INCLUDED
+
+#include <mtchain/core/Histogram.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/beast/insight/Insight.h>
+#include <mtchain/beast/utility/Journal.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mtchain {
+
+class CollectorManager;
+
+namespace RPC {
+
+/** Distributions of the time taken and the reply size of each method.
+
+    Requests slower than Tuning::slowRequestTime are also kept in a log
+    of the most recent ones, with their parameters and the ledger they
+    used. At most Tuning::slowRequestsPerSecond are logged each second,
+    the others are only counted.
+
+    Recording a request that is not slow costs a map lookup and a few
+    relaxed atomic operations.
+*/
+class MethodStats
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    MethodStats (CollectorManager& collectorManager,
+        beast::Journal journal);
+
+    ~MethodStats ();
+
+    /** Record a request.
+
+        @param result The result of the request, used to find the ledger
+                      it used, or null if the result was not kept.
+        @param bytes The size of the reply, or zero if it is not known.
+    */
+    void
+    onRequest (std::string const& method, Json::Value const& params,
+        Json::Value const* result, std::chrono::microseconds elapsed,
+        std::size_t bytes);
+
+    /** Returns the histograms of the methods called, times in
+        microseconds and sizes in bytes, and the log of slow requests.
+    */
+    Json::Value
+    getJson () const;
+
+private:
+    struct Method
+    {
+        Histogram time;
+        Histogram size;
+        std::atomic <std::uint64_t> slow {0};
+    };
+
+    struct SlowRequest
+    {
+        std::string method;
+        std::string params;
+        std::string ledgerIndex;
+        std::string ledgerHash;
+        std::string ledgerCurrentIndex;
+        std::chrono::microseconds elapsed;
+        std::size_t bytes;
+        clock_type::time_point when;
+    };
+
+    void
+    onSlow (std::string const& method, Json::Value const& params,
+        Json::Value const* result, std::chrono::microseconds elapsed,
+        std::size_t bytes);
+
+    void
+    collectMetrics ();
+
+    beast::Journal j_;
+
+    // One for each handler, not changed after construction
+    std::map <std::string, Method> methods_;
+
+    mutable std::mutex mutex_;
+    std::deque <SlowRequest> slow_;
+    clock_type::time_point second_;
+    int logged_ = 0;            // in the second starting at second_
+    std::uint64_t dropped_ = 0;
+
+    // Percentiles of the histograms, published to the collector
+    std::vector <beast::insight::Gauge> gauges_;
+    beast::insight::Hook hook_;
+};
+
+} // RPC
+} //
+
+#endif
@@ -256,6 +256,41 @@ Status doCommand (
     return rpcUNKNOWN_COMMAND;
 }
 
+Status doCommand (
+    RPC::Context& context, Json::Object& result)
+{
+    boost::optional <Handler const&> handler;
+    if (auto error = fillHandler (context, handler))
+    {
+        inject_error (error, result);
+        return error;
+    }
+
+    if (auto method = handler->objectMethod_)
+    {
+        // Part of the result may be sent already, so an error can no
+        // longer replace it: the caller has to cut the reply short.
+        auto v = context.app.getJobQueue().getLoadEventAP(
+            jtGENERIC, std::string ("cmd:") + handler->name_);
+        return method (context, result);
+    }
+
+    inject_error (rpcUNKNOWN_COMMAND, result);
+    return rpcUNKNOWN_COMMAND;
+}
+
+error_code_i checkCommand (RPC::Context& context)
+{
+    boost::optional <Handler const&> handler;
+    return fillHandler (context, handler);
+}
+
+bool canWriteResult (std::string const& method)
+{
+    auto const handler = getHandler (method);
+    return handler && handler->objectMethod_;
+}
+
 /** Execute an RPC command and store the results in a string. */
 void executeRPC (
     RPC::Context& context, std::string& output)
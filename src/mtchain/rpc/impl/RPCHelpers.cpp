@@ -9,6 +9,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <mtchain/app/ledger/LedgerHandles.h>
 #include <mtchain/app/ledger/LedgerMaster.h>
 #include <mtchain/app/misc/Transaction.h>
 #include <mtchain/ledger/View.h>
@@ -172,6 +173,23 @@ ledgerFromRequest(T& ledger, Context& context)
     auto& params = context.params;
     auto& ledgerMaster = context.ledgerMaster;
 
+    // A handle names a ledger held for the client
+    if (params.isMember (jss::ledger_handle))
+    {
+        auto const& handleValue = params[jss::ledger_handle];
+        if (! handleValue.isString ())
+            return {rpcINVALID_PARAMS, "ledgerHandleNotString"};
+
+        uint256 handle;
+        if (! handle.SetHexExact (handleValue.asString ()))
+            return {rpcINVALID_PARAMS, "ledgerHandleMalformed"};
+
+        ledger = context.app.getLedgerHandles ().find (handle);
+        if (ledger == nullptr)
+            return {rpcLGR_NOT_FOUND, "ledgerHandleNotFound"};
+        return Status::OK;
+    }
+
     auto indexValue = params[jss::ledger_index];
     auto hashValue = params[jss::ledger_hash];
 
@@ -227,7 +245,10 @@ ledgerFromRequest(T& ledger, Context& context)
         auto const index = indexValue.asString ();
         if (index == "validated")
         {
-            ledger = ledgerMaster.getValidatedLedger ();
+            if (context.ledgers.validated)
+                ledger = context.ledgers.validated;
+            else
+                ledger = ledgerMaster.getValidatedLedger ();
             if (ledger == nullptr)
                 return {rpcNO_NETWORK, "InsufficientNetworkMode"};
 
@@ -237,12 +258,18 @@ ledgerFromRequest(T& ledger, Context& context)
         {
             if (index.empty () || index == "current")
             {
-                ledger = ledgerMaster.getCurrentLedger ();
+                if (context.ledgers.current)
+                    ledger = context.ledgers.current;
+                else
+                    ledger = ledgerMaster.getCurrentLedger ();
                 assert (ledger->open());
             }
             else if (index == "closed")
             {
-                ledger = ledgerMaster.getClosedLedger ();
+                if (context.ledgers.closed)
+                    ledger = context.ledgers.closed;
+                else
+                    ledger = ledgerMaster.getClosedLedger ();
                 assert (! ledger->open());
             }
             else
@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/rpc/impl/ReplyWriter.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+namespace mtchain {
+namespace RPC {
+
+// Body bytes gathered into each chunk
+static std::size_t const chunkBytes = 16 * 1024;
+
+struct ReplyWriter::State
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::shared_ptr<JobQueue::Coro> coro;
+    std::size_t const limit;
+
+    std::deque<std::string> chunks;     // framed, not completely sent
+    std::size_t sent = 0;               // bytes of the first chunk sent
+    std::size_t pending = 0;            // bytes not sent
+    std::size_t peak = 0;
+    bool done = false;
+    bool failed = false;                // done without the last chunk
+    bool abandoned = false;
+    bool waiting = false;               // the writer is suspended
+
+    // Resumes the session once there is data to send
+    std::function<void(void)> resume;
+
+    State (std::shared_ptr<JobQueue::Coro> c, std::size_t l)
+        : coro (std::move (c))
+        , limit (l)
+    {
+    }
+
+    // Let the writer continue. Called with the lock held.
+    void
+    wake (std::unique_lock<std::mutex>& lock)
+    {
+        if (! waiting)
+            return;
+        waiting = false;
+        if (coro)
+        {
+            lock.unlock ();
+            coro->post ();
+        }
+        else
+        {
+            cv.notify_all ();
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+class ReplyWriter::Source : public Writer
+{
+public:
+    explicit
+    Source (std::shared_ptr<State> state)
+        : state_ (std::move (state))
+    {
+    }
+
+    ~Source () override
+    {
+        std::unique_lock<std::mutex> lock (state_->mutex);
+        if (state_->done && state_->pending == 0)
+            return;
+        state_->abandoned = true;
+        state_->chunks.clear ();
+        state_->pending = 0;
+        state_->wake (lock);
+    }
+
+    bool
+    complete () override
+    {
+        std::lock_guard<std::mutex> lock (state_->mutex);
+        return state_->done && state_->pending == 0;
+    }
+
+    void
+    consume (std::size_t bytes) override
+    {
+        std::unique_lock<std::mutex> lock (state_->mutex);
+        state_->pending -= bytes;
+        bytes += state_->sent;
+        while (! state_->chunks.empty () &&
+            bytes >= state_->chunks.front ().size ())
+        {
+            bytes -= state_->chunks.front ().size ();
+            state_->chunks.pop_front ();
+        }
+        state_->sent = bytes;
+
+        if (state_->pending <= state_->limit / 2)
+            state_->wake (lock);
+    }
+
+    bool
+    prepare (std::size_t, std::function<void(void)> resume) override
+    {
+        std::lock_guard<std::mutex> lock (state_->mutex);
+        if (state_->pending != 0)
+            return true;
+        state_->resume = std::move (resume);
+        return false;
+    }
+
+    bool
+    failed () override
+    {
+        std::lock_guard<std::mutex> lock (state_->mutex);
+        return state_->failed;
+    }
+
+    std::vector<boost::asio::const_buffer>
+    data () override
+    {
+        // Chunks are only added at the back, so the buffers of those
+        // already queued stay put while they are being sent.
+        std::lock_guard<std::mutex> lock (state_->mutex);
+        std::vector<boost::asio::const_buffer> result;
+        result.reserve (state_->chunks.size ());
+        auto offset = state_->sent;
+        for (auto const& chunk : state_->chunks)
+        {
+            result.emplace_back (chunk.data () + offset,
+                chunk.size () - offset);
+            offset = 0;
+        }
+        return result;
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+//------------------------------------------------------------------------------
+
+ReplyWriter::ReplyWriter (std::string const& header, std::size_t limit,
+        std::shared_ptr<JobQueue::Coro> coro)
+    : state_ (std::make_shared<State> (std::move (coro), limit))
+{
+    state_->chunks.push_back (header);
+    state_->pending = state_->peak = header.size ();
+    chunk_.reserve (chunkBytes);
+}
+
+ReplyWriter::~ReplyWriter ()
+{
+    finish ();
+}
+
+std::shared_ptr<Writer>
+ReplyWriter::getWriter ()
+{
+    return std::make_shared<Source> (state_);
+}
+
+Json::Output
+ReplyWriter::output ()
+{
+    return [this](boost::string_ref const& data)
+    {
+        // Collections close themselves as they are destroyed
+        if (! std::uncaught_exception ())
+            write (data);
+    };
+}
+
+void
+ReplyWriter::write (boost::string_ref const& data)
+{
+    if (finished_)
+        return;
+    chunk_.append (data.data (), data.size ());
+    bytes_ += data.size ();
+    if (chunk_.size () >= chunkBytes)
+        flush (false);
+}
+
+void
+ReplyWriter::finish ()
+{
+    if (finished_)
+        return;
+    finished_ = true;
+    flush (true);
+}
+
+void
+ReplyWriter::fail ()
+{
+    if (finished_)
+        return;
+    finished_ = true;
+    chunk_.clear ();
+
+    std::function<void(void)> resume;
+    {
+        std::lock_guard<std::mutex> lock (state_->mutex);
+        if (state_->abandoned)
+            return;
+        state_->done = true;
+        state_->failed = true;
+        std::swap (resume, state_->resume);
+    }
+    if (resume)
+        resume ();
+}
+
+bool
+ReplyWriter::abandoned () const
+{
+    std::lock_guard<std::mutex> lock (state_->mutex);
+    return state_->abandoned;
+}
+
+std::size_t
+ReplyWriter::getPeak () const
+{
+    std::lock_guard<std::mutex> lock (state_->mutex);
+    return state_->peak;
+}
+
+void
+ReplyWriter::flush (bool last)
+{
+    std::string framed;
+    if (! chunk_.empty ())
+    {
+        char size[20];
+        auto const n = std::snprintf (size, sizeof (size), "%zx\r\n",
+            chunk_.size ());
+        framed.reserve (n + chunk_.size () + 7);
+        framed.append (size, n);
+        framed.append (chunk_);
+        framed.append ("\r\n");
+        chunk_.clear ();
+    }
+    if (last)
+        framed.append ("0\r\n\r\n");
+
+    std::function<void(void)> resume;
+    bool wait;
+    {
+        std::lock_guard<std::mutex> lock (state_->mutex);
+        if (state_->abandoned)
+            return;
+
+        state_->pending += framed.size ();
+        state_->peak = std::max (state_->peak, state_->pending);
+        state_->chunks.push_back (std::move (framed));
+        state_->done = last;
+        std::swap (resume, state_->resume);
+
+        wait = ! last && state_->pending > state_->limit;
+        state_->waiting = wait;
+    }
+
+    if (resume)
+        resume ();
+
+    if (! wait)
+        return;
+
+    // The session wakes the writer once, when it has sent enough or
+    // gone away. A coroutine may be posted before it yields.
+    if (state_->coro)
+    {
+        state_->coro->yield ();
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock (state_->mutex);
+        state_->cv.wait (lock, [this] { return ! state_->waiting; });
+    }
+}
+
+} // RPC
+} //
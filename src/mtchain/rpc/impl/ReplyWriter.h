@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#ifndef MTCHAIN_RPC_REPLYWRITER_H_INCLUDED
+#define MTCHAIN_RPC_REPLYWRITER_H_INCLUDED
+
+#include <mtchain/core/JobQueue.h>
+#include <mtchain/json/Output.h>
+#include <mtchain/server/Writer.h>
+#include <memory>
+#include <string>
+
+namespace mtchain {
+namespace RPC {
+
+/** Sends the body of an HTTP reply while it is being written.
+
+    The body goes out with chunked transfer encoding, so its size need
+    not be known before it is complete. At most about `limit` bytes are
+    held unsent: past that, write() suspends the coroutine writing the
+    reply, or blocks the thread when there is none, until the session
+    has sent half of them.
+
+    If the session goes away first the rest of the reply is discarded.
+    If the reply cannot be completed, fail() ends it without the end of
+    the body, and the session closes the connection once it is sent.
+*/
+class ReplyWriter
+{
+public:
+    /** @param header The HTTP header, sent ahead of the body. */
+    ReplyWriter (std::string const& header, std::size_t limit,
+        std::shared_ptr<JobQueue::Coro> coro);
+
+    ~ReplyWriter ();
+
+    ReplyWriter (ReplyWriter const&) = delete;
+    ReplyWriter& operator= (ReplyWriter const&) = delete;
+
+    /** Returns the Writer that the session sends the reply from. */
+    std::shared_ptr<Writer>
+    getWriter ();
+
+    /** Returns an Output appending to the body.
+
+        Nothing is appended while an exception unwinds the stack, so the
+        closing brackets of a reply cut short are not sent.
+    */
+    Json::Output
+    output ();
+
+    /** Append data to the body. */
+    void
+    write (boost::string_ref const& data);
+
+    /** End the body. */
+    void
+    finish ();
+
+    /** Cut the body short.
+
+        What was sent stays sent; the rest is discarded, and the session
+        closes the connection so the client sees the reply as incomplete.
+    */
+    void
+    fail ();
+
+    /** Returns `true` if the session went away before the end. */
+    bool
+    abandoned () const;
+
+    /** Returns the number of bytes of body written. */
+    std::size_t
+    getBytes () const
+    {
+        return bytes_;
+    }
+
+    /** Returns the most bytes that were held unsent at once. */
+    std::size_t
+    getPeak () const;
+
+private:
+    struct State;
+    class Source;
+
+    void
+    flush (bool last);
+
+    std::shared_ptr<State> state_;
+    std::string chunk_;
+    std::size_t bytes_ = 0;
+    bool finished_ = false;
+};
+
+} // RPC
+} //
+
+#endif
@@ -9,20 +9,26 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <mtchain/app/ledger/LedgerMaster.h>
 #include <mtchain/app/main/Application.h>
 #include <mtchain/app/misc/NetworkOPs.h>
 #include <mtchain/beast/rfc2616.h>
 #include <mtchain/beast/net/IPAddressConversion.h>
+#include <mtchain/json/FastReader.h>
 #include <mtchain/json/json_reader.h>
 #include <mtchain/rpc/json_body.h>
 #include <mtchain/rpc/ServerHandler.h>
 #include <mtchain/server/Server.h>
 #include <mtchain/server/impl/JSONRPCUtil.h>
+#include <mtchain/rpc/impl/BinaryCommand.h>
+#include <mtchain/rpc/impl/MethodStats.h>
+#include <mtchain/rpc/impl/ReplyWriter.h>
 #include <mtchain/rpc/impl/ServerHandlerImp.h>
 #include <mtchain/basics/contract.h>
 #include <mtchain/basics/Log.h>
 #include <mtchain/basics/make_SSLContext.h>
 #include <mtchain/core/JobQueue.h>
+#include <mtchain/json/Object.h>
 #include <mtchain/json/to_string.h>
 #include <mtchain/net/RPCErr.h>
 #include <mtchain/overlay/Overlay.h>
@@ -39,6 +45,8 @@
 #include <boost/optional.hpp>
 #include <boost/regex.hpp>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <stdexcept>
 
 namespace mtchain {
@@ -258,6 +266,16 @@ Json::Output makeOutput (Session& session)
     };
 }
 
+// Returns this thread's reader, which keeps its buffers between requests.
+// Parsing never yields, so a coroutine can't move threads while using it.
+static
+Json::FastReader&
+fastReader ()
+{
+    thread_local Json::FastReader reader;
+    return reader;
+}
+
 // HACK!
 static
 std::map<std::string, std::string>
@@ -322,10 +340,26 @@ ServerHandlerImp::onWSMessage(
     std::shared_ptr<WSSession> session,
         std::vector<boost::asio::const_buffer> const& buffers)
 {
-    Json::Value jv;
     auto const size = boost::asio::buffer_size(buffers);
+    if (session->binary() && size <= RPC::Tuning::maxRequestSize)
+    {
+        m_jobQueue.postCoro(jtCLIENT, "WS-Binary",
+            [this, session = std::move(session),
+                request = buffers_to_string(buffers)](auto const& c)
+            {
+                auto const reply = std::make_shared<std::string const>(
+                    this->processBinary(session, c, request));
+                session->send(std::make_shared<BinaryWSMsg>(reply));
+                session->complete();
+            });
+        return;
+    }
+
+    Json::Value jv;
     if (size > RPC::Tuning::maxRequestSize ||
-        ! Json::Reader{}.parse(jv, buffers) ||
+        ! (session->port().fast_json ?
+            fastReader().parse(jv, buffers) :
+            Json::Reader{}.parse(jv, buffers)) ||
         ! jv ||
         ! jv.isObject())
     {
@@ -355,10 +389,17 @@ ServerHandlerImp::onWSMessage(
         [this, session = std::move(session),
             jv = std::move(jv)](auto const& c)
         {
+            auto const start = std::chrono::steady_clock::now();
             auto const jr =
                 this->processSession(session, c, jv);
             auto const s = to_string(jr);
             auto const n = s.length();
+            app_.getMethodStats().onRequest(
+                jv[jv.isMember(jss::command) ?
+                    jss::command : jss::method].asString(),
+                jv, jr.isMember(jss::result) ? &jr[jss::result] : &jr,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start), n);
             beast::streambuf sb(n);
             sb.commit(boost::asio::buffer_copy(
                 sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
@@ -390,6 +431,9 @@ ServerHandlerImp::processSession(
         std::shared_ptr<JobQueue::Coro> const& coro,
             Json::Value const& jv)
 {
+    // The request and reply are built in an arena
+    Json::Arena::Scope arena;
+
     auto is = std::static_pointer_cast<WSInfoSub> (session->appDefined);
     if (is->getConsumer().disconnect())
     {
@@ -489,11 +533,66 @@ ServerHandlerImp::processSession(
     return jr;
 }
 
+std::string
+ServerHandlerImp::processBinary(
+    std::shared_ptr<WSSession> const& session,
+        std::shared_ptr<JobQueue::Coro> const& coro,
+            std::string const& request)
+{
+    auto is = std::static_pointer_cast<WSInfoSub> (session->appDefined);
+    if (is->getConsumer().disconnect())
+    {
+        session->close();
+        return {};
+    }
+
+    Resource::Charge loadType = Resource::feeReferenceRPC;
+    auto const role = requestRole(
+        Role::USER,
+        session->port(),
+        Json::Value(),
+        beast::IP::from_asio(session->remote_endpoint().address()),
+        is->user());
+
+    RPC::Context context{
+        app_.journal("RPCHandler"),
+        Json::Value(Json::objectValue),
+        app_,
+        loadType,
+        app_.getOPs(),
+        app_.getLedgerMaster(),
+        is->getConsumer(),
+        role,
+        coro,
+        is,
+        {is->user(), is->forwarded_for()}
+        };
+    auto reply = RPC::doBinaryCommand(context, makeSlice(request));
+    if (Role::FORBID == role)
+        loadType = Resource::feeInvalidRPC;
+
+    is->getConsumer().charge(loadType);
+    return reply;
+}
+
 // Run as a coroutine.
 void
 ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
     std::shared_ptr<JobQueue::Coro> coro)
 {
+    // Large results are sent as they are written, in chunks
+    bool streamed = false;
+    Stream stream;
+    if (session->request().version >= 11)
+    {
+        stream.keepAlive = is_keep_alive (session->request());
+        stream.write = [&](std::shared_ptr<Writer> const& writer)
+        {
+            streamed = true;
+            session->write (writer, stream.keepAlive);
+        };
+    }
+
     auto closeSess = processRequest (
         session->port(), buffers_to_string(
             session->request().body.data()),
@@ -516,7 +615,11 @@ ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
             if(iter != session->request().fields.end())
                 return iter->second;
             return std::string{};
-        }());
+        }(), stream);
+
+    // The writer finishes the request once the reply is sent
+    if (streamed)
+        return;
 
     if(!closeSess && is_keep_alive(session->request()))
         session->complete();
@@ -528,23 +631,29 @@ int
 ServerHandlerImp::processRequest (Port const& port,
     std::string const& request, beast::IP::Endpoint const& remoteIPAddress,
         Output&& output, std::shared_ptr<JobQueue::Coro> coro,
-        std::string forwardedFor, std::string user)
+        std::string forwardedFor, std::string user, Stream const& stream)
 {
     auto rpcJ = app_.journal ("RPC");
 
+    // The request and reply are built in an arena
+    Json::Arena::Scope arena;
+
     Json::Value jsonRPC;
+    if ((request.size () > RPC::Tuning::maxRequestSize) ||
+        ! (port.fast_json ?
+            fastReader ().parse (request, jsonRPC) :
+            Json::Reader ().parse (request, jsonRPC)) ||
+        ! jsonRPC ||
+        ! (jsonRPC.isObject () || jsonRPC.isArray ()))
     {
-        Json::Reader reader;
-        if ((request.size () > RPC::Tuning::maxRequestSize) ||
-            ! reader.parse (request, jsonRPC) ||
-            ! jsonRPC ||
-            ! jsonRPC.isObject ())
-        {
-            HTTPReply (400, "Unable to parse request", output, rpcJ);
-            return 0;
-        }
+        HTTPReply (400, "Unable to parse request", output, rpcJ);
+        return 0;
     }
 
+    if (jsonRPC.isArray ())
+        return processBatch (port, std::move (jsonRPC), remoteIPAddress,
+            output, coro, forwardedFor, user, stream);
+
     /* ---------------------------------------------------------------------- */
     // Determine role/usage so we can charge for invalid requests
     Json::Value const& method = jsonRPC [jss::method];
@@ -661,6 +770,73 @@ ServerHandlerImp::processRequest (Port const& port,
     RPC::Context context {m_journal, params, app_, loadType, m_networkOPs,
         app_.getLedgerMaster(), usage, role, coro, InfoSub::pointer(),
         {user, forwardedFor}, &output};
+
+    if (stream && RPC::canWriteResult (strMethod))
+    {
+        RPC::ReplyWriter writer (HTTPChunkedReplyHeader (stream.keepAlive),
+            RPC::Tuning::maxReplyBuffer, coro);
+        stream.write (writer.getWriter ());
+        context.stopped = [&writer] { return writer.abandoned (); };
+        try
+        {
+            Json::Writer w (writer.output ());
+            Json::Object::Root reply (w);
+            {
+                auto&& result = Json::addObject (reply, jss::result);
+                if (auto status = RPC::doCommand (context, result))
+                {
+                    JLOG (m_journal.debug()) <<
+                        "rpcError: " << status.toString ();
+                    result[jss::status] = jss::error;
+                    result[jss::request] = params;
+                }
+                else
+                {
+                    result[jss::status] = jss::success;
+                }
+
+                usage.charge (loadType);
+                if (usage.warn())
+                    result[jss::warning] = jss::load;
+            }
+            if (jsonRPC.isMember(jss::jsonrpc))
+                reply[jss::jsonrpc] = jsonRPC[jss::jsonrpc];
+            if (jsonRPC.isMember(jss::FinPalrpc))
+                reply[jss::FinPalrpc] = jsonRPC[jss::FinPalrpc];
+            if (jsonRPC.isMember(jss::id))
+                reply[jss::id] = jsonRPC[jss::id];
+        }
+        catch (std::exception const& e)
+        {
+            // Part of the reply may be out: the client can only be told
+            // by closing the connection before the end of the body.
+            JLOG (m_journal.info()) << "Caught throw: " << e.what ();
+            if (loadType == Resource::feeReferenceRPC)
+                loadType = Resource::feeExceptionRPC;
+            usage.charge (loadType);
+            writer.fail ();
+        }
+        writer.write ("\n");
+        writer.finish ();
+
+        auto const elapsed =
+            std::chrono::high_resolution_clock::now () - start;
+        rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
+            std::chrono::duration_cast <std::chrono::milliseconds> (
+                elapsed)));
+        ++rpc_requests_;
+        rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
+            writer.getBytes ()));
+        app_.getMethodStats ().onRequest (strMethod, params, nullptr,
+            std::chrono::duration_cast <std::chrono::microseconds> (elapsed),
+            writer.getBytes ());
+
+        JLOG (m_journal.debug()) << "Streamed reply: " <<
+            writer.getBytes () << " bytes, " << writer.getPeak () <<
+            " held at most" << (writer.abandoned () ? ", abandoned" : "");
+        return 0;
+    }
+
     Json::Value result;
     RPC::doCommand (context, result);
 
@@ -698,12 +874,15 @@ ServerHandlerImp::processRequest (Port const& port,
         reply[jss::id] = jsonRPC[jss::id];
     auto response = to_string (reply);
 
+    auto const elapsed = std::chrono::high_resolution_clock::now () - start;
     rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
-        std::chrono::duration_cast <std::chrono::milliseconds> (
-            std::chrono::high_resolution_clock::now () - start)));
+        std::chrono::duration_cast <std::chrono::milliseconds> (elapsed)));
     ++rpc_requests_;
     rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
         response.size ()));
+    app_.getMethodStats ().onRequest (strMethod, params, &reply[jss::result],
+        std::chrono::duration_cast <std::chrono::microseconds> (elapsed),
+        response.size ());
 
     response += '\n';
 
@@ -720,6 +899,341 @@ ServerHandlerImp::processRequest (Port const& port,
     return 0;
 }
 
+// The requests run on several coroutines at once, the replies are
+// written in order as they complete.
+struct ServerHandlerImp::Batch
+{
+    Port const& port;
+    beast::IP::Endpoint const remoteIPAddress;
+    Resource::Consumer usage;
+    std::string const forwardedFor;
+    std::string const user;
+    RPC::Context::Ledgers const ledgers;
+    Json::Value const requests;
+
+    // The reply being streamed. The session lets go of it when the
+    // client goes away.
+    std::weak_ptr<Writer> session;
+    bool streamed = false;
+
+    std::atomic<std::size_t> next {0};  // the next request to run
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Json::Value> replies;   // null until complete
+
+    Batch (Port const& port_, beast::IP::Endpoint const& remoteIPAddress_,
+            Resource::Consumer const& usage_,
+            std::string const& forwardedFor_, std::string const& user_,
+            RPC::Context::Ledgers ledgers_,
+            Json::Value&& requests_)
+        : port (port_)
+        , remoteIPAddress (remoteIPAddress_)
+        , usage (usage_)
+        , forwardedFor (forwardedFor_)
+        , user (user_)
+        , ledgers (std::move (ledgers_))
+        , requests (std::move (requests_))
+        , replies (requests.size ())
+    {
+    }
+
+    // Whether nobody is left to read the replies
+    bool
+    stopped () const
+    {
+        return streamed && session.expired ();
+    }
+
+    // Runs the next request, returns false if none are left
+    bool
+    runOne (ServerHandlerImp& handler,
+        std::shared_ptr<JobQueue::Coro> const& coro)
+    {
+        auto const i = next++;
+        if (i >= requests.size ())
+            return false;
+
+        // The reply of a dropped batch is never read
+        complete (i, stopped () ? Json::Value (Json::objectValue) :
+            handler.processBatchItem (*this, requests[i], coro));
+        return true;
+    }
+
+    // Run requests until none are left
+    void
+    run (ServerHandlerImp& handler,
+        std::shared_ptr<JobQueue::Coro> const& coro)
+    {
+        while (runOne (handler, coro))
+            ;
+    }
+
+    void
+    complete (std::size_t i, Json::Value&& reply)
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            replies[i] = std::move (reply);
+        }
+        cv.notify_all ();
+    }
+
+    // Returns a reply. Until it completes the writer runs requests
+    // itself, then waits for those still running on other jobs.
+    Json::Value
+    take (std::size_t i, ServerHandlerImp& handler,
+        std::shared_ptr<JobQueue::Coro> const& coro)
+    {
+        std::unique_lock<std::mutex> lock (mutex);
+        while (replies[i].isNull ())
+        {
+            lock.unlock ();
+            bool const ran = runOne (handler, coro);
+            lock.lock ();
+            if (! ran)
+                cv.wait (lock, [&] { return ! replies[i].isNull (); });
+        }
+        return std::move (replies[i]);
+    }
+};
+
+int
+ServerHandlerImp::processBatch (Port const& port, Json::Value&& requests,
+    beast::IP::Endpoint const& remoteIPAddress, Output const& output,
+    std::shared_ptr<JobQueue::Coro> const& coro,
+    std::string const& forwardedFor, std::string const& user,
+    Stream const& stream)
+{
+    auto rpcJ = app_.journal ("RPC");
+
+    if (requests.size () == 0 ||
+        requests.size () > RPC::Tuning::maxBatchSize)
+    {
+        HTTPReply (400, requests.size () == 0 ?
+            "Batch is empty" : "Batch is too large", output, rpcJ);
+        return 0;
+    }
+
+    // Each request is checked for its own role, all of them are
+    // charged to the same endpoint
+    auto const role = requestRole (Role::GUEST, port, Json::objectValue,
+        remoteIPAddress, user);
+
+    Resource::Consumer usage;
+    if (isUnlimited (role))
+    {
+        usage = m_resourceManager.newUnlimitedEndpoint (
+            remoteIPAddress.to_string ());
+    }
+    else
+    {
+        usage = m_resourceManager.newInboundEndpoint (remoteIPAddress);
+        if (usage.disconnect ())
+        {
+            HTTPReply (503, "Server is overloaded", output, rpcJ);
+            return 0;
+        }
+    }
+
+    if (role == Role::FORBID)
+    {
+        usage.charge (Resource::feeInvalidRPC);
+        HTTPReply (403, "Forbidden", output, rpcJ);
+        return 0;
+    }
+
+    // Every request sees the ledgers of the start of the batch
+    auto const start (std::chrono::high_resolution_clock::now ());
+    auto& ledgerMaster = app_.getLedgerMaster ();
+    RPC::Context::Ledgers ledgers;
+    ledgers.validated = ledgerMaster.getValidatedLedger ();
+    ledgers.closed = ledgerMaster.getClosedLedger ();
+    ledgers.current = ledgerMaster.getCurrentLedger ();
+    auto const batch = std::make_shared<Batch> (port, remoteIPAddress,
+        usage, forwardedFor, user, std::move (ledgers),
+        std::move (requests));
+    auto const size = batch->requests.size ();
+
+    JLOG (m_journal.debug()) << "Batch of " << size << " requests";
+
+    // The session starts before the requests so they can stop
+    // when it goes away
+    boost::optional<RPC::ReplyWriter> writer;
+    if (stream)
+    {
+        writer.emplace (HTTPChunkedReplyHeader (stream.keepAlive),
+            RPC::Tuning::maxReplyBuffer, coro);
+        auto const source = writer->getWriter ();
+        batch->session = source;
+        batch->streamed = true;
+        stream.write (source);
+    }
+
+    if (coro)
+    {
+        auto const jobs = std::min<std::size_t> (
+            size, RPC::Tuning::maxBatchJobs);
+        for (std::size_t i = 0; i < jobs; ++i)
+        {
+            m_jobQueue.postCoro (jtCLIENT, "RPC-Batch",
+                [this, batch](auto const& c)
+                {
+                    batch->run (*this, c);
+                });
+        }
+    }
+    else
+    {
+        batch->run (*this, nullptr);
+    }
+
+    std::size_t bytes = 0;
+    if (writer)
+    {
+        {
+            Json::Writer w (writer->output ());
+            w.startRoot (Json::Writer::array);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                w.rawAppend ();
+                w.output (batch->take (i, *this, coro));
+            }
+            w.finish ();
+        }
+        writer->write ("\n");
+        writer->finish ();
+        bytes = writer->getBytes ();
+    }
+    else
+    {
+        Json::Value reply (Json::arrayValue);
+        for (std::size_t i = 0; i < size; ++i)
+            reply.append (batch->take (i, *this, coro));
+        auto response = to_string (reply);
+        response += '\n';
+        bytes = response.size ();
+        HTTPReply (200, response, output, rpcJ);
+    }
+
+    rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
+        std::chrono::duration_cast <std::chrono::milliseconds> (
+            std::chrono::high_resolution_clock::now () - start)));
+    rpc_requests_ += size;
+    rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
+        bytes));
+    return 0;
+}
+
+// Run one request of a batch. Errors that would fail a request on its
+// own are reported in its reply.
+Json::Value
+ServerHandlerImp::processBatchItem (Batch& batch,
+    Json::Value const& jsonRPC, std::shared_ptr<JobQueue::Coro> const& coro)
+{
+    // The reply is built in an arena
+    Json::Arena::Scope arena;
+
+    Json::Value reply (Json::objectValue);
+    auto& result = reply[jss::result];
+    auto const fail = [&](error_code_i code, std::string const& message)
+    {
+        result = RPC::make_error (code, message);
+        result[jss::status] = jss::error;
+        result[jss::request] = jsonRPC;
+        return reply;
+    };
+
+    if (! jsonRPC.isObject ())
+    {
+        batch.usage.charge (Resource::feeInvalidRPC);
+        return fail (rpcINVALID_PARAMS, "Request is not an object");
+    }
+
+    if (jsonRPC.isMember(jss::jsonrpc))
+        reply[jss::jsonrpc] = jsonRPC[jss::jsonrpc];
+    if (jsonRPC.isMember(jss::FinPalrpc))
+        reply[jss::FinPalrpc] = jsonRPC[jss::FinPalrpc];
+    if (jsonRPC.isMember(jss::id))
+        reply[jss::id] = jsonRPC[jss::id];
+
+    if (batch.usage.disconnect ())
+        return fail (rpcSLOW_DOWN, "Server is overloaded");
+
+    Json::Value const& method = jsonRPC [jss::method];
+    if (! method || ! method.isString () || method.asString ().empty ())
+    {
+        batch.usage.charge (Resource::feeInvalidRPC);
+        return fail (rpcINVALID_PARAMS, "Missing method");
+    }
+    std::string const strMethod = method.asString ();
+
+    // As processRequest, params must be missing or one object
+    Json::Value params = jsonRPC [jss::params];
+    if (! params)
+    {
+        params = Json::Value (Json::objectValue);
+    }
+    else if (! params.isArray () || params.size () != 1 ||
+        ! params[0u].isObject ())
+    {
+        batch.usage.charge (Resource::feeInvalidRPC);
+        return fail (rpcINVALID_PARAMS, "params unparseable");
+    }
+    else
+    {
+        params = std::move (params[0u]);
+    }
+
+    auto const role = requestRole (RPC::roleRequired (strMethod),
+        batch.port, params, batch.remoteIPAddress, batch.user);
+    if (role == Role::FORBID)
+    {
+        batch.usage.charge (Resource::feeInvalidRPC);
+        return fail (rpcFORBIDDEN, "Forbidden");
+    }
+
+    std::string forwardedFor;
+    std::string user;
+    if (role == Role::IDENTIFIED)
+    {
+        forwardedFor = batch.forwardedFor;
+        user = batch.user;
+    }
+
+    params[jss::command] = strMethod;
+    JLOG (m_journal.trace())
+        << "doRpcCommand:" << strMethod << ":" << params;
+
+    Resource::Charge loadType = Resource::feeReferenceRPC;
+    auto const start = std::chrono::steady_clock::now ();
+    RPC::Context context {m_journal, params, app_, loadType, m_networkOPs,
+        app_.getLedgerMaster(), batch.usage, role, coro, InfoSub::pointer(),
+        {user, forwardedFor}, nullptr, false, false, batch.ledgers,
+        [&batch] { return batch.stopped (); }};
+    RPC::doCommand (context, result);
+
+    // The reply is not written on its own, so its size is not known
+    app_.getMethodStats ().onRequest (strMethod, params, &result,
+        std::chrono::duration_cast <std::chrono::microseconds> (
+            std::chrono::steady_clock::now () - start), 0);
+
+    if (result.isMember (jss::error))
+    {
+        result[jss::status] = jss::error;
+        result[jss::request] = params;
+    }
+    else
+    {
+        result[jss::status] = jss::success;
+    }
+
+    batch.usage.charge (loadType);
+    if (batch.usage.warn ())
+        result[jss::warning] = jss::load;
+    return reply;
+}
+
 //------------------------------------------------------------------------------
 
 /*  This response is used with load balancing.
@@ -830,6 +1344,16 @@ to_Port(ParsedPort const& parsed, std::ostream& log)
     p.ssl_chain = parsed.ssl_chain;
     p.ssl_ciphers = parsed.ssl_ciphers;
     p.pmd_options = parsed.pmd_options;
+    p.fast_json = parsed.fast_json;
+
+    // Peer handoff takes the connection over mid stream
+    if (parsed.pipeline > 1 && p.protocol.count("peer") > 0)
+    {
+        log << "Key 'pipeline' is not supported with protocol 'peer' in [" <<
+            p.name << "]\n";
+        Throw<std::exception> ();
+    }
+    p.pipeline = parsed.pipeline;
 
     return p;
 }
@@ -146,15 +146,51 @@ private:
             std::shared_ptr<JobQueue::Coro> const& coro,
                 Json::Value const& jv);
 
+    std::string
+    processBinary(
+        std::shared_ptr<WSSession> const& session,
+            std::shared_ptr<JobQueue::Coro> const& coro,
+                std::string const& request);
+
     void
     processSession (std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
+    // Hands the session a reply that is sent while it is written
+    struct Stream
+    {
+        std::function<void (std::shared_ptr<Writer> const&)> write;
+
+        // Whether the connection stays open after the reply
+        bool keepAlive = true;
+
+        explicit
+        operator bool () const
+        {
+            return static_cast<bool> (write);
+        }
+    };
+
     int
     processRequest (Port const& port, std::string const& request,
         beast::IP::Endpoint const& remoteIPAddress, Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
-        std::string forwardedFor, std::string user);
+        std::string forwardedFor, std::string user,
+        Stream const& stream);
+
+    // The requests of a JSON-RPC batch and their replies
+    struct Batch;
+
+    int
+    processBatch (Port const& port, Json::Value&& requests,
+        beast::IP::Endpoint const& remoteIPAddress, Output const& output,
+        std::shared_ptr<JobQueue::Coro> const& coro,
+        std::string const& forwardedFor, std::string const& user,
+        Stream const& stream);
+
+    Json::Value
+    processBatchItem (Batch& batch, Json::Value const& jsonRPC,
+        std::shared_ptr<JobQueue::Coro> const& coro);
 
     Handoff
     statusResponse(http_request_type const& request) const;
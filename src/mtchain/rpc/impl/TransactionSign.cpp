@@ -1290,5 +1290,64 @@ Json::Value transactionSubmitMultiSigned (
     return transactionFormatResultImpl (txn.second);
 }
 
+SubmittedBlob submitBlob (
+    Slice const& blob,
+    NetworkOPs::FailHard failType,
+    Role role,
+    Application& app,
+    ProcessTransactionFn const& processTransaction)
+{
+    SubmittedBlob result;
+
+    try
+    {
+        SerialIter sit (blob);
+        result.stTx = std::make_shared<STTx const> (std::ref (sit));
+    }
+    catch (std::exception& e)
+    {
+        result.error = "invalidTransaction";
+        result.exception = e.what ();
+        return result;
+    }
+
+    if (!app.checkSigs())
+        forceValidity(app.getHashRouter(),
+            result.stTx->getTransactionID(), Validity::SigGoodOnly);
+    auto validity = checkValidity(app.getHashRouter(),
+        *result.stTx, app.getLedgerMaster().getCurrentLedger()->rules(),
+            app.config());
+    if (validity.first != Validity::Valid)
+    {
+        result.error = "invalidTransaction";
+        result.exception = "fails local checks: " + validity.second;
+        return result;
+    }
+
+    std::string reason;
+    auto tpTrans = std::make_shared<Transaction> (
+        result.stTx, reason, app);
+    if (tpTrans->getStatus() != NEW)
+    {
+        result.error = "invalidTransaction";
+        result.exception = "fails local checks: " + reason;
+        return result;
+    }
+
+    result.transaction = tpTrans;
+    try
+    {
+        processTransaction (
+            result.transaction, isUnlimited (role), true, failType);
+    }
+    catch (std::exception& e)
+    {
+        result.error = "internalSubmit";
+        result.exception = e.what ();
+    }
+
+    return result;
+}
+
 } // RPC
 } //
@@ -12,6 +12,7 @@
 #define MTCHAIN_RPC_TRANSACTIONSIGN_H_INCLUDED
 
 #include <mtchain/app/misc/NetworkOPs.h>
+#include <mtchain/basics/Slice.h>
 #include <mtchain/rpc/Role.h>
 #include <mtchain/ledger/ApplyView.h>
 
@@ -20,6 +21,7 @@ namespace mtchain {
 // Forward declarations
 class Application;
 class LoadFeeTrack;
+class STTx;
 class Transaction;
 class TxQ;
 
@@ -92,6 +94,28 @@ Json::Value transactionSubmit (
     Application& app,
     ProcessTransactionFn const& processTransaction);
 
+/** The outcome of submitting a serialized transaction. */
+struct SubmittedBlob
+{
+    // Null if the blob is not a transaction
+    std::shared_ptr<STTx const> stTx;
+
+    // Null unless the transaction passed the local checks
+    std::shared_ptr<Transaction> transaction;
+
+    // The error token and its details, if the submission failed
+    char const* error = nullptr;
+    std::string exception;
+};
+
+/** Check and submit a serialized transaction, as submit does a tx_blob. */
+SubmittedBlob submitBlob (
+    Slice const& blob,
+    NetworkOPs::FailHard failType,
+    Role role,
+    Application& app,
+    ProcessTransactionFn const& processTransaction);
+
 /** Returns a Json::objectValue. */
 Json::Value transactionSignFor (
     Json::Value params,  // Passed by value so it can be modified locally.
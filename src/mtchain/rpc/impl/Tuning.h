@@ -41,6 +41,9 @@ static LimitRange const bookOffers = {0, 300, 400};
 /** Limits for the no_mtchain_check command. */
 static LimitRange const noMtchainCheck = {10, 300, 400};
 
+/** Limits for the time to live of a ledger_handle, in seconds. */
+static LimitRange const ledgerHandleTTL = {1, 60, 300};
+
 static int const defaultAutoFillFeeMultiplier = 10;
 static int const defaultAutoFillFeeDivisor = 1;
 static int const maxPathfindsInProgress = 2;
@@ -50,6 +53,30 @@ using namespace std::chrono_literals;
 auto constexpr maxValidatedLedgerAge = 60min;//2min;
 static int const maxRequestSize = 1000000;
 
+/** Most bytes of a streamed reply held unsent before its writer waits. */
+static int const maxReplyBuffer = 256 * 1024;
+
+/** Most requests in one JSON-RPC batch. */
+static int const maxBatchSize = 1000;
+
+/** Most requests of one batch that run at the same time. */
+static int const maxBatchJobs = 8;
+
+/** Most transactions in one binary submit request. */
+static std::size_t const maxBinarySubmit = 256;
+
+/** Requests taking this long or longer are logged as slow. */
+auto constexpr slowRequestTime = 500ms;
+
+/** Most slow requests logged in one second. */
+static int const slowRequestsPerSecond = 10;
+
+/** Most slow requests kept in the log. */
+static std::size_t const slowRequestLogSize = 100;
+
+/** Most characters of the parameters of a slow request kept. */
+static std::size_t const slowRequestParamsSize = 1024;
+
 /** Maximum number of pages in one response from a binary LedgerData request. */
 static int const binaryPageLength = 2048;
 
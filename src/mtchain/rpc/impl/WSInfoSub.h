@@ -77,6 +77,15 @@ public:
                 std::move(sb));
         sp->send(m);
     }
+
+    void
+    publish(Event const& event) override
+    {
+        auto sp = ws_.lock();
+        if(! sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(event.getText()));
+    }
 };
 
 } //
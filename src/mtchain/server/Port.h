@@ -49,6 +49,13 @@ struct Port
     // port in the range [0, 65535] where 0 means unlimited.
     int limit = 0;
 
+    // Parse requests with Json::FastReader instead of Json::Reader
+    bool fast_json = false;
+
+    // How many HTTP requests on one connection may be in progress at
+    // once. Responses are sent in the order the requests arrived.
+    std::size_t pipeline = 1;
+
     // Returns `true` if any websocket protocols are specified
     bool websockets() const;
 
@@ -78,6 +85,8 @@ struct ParsedPort
     std::string ssl_ciphers;
     beast::websocket::permessage_deflate pmd_options;
     int limit = 0;
+    bool fast_json = false;
+    std::size_t pipeline = 1;
 
     boost::optional<boost::asio::ip::address> ip;
     boost::optional<std::uint16_t> port;
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -56,6 +57,14 @@ public:
         std::vector<boost::asio::const_buffer>>
     prepare(std::size_t bytes,
         std::function<void(void)> resume) = 0;
+
+    /** Returns `true` if the message is sent as binary. */
+    virtual
+    bool
+    binary() const
+    {
+        return false;
+    }
 };
 
 template<class Streambuf>
@@ -97,6 +106,62 @@ public:
     }
 };
 
+/** A message whose data is shared, unchanged, with other sessions. */
+class SharedWSMsg : public WSMsg
+{
+    std::shared_ptr<std::string const> data_;
+    std::size_t pos_ = 0;
+    std::size_t n_ = 0;
+
+public:
+    explicit
+    SharedWSMsg(std::shared_ptr<std::string const> data)
+        : data_(std::move(data))
+    {
+    }
+
+    std::pair<boost::tribool,
+        std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes,
+        std::function<void(void)>) override
+    {
+        pos_ += n_;
+        auto const remaining = data_->size() - pos_;
+        if (remaining == 0)
+            return{true, {}};
+        boost::tribool done;
+        if (bytes < remaining)
+        {
+            n_ = bytes;
+            done = false;
+        }
+        else
+        {
+            n_ = remaining;
+            done = true;
+        }
+        return{done, {boost::asio::const_buffer(
+            data_->data() + pos_, n_)}};
+    }
+};
+
+/** A message sent as binary. */
+class BinaryWSMsg : public SharedWSMsg
+{
+public:
+    explicit
+    BinaryWSMsg(std::shared_ptr<std::string const> data)
+        : SharedWSMsg(std::move(data))
+    {
+    }
+
+    bool
+    binary() const override
+    {
+        return true;
+    }
+};
+
 struct WSSession
 {
     std::shared_ptr<void> appDefined;
@@ -117,6 +182,11 @@ struct WSSession
     boost::asio::ip::tcp::endpoint const&
     remote_endpoint() const = 0;
 
+    /** Returns `true` if the message being handled arrived as binary. */
+    virtual
+    bool
+    binary() const = 0;
+
     /** Send a WebSockets message. */
     virtual
     void
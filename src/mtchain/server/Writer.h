@@ -49,6 +49,17 @@ public:
     virtual
     std::vector<boost::asio::const_buffer>
     data() = 0;
+
+    /** Returns `true` if the data ended before the response did.
+
+        The connection is closed once what there is has been sent.
+    */
+    virtual
+    bool
+    failed()
+    {
+        return false;
+    }
 };
 
 } //
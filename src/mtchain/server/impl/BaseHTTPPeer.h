@@ -28,6 +28,7 @@
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -74,6 +75,137 @@ protected:
         std::size_t used;
     };
 
+    // A request read while the responses to earlier requests on the
+    // connection may still be pending. Its response is held back until
+    // theirs have been sent.
+    class Pipelined
+        : public Session
+        , public std::enable_shared_from_this<Pipelined>
+    {
+    public:
+        Pipelined(std::shared_ptr<Impl> peer, http_request_type&& message)
+            : peer_(std::move(peer))
+            , message_(std::move(message))
+            , keep_alive_(is_keep_alive(message_))
+        {
+        }
+
+        beast::Journal
+        journal() override
+        {
+            return peer().journal_;
+        }
+
+        Port const&
+        port() override
+        {
+            return peer().port_;
+        }
+
+        beast::IP::Endpoint
+        remoteAddress() override
+        {
+            return peer().remoteAddress();
+        }
+
+        http_request_type&
+        request() override
+        {
+            return message_;
+        }
+
+        void
+        write(void const* buffer, std::size_t bytes) override
+        {
+            if(bytes == 0)
+                return;
+            update([&]
+                {
+                    wq_.emplace_back(buffer, bytes);
+                });
+        }
+
+        void
+        write(std::shared_ptr <Writer> const& writer,
+            bool keep_alive) override
+        {
+            update([&]
+                {
+                    writer_ = writer;
+                    complete_ = true;
+                    keep_alive_ = keep_alive_ && keep_alive;
+                });
+        }
+
+        std::shared_ptr<Session>
+        detach() override
+        {
+            return this->shared_from_this();
+        }
+
+        void
+        complete() override
+        {
+            update([&]
+                {
+                    complete_ = true;
+                });
+        }
+
+        void
+        close(bool graceful) override
+        {
+            if(! graceful)
+                return peer_->close();
+            update([&]
+                {
+                    complete_ = true;
+                    keep_alive_ = false;
+                });
+        }
+
+        std::shared_ptr<WSSession>
+        websocketUpgrade() override
+        {
+            return nullptr;
+        }
+
+    private:
+        friend class BaseHTTPPeer;
+
+        BaseHTTPPeer&
+        peer()
+        {
+            return *peer_;
+        }
+
+        // Change the response and send what is ready
+        template<class F>
+        void
+        update(F const& f)
+        {
+            {
+                std::lock_guard<std::mutex> lock(peer().mutex_);
+                f();
+                if(peer().flushing_)
+                    return;
+                peer().flushing_ = true;
+            }
+            boost::asio::spawn(peer().strand_, std::bind(
+                &BaseHTTPPeer<Handler, Impl>::do_flush, peer_,
+                    std::placeholders::_1));
+        }
+
+        std::shared_ptr<Impl> peer_;
+        http_request_type message_;
+
+        // Guarded by the peer's mutex_
+        std::vector<buffer> wq_;
+        std::shared_ptr <Writer> writer_;
+        bool complete_ = false;
+        bool keep_alive_;
+    };
+
     Port const& port_;
     Handler& handler_;
     boost::asio::io_service::work work_;
@@ -98,6 +230,15 @@ protected:
     std::size_t bytes_in_ = 0;
     std::size_t bytes_out_ = 0;
 
+    // When the port allows pipelining, the requests not yet answered,
+    // oldest first. Only the strand touches these.
+    std::deque<std::shared_ptr<Pipelined>> pipeline_;
+    bool reading_ = false;
+    bool waiting_ = false;      // the pipeline is full
+    bool parked_ = false;       // an upgrade waits for the pipeline to empty
+    bool idle_ = false;         // the timer is waiting for a request
+    bool flushing_ = false;     // guarded by mutex_
+
     //--------------------------------------------------------------------------
 
 public:
@@ -147,6 +288,28 @@ protected:
     do_writer(std::shared_ptr <Writer> const& writer,
         bool keep_alive, yield_context do_yield);
 
+    bool
+    pipelining() const
+    {
+        return port_.pipeline > 1;
+    }
+
+    std::shared_ptr<Pipelined>
+    enqueue();
+
+    // Pass the request read to the handler
+    void
+    on_request();
+
+    // Answer the request read without the handler
+    void
+    on_response(std::shared_ptr <Writer> const& writer,
+        bool keep_alive);
+
+    // Send the pipelined responses that are ready, in order
+    void
+    do_flush(yield_context do_yield);
+
     virtual
     void
     do_request() = 0;
@@ -261,6 +424,11 @@ fail(error_code ec, char const* what)
             std::string(what) << ": " << ec.message();
         impl().stream_.lowest_layer().close(ec);
     }
+
+    // Requests not answered hold the connection
+    pipeline_.clear();
+    waiting_ = false;
+    parked_ = false;
 }
 
 template<class Handler, class Impl>
@@ -315,12 +483,35 @@ do_read(yield_context do_yield)
 {
     complete_ = false;
     error_code ec;
-    start_timer();
+    // While requests are in progress the writes own the timer
+    if(pipeline_.empty())
+    {
+        idle_ = true;
+        start_timer();
+    }
+    reading_ = true;
     beast::http::async_read(impl().stream_,
         read_buf_, message_, do_yield[ec]);
-    cancel_timer();
+    reading_ = false;
+    if(idle_)
+    {
+        idle_ = false;
+        cancel_timer();
+    }
+    if(ec == boost::asio::error::eof && ! pipeline_.empty())
+    {
+        // Answer the requests already read, then close
+        std::lock_guard<std::mutex> lock(mutex_);
+        pipeline_.back()->keep_alive_ = false;
+        return;
+    }
     if(ec)
         return fail(ec, "http::read");
+    if(beast::http::is_upgrade(message_) && ! pipeline_.empty())
+    {
+        parked_ = true;
+        return;
+    }
     do_request();
 }
 
@@ -382,7 +573,7 @@ do_writer(std::shared_ptr <Writer> const& writer,
             });
     }
 
-    for(;;)
+    while(! writer->complete())
     {
         if(! writer->prepare(bufferSize, resume))
             return;
@@ -393,17 +584,175 @@ do_writer(std::shared_ptr <Writer> const& writer,
         if(ec)
             return fail(ec, "writer");
         writer->consume(bytes_transferred);
-        if(writer->complete())
-            break;
     }
 
-    if(! keep_alive)
+    if(! keep_alive || writer->failed())
         return do_close();
 
     boost::asio::spawn(strand_, std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
         impl().shared_from_this(), std::placeholders::_1));
 }
 
+template<class Handler, class Impl>
+auto
+BaseHTTPPeer<Handler, Impl>::
+enqueue() ->
+    std::shared_ptr<Pipelined>
+{
+    auto const p = std::make_shared<Pipelined>(
+        impl().shared_from_this(), std::move(message_));
+    message_ = {};
+    pipeline_.push_back(p);
+
+    // Read the next request while the handler works on this one
+    if(p->keep_alive_)
+    {
+        if(pipeline_.size() < port_.pipeline)
+            boost::asio::spawn(strand_, std::bind(
+                &BaseHTTPPeer<Handler, Impl>::do_read,
+                    impl().shared_from_this(), std::placeholders::_1));
+        else
+            waiting_ = true;
+    }
+    return p;
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+on_request()
+{
+    if(! pipelining())
+        return handler_.onRequest(session());
+    auto const p = enqueue();
+    handler_.onRequest(*p);
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+on_response(std::shared_ptr <Writer> const& writer,
+    bool keep_alive)
+{
+    if(! pipelining())
+        return write(writer, keep_alive);
+    enqueue()->write(writer, keep_alive);
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+do_flush(yield_context do_yield)
+{
+    std::function <void(void)> resume;
+    {
+        auto const p = impl().shared_from_this();
+        resume = std::function <void(void)>(
+            [this, p]()
+            {
+                boost::asio::spawn(strand_, std::bind(
+                    &BaseHTTPPeer<Handler, Impl>::do_flush, p,
+                        std::placeholders::_1));
+            });
+    }
+
+    for(;;)
+    {
+        std::shared_ptr<Pipelined> p;
+        std::vector<buffer> wq;
+        std::shared_ptr <Writer> writer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(! pipeline_.empty())
+            {
+                p = pipeline_.front();
+                std::swap(wq, p->wq_);
+                writer = p->writer_;
+            }
+            if(! p || (wq.empty() && ! writer && ! p->complete_))
+            {
+                flushing_ = false;
+                return;
+            }
+        }
+
+        error_code ec;
+        if(! wq.empty())
+        {
+            std::vector<boost::asio::const_buffer> v;
+            v.reserve(wq.size());
+            for(auto const& b : wq)
+                v.emplace_back(b.data.get(), b.bytes);
+            start_timer();
+            auto const bytes_transferred = boost::asio::async_write(
+                impl().stream_, v, do_yield[ec]);
+            cancel_timer();
+            if(ec)
+                return fail(ec, "write");
+            bytes_out_ += bytes_transferred;
+            // More may have been written meanwhile
+            continue;
+        }
+
+        if(writer)
+        {
+            while(! writer->complete())
+            {
+                if(! writer->prepare(bufferSize, resume))
+                    return;
+                auto const bytes_transferred = boost::asio::async_write(
+                    impl().stream_, writer->data(),
+                        boost::asio::transfer_at_least(1), do_yield[ec]);
+                if(ec)
+                    return fail(ec, "writer");
+                writer->consume(bytes_transferred);
+                bytes_out_ += bytes_transferred;
+            }
+        }
+
+        // The response has been sent
+        pipeline_.pop_front();
+        bool keep_alive;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            keep_alive = p->keep_alive_;
+        }
+        if(writer && writer->failed())
+            keep_alive = false;
+        if(! keep_alive)
+        {
+            // Requests read after this one are dropped. flushing_
+            // stays set so that their responses are never started.
+            pipeline_.clear();
+            waiting_ = false;
+            parked_ = false;
+            if(reading_)
+                impl().stream_.lowest_layer().cancel(ec);
+            return do_close();
+        }
+        if(waiting_)
+        {
+            waiting_ = false;
+            boost::asio::spawn(strand_, std::bind(
+                &BaseHTTPPeer<Handler, Impl>::do_read,
+                    impl().shared_from_this(), std::placeholders::_1));
+        }
+        else if(pipeline_.empty())
+        {
+            if(parked_)
+            {
+                parked_ = false;
+                do_request();
+            }
+            else if(reading_)
+            {
+                idle_ = true;
+                start_timer();
+            }
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 
 // Send a copy of the data.
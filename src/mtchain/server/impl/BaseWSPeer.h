@@ -86,6 +86,12 @@ public:
         return this->remote_address_;
     }
 
+    bool
+    binary() const override
+    {
+        return op_ == beast::websocket::opcode::binary;
+    }
+
     void
     send(std::shared_ptr<WSMsg> w) override;
 
@@ -295,6 +301,9 @@ on_write(error_code const& ec)
     if(boost::indeterminate(result.first))
         return;
     start_timer();
+    // Takes effect at the start of each message
+    impl().ws_.set_option(beast::websocket::message_type{w.binary() ?
+        beast::websocket::opcode::binary : beast::websocket::opcode::text});
     if(! result.first)
         impl().ws_.async_write_frame(
             result.first, result.second, strand_.wrap(std::bind(
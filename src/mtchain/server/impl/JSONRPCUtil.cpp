@@ -109,4 +109,15 @@ void HTTPReply (
     output ("\r\n");
 }
 
+std::string HTTPChunkedReplyHeader (bool keepAlive)
+{
+    return "HTTP/1.1 200 OK\r\n" + getHTTPHeaderTimestamp () +
+        (keepAlive ? "Connection: Keep-Alive\r\n" : "Connection: close\r\n") +
+        "Transfer-Encoding: chunked\r\n"
+        "Content-Type: application/json; charset=UTF-8\r\n"
+        "Server: " + systemName () + "-json-rpc/" +
+        BuildInfo::getFullVersionString () + "\r\n"
+        "\r\n";
+}
+
 } //
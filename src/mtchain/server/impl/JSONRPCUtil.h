@@ -20,6 +20,12 @@ std::string getHTTPHeaderTimestamp ();
 void HTTPReply (
     int nStatus, std::string const& strMsg, Json::Output const&, beast::Journal j);
 
+/** Returns the header of a 200 reply whose content is sent in chunks.
+
+    @param keepAlive Whether the connection stays open after the reply.
+*/
+std::string HTTPChunkedReplyHeader (bool keepAlive);
+
 } //
 
 #endif
@@ -119,7 +119,7 @@ do_request()
             stream_.shutdown(socket_type::shutdown_receive, ec);
         if (ec)
             return this->fail(ec, "request");
-        return this->write(what.response, what.keep_alive);
+        return this->on_response(what.response, what.keep_alive);
     }
 
     // Perform half-close when Connection: close and not SSL
@@ -128,7 +128,7 @@ do_request()
     if (ec)
         return this->fail(ec, "request");
     // legacy
-    this->handler_.onRequest(this->session());
+    this->on_request();
 }
 
 template<class Handler>
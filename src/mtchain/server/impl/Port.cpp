@@ -196,6 +196,29 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
         }
     }
 
+    {
+        auto const result = section.find("pipeline");
+        if (result.second)
+        {
+            try
+            {
+                port.pipeline =
+                    beast::lexicalCastThrow<std::uint16_t>(result.first);
+
+                // At least one request must be allowed
+                if (port.pipeline == 0)
+                    Throw<std::exception> ();
+            }
+            catch (std::exception const&)
+            {
+                log <<
+                    "Invalid value '" << result.first << "' for key " <<
+                    "'pipeline' in [" << section.name() << "]\n";
+                Rethrow();
+            }
+        }
+    }
+
     populate (section, "admin", log, port.admin_ip, true, {});
     populate (section, "secure_gateway", log, port.secure_gateway_ip, false,
         port.admin_ip.get_value_or({}));
@@ -223,6 +246,7 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
         section.value_or("compress_level", 3);
     port.pmd_options.memLevel =
         section.value_or("memory_level", 4);
+    port.fast_json = section.value_or("fast_json", false);
 }
 
 } //
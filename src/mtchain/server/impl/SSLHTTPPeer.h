@@ -148,9 +148,9 @@ do_request()
     if(what.moved)
         return;
     if(what.response)
-        return this->write(what.response, what.keep_alive);
+        return this->on_response(what.response, what.keep_alive);
     // legacy
-    this->handler_.onRequest(this->session());
+    this->on_request();
 }
 
 template<class Handler>
@@ -169,6 +169,12 @@ public:
     const_iterator upper_bound(uint256 const& id) const;
 
     void visitNodes (std::function<bool (SHAMapAbstractNode&)> const&) const;
+
+    /** Visit the nodes below one branch of the root, excluding the root.
+        Different branches may be visited concurrently.
+    */
+    void visitBranch (int branch,
+        std::function<bool (SHAMapAbstractNode&)> const&) const;
     void
         visitLeaves(
             std::function<void(std::shared_ptr<SHAMapItem const> const&)> const&) const;
@@ -205,6 +211,19 @@ public:
 
     int flushDirty (NodeObjectType t, std::uint32_t seq);
     void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
+
+    /** Load every node of a backed map into the tree node cache.
+
+        The map is walked breadth-first, with many node store reads
+        outstanding at once, so that later lookups and walks find their
+        nodes in memory. Nodes are not hooked into the map.
+
+        @param progress Called after each batch of reads, and at the end,
+                        with the number of nodes loaded so far.
+        @return The number of nodes that could not be found.
+    */
+    std::size_t prefetch (
+        std::function<void (std::size_t)> const& progress = {}) const;
     bool deepCompare (SHAMap & other) const;  // Intended for debug/test only
 
     using fetchPackEntry_t = std::pair <uint256, Blob>;
@@ -294,6 +313,10 @@ private:
     std::shared_ptr<SHAMapAbstractNode>
         descendNoStore (std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
+    // Returns true if the function stopped the walk
+    bool visitInner (std::shared_ptr<SHAMapInnerNode> node,
+        std::function<bool (SHAMapAbstractNode&)> const&) const;
+
     /** If there is only one leaf below this node, get its contents */
     std::shared_ptr<SHAMapItem const> const& onlyBelow (SHAMapAbstractNode*) const;
 
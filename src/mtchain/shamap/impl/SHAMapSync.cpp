@@ -12,6 +12,8 @@
 #include <mtchain/basics/random.h>
 #include <mtchain/shamap/SHAMap.h>
 #include <mtchain/nodestore/Database.h>
+#include <algorithm>
+#include <deque>
 
 namespace mtchain {
 
@@ -41,10 +43,35 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
     if (!root_->isInner ())
         return;
 
+    visitInner (std::static_pointer_cast<SHAMapInnerNode>(root_), function);
+}
+
+void SHAMap::visitBranch (int branch,
+    std::function<bool (SHAMapAbstractNode&)> const& function) const
+{
+    // Visit the nodes below one branch of the root. Distinct branches
+    // share no nodes, so they may be walked from separate threads.
+    if (!root_ || !root_->isInner ())
+        return;
+
+    auto const root = std::static_pointer_cast<SHAMapInnerNode>(root_);
+    if (root->isEmptyBranch (branch))
+        return;
+
+    auto child = descendNoStore (root, branch);
+    if (function (*child) || child->isLeaf ())
+        return;
+
+    visitInner (std::static_pointer_cast<SHAMapInnerNode>(child), function);
+}
+
+bool SHAMap::visitInner (std::shared_ptr<SHAMapInnerNode> node,
+    std::function<bool (SHAMapAbstractNode&)> const& function) const
+{
+    // Visit every node below an inner node, returns true if stopped early
     using StackEntry = std::pair <int, std::shared_ptr<SHAMapInnerNode>>;
     std::stack <StackEntry, std::vector <StackEntry>> stack;
 
-    auto node = std::static_pointer_cast<SHAMapInnerNode>(root_);
     int pos = 0;
 
     while (1)
@@ -56,7 +83,7 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
             {
                 std::shared_ptr<SHAMapAbstractNode> child = descendNoStore (node, pos);
                 if (function (*child))
-                    return;
+                    return true;
 
                 if (child->isLeaf ())
                     ++pos;
@@ -89,6 +116,7 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
         std::tie(pos, node) = stack.top ();
         stack.pop ();
     }
+    return false;
 }
 
 /** Get a list of node IDs and hashes for nodes that are part of this SHAMap
@@ -292,6 +320,88 @@ SHAMap::getMissingNodes(std::size_t max, SHAMapSyncFilter* filter)
     return ret;
 }
 
+std::size_t
+SHAMap::prefetch (std::function<void (std::size_t)> const& progress) const
+{
+    if (!backed_ || !root_ || !root_->isInner ())
+        return 0;
+
+    // Issue up to this many reads before waiting for them
+    std::size_t const maxDefer = std::max (1, f_.db().getDesiredAsyncReadCount ());
+
+    std::size_t loaded = 0;
+    std::size_t missing = 0;
+
+    // Inner nodes whose children have not been requested, in level order
+    std::deque <std::shared_ptr<SHAMapInnerNode>> queue;
+    queue.push_back (std::static_pointer_cast<SHAMapInnerNode>(root_));
+
+    std::vector <SHAMapHash> deferredReads;
+    deferredReads.reserve (maxDefer + 16);
+
+    auto const found = [&](std::shared_ptr<SHAMapAbstractNode> const& node)
+    {
+        if (!node || isInconsistentNode (node))
+        {
+            ++missing;
+            return;
+        }
+
+        ++loaded;
+        if (node->isInner ())
+            queue.push_back (std::static_pointer_cast<SHAMapInnerNode>(node));
+    };
+
+    while (!queue.empty ())
+    {
+        auto const node = std::move (queue.front ());
+        queue.pop_front ();
+
+        for (int branch = 0; branch < 16; ++branch)
+        {
+            if (node->isEmptyBranch (branch))
+                continue;
+
+            auto const& childHash = node->getChildHash (branch);
+            auto child = node->getChild (branch);
+            if (!child)
+                child = getCache (childHash);
+            if (child)
+            {
+                found (child);
+                continue;
+            }
+
+            std::shared_ptr<NodeObject> obj;
+            if (f_.db().asyncFetch (childHash.as_uint256(), obj))
+                found (obj ? fetchNodeNT (childHash) : nullptr);
+            else
+                deferredReads.push_back (childHash);
+        }
+
+        bool const flush = deferredReads.size () >= maxDefer ||
+            (queue.empty () && !deferredReads.empty ());
+        if (!flush)
+            continue;
+
+        // The reads are complete, so these come from the database's cache
+        f_.db().waitReads ();
+        for (auto const& hash : deferredReads)
+            found (fetchNodeNT (hash));
+        deferredReads.clear ();
+
+        if (progress && !queue.empty ())
+            progress (loaded);
+    }
+
+    if (progress)
+        progress (loaded);
+
+    JLOG(journal_.debug()) << "prefetch loaded " << loaded <<
+        " nodes, " << missing << " missing";
+    return missing;
+}
+
 std::vector<uint256> SHAMap::getNeededHashes (int max, SHAMapSyncFilter* filter)
 {
     auto ret = getMissingNodes(max, filter);
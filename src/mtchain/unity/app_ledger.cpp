@@ -22,11 +22,14 @@
 #include <mtchain/app/ledger/TransactionStateSF.cpp>
 
 #include <mtchain/app/ledger/impl/ConsensusImp.cpp>
+#include <mtchain/app/ledger/impl/FetchPackStream.cpp>
+#include <mtchain/app/ledger/impl/FetchPipeline.cpp>
 #include <mtchain/app/ledger/impl/InboundLedger.cpp>
 #include <mtchain/app/ledger/impl/InboundLedgers.cpp>
 #include <mtchain/app/ledger/impl/InboundTransactions.cpp>
 #include <mtchain/app/ledger/impl/LedgerCleaner.cpp>
 #include <mtchain/app/ledger/impl/LedgerConsensusImp.cpp>
+#include <mtchain/app/ledger/impl/LedgerHandles.cpp>
 #include <mtchain/app/ledger/impl/LedgerMaster.cpp>
 #include <mtchain/app/ledger/impl/LedgerTiming.cpp>
 #include <mtchain/app/ledger/impl/LocalTxs.cpp>
@@ -17,10 +17,12 @@
 #include <mtchain/app/misc/SHAMapStoreImp.cpp>
 #include <mtchain/app/misc/Validations.cpp>
 
+#include <mtchain/app/misc/impl/AccountSubscriptions.cpp>
 #include <mtchain/app/misc/impl/AccountTxPaging.cpp>
 #include <mtchain/app/misc/impl/AmendmentTable.cpp>
 #include <mtchain/app/misc/impl/LoadFeeTrack.cpp>
 #include <mtchain/app/misc/impl/Manifest.cpp>
+#include <mtchain/app/misc/impl/SnapshotExport.cpp>
 #include <mtchain/app/misc/impl/Transaction.cpp>
 #include <mtchain/app/misc/impl/TxQ.cpp>
 #include <mtchain/app/misc/impl/ValidatorList.cpp>
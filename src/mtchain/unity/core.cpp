@@ -13,6 +13,7 @@
 #include <mtchain/core/impl/Config.cpp>
 #include <mtchain/core/impl/DatabaseCon.cpp>
 #include <mtchain/core/impl/DeadlineTimer.cpp>
+#include <mtchain/core/impl/Histogram.cpp>
 #include <mtchain/core/impl/LoadEvent.cpp>
 #include <mtchain/core/impl/LoadMonitor.cpp>
 #include <mtchain/core/impl/Job.cpp>
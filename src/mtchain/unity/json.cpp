@@ -22,6 +22,8 @@
 #include <mtchain/json/impl/json_writer.cpp>
 #include <mtchain/json/impl/to_string.cpp>
 
+#include <mtchain/json/impl/Arena.cpp>
+#include <mtchain/json/impl/FastReader.cpp>
 #include <mtchain/json/impl/JsonPropertyStream.cpp>
 #include <mtchain/json/impl/Writer.cpp>
 #include <mtchain/json/impl/Object.cpp>
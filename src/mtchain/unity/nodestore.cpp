@@ -15,6 +15,7 @@
 #include <mtchain/nodestore/backend/NullFactory.cpp>
 #include <mtchain/nodestore/backend/RocksDBFactory.cpp>
 #include <mtchain/nodestore/backend/RocksDBQuickFactory.cpp>
+#include <mtchain/nodestore/backend/SnapshotFactory.cpp>
 
 #include <mtchain/nodestore/impl/BatchWriter.cpp>
 #include <mtchain/nodestore/impl/DatabaseImp.h>
@@ -22,6 +23,9 @@
 #include <mtchain/nodestore/impl/DummyScheduler.cpp>
 #include <mtchain/nodestore/impl/DecodedBlob.cpp>
 #include <mtchain/nodestore/impl/EncodedBlob.cpp>
+#include <mtchain/nodestore/impl/Import.cpp>
 #include <mtchain/nodestore/impl/ManagerImp.cpp>
+#include <mtchain/nodestore/impl/NegativeCache.cpp>
 #include <mtchain/nodestore/impl/NodeObject.cpp>
+#include <mtchain/nodestore/impl/SnapshotWriter.cpp>
 
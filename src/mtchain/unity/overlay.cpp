@@ -12,12 +12,18 @@
 
 #include <mtchain/overlay/impl/ConnectAttempt.cpp>
 #include <mtchain/overlay/impl/Cluster.cpp>
+#include <mtchain/overlay/impl/Compression.cpp>
 #include <mtchain/overlay/impl/Message.cpp>
 #include <mtchain/overlay/impl/OverlayImpl.cpp>
 #include <mtchain/overlay/impl/PeerImp.cpp>
 #include <mtchain/overlay/impl/PeerSet.cpp>
+#include <mtchain/overlay/impl/QueryTracker.cpp>
+#include <mtchain/overlay/impl/SendQueue.cpp>
+#include <mtchain/overlay/impl/Squelch.cpp>
 #include <mtchain/overlay/impl/TMHello.cpp>
 #include <mtchain/overlay/impl/TrafficCount.cpp>
+#include <mtchain/overlay/impl/TrafficHistograms.cpp>
+#include <mtchain/overlay/impl/TxBatch.cpp>
 
 #if DOXYGEN
 #include <mtchain/overlay/README.md>
@@ -29,7 +29,6 @@
 #include <mtchain/rpc/handlers/AccountOffers.cpp>
 #include <mtchain/rpc/handlers/AccountTx.cpp>
 #include <mtchain/rpc/handlers/AccountTxOld.cpp>
-#include <mtchain/rpc/handlers/AccountTxSwitch.cpp>
 #include <mtchain/rpc/handlers/BlackList.cpp>
 #include <mtchain/rpc/handlers/BookOffers.cpp>
 #include <mtchain/rpc/handlers/CanDelete.cpp>
@@ -47,6 +46,7 @@
 #include <mtchain/rpc/handlers/LedgerCurrent.cpp>
 #include <mtchain/rpc/handlers/LedgerData.cpp>
 #include <mtchain/rpc/handlers/LedgerEntry.cpp>
+#include <mtchain/rpc/handlers/LedgerHandle.cpp>
 #include <mtchain/rpc/handlers/LedgerHeader.cpp>
 #include <mtchain/rpc/handlers/LedgerRequest.cpp>
 #include <mtchain/rpc/handlers/LogLevel.cpp>
@@ -60,6 +60,7 @@
 #include <mtchain/rpc/handlers/Print.cpp>
 #include <mtchain/rpc/handlers/Random.cpp>
 #include <mtchain/rpc/handlers/MTChainPathFind.cpp>
+#include <mtchain/rpc/handlers/RPCStats.cpp>
 #include <mtchain/rpc/handlers/ServerInfo.cpp>
 #include <mtchain/rpc/handlers/ServerState.cpp>
 #include <mtchain/rpc/handlers/SignFor.cpp>
@@ -68,6 +69,7 @@
 #include <mtchain/rpc/handlers/Submit.cpp>
 #include <mtchain/rpc/handlers/SubmitMultiSigned.cpp>
 #include <mtchain/rpc/handlers/Subscribe.cpp>
+#include <mtchain/rpc/handlers/TrafficHistograms.cpp>
 #include <mtchain/rpc/handlers/TransactionEntry.cpp>
 #include <mtchain/rpc/handlers/Tx.cpp>
 #include <mtchain/rpc/handlers/TxHistory.cpp>
@@ -84,7 +86,10 @@
 
 #include <mtchain/rpc/impl/Handler.cpp>
 #include <mtchain/rpc/impl/LegacyPathFind.cpp>
+#include <mtchain/rpc/impl/MethodStats.cpp>
 #include <mtchain/rpc/impl/Role.cpp>
+#include <mtchain/rpc/impl/BinaryCommand.cpp>
+#include <mtchain/rpc/impl/ReplyWriter.cpp>
 #include <mtchain/rpc/impl/RPCHelpers.cpp>
 #include <mtchain/rpc/impl/ServerHandlerImp.cpp>
 #include <mtchain/rpc/impl/TransactionSign.cpp>
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/misc/impl/AccountSubscriptions.h>
+#include <mtchain/app/misc/NetworkOPs.h>
+#include <mtchain/beast/unit_test.h>
+#include <test/jtx.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class AccountSubscriptions_test : public beast::unit_test::suite
+{
+    class Sub : public InfoSub
+    {
+    public:
+        explicit Sub (Source& source)
+            : InfoSub (source)
+        {
+        }
+
+        void
+        send (Json::Value const&, bool) override
+        {
+        }
+    };
+
+    void
+    testFind ()
+    {
+        testcase ("find");
+        using namespace jtx;
+        Env env (*this);
+        auto& source = env.app ().getOPs ();
+
+        AccountSubscriptions subs (4);
+        BEAST_EXPECT(subs.empty ());
+
+        auto const alice = Account ("alice").id ();
+        auto const bob = Account ("bob").id ();
+        auto const carol = Account ("carol").id ();
+        auto a = std::make_shared <Sub> (source);
+        auto b = std::make_shared <Sub> (source);
+        subs.add (alice, a);
+        subs.add (bob, a);
+        subs.add (bob, b);
+        BEAST_EXPECT(subs.size () == 2);
+
+        // A subscriber watching several of the accounts appears once
+        AccountSubscriptions::Listeners listeners;
+        subs.find ({ alice, bob, carol }, listeners);
+        BEAST_EXPECT(listeners.size () == 2);
+        subs.find ({ alice }, listeners);
+        BEAST_EXPECT(listeners.size () == 2);
+
+        listeners.clear ();
+        subs.find ({ carol }, listeners);
+        BEAST_EXPECT(listeners.empty ());
+
+        subs.remove (bob, a->getSeq ());
+        subs.find ({ bob }, listeners);
+        BEAST_EXPECT(listeners.size () == 1 && listeners[0] == b);
+        listeners.clear ();
+
+        // Subscribers that are gone are forgotten
+        b.reset ();
+        subs.find ({ bob }, listeners);
+        BEAST_EXPECT(listeners.empty ());
+        BEAST_EXPECT(subs.size () == 1);
+
+        subs.remove (alice, a->getSeq ());
+        BEAST_EXPECT(subs.empty ());
+    }
+
+    void
+    testConcurrent ()
+    {
+        testcase ("concurrent");
+        using namespace jtx;
+        Env env (*this);
+        auto& source = env.app ().getOPs ();
+
+        // Many watched accounts, published and subscribed at once
+        AccountSubscriptions subs;
+        std::vector <AccountID> accounts;
+        std::vector <std::shared_ptr <Sub>> listeners;
+        for (int i = 0; i < 1000; ++i)
+        {
+            accounts.push_back (
+                Account ("a" + std::to_string (i)).id ());
+            listeners.push_back (std::make_shared <Sub> (source));
+            subs.add (accounts.back (), listeners.back ());
+        }
+
+        std::atomic <std::size_t> found (0);
+        std::vector <std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back (
+                [&, t]
+                {
+                    AccountSubscriptions::Listeners l;
+                    for (int i = t; i < 1000; i += 4)
+                    {
+                        l.clear ();
+                        subs.find ({ accounts[i] }, l);
+                        found += l.size ();
+                    }
+                });
+        }
+        threads.emplace_back (
+            [&]
+            {
+                auto const late = std::make_shared <Sub> (source);
+                for (int i = 0; i < 1000; ++i)
+                    subs.add (accounts[i], late);
+                for (int i = 0; i < 1000; ++i)
+                    subs.remove (accounts[i], late->getSeq ());
+            });
+        for (auto& t : threads)
+            t.join ();
+
+        BEAST_EXPECT(found >= 1000);
+        BEAST_EXPECT(found <= 2000);
+        BEAST_EXPECT(subs.size () == 1000);
+    }
+
+public:
+    void
+    run () override
+    {
+        testFind ();
+        testConcurrent ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountSubscriptions,app,mtchain);
+
+}
+}
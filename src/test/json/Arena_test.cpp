@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/json/Arena.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/json/json_writer.h>
+#include <mtchain/beast/unit_test.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace mtchain {
+namespace test {
+
+class Arena_test : public beast::unit_test::suite
+{
+public:
+    // Heap calls made on this thread
+    static
+    std::size_t
+    heapCalls ()
+    {
+        auto const& stats = Json::Arena::getStats ();
+        return stats.heap + stats.blocks;
+    }
+
+    // A reply shaped like that of ledger_data
+    static
+    Json::Value
+    makeReply (int count)
+    {
+        Json::Value reply (Json::objectValue);
+        reply["ledger_index"] = 1234567;
+        reply["ledger_hash"] = std::string (64, 'A');
+        Json::Value& state = reply["state"] = Json::arrayValue;
+        for (int i = 0; i < count; ++i)
+        {
+            Json::Value& entry = state.append (Json::objectValue);
+            entry["Account"] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+            entry["Balance"] = std::to_string (1000000 + i);
+            entry["Flags"] = 0;
+            entry["LedgerEntryType"] = "AccountRoot";
+            entry["OwnerCount"] = i % 7;
+            entry["PreviousTxnID"] = std::string (64, 'B');
+            entry["PreviousTxnLgrSeq"] = 1234000 + i;
+            entry["Sequence"] = i;
+            entry["index"] = std::string (64, 'C');
+        }
+        return reply;
+    }
+
+    void
+    testScope ()
+    {
+        testcase ("scope");
+
+        std::size_t const before = heapCalls ();
+        Json::Value outside (std::string (10, 'x'));
+        BEAST_EXPECT(heapCalls () == before + 1);
+
+        Json::Value kept;
+        {
+            Json::Arena::Scope arena;
+            Json::Value inside (Json::objectValue);
+            for (int i = 0; i < 100; ++i)
+                inside[std::to_string (i)] = std::to_string (i);
+            // One block holds it all
+            BEAST_EXPECT(heapCalls () == before + 2);
+
+            // Strings too big to carve come from the heap
+            Json::Value big (std::string (10000, 'x'));
+            BEAST_EXPECT(heapCalls () == before + 3);
+
+            kept = inside;
+            {
+                Json::Arena::Scope nested;
+                Json::Value other ("nested");
+                BEAST_EXPECT(heapCalls () == before + 4);
+            }
+            Json::Value more ("more");
+            BEAST_EXPECT(heapCalls () == before + 4);
+
+            // A suspended arena leaves values on the heap
+            {
+                Json::Arena::Suspend heap;
+                Json::Value escapes ("escapes");
+                BEAST_EXPECT(heapCalls () == before + 5);
+            }
+            Json::Value last ("last");
+            BEAST_EXPECT(heapCalls () == before + 5);
+        }
+
+        // The values outlive the arena
+        BEAST_EXPECT(kept.size () == 100);
+        BEAST_EXPECT(kept["42"].asString () == "42");
+        Json::Value after ("after");
+        BEAST_EXPECT(heapCalls () == before + 6);
+    }
+
+    void
+    testThreads ()
+    {
+        testcase ("threads");
+
+        Json::Value reply;
+        {
+            Json::Arena::Scope arena;
+            reply = makeReply (1000);
+        }
+        auto const expected = Json::FastWriter ().write (reply);
+
+        // Another thread copies the reply and frees it
+        std::string written;
+        std::thread t (
+            [&written, reply = std::move (reply)] () mutable
+            {
+                written = Json::FastWriter ().write (reply);
+                Json::Value copy = reply;
+                reply = Json::Value ();
+            });
+        t.join ();
+        BEAST_EXPECT(written == expected);
+
+        // An arena is used on one thread at a time
+        Json::Arena arena;
+        BEAST_EXPECT(Json::Arena::exchange (&arena) == nullptr);
+        std::thread other (
+            [this]
+            {
+                BEAST_EXPECT(Json::Arena::exchange (nullptr) == nullptr);
+            });
+        other.join ();
+        BEAST_EXPECT(Json::Arena::exchange (nullptr) == &arena);
+    }
+
+    // Builds a reply, returning the heap calls made and its size
+    static
+    std::pair<std::size_t, std::size_t>
+    buildReply (int count, bool useArena)
+    {
+        std::size_t const before = heapCalls ();
+        std::size_t size = 0;
+        {
+            Json::Value reply;
+            if (useArena)
+            {
+                Json::Arena::Scope arena;
+                reply = makeReply (count);
+            }
+            else
+            {
+                reply = makeReply (count);
+            }
+            size = reply["state"].size ();
+        }
+        return { heapCalls () - before, size };
+    }
+
+    void
+    testReply ()
+    {
+        testcase ("reply");
+
+        int const count = 1000;
+        auto const heap = buildReply (count, false);
+        BEAST_EXPECT(heap.second == count);
+        auto const arena = buildReply (count, true);
+        BEAST_EXPECT(arena.second == count);
+
+        BEAST_EXPECT(heap.first > count * 10);
+        BEAST_EXPECT(arena.first * 20 < heap.first);
+    }
+
+    void
+    run () override
+    {
+        testScope ();
+        testThreads ();
+        testReply ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Arena,json,mtchain);
+
+//------------------------------------------------------------------------------
+
+// Times building a large reply with and without an arena
+class ArenaTiming_test : public beast::unit_test::suite
+{
+public:
+    void
+    run () override
+    {
+        using namespace std::chrono;
+
+        int const count = 10000;
+        auto const time = [count] (bool useArena)
+        {
+            auto const start = steady_clock::now ();
+            auto const result = Arena_test::buildReply (count, useArena);
+            return std::make_pair (result.first,
+                duration_cast<microseconds> (steady_clock::now () - start));
+        };
+
+        auto const heap = time (false);
+        auto const arena = time (true);
+        log << "heap: " << heap.first << " allocations, " <<
+            heap.second.count () << "us; arena: " << arena.first <<
+            " allocations, " << arena.second.count () << "us" << std::endl;
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(ArenaTiming,json,mtchain);
+
+}
+}
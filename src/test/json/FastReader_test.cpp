@@ -0,0 +1,455 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/json/FastReader.h>
+#include <mtchain/json/json_reader.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/json/to_string.h>
+#include <mtchain/beast/unit_test.h>
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class FastReader_test : public beast::unit_test::suite
+{
+public:
+    // Values equal in type as well as content
+    static
+    bool
+    same (Json::Value const& a, Json::Value const& b)
+    {
+        if (a.type () != b.type ())
+            return false;
+        switch (a.type ())
+        {
+        case Json::arrayValue:
+            if (a.size () != b.size ())
+                return false;
+            for (Json::UInt i = 0; i < a.size (); ++i)
+                if (! same (a[i], b[i]))
+                    return false;
+            return true;
+        case Json::objectValue:
+            if (a.getMemberNames () != b.getMemberNames ())
+                return false;
+            for (auto const& name : a.getMemberNames ())
+                if (! same (a[name], b[name]))
+                    return false;
+            return true;
+        default:
+            return a == b;
+        }
+    }
+
+    // Parses `text` with both readers, expecting the same outcome
+    bool
+    check (std::string const& text, bool strict)
+    {
+        Json::Value expected (7);
+        Json::Reader reader;
+        bool const ok = reader.parse (text, expected);
+
+        Json::Value value (7);
+        Json::FastReader fast;
+        bool const fastOk = fast.parse (text, value);
+        bool const matched = fastOk == ok && same (value, expected) &&
+            fast.getFormatedErrorMessages () ==
+                reader.getFormatedErrorMessages () &&
+            fast.fellBack () != strict;
+        if (! matched)
+            log << "mismatch: " << text << std::endl;
+        return matched;
+    }
+
+    void
+    testStrict ()
+    {
+        testcase ("strict");
+
+        char const* const docs[] = {
+            "{}",
+            "[]",
+            " \t\r\n{ } ",
+            "{\"a\":1}",
+            "[1,-1,0,-0,2147483647,2147483648,4294967295,-2147483648]",
+            "[1.5,-0.25,1e3,1E-3,-2.5e+2,0.1,123456789012345678901234567890.0]",
+            "[true,false,null,\"\"]",
+            "{\"a\":{\"b\":[{\"c\":[[],{}]}]},\"d\":\"e\"}",
+            "{\"\":0}",
+            "[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"]",
+            "[\"\\u0041\\u00e9\\u20AC\\ud83d\\ude00\"]",
+            "[\"\\\\\",\"\\\\\\\\\",\"a\\\\\\\"b\"]",
+            "{\"key with \\\"quotes\\\"\":\"{[,:]}\"}",
+            "[\"\xc3\xa9\xe2\x82\xac\"]",
+            "{\"method\":\"submit\",\"params\":[{\"tx_blob\":\"1200002280000000\"}]}",
+        };
+        for (auto doc : docs)
+            BEAST_EXPECT(check (doc, true));
+
+        // Strings and runs of backslashes across the 64 byte blocks
+        for (int n = 0; n < 140; ++n)
+        {
+            std::string padded = "[\"" + std::string (n, 'x') + "\\\\\\\"" +
+                std::string (n % 7, '\\') + std::string (n % 7, '\\') +
+                "\", " + std::string (n, ' ') + "1" + std::string (n, ' ') + "]";
+            BEAST_EXPECT(check (padded, true));
+        }
+    }
+
+    void
+    testFallback ()
+    {
+        testcase ("fallback");
+
+        char const* const docs[] = {
+            "",
+            "   ",
+            "1",
+            "\"a\"",
+            "{\"a\":1",
+            "{\"a\":1,}",
+            "{\"\":1,}",
+            "[1,]",
+            "[1 2]",
+            "{\"a\" 1}",
+            "{\"a\":1,\"a\":2}",
+            "{\"a\":1} trailing",
+            "{} {",
+            "// comment\n{\"a\":1}",
+            "{\"a\":/* comment */1}",
+            "[01]",
+            "[-]",
+            "[1.]",
+            "[.5]",
+            "[1e]",
+            "[4294967296]",
+            "[-2147483649]",
+            "[12345678901]",
+            "[tru]",
+            "[truex]",
+            "[nul]",
+            "[\"abc]",
+            "[\"\\x\"]",
+            "[\"\\u12\"]",
+            "[\"\\ud83d\"]",
+            "[\"\\ud83dx\\ude00\"]",
+            "{\"a\":1}\"",
+            "{1:2}",
+            "[\"a\"1]",
+            "\xef\xbb\xbf{}",
+        };
+        for (auto doc : docs)
+            BEAST_EXPECT(check (doc, false));
+    }
+
+    //--------------------------------------------------------------------------
+
+    class Generator
+    {
+    public:
+        explicit
+        Generator (std::uint32_t seed)
+            : engine_ (seed)
+        {
+        }
+
+        std::string
+        document ()
+        {
+            std::string s;
+            value (s, 0, true);
+            return s;
+        }
+
+        int
+        pick (int n)
+        {
+            return std::uniform_int_distribution<int> (0, n - 1) (engine_);
+        }
+
+    private:
+        void
+        space (std::string& s)
+        {
+            static char const spaces[] = { ' ', '\t', '\r', '\n' };
+            while (pick (4) == 0)
+                s += spaces[pick (4)];
+        }
+
+        void
+        string (std::string& s)
+        {
+            static char const* const pieces[] = {
+                "a", "Zz", " ", "{", "]", ":", ",", "\\\"", "\\\\", "\\/",
+                "\\n", "\\t", "\\u00e9", "\\ud83d\\ude00", "\xc3\xa9",
+                "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh", "\\\\\\\\\\\"",
+            };
+            s += '"';
+            for (int n = pick (12); n > 0; --n)
+                s += pieces[pick (sizeof (pieces) / sizeof (pieces[0]))];
+            s += '"';
+        }
+
+        void
+        number (std::string& s)
+        {
+            static char const* const numbers[] = {
+                "0", "-0", "7", "-12", "2147483647", "2147483648",
+                "4294967295", "-2147483648", "0.5", "-3.25e10", "1E-7",
+                "98765.4321",
+            };
+            s += numbers[pick (sizeof (numbers) / sizeof (numbers[0]))];
+        }
+
+        void
+        value (std::string& s, int depth, bool root)
+        {
+            space (s);
+            auto const kind = root ? 5 + pick (2) :
+                pick (depth > 4 ? 5 : 7);
+            switch (kind)
+            {
+            case 0: string (s); break;
+            case 1: number (s); break;
+            case 2: s += "true"; break;
+            case 3: s += "false"; break;
+            case 4: s += "null"; break;
+            case 5:
+            {
+                s += '[';
+                for (int n = pick (6), i = 0; i < n; ++i)
+                {
+                    if (i != 0)
+                        s += ',';
+                    value (s, depth + 1, false);
+                }
+                space (s);
+                s += ']';
+                break;
+            }
+            default:
+            {
+                s += '{';
+                for (int n = pick (6), i = 0; i < n; ++i)
+                {
+                    if (i != 0)
+                        s += ',';
+                    space (s);
+                    // Unique names, so the document is strict
+                    s += "\"k" + std::to_string (i);
+                    if (pick (3) == 0)
+                        s += "\\t";
+                    s += '"';
+                    space (s);
+                    s += ':';
+                    value (s, depth + 1, false);
+                }
+                space (s);
+                s += '}';
+                break;
+            }
+            }
+            space (s);
+        }
+
+        std::mt19937 engine_;
+    };
+
+    void
+    testRandom ()
+    {
+        testcase ("random");
+
+        Generator g (2718);
+        std::size_t mismatched = 0;
+        for (int i = 0; i < 3000; ++i)
+        {
+            auto doc = g.document ();
+            if (! check (doc, true))
+                ++mismatched;
+
+            // Damaged documents reach the same verdict
+            if (doc.size () > 2)
+            {
+                auto broken = doc;
+                switch (g.pick (3))
+                {
+                case 0:
+                    broken.resize (g.pick (doc.size ()));
+                    break;
+                case 1:
+                    broken[g.pick (doc.size ())] = "\"\\,:{}[]x1"[g.pick (10)];
+                    break;
+                default:
+                    broken.erase (g.pick (doc.size ()), 1);
+                    break;
+                }
+                Json::Value expected;
+                Json::Value value;
+                Json::FastReader fast;
+                if (Json::Reader ().parse (broken, expected) !=
+                        fast.parse (broken, value) ||
+                    ! same (value, expected))
+                {
+                    log << "mismatch: " << broken << std::endl;
+                    ++mismatched;
+                }
+            }
+        }
+        BEAST_EXPECT(mismatched == 0);
+    }
+
+    void
+    testBuffers ()
+    {
+        testcase ("buffers");
+
+        std::string const doc =
+            "{\"command\":\"account_info\",\"account\":\"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh\"}";
+        std::vector<boost::asio::const_buffer> buffers;
+        for (std::size_t i = 0; i < doc.size (); i += 10)
+            buffers.emplace_back (doc.data () + i,
+                std::min<std::size_t> (10, doc.size () - i));
+
+        Json::Value value;
+        Json::FastReader fast;
+        BEAST_EXPECT(fast.parse (value, buffers));
+        BEAST_EXPECT(! fast.fellBack ());
+        BEAST_EXPECT(value["account"] == "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh");
+
+        Json::Value single;
+        BEAST_EXPECT(fast.parse (single,
+            boost::asio::const_buffers_1 (doc.data (), doc.size ())));
+        BEAST_EXPECT(same (single, value));
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Requests shaped like the RPC and WebSocket traffic of a busy server
+    static
+    std::vector<std::string>
+    makeTraffic ()
+    {
+        std::string const account = "\"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh\"";
+        std::string const hash = "\"" + std::string (64, 'A') + "\"";
+        std::vector<std::string> requests;
+        for (int i = 0; i < 200; ++i)
+        {
+            auto const n = std::to_string (i);
+            requests.push_back ("{\"method\":\"account_info\",\"params\":[{"
+                "\"account\":" + account + ",\"ledger_index\":\"validated\","
+                "\"strict\":true}]}");
+            requests.push_back ("{\"id\":" + n + ",\"command\":\"tx\","
+                "\"transaction\":" + hash + ",\"binary\":false}");
+            requests.push_back ("{\"method\":\"submit\",\"params\":[{"
+                "\"tx_blob\":\"" + std::string (480 + i, 'F') + "\"}]}");
+            requests.push_back ("{\"method\":\"sign\",\"params\":[{"
+                "\"offline\":false,\"secret\":\"snoPBrXtMeMyMHUVTgbuqAfg1SUTb\","
+                "\"tx_json\":{\"Account\":" + account + ",\"Amount\":{"
+                "\"currency\":\"USD\",\"issuer\":" + account + ",\"value\":\"" +
+                n + ".25\"},\"Destination\":\"rPT1Sjq2YGrBMTttX4GZHjKu9dyfzbpAYe\","
+                "\"Fee\":\"12\",\"Flags\":2147483648,\"Sequence\":" + n +
+                ",\"TransactionType\":\"Payment\",\"Memos\":[{\"Memo\":{"
+                "\"MemoData\":\"48656C6C6F\",\"MemoType\":\"74657874\"}}]}}]}");
+            requests.push_back ("{\n  \"id\": " + n + ",\n  \"command\": "
+                "\"book_offers\",\n  \"taker_gets\": {\"currency\": \"MTC\"},\n"
+                "  \"taker_pays\": {\"currency\": \"USD\", \"issuer\": " +
+                account + "},\n  \"limit\": 20\n}");
+            requests.push_back ("{\"command\":\"subscribe\",\"accounts\":[" +
+                account + "," + account + "],\"streams\":[\"ledger\","
+                "\"transactions\"]}");
+            requests.push_back ("{\"method\":\"ledger_data\",\"params\":[{"
+                "\"ledger_hash\":" + hash + ",\"marker\":" + hash +
+                ",\"limit\":256,\"binary\":true}]}");
+        }
+        return requests;
+    }
+
+    void
+    testTraffic ()
+    {
+        testcase ("traffic");
+
+        for (auto const& request : makeTraffic ())
+            BEAST_EXPECT(check (request, true));
+    }
+
+    void
+    run () override
+    {
+        testStrict ();
+        testFallback ();
+        testRandom ();
+        testBuffers ();
+        testTraffic ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FastReader,json,mtchain);
+
+//------------------------------------------------------------------------------
+
+// Compares the parse rates of the readers on the same traffic, each
+// reader reused for every request as the server does
+class FastReaderTiming_test : public beast::unit_test::suite
+{
+public:
+    template <class Reader>
+    static
+    std::chrono::microseconds
+    parseAll (std::vector<std::string> const& requests, int rounds)
+    {
+        using namespace std::chrono;
+        auto const start = steady_clock::now ();
+        Reader reader;
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (auto const& request : requests)
+            {
+                Json::Value value;
+                reader.parse (request, value);
+            }
+        }
+        return duration_cast<microseconds> (steady_clock::now () - start);
+    }
+
+    void
+    run () override
+    {
+        auto const requests = FastReader_test::makeTraffic ();
+        std::size_t bytes = 0;
+        for (auto const& request : requests)
+            bytes += request.size ();
+
+        int const rounds = 20;
+        auto const classic = parseAll<Json::Reader> (requests, rounds);
+        auto const fast = parseAll<Json::FastReader> (requests, rounds);
+        auto const rate = [&] (std::chrono::microseconds t)
+        {
+            return double (bytes) * rounds / std::max<double> (1, t.count ());
+        };
+        log << requests.size () * rounds << " requests, " <<
+            "Json::Reader " << rate (classic) << "MB/s, " <<
+            "Json::FastReader " << rate (fast) << "MB/s" << std::endl;
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(FastReaderTiming,json,mtchain);
+
+}
+}
@@ -16,6 +16,7 @@
 #include <boost/optional.hpp>
 #include <chrono>
 #include <memory>
+#include <string>
 
 namespace mtchain {
 namespace test {
@@ -34,6 +35,13 @@ public:
     boost::optional<Json::Value>
     findMsg(std::chrono::milliseconds const& timeout,
         std::function<bool(Json::Value const&)> pred) = 0;
+
+    /** Send a binary message and retrieve the binary reply. */
+    virtual
+    boost::optional<std::string>
+    invokeBinary(std::string const& request,
+        std::chrono::milliseconds const& timeout =
+            std::chrono::milliseconds{5000}) = 0;
 };
 
 /** Returns a client operating through WebSockets/S. */
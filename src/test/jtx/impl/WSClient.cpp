@@ -100,6 +100,7 @@ class WSClientImpl : public WSClient
     std::mutex m_;
     std::condition_variable cv_;
     std::list<std::shared_ptr<msg>> msgs_;
+    std::list<std::string> binaryMsgs_;
 
     unsigned rpc_version_;
 
@@ -242,6 +243,24 @@ public:
         return std::move(m->jv);
     }
 
+    boost::optional<std::string>
+    invokeBinary(std::string const& request,
+        std::chrono::milliseconds const& timeout) override
+    {
+        using namespace beast::websocket;
+        ws_.set_option(message_type{opcode::binary});
+        ws_.write_frame(true, boost::asio::buffer(request));
+        ws_.set_option(message_type{opcode::text});
+
+        std::unique_lock<std::mutex> lock(m_);
+        if(! cv_.wait_for(lock, timeout,
+                [&]{ return ! binaryMsgs_.empty(); }))
+            return boost::none;
+        auto s = std::move(binaryMsgs_.back());
+        binaryMsgs_.pop_back();
+        return std::move(s);
+    }
+
     unsigned version() const override
     {
         return rpc_version_;
@@ -258,13 +277,22 @@ private:
             return;
         }
 
-        Json::Value jv;
-        Json::Reader jr;
-        jr.parse(buffer_string(rb_.data()), jv);
-        rb_.consume(rb_.size());
-        auto m = std::make_shared<msg>(
-            std::move(jv));
+        if(op_ == beast::websocket::opcode::binary)
+        {
+            auto s = buffer_string(rb_.data());
+            rb_.consume(rb_.size());
+            std::lock_guard<std::mutex> lock(m_);
+            binaryMsgs_.push_front(std::move(s));
+            cv_.notify_all();
+        }
+        else
         {
+            Json::Value jv;
+            Json::Reader jr;
+            jr.parse(buffer_string(rb_.data()), jv);
+            rb_.consume(rb_.size());
+            auto m = std::make_shared<msg>(
+                std::move(jv));
             std::lock_guard<std::mutex> lock(m_);
             msgs_.push_front(m);
             cv_.notify_all();
@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/impl/FetchPackStream.h>
+#include <mtchain/basics/random.h>
+#include <mtchain/beast/unit_test.h>
+#include <mtchain/shamap/SHAMapItem.h>
+#include <test/shamap/common.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class FetchPackStream_test : public beast::unit_test::suite
+{
+public:
+    static
+    SHAMapItem
+    makeItem ()
+    {
+        Serializer s;
+        for (int d = 0; d < 3; ++d)
+            s.add32 (rand_int <std::uint32_t> ());
+        return SHAMapItem (s.getSHA512Half (), s.peekData ());
+    }
+
+    void
+    testChunks ()
+    {
+        testcase ("chunks");
+
+        beast::Journal const j;
+        tests::TestFamily f (j);
+        SHAMap have (SHAMapType::FREE, f, SHAMap::version{1});
+        for (int i = 0; i < 2000; ++i)
+            have.addItem (makeItem (), false, false);
+        auto want = have.snapShot (true);
+        for (int i = 0; i < 300; ++i)
+            want->addItem (makeItem (), false, false);
+        have.getHash ();
+        have.setImmutable ();
+        want->getHash ();
+        want->setImmutable ();
+
+        // Everything the whole pack would hold
+        std::set <uint256> expected;
+        want->getFetchPack (&have, true, 16384,
+            [&expected] (SHAMapHash const& hash, Blob const&)
+            {
+                expected.insert (hash.as_uint256 ());
+            });
+        BEAST_EXPECT(expected.size () > 300);
+
+        protocol::TMGetObjectByHash request;
+        request.set_query (true);
+        request.set_seq (7);
+        request.set_ledgerhash (std::string (32, 'h'));
+        request.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
+
+        std::size_t const chunkBytes = 4096;
+        std::set <uint256> received;
+        std::size_t chunks = 0;
+        std::size_t largest = 0;
+        bool wellFormed = true;
+        FetchPackStream stream (request, chunkBytes,
+            [&] (protocol::TMGetObjectByHash const& chunk, std::size_t bytes)
+            {
+                ++chunks;
+                wellFormed = wellFormed && ! chunk.query () &&
+                    chunk.seq () == 7 &&
+                    chunk.ledgerhash () == request.ledgerhash () &&
+                    chunk.type () == protocol::TMGetObjectByHash::otFETCH_PACK;
+                std::size_t size = 0;
+                for (auto const& obj : chunk.objects ())
+                {
+                    uint256 hash;
+                    std::memcpy (hash.data (), obj.hash ().data (), 32);
+                    received.insert (hash);
+                    wellFormed = wellFormed && obj.ledgerseq () == 5;
+                    size += obj.data ().size ();
+                }
+                wellFormed = wellFormed && size == bytes;
+                largest = std::max (largest, bytes);
+            });
+
+        stream.addMap (5, *want, &have, 16384);
+        std::size_t const sent = chunks;
+        stream.flush ();
+        stream.flush ();
+
+        BEAST_EXPECT(wellFormed);
+        BEAST_EXPECT(sent > 1);
+        BEAST_EXPECT(chunks == sent + 1);
+        BEAST_EXPECT(stream.getChunks () == chunks);
+        BEAST_EXPECT(stream.getObjects () == expected.size ());
+        BEAST_EXPECT(received == expected);
+
+        // No chunk is bigger than the limit and one node
+        BEAST_EXPECT(largest >= chunkBytes);
+        BEAST_EXPECT(largest < chunkBytes + 1024);
+    }
+
+    void
+    run () override
+    {
+        testChunks ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FetchPackStream,ledger,mtchain);
+
+}
+}
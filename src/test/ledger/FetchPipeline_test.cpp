@@ -0,0 +1,382 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/impl/FetchPipeline.h>
+#include <mtchain/basics/random.h>
+#include <mtchain/beast/unit_test.h>
+#include <mtchain/shamap/SHAMap.h>
+#include <mtchain/shamap/SHAMapItem.h>
+#include <test/jtx/BasicNetwork.h>
+#include <test/shamap/common.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class FetchPipeline_test : public beast::unit_test::suite
+{
+public:
+    struct Node;
+    using Network = BasicNetwork <Node*>;
+
+    // Requests are served one at a time, each node taking `perNode`
+    struct Node
+    {
+        Peer::id_t id;
+        std::chrono::microseconds perNode;
+        Network::time_point busy;
+    };
+
+    // Checks that the requests cover [0, count) without overlapping
+    static
+    bool
+    covers (std::vector <FetchPipeline::Request> const& requests,
+        std::size_t count)
+    {
+        std::size_t next = 0;
+        for (auto const& r : requests)
+        {
+            if (r.first != next || r.count == 0)
+                return false;
+            next += r.count;
+        }
+        return next == count;
+    }
+
+    void
+    testAssign ()
+    {
+        using namespace std::chrono;
+        testcase ("assign");
+
+        Network net;
+        FetchPipeline pipeline (net.clock(), 2);
+        std::vector <Peer::id_t> const peers { 1, 2, 3 };
+        BEAST_EXPECT(pipeline.capacity (peers) == 6);
+
+        // Unmeasured peers share alike
+        auto requests = pipeline.assign (peers, 300, 128);
+        BEAST_EXPECT(covers (requests, 300));
+        BEAST_EXPECT(requests.size () == 3);
+        BEAST_EXPECT(pipeline.capacity (peers) == 3);
+
+        // A full pipeline takes no more
+        requests = pipeline.assign (peers, 1000, 128);
+        BEAST_EXPECT(covers (requests, 3 * 128));
+        BEAST_EXPECT(pipeline.capacity (peers) == 0);
+        BEAST_EXPECT(pipeline.assign (peers, 10, 128).empty ());
+
+        // Peer 1 replies quickly, peer 3 slowly
+        net.step_for (milliseconds (100));
+        pipeline.onReply (1, 100);
+        pipeline.onReply (1, 100);
+        net.step_for (milliseconds (900));
+        pipeline.onReply (3, 100);
+        pipeline.onReply (3, 100);
+        BEAST_EXPECT(pipeline.getNodes () == 400);
+        BEAST_EXPECT(pipeline.capacity (peers) == 4);
+
+        requests = pipeline.assign (peers, 200, 128);
+        BEAST_EXPECT(covers (requests, 200));
+        std::size_t fast = 0;
+        std::size_t slow = 0;
+        for (auto const& r : requests)
+        {
+            BEAST_EXPECT(r.peer != 2);
+            (r.peer == 1 ? fast : slow) += r.count;
+        }
+        BEAST_EXPECT(fast > 4 * slow);
+        BEAST_EXPECT(slow > 0);
+
+        auto const json = pipeline.getJson ();
+        BEAST_EXPECT(json.size () == 3);
+    }
+
+    void
+    testExpire ()
+    {
+        using namespace std::chrono;
+        testcase ("expire");
+
+        Network net;
+        FetchPipeline pipeline (net.clock(), 1);
+        std::vector <Peer::id_t> const peers { 1, 2 };
+        pipeline.assign (peers, 200, 128);
+        net.step_for (milliseconds (50));
+        pipeline.onReply (1, 100);
+        BEAST_EXPECT(pipeline.capacity (peers) == 1);
+
+        // Peer 2 never replies
+        net.step_for (seconds (3));
+        pipeline.expire (milliseconds (2500));
+        BEAST_EXPECT(pipeline.capacity (peers) == 2);
+        auto const requests = pipeline.assign (peers, 200, 128);
+        BEAST_EXPECT(covers (requests, 200));
+        BEAST_EXPECT(requests.size () == 2);
+        BEAST_EXPECT(requests.front ().peer == 1);
+        BEAST_EXPECT(requests.front ().count == 128);
+    }
+
+    //--------------------------------------------------------------------------
+
+    // A map acquired from several servers over a simulated network
+    class Sync
+    {
+    public:
+        Sync (SHAMap const& source, std::size_t depth, bool pipelined)
+            : journal_ ()
+            , family_ (journal_)
+            , source_ (source)
+            , destination_ (SHAMapType::FREE, family_, SHAMap::version{1})
+            , pipeline_ (net_.clock(), depth)
+            , pipelined_ (pipelined)
+        {
+            using namespace std::chrono;
+            client_.id = 0;
+            std::size_t const latency[] = { 20, 40, 60, 80, 120, 160 };
+            std::size_t const perNode[] = { 200, 50, 100, 400, 50, 150 };
+            for (Peer::id_t i = 0; i < 6; ++i)
+            {
+                servers_.push_back (std::make_unique <Node> (
+                    Node{ i + 1, microseconds (perNode[i]), {} }));
+                net_.connect (&client_, servers_.back ().get (),
+                    milliseconds (latency[i]));
+            }
+        }
+
+        // Returns the time taken to acquire the map
+        std::chrono::milliseconds
+        run ()
+        {
+            using namespace std::chrono;
+            auto const start = net_.now ();
+
+            std::vector <SHAMapNodeID> ids;
+            std::vector <Blob> blobs;
+            source_.getNodeFat (SHAMapNodeID (), ids, blobs, false, 0);
+            destination_.setSynching ();
+            destination_.addRootNode (source_.getHash (),
+                makeSlice (blobs.front ()), snfWIRE, nullptr);
+
+            trigger (nullptr, false);
+            onTimer ();
+            while (! done_ && net_.step_one ())
+                ;
+            return duration_cast <milliseconds> (net_.now () - start);
+        }
+
+        bool
+        complete ()
+        {
+            destination_.clearSynching ();
+            return source_.deepCompare (destination_);
+        }
+
+    private:
+        using Missing = std::vector <std::pair <SHAMapNodeID, uint256>>;
+
+        void
+        onTimer ()
+        {
+            if (done_)
+                return;
+            recent_.clear ();
+            pipeline_.expire (std::chrono::milliseconds (2500));
+            if (! progress_)
+                trigger (nullptr, false);
+            progress_ = false;
+            net_.timer (std::chrono::milliseconds (2500),
+                [this] { onTimer (); });
+        }
+
+        // Mirrors InboundLedger::trigger
+        void
+        trigger (Node* peer, bool reply)
+        {
+            std::size_t limit = 8;
+            if (reply)
+                limit = pipelined_
+                    ? std::min <std::size_t> (4096,
+                        pipeline_.capacity (ids ()) * 128)
+                    : 128;
+
+            auto nodes = destination_.getMissingNodes (
+                std::max <std::size_t> (256, limit), nullptr);
+            if (nodes.empty ())
+            {
+                done_ = true;
+                return;
+            }
+
+            auto const dup = std::stable_partition (
+                nodes.begin (), nodes.end (),
+                [this](auto const& n)
+                {
+                    return recent_.count (n.second) == 0;
+                });
+            if (dup == nodes.begin () && reply)
+                return;
+            if (dup != nodes.begin ())
+                nodes.erase (dup, nodes.end ());
+            if (nodes.size () > limit)
+                nodes.resize (limit);
+            for (auto const& n : nodes)
+                recent_.insert (n.second);
+
+            if (! reply)
+            {
+                for (auto const& server : servers_)
+                    request (server.get (), nodes, 0, nodes.size (), 0);
+            }
+            else if (! pipelined_)
+            {
+                request (peer, nodes, 0, nodes.size (), 1);
+            }
+            else
+            {
+                std::sort (nodes.begin (), nodes.end (),
+                    [](auto const& a, auto const& b)
+                    {
+                        return a.first.getNodeID () < b.first.getNodeID ();
+                    });
+                for (auto const& r : pipeline_.assign (
+                        ids (), nodes.size (), 128))
+                    request (servers_[r.peer - 1].get (),
+                        nodes, r.first, r.count, 1);
+            }
+        }
+
+        void
+        request (Node* server, Missing const& nodes,
+            std::size_t first, std::size_t count, int depth)
+        {
+            std::vector <SHAMapNodeID> wanted;
+            for (auto i = first; i != first + count; ++i)
+                wanted.push_back (nodes[i].first);
+            net_.send (&client_, server,
+                [this, server, wanted = std::move (wanted), depth]
+                {
+                    serve (server, wanted, depth);
+                });
+        }
+
+        void
+        serve (Node* server, std::vector <SHAMapNodeID> const& wanted,
+            int depth)
+        {
+            auto ids = std::make_shared <std::vector <SHAMapNodeID>> ();
+            auto blobs = std::make_shared <std::vector <Blob>> ();
+            for (auto const& id : wanted)
+                source_.getNodeFat (id, *ids, *blobs, false, depth);
+
+            server->busy = std::max (server->busy, net_.now ()) +
+                server->perNode * ids->size ();
+            net_.timer (server->busy,
+                [this, server, ids, blobs]
+                {
+                    net_.send (server, &client_,
+                        [this, server, ids, blobs]
+                        {
+                            receive (server, *ids, *blobs);
+                        });
+                });
+        }
+
+        void
+        receive (Node* server, std::vector <SHAMapNodeID> const& ids,
+            std::vector <Blob> const& blobs)
+        {
+            if (done_)
+                return;
+            std::size_t good = 0;
+            for (std::size_t i = 0; i < ids.size (); ++i)
+            {
+                if (destination_.addKnownNode (ids[i],
+                        makeSlice (blobs[i]), nullptr).isUseful ())
+                    ++good;
+            }
+            if (good != 0)
+                progress_ = true;
+            pipeline_.onReply (server->id, good);
+            trigger (server, true);
+        }
+
+        std::vector <Peer::id_t>
+        ids () const
+        {
+            std::vector <Peer::id_t> result;
+            for (auto const& server : servers_)
+                result.push_back (server->id);
+            return result;
+        }
+
+        beast::Journal journal_;
+        tests::TestFamily family_;
+        SHAMap const& source_;
+        SHAMap destination_;
+        Network net_;
+        Node client_;
+        std::vector <std::unique_ptr <Node>> servers_;
+        FetchPipeline pipeline_;
+        bool const pipelined_;
+        std::set <uint256> recent_;
+        bool progress_ = false;
+        bool done_ = false;
+    };
+
+    void
+    testSync ()
+    {
+        testcase ("sync");
+
+        beast::Journal const j;
+        tests::TestFamily f (j);
+        SHAMap source (SHAMapType::FREE, f, SHAMap::version{1});
+        for (int i = 0; i < 20000; ++i)
+        {
+            Serializer s;
+            for (int d = 0; d < 3; ++d)
+                s.add32 (rand_int <std::uint32_t> ());
+            source.addItem (SHAMapItem (s.getSHA512Half (), s.peekData ()),
+                false, false);
+        }
+        // Hash the tree before the servers share it
+        source.getHash ();
+        source.setImmutable ();
+
+        Sync single (source, 1, false);
+        auto const singleTime = single.run ();
+        BEAST_EXPECT(single.complete ());
+
+        Sync pipelined (source, 4, true);
+        auto const pipelinedTime = pipelined.run ();
+        BEAST_EXPECT(pipelined.complete ());
+
+        log << "one peer at a time: " << singleTime.count () << "ms, " <<
+            "pipelined: " << pipelinedTime.count () << "ms" << std::endl;
+        BEAST_EXPECT(pipelinedTime * 2 < singleTime);
+    }
+
+    void
+    run () override
+    {
+        testAssign ();
+        testExpire ();
+        testSync ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FetchPipeline,ledger,mtchain);
+
+}
+}
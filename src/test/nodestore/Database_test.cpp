@@ -10,10 +10,13 @@
 
 #include <BeastConfig.h>
 #include <test/nodestore/TestBase.h>
+#include <mtchain/nodestore/DatabaseRotating.h>
 #include <mtchain/nodestore/DummyScheduler.h>
 #include <mtchain/nodestore/Manager.h>
 #include <mtchain/beast/utility/temp_dir.h>
+#include <boost/filesystem.hpp>
 #include <algorithm>
+#include <fstream>
 
 namespace mtchain {
 namespace NodeStore {
@@ -150,6 +153,142 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void testParallelImport (std::int64_t const seedValue)
+    {
+        testcase ("parallel import");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+        beast::temp_dir checkpoint_dir;
+
+        Section srcParams;
+        srcParams.set ("type", "memory");
+        srcParams.set ("path", "parallel_import_source");
+        auto src = Manager::instance().make_Database (
+            "test", scheduler, j, 0, srcParams);
+        auto batch = createPredictableBatch (numObjectsToTest, seedValue);
+        storeBatch (*src, batch);
+
+        ImportOptions options;
+        options.threads = 4;
+        options.batchSize = 64;
+        options.queueDepth = 2;
+        options.checkpoint = checkpoint_dir.file ("import.checkpoint");
+
+        // Import everything
+        {
+            Section destParams;
+            destParams.set ("type", "memory");
+            destParams.set ("path", "parallel_import_all");
+            auto dest = Manager::instance().make_Database (
+                "test", scheduler, j, 0, destParams);
+            dest->import (*src, options);
+            BEAST_EXPECT(dest->getStoreCount() == batch.size());
+            BEAST_EXPECT(! boost::filesystem::exists (options.checkpoint));
+
+            Batch copy;
+            fetchCopyOfBatch (*dest, &copy, batch);
+            std::sort (batch.begin (), batch.end (), LessThan{});
+            std::sort (copy.begin (), copy.end (), LessThan{});
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+
+        // Resume from a checkpoint. The memory backend visits in key
+        // order, so the objects already imported have the lowest keys.
+        std::size_t const resume = 500;
+        {
+            std::ofstream out (options.checkpoint);
+            out << src->getName() << '\n' << resume << '\n';
+        }
+        {
+            Section destParams;
+            destParams.set ("type", "memory");
+            destParams.set ("path", "parallel_import_resume");
+            auto dest = Manager::instance().make_Database (
+                "test", scheduler, j, 0, destParams);
+            options.threads = 1;
+            options.bytesPerSecond = 64 * 1024 * 1024;
+            dest->import (*src, options);
+            BEAST_EXPECT(dest->getStoreCount() == batch.size() - resume);
+
+            std::sort (batch.begin (), batch.end (), LessThan{});
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                auto const object = dest->fetch (batch[i]->getHash());
+                BEAST_EXPECT((object == nullptr) == (i < resume));
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void testRotating (std::int64_t const seedValue)
+    {
+        testcase ("rotating copy");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+
+        auto const makeBackend = [&](std::string const& path)
+        {
+            Section params;
+            params.set ("type", "memory");
+            params.set ("path", path);
+            return std::shared_ptr <Backend> (
+                Manager::instance().make_Backend (params, scheduler, j));
+        };
+
+        auto const first = makeBackend ("rotating_first");
+        auto const second = makeBackend ("rotating_second");
+        auto db = Manager::instance().make_DatabaseRotating (
+            "test", scheduler, 2, first, second, j);
+        auto& dbr = dynamic_cast <Database&> (*db);
+
+        auto const archived = createPredictableBatch (
+            numObjectsToTest, seedValue);
+        auto const written = createPredictableBatch (
+            numObjectsToTest, seedValue + 1);
+        storeBatch (*second, archived);
+        storeBatch (dbr, written);
+
+        // Nodes stored since the last rotation are skipped
+        bool copied = false;
+        for (auto const& object : written)
+            copied |= db->copyToWritable (object->getHash());
+        BEAST_EXPECT(! copied);
+
+        // Archived nodes are copied exactly once
+        bool all = true;
+        for (auto const& object : archived)
+            all &= db->copyToWritable (object->getHash());
+        BEAST_EXPECT(all);
+        copied = false;
+        for (auto const& object : archived)
+            copied |= db->copyToWritable (object->getHash());
+        BEAST_EXPECT(! copied);
+
+        Batch copy;
+        fetchCopyOfBatch (*first, &copy, archived);
+        BEAST_EXPECT(areBatchesEqual (archived, copy));
+
+        // After a rotation everything must be copied again
+        auto const third = makeBackend ("rotating_third");
+        {
+            std::lock_guard <std::mutex> lock (db->peekMutex());
+            db->rotateBackends (third);
+        }
+        all = true;
+        for (auto const& object : written)
+            all &= db->copyToWritable (object->getHash());
+        BEAST_EXPECT(all);
+
+        copy.clear();
+        fetchCopyOfBatch (*third, &copy, written);
+        BEAST_EXPECT(areBatchesEqual (written, copy));
+    }
+
+    //--------------------------------------------------------------------------
+
     void runBackendTests (std::int64_t const seedValue)
     {
         testNodeStore ("nudb", true, seedValue);
@@ -182,6 +321,10 @@ public:
 
         testNodeStore ("memory", false, seedValue);
 
+        testParallelImport (seedValue);
+
+        testRotating (seedValue);
+
         runBackendTests (seedValue);
 
         runImportTests (seedValue);
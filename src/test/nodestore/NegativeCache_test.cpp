@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/nodestore/impl/NegativeCache.h>
+#include <mtchain/basics/chrono.h>
+#include <mtchain/basics/KeyCache.h>
+#include <mtchain/beast/unit_test.h>
+#include <mtchain/beast/xor_shift_engine.h>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace mtchain {
+namespace NodeStore {
+
+namespace {
+
+uint256
+makeKey (beast::xor_shift_engine& rng)
+{
+    uint256 key;
+    for (auto& byte : key)
+        byte = static_cast <std::uint8_t> (rng());
+    return key;
+}
+
+std::vector <uint256>
+makeKeys (std::size_t count, std::uint64_t seed)
+{
+    beast::xor_shift_engine rng (seed);
+    std::vector <uint256> keys;
+    keys.reserve (count);
+    for (std::size_t i = 0; i < count; ++i)
+        keys.push_back (makeKey (rng));
+    return keys;
+}
+
+}
+
+class NegativeCache_test : public beast::unit_test::suite
+{
+public:
+    void testBasics ()
+    {
+        testcase ("basics");
+
+        TestStopwatch clock;
+        clock.set (0);
+        NegativeCache c (clock, 64, 2, 0);
+        auto const keys = makeKeys (2, 1);
+
+        BEAST_EXPECT(c.size () == 0);
+        BEAST_EXPECT(! c.touch_if_exists (keys[0]));
+        c.insert (keys[0]);
+        c.insert (keys[0]);
+        BEAST_EXPECT(c.size () == 1);
+        BEAST_EXPECT(c.touch_if_exists (keys[0]));
+        BEAST_EXPECT(! c.touch_if_exists (keys[1]));
+
+        BEAST_EXPECT(c.erase (keys[0]));
+        BEAST_EXPECT(! c.erase (keys[0]));
+        BEAST_EXPECT(! c.touch_if_exists (keys[0]));
+        BEAST_EXPECT(c.size () == 0);
+    }
+
+    void testExpiration ()
+    {
+        testcase ("expiration");
+
+        TestStopwatch clock;
+        clock.set (0);
+        NegativeCache c (clock, 64, 2, 0);
+        auto const keys = makeKeys (2, 2);
+
+        c.insert (keys[0]);
+        c.insert (keys[1]);
+        ++clock;
+        c.sweep ();
+        BEAST_EXPECT(c.size () == 2);
+
+        // Touching refreshes the entry
+        BEAST_EXPECT(c.touch_if_exists (keys[1]));
+        ++clock;
+        c.sweep ();
+        BEAST_EXPECT(c.size () == 1);
+        BEAST_EXPECT(! c.touch_if_exists (keys[0]));
+        BEAST_EXPECT(c.touch_if_exists (keys[1]));
+
+        c.setTargetAge (1);
+        ++clock;
+        BEAST_EXPECT(! c.touch_if_exists (keys[1]));
+    }
+
+    void testCapacity ()
+    {
+        testcase ("capacity");
+
+        TestStopwatch clock;
+        clock.set (0);
+        NegativeCache c (clock, 1000, 60, 0);
+        BEAST_EXPECT(c.capacity () >= 1000);
+        BEAST_EXPECT(c.capacity () < 2000 + NegativeCache::ways);
+
+        // A full table keeps accepting keys, replacing the oldest
+        auto const keys = makeKeys (4 * c.capacity (), 3);
+        for (auto const& key : keys)
+            c.insert (key);
+        BEAST_EXPECT(c.size () <= c.capacity ());
+        BEAST_EXPECT(c.touch_if_exists (keys.back ()));
+
+        // Resizing discards the contents
+        c.setTargetSize (10000);
+        BEAST_EXPECT(c.capacity () >= 10000);
+        BEAST_EXPECT(c.size () == 0);
+        BEAST_EXPECT(! c.touch_if_exists (keys.back ()));
+    }
+
+    void testVerify ()
+    {
+        testcase ("verify");
+
+        TestStopwatch clock;
+        clock.set (0);
+        NegativeCache c (clock, 64, 60, 4);
+        auto const keys = makeKeys (1, 4);
+        c.insert (keys[0]);
+
+        int hits = 0;
+        for (int i = 0; i < 8; ++i)
+            hits += c.touch_if_exists (keys[0]);
+        BEAST_EXPECT(hits == 6);
+    }
+
+    void testConcurrent ()
+    {
+        testcase ("concurrent");
+
+        std::size_t const count = 10000;
+        // Room enough that no bucket overflows and evicts a key
+        NegativeCache c (stopwatch (), 32 * count, 60, 0);
+        auto const stable = makeKeys (count, 5);
+        auto const keys = makeKeys (count, 6);
+
+        // Keys inserted by one thread are all remembered
+        for (auto const& key : stable)
+            c.insert (key);
+        std::size_t found = 0;
+        for (auto const& key : stable)
+            found += c.touch_if_exists (key);
+        BEAST_EXPECT(found == count);
+
+        // Writers insert and erase disjoint keys while readers look up.
+        // An insert that loses a race drops its key, so only erased keys
+        // are known to be absent.
+        std::atomic <bool> stop {false};
+        std::atomic <std::size_t> missed {0};
+        std::vector <std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back ([&, t]
+            {
+                for (std::size_t i = t; i < count; i += 4)
+                    c.insert (keys[i]);
+                for (std::size_t i = t; i < count; i += 8)
+                    c.erase (keys[i]);
+            });
+        }
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back ([&]
+            {
+                while (! stop)
+                {
+                    for (auto const& key : stable)
+                        missed += ! c.touch_if_exists (key);
+                    for (auto const& key : keys)
+                        c.touch_if_exists (key);
+                }
+            });
+        }
+        for (int t = 0; t < 4; ++t)
+            threads[t].join ();
+        stop = true;
+        for (int t = 4; t < 8; ++t)
+            threads[t].join ();
+        BEAST_EXPECT(missed == 0);
+
+        std::size_t erased = 0;
+        std::size_t present = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            bool const found = c.touch_if_exists (keys[i]);
+            if (i % 8 < 4)
+                erased += ! found;
+            else
+                present += found;
+        }
+        BEAST_EXPECT(erased == count / 2);
+        BEAST_EXPECT(present <= count / 2);
+
+        found = 0;
+        for (auto const& key : stable)
+            found += c.touch_if_exists (key);
+        BEAST_EXPECT(found == count);
+    }
+
+    void run ()
+    {
+        testBasics ();
+        testExpiration ();
+        testCapacity ();
+        testVerify ();
+        testConcurrent ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(NegativeCache,NodeStore,mtchain);
+
+//------------------------------------------------------------------------------
+
+// Compares the miss path of the node store's negative caches
+class NegativeCacheTiming_test : public beast::unit_test::suite
+{
+public:
+    static std::size_t const keyCount = 1 << 20;
+    static int const readers = 16;
+    static std::size_t const lookups = 4 * 1024 * 1024;
+
+    template <class Cache>
+    void
+    measure (std::string const& name, Cache& cache,
+        std::vector <uint256> const& keys)
+    {
+        for (auto const& key : keys)
+            cache.insert (key);
+
+        std::atomic <std::uint64_t> found {0};
+        auto const start = std::chrono::steady_clock::now ();
+        std::vector <std::thread> threads;
+        for (int t = 0; t < readers; ++t)
+        {
+            threads.emplace_back ([&, t]
+            {
+                std::uint64_t n = 0;
+                auto const mask = keys.size () - 1;
+                for (std::size_t i = 0; i < lookups / readers; ++i)
+                    n += cache.touch_if_exists (
+                        keys[(i * 7919 + t * 104729) & mask]);
+                found += n;
+            });
+        }
+        for (auto& thread : threads)
+            thread.join ();
+        auto const elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now () - start).count ();
+
+        std::stringstream ss;
+        ss << name << ": " << readers << " readers, " <<
+            static_cast <std::uint64_t> (lookups / elapsed) << " lookups/s, " <<
+            (elapsed * 1e9 * readers / lookups) << " ns/lookup, " <<
+            (100.0 * found / lookups) << "% hits";
+        log << ss.str () << std::endl;
+    }
+
+    void run ()
+    {
+        auto const keys = makeKeys (keyCount, 6);
+        {
+            KeyCache <uint256> cache ("timing", stopwatch (), keyCount, 120);
+            measure ("KeyCache", cache, keys);
+        }
+        {
+            NegativeCache cache (stopwatch (), keyCount, 120);
+            measure ("NegativeCache", cache, keys);
+        }
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(NegativeCacheTiming,NodeStore,mtchain);
+
+}
+}
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/nodestore/TestBase.h>
+#include <mtchain/nodestore/DummyScheduler.h>
+#include <mtchain/nodestore/Manager.h>
+#include <mtchain/nodestore/SnapshotWriter.h>
+#include <mtchain/beast/utility/temp_dir.h>
+#include <algorithm>
+#include <thread>
+
+namespace mtchain {
+namespace NodeStore {
+
+// Tests the read-only Snapshot backend and its writer
+//
+class Snapshot_test : public TestBase
+{
+public:
+    void testSnapshot (std::uint64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+
+        testcase ("write and read");
+
+        beast::temp_dir tempDir;
+        Section params;
+        params.set ("type", "Snapshot");
+        params.set ("path", tempDir.path());
+
+        auto batch = createPredictableBatch (
+            numObjectsToTest, seedValue);
+
+        {
+            // Insert from several threads, with every
+            // object inserted twice to exercise dedup.
+            SnapshotWriter writer (tempDir.path());
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back ([&batch, &writer, t]
+                {
+                    for (std::size_t i = t % 2; i < batch.size(); i += 2)
+                        writer.insert (batch[i]);
+                });
+            }
+            for (auto& t : threads)
+                t.join();
+            BEAST_EXPECT(writer.inserted() == 2 * batch.size());
+            BEAST_EXPECT(writer.finish() == batch.size());
+        }
+
+        beast::Journal j;
+        std::unique_ptr <Backend> backend =
+            Manager::instance().make_Backend (params, scheduler, j);
+
+        {
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+
+        {
+            auto const missing = createPredictableBatch (
+                numObjectsToTest, seedValue + 1);
+            fetchMissing (*backend, missing);
+        }
+
+        {
+            Batch copy;
+            backend->for_each ([&copy](std::shared_ptr<NodeObject> no)
+            {
+                copy.push_back (std::move (no));
+            });
+            std::sort (batch.begin (), batch.end (), LessThan{});
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+
+        try
+        {
+            backend->verify();
+            pass();
+        }
+        catch (std::exception const&)
+        {
+            fail ("verify");
+        }
+
+        try
+        {
+            backend->store (batch.front());
+            fail ("store into a snapshot");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void testEmpty ()
+    {
+        DummyScheduler scheduler;
+
+        testcase ("empty");
+
+        beast::temp_dir tempDir;
+        Section params;
+        params.set ("type", "Snapshot");
+        params.set ("path", tempDir.path());
+
+        {
+            SnapshotWriter writer (tempDir.path());
+            BEAST_EXPECT(writer.finish() == 0);
+        }
+
+        beast::Journal j;
+        std::unique_ptr <Backend> backend =
+            Manager::instance().make_Backend (params, scheduler, j);
+        fetchMissing (*backend,
+            createPredictableBatch (numObjectsToTest, 7));
+    }
+
+    void run ()
+    {
+        testSnapshot (50);
+        testEmpty ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Snapshot,NodeStore,mtchain);
+
+}
+}
@@ -50,10 +50,32 @@ public:
         check("RTXP/1.1, RTXP/1.0", "1.0,1.1");
     }
 
+    void
+    test_negotiate()
+    {
+        auto const& minimum = BuildInfo::getMinimumProtocol ();
+        auto const& current = BuildInfo::getCurrentProtocol ();
+
+        auto const offered = parse_ProtocolVersions (makeProtocolVersions ());
+        BEAST_EXPECT(! offered.empty ());
+        BEAST_EXPECT(offered.front () == minimum);
+        BEAST_EXPECT(offered.back () == current);
+
+        protocol::TMHello hello;
+        hello.set_protoversion (to_packed (minimum));
+        BEAST_EXPECT(negotiateProtocolVersion (hello) == minimum);
+        hello.set_protoversion (to_packed (current));
+        BEAST_EXPECT(negotiateProtocolVersion (hello) == current);
+        hello.set_protoversion (to_packed (
+            ProtocolVersion (current.first + 1, 0)));
+        BEAST_EXPECT(negotiateProtocolVersion (hello) == current);
+    }
+
     void
     run()
     {
         test_protocolVersions();
+        test_negotiate();
     }
 };
 
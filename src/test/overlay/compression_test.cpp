@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/Message.h>
+#include <mtchain/overlay/impl/ProtocolMessage.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <mtchain/basics/random.h>
+#include <mtchain/beast/unit_test.h>
+#include <array>
+#include <string>
+
+namespace mtchain {
+
+class compression_test : public beast::unit_test::suite
+{
+private:
+    using error_code = boost::system::error_code;
+
+    // Records the message passed to invokeProtocolMessage
+    struct Handler
+    {
+        std::shared_ptr<::google::protobuf::Message> message;
+        std::size_t size = 0;
+        std::size_t uncompressedSize = 0;
+
+        error_code
+        onMessageUnknown (std::uint16_t)
+        {
+            return {};
+        }
+
+        error_code
+        onMessageBegin (std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const& m,
+            std::size_t size_, std::size_t uncompressedSize_)
+        {
+            message = m;
+            size = size_;
+            uncompressedSize = uncompressedSize_;
+            return {};
+        }
+
+        template <class T>
+        void
+        onMessage (std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessageEnd (std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const&)
+        {
+        }
+    };
+
+    static
+    protocol::TMLedgerData
+    makeLedgerData ()
+    {
+        protocol::TMLedgerData tm;
+        tm.set_ledgerhash (std::string (32, 'h'));
+        tm.set_ledgerseq (1);
+        tm.set_type (protocol::liAS_NODE);
+        for (int i = 0; i < 100; ++i)
+        {
+            tm.add_nodes()->set_nodedata (
+                std::string (200, static_cast<char>('a' + i % 4)));
+        }
+        return tm;
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        auto const tm = makeLedgerData ();
+        Message const m (tm, protocol::mtLEDGER_DATA);
+        auto const& raw = m.getBuffer ();
+        auto const& wire = m.getBuffer (true);
+        BEAST_EXPECT(wire.size () < raw.size () / 4);
+        BEAST_EXPECT(&m.getBuffer (true) == &wire);
+        BEAST_EXPECT(wire[0] & 0x80);
+
+        {
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire), h, true);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(result.first == wire.size ());
+            BEAST_EXPECT(h.size == wire.size ());
+            BEAST_EXPECT(h.uncompressedSize == raw.size ());
+            BEAST_EXPECT(h.message &&
+                h.message->SerializeAsString () == tm.SerializeAsString ());
+        }
+
+        // The payload spans more than one buffer
+        {
+            std::array<boost::asio::const_buffer, 3> buffers {{
+                boost::asio::buffer (wire.data (), 3),
+                boost::asio::buffer (wire.data () + 3, 20),
+                boost::asio::buffer (wire.data () + 23, wire.size () - 23) }};
+            Handler h;
+            auto const result = invokeProtocolMessage (buffers, h, true);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(result.first == wire.size ());
+            BEAST_EXPECT(h.message &&
+                h.message->SerializeAsString () == tm.SerializeAsString ());
+        }
+
+        // An incomplete message is left for later
+        {
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire.data (), wire.size () - 1), h, true);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(result.first == 0);
+            BEAST_EXPECT(! h.message);
+        }
+
+        // Uncompressed messages are still understood
+        {
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (raw), h, true);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(result.first == raw.size ());
+            BEAST_EXPECT(h.uncompressedSize == h.size);
+        }
+    }
+
+    void
+    testUncompressed ()
+    {
+        testcase ("uncompressed");
+
+        // Too small
+        protocol::TMPing ping;
+        ping.set_type (protocol::TMPing::ptPING);
+        Message const m1 (ping, protocol::mtPING);
+        BEAST_EXPECT(&m1.getBuffer (true) == &m1.getBuffer ());
+
+        // Does not shrink
+        protocol::TMTransaction tx;
+        std::string data (4000, 0);
+        for (auto& c : data)
+            c = static_cast<char>(rand_int (255));
+        tx.set_rawtransaction (data);
+        tx.set_status (protocol::tsNEW);
+        Message const m2 (tx, protocol::mtTRANSACTION);
+        BEAST_EXPECT(&m2.getBuffer (true) == &m2.getBuffer ());
+
+        // Not a compressed type
+        protocol::TMValidation validation;
+        validation.set_validation (std::string (1000, 'v'));
+        Message const m3 (validation, protocol::mtVALIDATION);
+        BEAST_EXPECT(&m3.getBuffer (true) == &m3.getBuffer ());
+    }
+
+    void
+    testInvalid ()
+    {
+        testcase ("invalid");
+
+        Message const m (makeLedgerData (), protocol::mtLEDGER_DATA);
+
+        // Unknown algorithm
+        {
+            auto wire = m.getBuffer (true);
+            wire[0] |= 0x70;
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire), h, true);
+            BEAST_EXPECT(result.second);
+            BEAST_EXPECT(! h.message);
+        }
+
+        // Wrong uncompressed size
+        {
+            auto wire = m.getBuffer (true);
+            ++wire[9];
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire), h, true);
+            BEAST_EXPECT(result.second);
+            BEAST_EXPECT(! h.message);
+        }
+
+        // Larger than the type allows, refused before decompressing
+        {
+            protocol::TMTransaction tx;
+            tx.set_rawtransaction (std::string (1000, 't'));
+            tx.set_status (protocol::tsNEW);
+            Message const mt (tx, protocol::mtTRANSACTION);
+            auto wire = mt.getBuffer (true);
+            if (BEAST_EXPECT(wire[0] & 0x80))
+            {
+                auto const declared = Tuning::compressionMaximumBytes + 1;
+                wire[6] = static_cast<std::uint8_t>(declared >> 24);
+                wire[7] = static_cast<std::uint8_t>(declared >> 16);
+                wire[8] = static_cast<std::uint8_t>(declared >> 8);
+                wire[9] = static_cast<std::uint8_t>(declared);
+                Handler h;
+                auto const result = invokeProtocolMessage (
+                    boost::asio::buffer (wire), h, true);
+                BEAST_EXPECT(result.second ==
+                    boost::system::errc::message_size);
+                BEAST_EXPECT(! h.message);
+            }
+        }
+
+        // A type that is never compressed
+        {
+            auto wire = m.getBuffer (true);
+            wire[4] = 0;
+            wire[5] = protocol::mtVALIDATION;
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire), h, true);
+            BEAST_EXPECT(result.second);
+            BEAST_EXPECT(! h.message);
+        }
+
+        // Corrupt payload
+        {
+            auto wire = m.getBuffer (true);
+            for (auto i = Message::kCompressedHeaderBytes; i < wire.size (); ++i)
+                wire[i] = 0xFF;
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire), h, true);
+            BEAST_EXPECT(result.second);
+            BEAST_EXPECT(! h.message);
+        }
+    }
+
+public:
+    void
+    run ()
+    {
+        testRoundTrip ();
+        testUncompressed ();
+        testInvalid ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(compression,overlay,mtchain);
+
+}
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/Message.h>
+#include <mtchain/overlay/impl/ProtocolMessage.h>
+#include <mtchain/basics/random.h>
+#include <mtchain/basics/Slice.h>
+#include <mtchain/beast/unit_test.h>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+// Measures parsing inbound ledger data and handing its nodes to the
+// SHAMaps, by copying each node and by referencing it in the packet
+class ledger_data_timing_test : public beast::unit_test::suite
+{
+public:
+    static int const nodes = 256;
+    static std::size_t const iterations = 20000;
+
+    // Counts the allocations made by the hand-off containers
+    template <class T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        static std::size_t& count ()
+        {
+            static std::size_t n = 0;
+            return n;
+        }
+
+        counting_allocator () = default;
+
+        template <class U>
+        counting_allocator (counting_allocator<U> const&)
+        {
+        }
+
+        T* allocate (std::size_t n)
+        {
+            ++counting_allocator<void>::count ();
+            return std::allocator<T>().allocate (n);
+        }
+
+        void deallocate (T* p, std::size_t n)
+        {
+            std::allocator<T>().deallocate (p, n);
+        }
+
+        template <class U>
+        bool operator== (counting_allocator<U> const&) const
+        {
+            return true;
+        }
+
+        template <class U>
+        bool operator!= (counting_allocator<U> const&) const
+        {
+            return false;
+        }
+    };
+
+    using Bytes = std::vector<std::uint8_t,
+        counting_allocator<std::uint8_t>>;
+
+    struct Handler
+    {
+        bool copy;
+        std::size_t bytes = 0;
+
+        using error_code = boost::system::error_code;
+
+        error_code
+        onMessageUnknown (std::uint16_t)
+        {
+            return {};
+        }
+
+        error_code
+        onMessageBegin (std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const&,
+            std::size_t, std::size_t)
+        {
+            return {};
+        }
+
+        template <class T>
+        void
+        onMessage (std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessage (std::shared_ptr<protocol::TMLedgerData> const& m)
+        {
+            if (copy)
+            {
+                std::vector<Bytes, counting_allocator<Bytes>> data;
+                data.reserve (m->nodes ().size ());
+                for (auto const& node : m->nodes ())
+                    data.emplace_back (node.nodedata ().begin (),
+                        node.nodedata ().end ());
+                for (auto const& node : data)
+                    bytes += node.size ();
+            }
+            else
+            {
+                std::vector<Slice, counting_allocator<Slice>> data;
+                data.reserve (m->nodes ().size ());
+                for (auto const& node : m->nodes ())
+                    data.push_back (makeSlice (node.nodedata ()));
+                for (auto const& node : data)
+                    bytes += node.size ();
+            }
+        }
+
+        void
+        onMessageEnd (std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const&)
+        {
+        }
+    };
+
+    void
+    measure (std::string const& name,
+        std::vector<std::uint8_t> const& wire, bool copy)
+    {
+        Handler h {copy};
+        std::size_t parsed = 0;
+        counting_allocator<void>::count () = 0;
+        auto const start = std::chrono::steady_clock::now ();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (wire), h, true);
+            parsed += result.first == wire.size ();
+        }
+        BEAST_EXPECT(parsed == iterations);
+        auto const elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now () - start).count ();
+
+        std::stringstream ss;
+        ss << name << ": " <<
+            static_cast <std::uint64_t> (iterations / elapsed) << " msgs/s, " <<
+            (h.bytes / elapsed / (1024 * 1024)) << " MB/s of nodes, " <<
+            (1.0 * counting_allocator<void>::count () / iterations) <<
+            " hand-off allocations/msg";
+        log << ss.str () << std::endl;
+    }
+
+    void
+    run ()
+    {
+        protocol::TMLedgerData tm;
+        tm.set_ledgerhash (std::string (32, 'h'));
+        tm.set_ledgerseq (1);
+        tm.set_type (protocol::liAS_NODE);
+        for (int i = 0; i < nodes; ++i)
+        {
+            auto node = tm.add_nodes ();
+            node->set_nodeid (std::string (33, static_cast<char>(i)));
+            std::string data (400, 0);
+            for (auto& c : data)
+                c = static_cast<char>(rand_int (255));
+            node->set_nodedata (data);
+        }
+        Message const m (tm, protocol::mtLEDGER_DATA);
+
+        measure ("copy", m.getBuffer (), true);
+        measure ("slice", m.getBuffer (), false);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(ledger_data_timing,overlay,mtchain);
+
+}
+}
@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/QueryTracker.h>
+#include <mtchain/basics/random.h>
+#include <mtchain/beast/unit_test.h>
+#include <mtchain/protocol/JsonFields.h>
+#include "mtchain.pb.h"
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <vector>
+
+namespace mtchain {
+
+class query_tracker_test : public beast::unit_test::suite
+{
+private:
+    using milliseconds = std::chrono::milliseconds;
+
+    static int const otLEDGER = protocol::TMGetObjectByHash::otLEDGER;
+    static int const otFETCH_PACK = protocol::TMGetObjectByHash::otFETCH_PACK;
+
+public:
+    void
+    testReplies ()
+    {
+        testcase ("replies");
+
+        TestStopwatch clock;
+        QueryTracker tracker (clock);
+
+        // Unmeasured, the assumed latency is used
+        BEAST_EXPECT(tracker.expectedWait (milliseconds (100)) ==
+            milliseconds (100));
+        tracker.onQuery (otLEDGER);
+        tracker.onQuery (otFETCH_PACK);
+        BEAST_EXPECT(tracker.outstanding () == 2);
+        BEAST_EXPECT(tracker.expectedWait (milliseconds (100)) ==
+            milliseconds (300));
+
+        // Replies match the oldest query of their type
+        clock.advance (milliseconds (40));
+        BEAST_EXPECT(tracker.onReply (otFETCH_PACK));
+        BEAST_EXPECT(tracker.outstanding () == 1);
+        BEAST_EXPECT(tracker.expectedWait (milliseconds (100)) ==
+            milliseconds (80));
+
+        // More chunks of the same fetch pack are not replies
+        BEAST_EXPECT(! tracker.onReply (otFETCH_PACK));
+        BEAST_EXPECT(tracker.outstanding () == 1);
+
+        clock.advance (milliseconds (40));
+        BEAST_EXPECT(tracker.onReply (otLEDGER));
+        BEAST_EXPECT(tracker.outstanding () == 0);
+        BEAST_EXPECT(tracker.expectedWait (milliseconds (100)) ==
+            milliseconds (50));
+    }
+
+    void
+    testExpire ()
+    {
+        testcase ("expire");
+
+        TestStopwatch clock;
+        QueryTracker tracker (clock);
+        tracker.onQuery (otLEDGER);
+        clock.advance (milliseconds (5000));
+        tracker.onQuery (otLEDGER);
+        clock.advance (milliseconds (4000));
+
+        // Only the first has waited too long, and it counts in full
+        tracker.expire (milliseconds (8000));
+        BEAST_EXPECT(tracker.outstanding () == 1);
+        BEAST_EXPECT(tracker.expectedWait (milliseconds (10)) ==
+            milliseconds (16000));
+
+        auto const json = tracker.getJson ();
+        BEAST_EXPECT(json[jss::timeouts].asUInt () == 1);
+        BEAST_EXPECT(json[jss::replies].asUInt () == 0);
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Peers answering queries one at a time, some of them slowly
+    struct Server
+    {
+        milliseconds roundTrip;
+        milliseconds perQuery;
+        TestStopwatch::time_point busy;
+    };
+
+    struct Reply
+    {
+        TestStopwatch::time_point when;
+        std::size_t server;
+
+        bool
+        operator> (Reply const& other) const
+        {
+            return when > other.when;
+        }
+    };
+
+    // Returns the 99th percentile of the time taken to answer a query
+    milliseconds
+    simulate (bool tracked)
+    {
+        std::array <Server, 6> servers {{
+            {milliseconds (20), milliseconds (5), {}},
+            {milliseconds (40), milliseconds (10), {}},
+            {milliseconds (60), milliseconds (15), {}},
+            {milliseconds (30), milliseconds (60), {}},
+            {milliseconds (50), milliseconds (90), {}},
+            {milliseconds (80), milliseconds (120), {}} }};
+
+        TestStopwatch clock;
+        std::vector <std::unique_ptr <QueryTracker>> trackers;
+        for (std::size_t i = 0; i < servers.size (); ++i)
+            trackers.push_back (std::make_unique <QueryTracker> (clock));
+
+        std::priority_queue <Reply, std::vector <Reply>,
+            std::greater <Reply>> replies;
+        std::vector <milliseconds> times;
+
+        auto const start = clock.now ();
+        for (int i = 0; i < 2000; ++i)
+        {
+            auto const when = start + milliseconds (25) * i;
+            while (! replies.empty () && replies.top ().when <= when)
+            {
+                clock.set (replies.top ().when);
+                trackers[replies.top ().server]->onReply (otLEDGER);
+                replies.pop ();
+            }
+            clock.set (when);
+
+            std::size_t target = rand_int (servers.size () - 1);
+            if (tracked)
+            {
+                for (std::size_t s = 0; s < servers.size (); ++s)
+                {
+                    if (trackers[s]->expectedWait (servers[s].roundTrip) <
+                        trackers[target]->expectedWait (
+                            servers[target].roundTrip))
+                        target = s;
+                }
+            }
+
+            auto& server = servers[target];
+            trackers[target]->onQuery (otLEDGER);
+            server.busy = std::max (server.busy, when + server.roundTrip / 2) +
+                server.perQuery;
+            auto const done = server.busy + server.roundTrip / 2;
+            replies.push ({done, target});
+            times.push_back (std::chrono::duration_cast <milliseconds> (
+                done - when));
+        }
+
+        std::sort (times.begin (), times.end ());
+        return times[times.size () * 99 / 100];
+    }
+
+    void
+    testRouting ()
+    {
+        testcase ("routing");
+
+        auto const spread = simulate (false);
+        auto const tracked = simulate (true);
+        log << "99th percentile reply time, spread evenly: " <<
+            spread.count () << "ms, to the fastest: " <<
+            tracked.count () << "ms" << std::endl;
+        BEAST_EXPECT(tracked * 3 < spread);
+        BEAST_EXPECT(tracked < milliseconds (100));
+    }
+
+    void
+    run () override
+    {
+        testReplies ();
+        testExpire ();
+        testRouting ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(query_tracker,overlay,mtchain);
+
+}
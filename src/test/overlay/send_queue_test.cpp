@@ -0,0 +1,320 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/SendQueue.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <mtchain/beast/unit_test.h>
+#include "mtchain.pb.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mtchain {
+
+class send_queue_test : public beast::unit_test::suite
+{
+private:
+    using clock_type = SendQueue::clock_type;
+    using microseconds = std::chrono::microseconds;
+
+    static
+    Message::pointer
+    makeLedgerData (std::size_t nodes)
+    {
+        protocol::TMLedgerData tm;
+        tm.set_ledgerhash (std::string (32, 'h'));
+        tm.set_ledgerseq (1);
+        tm.set_type (protocol::liAS_NODE);
+        for (std::size_t i = 0; i < nodes; ++i)
+            tm.add_nodes()->set_nodedata (std::string (200, 'n'));
+        return std::make_shared <Message> (tm, protocol::mtLEDGER_DATA);
+    }
+
+    static
+    Message::pointer
+    makeValidation ()
+    {
+        protocol::TMValidation tm;
+        tm.set_validation (std::string (200, 'v'));
+        return std::make_shared <Message> (tm, protocol::mtVALIDATION);
+    }
+
+    static
+    Message::pointer
+    makeTransaction ()
+    {
+        protocol::TMTransaction tm;
+        tm.set_rawtransaction (std::string (300, 't'));
+        tm.set_status (protocol::tsNEW);
+        return std::make_shared <Message> (tm, protocol::mtTRANSACTION);
+    }
+
+    static
+    Message::pointer
+    makeEndpoints ()
+    {
+        protocol::TMEndpoints tm;
+        tm.set_version (2);
+        return std::make_shared <Message> (tm, protocol::mtENDPOINTS);
+    }
+
+    // The send queue as it was, one first in first out list
+    class Fifo
+    {
+    public:
+        void
+        push (Message::pointer const& m, std::size_t size,
+            clock_type::time_point now)
+        {
+            queue_.push_back ({m, size, SendQueue::getLane (
+                static_cast <TrafficCount::category> (m->getCategory ())),
+                    now});
+        }
+
+        std::vector <SendQueue::Entry> const&
+        next (std::size_t maxMessages, std::size_t maxBytes)
+        {
+            std::size_t bytes = 0;
+            while (! queue_.empty () && (writing_.empty () ||
+                (writing_.size () < maxMessages &&
+                    bytes + queue_.front ().size <= maxBytes)))
+            {
+                bytes += queue_.front ().size;
+                writing_.push_back (queue_.front ());
+                queue_.pop_front ();
+            }
+            return writing_;
+        }
+
+        std::vector <SendQueue::Entry> const&
+        writing () const
+        {
+            return writing_;
+        }
+
+        void
+        onWritten (clock_type::time_point)
+        {
+            writing_.clear ();
+        }
+
+        std::size_t
+        size () const
+        {
+            return queue_.size () + writing_.size ();
+        }
+
+    private:
+        std::deque <SendQueue::Entry> queue_;
+        std::vector <SendQueue::Entry> writing_;
+    };
+
+    struct Result
+    {
+        microseconds worstValidation {0};
+        microseconds worstTransaction {0};
+        std::size_t ledgerBytes = 0;
+        std::size_t totalBytes = 0;
+    };
+
+    // A link writing one byte per microsecond, kept saturated by
+    // ledger data while validations and transactions trickle in
+    template <class Queue>
+    Result
+    saturate (Queue& queue)
+    {
+        Result result;
+        clock_type::time_point now;
+        auto const end = now + std::chrono::seconds (10);
+        auto nextValidation = now;
+        auto nextTransaction = now;
+        std::size_t ledgerQueued = 0;
+
+        while (now < end)
+        {
+            // Ledger data replies, about 40KB each, up to 2MB waiting
+            while (ledgerQueued < 2 * 1024 * 1024)
+            {
+                auto const m = makeLedgerData (200);
+                auto const size = m->getBuffer (false).size ();
+                queue.push (m, size, now);
+                ledgerQueued += size;
+            }
+            for (; nextValidation <= now;
+                    nextValidation += std::chrono::milliseconds (50))
+            {
+                auto const m = makeValidation ();
+                queue.push (m, m->getBuffer (false).size (), nextValidation);
+            }
+            for (; nextTransaction <= now;
+                    nextTransaction += std::chrono::milliseconds (10))
+            {
+                auto const m = makeTransaction ();
+                queue.push (m, m->getBuffer (false).size (), nextTransaction);
+            }
+
+            std::size_t bytes = 0;
+            for (auto const& entry : queue.next (
+                    Tuning::writeBatchMessages, Tuning::writeBatchBytes))
+                bytes += entry.size;
+            now += microseconds (bytes);
+
+            for (auto const& entry : queue.writing ())
+            {
+                auto const delay = std::chrono::duration_cast
+                    <microseconds> (now - entry.queued);
+                if (entry.lane == SendQueue::Lane::consensus)
+                    result.worstValidation =
+                        std::max (result.worstValidation, delay);
+                else if (entry.lane == SendQueue::Lane::transaction)
+                    result.worstTransaction =
+                        std::max (result.worstTransaction, delay);
+                else if (entry.lane == SendQueue::Lane::ledger)
+                {
+                    ledgerQueued -= entry.size;
+                    result.ledgerBytes += entry.size;
+                }
+            }
+            result.totalBytes += bytes;
+            queue.onWritten (now);
+        }
+        return result;
+    }
+
+public:
+    void
+    testLanes ()
+    {
+        testcase ("lanes");
+
+        using Lane = SendQueue::Lane;
+        using category = TrafficCount::category;
+        BEAST_EXPECT(SendQueue::getLane (category::CT_validation) ==
+            Lane::consensus);
+        BEAST_EXPECT(SendQueue::getLane (category::CT_proposal) ==
+            Lane::consensus);
+        BEAST_EXPECT(SendQueue::getLane (category::CT_base) ==
+            Lane::consensus);
+        BEAST_EXPECT(SendQueue::getLane (category::CT_transaction) ==
+            Lane::transaction);
+        BEAST_EXPECT(SendQueue::getLane (category::CT_share_ledger) ==
+            Lane::ledger);
+        BEAST_EXPECT(SendQueue::getLane (category::CT_get_trans) ==
+            Lane::ledger);
+        BEAST_EXPECT(SendQueue::getLane (category::CT_overlay) ==
+            Lane::discovery);
+
+        // The first message out is the most urgent
+        SendQueue queue;
+        clock_type::time_point const now;
+        auto const endpoints = makeEndpoints ();
+        auto const ledger = makeLedgerData (10);
+        auto const validation = makeValidation ();
+        queue.push (endpoints, 10, now);
+        queue.push (ledger, 2000, now);
+        queue.push (validation, 200, now);
+        BEAST_EXPECT(queue.size () == 3);
+        BEAST_EXPECT(queue.bytes () == 2210);
+
+        auto const& first = queue.next (1, 1000000);
+        BEAST_EXPECT(first.size () == 1);
+        BEAST_EXPECT(first.front ().message == validation);
+        BEAST_EXPECT(queue.onWritten (now + microseconds (400)) == 200);
+        BEAST_EXPECT(queue.size () == 2);
+
+        auto const stats = queue.getStats (Lane::consensus);
+        BEAST_EXPECT(stats.messages == 0);
+        BEAST_EXPECT(stats.written == 1);
+        BEAST_EXPECT(stats.delay == microseconds (50));
+        BEAST_EXPECT(queue.getStats (Lane::ledger).bytes == 2000);
+
+        // Everything else fits in one write
+        BEAST_EXPECT(queue.next (64, 1000000).size () == 2);
+        BEAST_EXPECT(queue.writing ().front ().message == ledger);
+        BEAST_EXPECT(queue.onWritten (now) == 2010);
+        BEAST_EXPECT(queue.empty ());
+        BEAST_EXPECT(queue.getStats (Lane::ledger).bytes == 0);
+    }
+
+    void
+    testShares ()
+    {
+        testcase ("shares");
+
+        // Every lane busy, each gets bytes in proportion to its weight
+        SendQueue queue;
+        clock_type::time_point const now;
+        std::array <Message::pointer, SendQueue::lanes> const messages {{
+            makeValidation (), makeTransaction (),
+            makeLedgerData (1), makeEndpoints () }};
+        std::size_t const size = 1024;
+        for (int i = 0; i < 1000; ++i)
+            for (auto const& m : messages)
+                queue.push (m, size, now);
+
+        std::array <std::size_t, SendQueue::lanes> sent {};
+        for (int i = 0; i < 20; ++i)
+        {
+            for (auto const& entry : queue.next (16, 16 * size))
+                sent[static_cast <std::size_t> (entry.lane)] += entry.size;
+            queue.onWritten (now);
+        }
+        log << "bytes per lane: " << sent[0] << ", " << sent[1] << ", " <<
+            sent[2] << ", " << sent[3] << std::endl;
+        BEAST_EXPECT(sent[3] > 0);
+        BEAST_EXPECT(sent[0] == 2 * sent[1]);
+        BEAST_EXPECT(sent[1] == 2 * sent[2]);
+        BEAST_EXPECT(sent[2] == 2 * sent[3]);
+    }
+
+    void
+    testSaturated ()
+    {
+        testcase ("saturated link");
+
+        Fifo fifo;
+        auto const before = saturate (fifo);
+        SendQueue queue;
+        auto const after = saturate (queue);
+
+        log << "worst validation delay, first in first out: " <<
+            before.worstValidation.count () / 1000 << "ms, lanes: " <<
+            after.worstValidation.count () / 1000 << "ms" << std::endl;
+        log << "worst transaction delay, first in first out: " <<
+            before.worstTransaction.count () / 1000 << "ms, lanes: " <<
+            after.worstTransaction.count () / 1000 << "ms" << std::endl;
+
+        // A validation waits for at most one write, not the backlog
+        BEAST_EXPECT(before.worstValidation > std::chrono::seconds (1));
+        BEAST_EXPECT(after.worstValidation < std::chrono::milliseconds (100));
+        BEAST_EXPECT(after.worstValidation * 10 < before.worstValidation);
+        BEAST_EXPECT(after.worstTransaction * 10 < before.worstTransaction);
+
+        // Ledger data still gets nearly all of the link
+        BEAST_EXPECT(after.ledgerBytes * 10 > after.totalBytes * 9);
+        BEAST_EXPECT(queue.getStats (SendQueue::Lane::consensus).delay <
+            queue.getStats (SendQueue::Lane::ledger).delay);
+    }
+
+    void
+    run () override
+    {
+        testLanes ();
+        testShares ();
+        testSaturated ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(send_queue,overlay,mtchain);
+
+}
@@ -0,0 +1,332 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/Squelch.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <mtchain/beast/unit_test.h>
+#include <test/jtx/BasicNetwork.h>
+#include <array>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class squelch_test : public beast::unit_test::suite
+{
+public:
+    struct Node;
+    using Network = BasicNetwork <Node*>;
+
+    // A validator, the peers relaying it, and the server receiving
+    // the relayed messages all share this type.
+    struct Node : squelch::SquelchHandler
+    {
+        Network& net;
+        Peer::id_t id;
+        PublicKey const& validator;
+        Node* server = nullptr;
+        squelch::Squelch squelch_;
+        std::unique_ptr <squelch::Slots> slots;
+        std::set <std::uint32_t> seen;
+        std::vector <Peer::id_t> delivered;
+
+        Node (Network& net_, Peer::id_t id_, PublicKey const& validator_)
+            : net (net_)
+            , id (id_)
+            , validator (validator_)
+            , squelch_ (net_.clock())
+        {
+        }
+
+        Node*
+        find (Peer::id_t peer)
+        {
+            for (auto const& link : net.links (this))
+                if (link.to->id == peer)
+                    return link.to;
+            return nullptr;
+        }
+
+        // The validator publishes a message to its peers
+        void
+        publish (std::uint32_t seq)
+        {
+            for (auto const& link : net.links (this))
+                net.send (this, link.to,
+                    [to = link.to, from = this, seq]
+                    {
+                        to->receive (from, seq);
+                    });
+        }
+
+        void
+        receive (Node* from, std::uint32_t seq)
+        {
+            bool const unique = seen.insert (seq).second;
+            if (slots)
+            {
+                slots->update (validator, from->id, unique);
+                delivered.push_back (from->id);
+                return;
+            }
+            if (unique && ! squelch_.isSquelched (validator))
+                net.send (this, server,
+                    [to = server, from = this, seq]
+                    {
+                        to->receive (from, seq);
+                    });
+        }
+
+        void
+        squelch (PublicKey const& key, Peer::id_t peer,
+            std::chrono::seconds duration) override
+        {
+            if (auto to = find (peer))
+                net.send (this, to,
+                    [to, key, duration]
+                    {
+                        to->squelch_.addSquelch (key, duration);
+                    });
+        }
+
+        void
+        unsquelch (PublicKey const& key, Peer::id_t peer) override
+        {
+            if (auto to = find (peer))
+                net.send (this, to,
+                    [to, key]
+                    {
+                        to->squelch_.removeSquelch (key);
+                    });
+        }
+    };
+
+    static std::size_t const relays = 10;
+
+    static
+    PublicKey
+    makeKey (std::uint8_t n)
+    {
+        std::array <std::uint8_t, 33> data {};
+        data[0] = 0x02;
+        data[1] = n;
+        return PublicKey (makeSlice (data));
+    }
+
+    PublicKey const validator_ = makeKey (1);
+
+    struct Fixture
+    {
+        Network net;
+        std::vector <std::unique_ptr <Node>> nodes;
+        std::uint32_t seq = 0;
+
+        explicit
+        Fixture (PublicKey const& validator)
+        {
+            using namespace std::chrono;
+            for (Peer::id_t i = 0; i < relays + 2; ++i)
+                nodes.push_back (std::make_unique <Node> (net, i, validator));
+            server().slots = std::make_unique <squelch::Slots> (
+                server(), net.clock());
+            for (std::size_t i = 1; i <= relays; ++i)
+            {
+                nodes[i]->server = &server();
+                net.connect (&source(), nodes[i].get(),
+                    milliseconds (10 * i));
+                net.connect (nodes[i].get(), &server(),
+                    milliseconds (5 * i));
+            }
+        }
+
+        Node&
+        source ()
+        {
+            return *nodes.front();
+        }
+
+        Node&
+        server ()
+        {
+            return *nodes.back();
+        }
+
+        // Publish `count` messages a second apart, returning
+        // the peers that delivered the last one
+        std::set <Peer::id_t>
+        publish (std::size_t count)
+        {
+            using namespace std::chrono;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                server().delivered.clear();
+                source().publish (++seq);
+                net.step_for (seconds (1));
+                server().slots->expire();
+            }
+            return std::set <Peer::id_t> (server().delivered.begin(),
+                server().delivered.end());
+        }
+
+        squelch::Slots::Stats
+        stats ()
+        {
+            auto const stats = server().slots->getStats();
+            if (stats.empty())
+                return {};
+            return stats.front();
+        }
+    };
+
+    void
+    testSelect ()
+    {
+        testcase ("select");
+
+        Fixture f (validator_);
+        auto peers = f.publish (Tuning::squelchMessageThreshold - 1);
+        BEAST_EXPECT(peers.size() == relays);
+        BEAST_EXPECT(! f.stats().selected);
+
+        // The fastest peers are selected, the rest squelched
+        peers = f.publish (2);
+        BEAST_EXPECT(peers == std::set <Peer::id_t> ({ 1, 2, 3, 4, 5 }));
+        auto stats = f.stats();
+        BEAST_EXPECT(stats.selected);
+        BEAST_EXPECT(stats.peers == relays);
+        BEAST_EXPECT(stats.selectedPeers == Tuning::squelchSelectedPeers);
+        BEAST_EXPECT(stats.squelchedPeers ==
+            relays - Tuning::squelchSelectedPeers);
+        BEAST_EXPECT(stats.squelches ==
+            relays - Tuning::squelchSelectedPeers);
+        BEAST_EXPECT(stats.messages ==
+            relays * Tuning::squelchMessageThreshold +
+                Tuning::squelchSelectedPeers);
+        BEAST_EXPECT(f.nodes[6]->squelch_.isSquelched (validator_));
+        BEAST_EXPECT(! f.nodes[1]->squelch_.isSquelched (validator_));
+
+        // Selection holds while the selected peers relay
+        peers = f.publish (20);
+        BEAST_EXPECT(peers.size() == Tuning::squelchSelectedPeers);
+        BEAST_EXPECT(f.stats().squelches == stats.squelches);
+    }
+
+    void
+    testDisconnect ()
+    {
+        testcase ("disconnect");
+
+        Fixture f (validator_);
+        f.publish (Tuning::squelchMessageThreshold + 1);
+        BEAST_EXPECT(f.stats().selected);
+
+        // Losing a selected peer releases the squelched ones
+        f.net.disconnect (&f.source(), f.nodes[1].get());
+        f.net.disconnect (f.nodes[1].get(), &f.server());
+        f.server().slots->deletePeer (1);
+        auto stats = f.stats();
+        BEAST_EXPECT(! stats.selected);
+        BEAST_EXPECT(stats.unsquelches ==
+            relays - Tuning::squelchSelectedPeers);
+        auto peers = f.publish (1);
+        BEAST_EXPECT(peers.size() == relays - 1);
+
+        // And a new selection is made
+        peers = f.publish (Tuning::squelchMessageThreshold);
+        BEAST_EXPECT(peers == std::set <Peer::id_t> ({ 2, 3, 4, 5, 6 }));
+        BEAST_EXPECT(f.stats().selected);
+    }
+
+    void
+    testIdle ()
+    {
+        using namespace std::chrono;
+        testcase ("idle");
+
+        Fixture f (validator_);
+        f.publish (Tuning::squelchMessageThreshold + 1);
+        BEAST_EXPECT(f.stats().selected);
+
+        // The validator goes quiet, so the selected peers idle
+        for (int i = 0; i <= Tuning::squelchIdleSeconds; ++i)
+        {
+            f.net.step_for (seconds (1));
+            f.server().slots->expire();
+        }
+        BEAST_EXPECT(! f.stats().selected);
+        BEAST_EXPECT(f.stats().squelchedPeers == 0);
+        BEAST_EXPECT(f.publish (1).size() == relays);
+
+        // A slot for a validator that stays silent is removed
+        f.net.step_for (seconds (Tuning::squelchMaxSeconds + 1));
+        f.server().slots->expire();
+        BEAST_EXPECT(f.server().slots->getStats().empty());
+    }
+
+    void
+    testExpire ()
+    {
+        using namespace std::chrono;
+        testcase ("expire");
+
+        Network net;
+        auto const other = makeKey (2);
+        squelch::Squelch s (net.clock());
+
+        BEAST_EXPECT(! s.addSquelch (validator_, seconds (0)));
+        BEAST_EXPECT(! s.addSquelch (validator_,
+            seconds (Tuning::squelchMaxSeconds + 1)));
+        BEAST_EXPECT(! s.isSquelched (validator_));
+
+        BEAST_EXPECT(s.addSquelch (validator_,
+            seconds (Tuning::squelchMinSeconds)));
+        BEAST_EXPECT(s.isSquelched (validator_));
+        BEAST_EXPECT(! s.isSquelched (other));
+        s.removeSquelch (validator_);
+        BEAST_EXPECT(! s.isSquelched (validator_));
+
+        BEAST_EXPECT(s.addSquelch (validator_,
+            seconds (Tuning::squelchMinSeconds)));
+        net.step_for (seconds (Tuning::squelchMinSeconds - 1));
+        BEAST_EXPECT(s.isSquelched (validator_));
+        net.step_for (seconds (1));
+        BEAST_EXPECT(! s.isSquelched (validator_));
+
+        // Lapsed squelches are renewed until the selection itself
+        // lapses, then peers are counted afresh
+        Fixture f (validator_);
+        f.publish (Tuning::squelchMessageThreshold + 1);
+        BEAST_EXPECT(f.stats().selected);
+        auto const peers = f.publish (Tuning::squelchMaxSeconds);
+        auto const stats = f.stats();
+        BEAST_EXPECT(! stats.selected);
+        BEAST_EXPECT(stats.squelches >
+            relays - Tuning::squelchSelectedPeers);
+        BEAST_EXPECT(stats.unsquelches > 0);
+        BEAST_EXPECT(peers.size() == relays);
+    }
+
+    void
+    run () override
+    {
+        testSelect ();
+        testDisconnect ();
+        testIdle ();
+        testExpire ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(squelch,overlay,mtchain);
+
+}
+}
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/TrafficHistograms.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/beast/unit_test.h>
+#include <thread>
+#include <vector>
+
+namespace mtchain {
+
+class traffic_histograms_test : public beast::unit_test::suite
+{
+public:
+    void
+    testBuckets ()
+    {
+        testcase ("buckets");
+
+        // Small values are exact
+        for (std::uint64_t v = 0; v < 4; ++v)
+        {
+            BEAST_EXPECT(Histogram::bucket (v) == v);
+            BEAST_EXPECT(Histogram::upperBound (v) == v);
+        }
+
+        // Every value lies in its bucket, a quarter power of two wide
+        bool ordered = true;
+        bool contained = true;
+        for (std::uint64_t v = 4; v < Histogram::maxValue; v += v / 7 + 1)
+        {
+            auto const b = Histogram::bucket (v);
+            contained = contained &&
+                Histogram::upperBound (b - 1) < v &&
+                v <= Histogram::upperBound (b) &&
+                Histogram::upperBound (b) - Histogram::upperBound (b - 1) <=
+                    v / 4 + 1;
+            ordered = ordered && b >= Histogram::bucket (v - 1);
+        }
+        BEAST_EXPECT(contained);
+        BEAST_EXPECT(ordered);
+        BEAST_EXPECT(Histogram::bucket (Histogram::maxValue) ==
+            Histogram::bucket (Histogram::maxValue - 1));
+        BEAST_EXPECT(Histogram::bucket (~std::uint64_t (0)) ==
+            Histogram::bucket (Histogram::maxValue - 1));
+    }
+
+    void
+    testPercentiles ()
+    {
+        testcase ("percentiles");
+
+        Histogram h;
+        BEAST_EXPECT(h.percentile (0.5) == 0);
+        for (std::uint64_t v = 1; v <= 1000; ++v)
+            h.record (v);
+        BEAST_EXPECT(h.count () == 1000);
+        BEAST_EXPECT(h.max () == 1000);
+        BEAST_EXPECT(h.mean () == 500.5);
+
+        // Within the width of a bucket
+        auto const p50 = h.percentile (0.50);
+        auto const p99 = h.percentile (0.99);
+        BEAST_EXPECT(p50 >= 500 && p50 < 500 * 5 / 4);
+        BEAST_EXPECT(p99 >= 990 && p99 <= 1000);
+        BEAST_EXPECT(h.percentile (1.0) == 1000);
+
+        auto const json = h.getJson ();
+        BEAST_EXPECT(json[jss::count].asUInt () == 1000);
+        BEAST_EXPECT(json[jss::p50].asUInt () == p50);
+        std::uint64_t total = 0;
+        for (auto const& bucket : json[jss::buckets])
+            total += bucket[1u].asUInt ();
+        BEAST_EXPECT(total == 1000);
+    }
+
+    void
+    testThreads ()
+    {
+        testcase ("threads");
+
+        Histogram h;
+        std::vector <std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back ([&h, t]
+            {
+                for (std::uint64_t v = 0; v < 100000; ++v)
+                    h.record (v * (t + 1));
+            });
+        }
+        for (auto& thread : threads)
+            thread.join ();
+        BEAST_EXPECT(h.count () == 400000);
+        BEAST_EXPECT(h.max () == 99999 * 4);
+        BEAST_EXPECT(h.percentile (1.0) == 99999 * 4);
+    }
+
+    void
+    testTraffic ()
+    {
+        testcase ("traffic");
+
+        using category = TrafficCount::category;
+        TrafficHistograms traffic;
+        TrafficHistograms::clock_type::time_point now;
+        for (int i = 1; i <= 10; ++i)
+        {
+            now += std::chrono::milliseconds (50);
+            traffic.onMessage (category::CT_validation, 200, now);
+            traffic.onProcessed (category::CT_validation,
+                std::chrono::microseconds (30));
+        }
+        traffic.onMessage (category::CT_share_ledger, 40000, now);
+
+        auto const& v = traffic[category::CT_validation];
+        BEAST_EXPECT(v.size.count () == 10);
+        BEAST_EXPECT(v.interarrival.count () == 9);
+        BEAST_EXPECT(v.interarrival.max () == 50000);
+        BEAST_EXPECT(v.processing.percentile (0.5) == 30);
+        BEAST_EXPECT(traffic[category::CT_share_ledger].size.max () == 40000);
+
+        // Only categories that saw traffic are reported
+        auto const json = traffic.getJson ();
+        BEAST_EXPECT(json.size () == 2);
+        BEAST_EXPECT(json.isMember ("validations"));
+        BEAST_EXPECT(json["ledger_share"][jss::size][jss::max].asUInt () ==
+            40000);
+    }
+
+    void
+    run () override
+    {
+        testBuckets ();
+        testPercentiles ();
+        testThreads ();
+        testTraffic ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(traffic_histograms,overlay,mtchain);
+
+}
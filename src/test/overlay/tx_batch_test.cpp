@@ -0,0 +1,288 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/overlay/impl/ProtocolMessage.h>
+#include <mtchain/overlay/impl/Tuning.h>
+#include <mtchain/overlay/impl/TxBatch.h>
+#include <mtchain/basics/chrono.h>
+#include <mtchain/beast/unit_test.h>
+#include <mtchain/resource/Consumer.h>
+#include <mtchain/resource/Fees.h>
+#include <mtchain/resource/impl/Entry.h>
+#include <mtchain/resource/impl/Logic.h>
+#include <string>
+
+namespace mtchain {
+
+class tx_batch_test : public beast::unit_test::suite
+{
+private:
+    using error_code = boost::system::error_code;
+    using clock_type = TxBatch::clock_type;
+
+    // Records the transactions passed to invokeProtocolMessage
+    struct Handler
+    {
+        std::uint16_t type = 0;
+        std::vector<std::string> txs;
+
+        error_code
+        onMessageUnknown (std::uint16_t)
+        {
+            return {};
+        }
+
+        error_code
+        onMessageBegin (std::uint16_t type_,
+            std::shared_ptr<::google::protobuf::Message> const&,
+            std::size_t, std::size_t)
+        {
+            type = type_;
+            return {};
+        }
+
+        void
+        onMessage (std::shared_ptr<protocol::TMTransaction> const& m)
+        {
+            txs.push_back (m->rawtransaction());
+        }
+
+        void
+        onMessage (std::shared_ptr<protocol::TMTransactions> const& m)
+        {
+            for (auto const& tm : m->transactions())
+                txs.push_back (tm.rawtransaction());
+        }
+
+        template <class T>
+        void
+        onMessage (std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessageEnd (std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const&)
+        {
+        }
+    };
+
+    static
+    std::shared_ptr<protocol::TMTransaction const>
+    makeTx (std::size_t bytes, char c = 't')
+    {
+        auto tx = std::make_shared<protocol::TMTransaction>();
+        tx->set_rawtransaction (std::string (bytes, c));
+        tx->set_status (protocol::tsNEW);
+        tx->set_receivetimestamp (0);
+        return tx;
+    }
+
+    void
+    testAssembly ()
+    {
+        testcase ("assembly");
+
+        TxBatch batch;
+        BEAST_EXPECT(batch.empty());
+
+        auto const start = clock_type::now();
+        TxBatch::list_type txs;
+        for (int i = 0; i < 3; ++i)
+        {
+            txs.push_back (makeTx (100, 'a' + i));
+            BEAST_EXPECT(! batch.add (txs.back(),
+                start + std::chrono::milliseconds (10 * i)));
+        }
+        BEAST_EXPECT(batch.size() == 3);
+
+        // The batch holds the transactions it was given, in order
+        auto const taken = batch.take();
+        BEAST_EXPECT(taken == txs);
+        BEAST_EXPECT(batch.empty());
+        BEAST_EXPECT(batch.take().empty());
+    }
+
+    void
+    testTriggers ()
+    {
+        testcase ("triggers");
+
+        auto const now = clock_type::now();
+
+        // Full by count
+        {
+            TxBatch batch;
+            for (std::size_t i = 1; i < Tuning::txBatchMaxTransactions; ++i)
+                BEAST_EXPECT(! batch.add (makeTx (10), now));
+            BEAST_EXPECT(batch.add (makeTx (10), now));
+            BEAST_EXPECT(batch.size() == Tuning::txBatchMaxTransactions);
+            batch.take();
+            BEAST_EXPECT(! batch.add (makeTx (10), now));
+        }
+
+        // Full by bytes
+        {
+            TxBatch batch;
+            auto const bytes = Tuning::txBatchBytes / 4;
+            for (int i = 0; i < 3; ++i)
+                BEAST_EXPECT(! batch.add (makeTx (bytes), now));
+            BEAST_EXPECT(batch.add (makeTx (bytes), now));
+            batch.take();
+            BEAST_EXPECT(! batch.add (makeTx (bytes), now));
+        }
+
+        // Due once the first transaction has waited long enough
+        {
+            auto const wait = std::chrono::milliseconds (
+                Tuning::txBatchMilliseconds);
+            TxBatch batch;
+            batch.add (makeTx (10), now);
+            BEAST_EXPECT(batch.deadline() == now + wait);
+            batch.add (makeTx (10), now + wait / 2);
+            BEAST_EXPECT(batch.deadline() == now + wait);
+
+            // The next batch starts its own wait
+            batch.take();
+            batch.add (makeTx (10), now + wait * 3);
+            BEAST_EXPECT(batch.deadline() == now + wait * 4);
+        }
+    }
+
+    void
+    testMessage ()
+    {
+        testcase ("message");
+
+        TxBatch::list_type txs;
+        for (int i = 0; i < 3; ++i)
+            txs.push_back (makeTx (50 + i, 'a' + i));
+
+        // A batch unpacks to its transactions, in order
+        {
+            auto const m = TxBatch::makeMessage (txs);
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (m->getBuffer()), h, false);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(h.type == protocol::mtTRANSACTIONS);
+            if (BEAST_EXPECT(h.txs.size() == txs.size()))
+            {
+                for (std::size_t i = 0; i < txs.size(); ++i)
+                    BEAST_EXPECT(h.txs[i] == txs[i]->rawtransaction());
+            }
+        }
+
+        // A batch of one is a plain transaction
+        {
+            TxBatch::list_type const one {txs.front()};
+            auto const m = TxBatch::makeMessage (one);
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (m->getBuffer()), h, false);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(h.type == protocol::mtTRANSACTION);
+            BEAST_EXPECT(h.txs.size() == 1 &&
+                h.txs.front() == txs.front()->rawtransaction());
+        }
+
+        // Batches of the same transactions hash alike
+        auto const copy = txs;
+        BEAST_EXPECT(TxBatch::hash (copy) == TxBatch::hash (txs));
+        TxBatch::list_type const other {txs[2], txs[1], txs[0]};
+        BEAST_EXPECT(TxBatch::hash (other) != TxBatch::hash (txs));
+    }
+
+    void
+    testCharging ()
+    {
+        testcase ("charging");
+
+        protocol::TMTransactions m;
+        for (int i = 0; i < 5; ++i)
+            m.add_transactions()->CopyFrom (*makeTx (10, 'a' + i));
+
+        // Every transaction but the last is charged as it is received
+        {
+            std::vector<std::string> received;
+            std::size_t charges = 0;
+            BEAST_EXPECT(receiveTransactions (m,
+                [&](protocol::TMTransaction const& tm)
+                {
+                    BEAST_EXPECT(charges == received.size());
+                    received.push_back (tm.rawtransaction());
+                },
+                [&]
+                {
+                    ++charges;
+                    return true;
+                }));
+            BEAST_EXPECT(received.size() == 5);
+            BEAST_EXPECT(charges == 4);
+        }
+
+        // Receiving stops when the peer is to be disconnected
+        {
+            int received = 0;
+            std::size_t charges = 0;
+            BEAST_EXPECT(! receiveTransactions (m,
+                [&](protocol::TMTransaction const&)
+                {
+                    ++received;
+                },
+                [&]
+                {
+                    return ++charges < 2;
+                }));
+            BEAST_EXPECT(received == 2);
+        }
+
+        // A batch of bad transactions costs what they would cost alone
+        {
+            TestStopwatch clock;
+            Resource::Logic logic (beast::insight::NullCollector::New(),
+                clock, beast::Journal());
+            Resource::Consumer c (logic.newInboundEndpoint (
+                beast::IP::Endpoint::from_string ("192.0.2.1")));
+
+            protocol::TMTransactions bad;
+            for (std::size_t i = 0; i < Tuning::txBatchMaxTransactions; ++i)
+                bad.add_transactions()->CopyFrom (*makeTx (10));
+            int received = 0;
+            BEAST_EXPECT(! receiveTransactions (bad,
+                [&](protocol::TMTransaction const&)
+                {
+                    ++received;
+                },
+                [&]
+                {
+                    c.charge (Resource::feeInvalidSignature);
+                    return ! c.disconnect();
+                }));
+            BEAST_EXPECT(c.disconnect());
+            BEAST_EXPECT(received < bad.transactions_size());
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testAssembly ();
+        testTriggers ();
+        testMessage ();
+        testCharging ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(tx_batch,overlay,mtchain);
+
+}
@@ -0,0 +1,305 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/protocol/ErrorCodes.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/protocol/Serializer.h>
+#include <mtchain/protocol/TER.h>
+#include <mtchain/rpc/impl/BinaryCommand.h>
+#include <mtchain/rpc/impl/Tuning.h>
+#include <test/jtx.h>
+#include <test/jtx/WSClient.h>
+#include <mtchain/beast/unit_test.h>
+#include <chrono>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class BinaryCommand_test : public beast::unit_test::suite
+{
+public:
+    static
+    std::string
+    submitRequest (std::vector<jtx::JTx> const& txs)
+    {
+        Serializer s;
+        s.add8 (RPC::BinaryCommand::submit);
+        for (auto const& tx : txs)
+        {
+            auto const blob = tx.stx->getSerializer ();
+            s.add32 (blob.getDataLength ());
+            s.addRaw (blob);
+        }
+        return s.getString ();
+    }
+
+    // Payments from the master account to new accounts
+    static
+    std::vector<jtx::JTx>
+    makePayments (jtx::Env& env, std::string const& prefix, int count)
+    {
+        using namespace jtx;
+        std::vector<JTx> txs;
+        auto const first = env.seq (env.master);
+        for (int i = 0; i < count; ++i)
+            txs.push_back (env.jt (
+                pay (env.master, Account (prefix + std::to_string (i)),
+                    M(1000)),
+                seq (first + i)));
+        return txs;
+    }
+
+    void
+    testSubmit ()
+    {
+        testcase ("submit");
+        using namespace jtx;
+
+        Env env (*this);
+        auto wsc = makeWSClient (env.app ().config ());
+
+        auto const txs = makePayments (env, "bob", 5);
+        auto const reply = wsc->invokeBinary (submitRequest (txs));
+        if (! BEAST_EXPECT(reply))
+            return;
+
+        SerialIter sit (reply->data (), reply->size ());
+        BEAST_EXPECT(sit.get8 () == RPC::BinaryCommand::submit);
+        BEAST_EXPECT(sit.get16 () == rpcSUCCESS);
+        BEAST_EXPECT(sit.get32 () == txs.size ());
+        for (auto const& tx : txs)
+        {
+            BEAST_EXPECT(TER (sit.get32 ()) == tesSUCCESS);
+            BEAST_EXPECT(sit.get256 () == tx.stx->getTransactionID ());
+        }
+        BEAST_EXPECT(sit.empty ());
+
+        env.close ();
+        BEAST_EXPECT(env.balance (Account ("bob4")) == M(1000));
+    }
+
+    void
+    testErrors ()
+    {
+        testcase ("errors");
+        using namespace jtx;
+
+        Env env (*this);
+        auto wsc = makeWSClient (env.app ().config ());
+
+        auto const status = [&](std::string const& request)
+        {
+            auto const reply = wsc->invokeBinary (request);
+            if (! reply || reply->size () != 3)
+                return -1;
+            return (static_cast<unsigned char> ((*reply)[1]) << 8) |
+                static_cast<unsigned char> ((*reply)[2]);
+        };
+
+        BEAST_EXPECT(status (std::string (1, '\x07')) == rpcUNKNOWN_COMMAND);
+        BEAST_EXPECT(status (std::string (1, '\x01')) == rpcINVALID_PARAMS);
+
+        // A length past the end
+        Serializer truncated;
+        truncated.add8 (RPC::BinaryCommand::submit);
+        truncated.add32 (100);
+        truncated.add32 (0);
+        BEAST_EXPECT(status (truncated.getString ()) == rpcINVALID_PARAMS);
+
+        // A transaction that cannot be decoded
+        Serializer garbage;
+        garbage.add8 (RPC::BinaryCommand::submit);
+        garbage.add32 (4);
+        garbage.add32 (0xDEADBEEF);
+        auto const reply = wsc->invokeBinary (garbage.getString ());
+        if (BEAST_EXPECT(reply))
+        {
+            SerialIter sit (reply->data (), reply->size ());
+            sit.skip (3);
+            BEAST_EXPECT(sit.get32 () == 1);
+            BEAST_EXPECT(TER (sit.get32 ()) == temMALFORMED);
+            BEAST_EXPECT(sit.get256 () == uint256 ());
+        }
+
+        // Too many transactions in one request
+        Serializer oversized;
+        oversized.add8 (RPC::BinaryCommand::submit);
+        for (std::size_t i = 0; i <= RPC::Tuning::maxBinarySubmit; ++i)
+        {
+            oversized.add32 (4);
+            oversized.add32 (0xDEADBEEF);
+        }
+        BEAST_EXPECT(status (oversized.getString ()) == rpcINVALID_PARAMS);
+
+        // JSON requests still work on the same connection
+        auto const jv = wsc->invoke ("ping");
+        BEAST_EXPECT(jv[jss::status] == "success");
+    }
+
+    void
+    testAccountTx ()
+    {
+        testcase ("account_tx");
+        using namespace jtx;
+
+        Env env (*this);
+        auto wsc = makeWSClient (env.app ().config ());
+
+        Account const alice ("alice");
+        env.fund (M(10000), alice);
+        env.close ();
+        for (int i = 0; i < 6; ++i)
+        {
+            env (pay (alice, env.master, M(10)));
+            env.close ();
+        }
+
+        auto const request = [&](std::uint32_t limit,
+            boost::optional<std::pair<std::uint32_t, std::uint32_t>> marker)
+        {
+            Serializer s;
+            s.add8 (RPC::BinaryCommand::accountTx);
+            s.add160 (alice.id ());
+            s.add32 (0xFFFFFFFF);
+            s.add32 (0xFFFFFFFF);
+            s.add32 (limit);
+            s.add8 (marker ? 2 : 0);
+            if (marker)
+            {
+                s.add32 (marker->first);
+                s.add32 (marker->second);
+            }
+            return s.getString ();
+        };
+
+        // The same transactions as the JSON command returns in binary
+        Json::Value params;
+        params[jss::account] = alice.human ();
+        params[jss::ledger_index_min] = -1;
+        params[jss::ledger_index_max] = -1;
+        params[jss::binary] = true;
+        auto const expected = env.rpc ("json", "account_tx",
+            to_string (params))[jss::result][jss::transactions];
+        BEAST_EXPECT(expected.size () == 9);
+
+        std::vector<std::string> blobs;
+        boost::optional<std::pair<std::uint32_t, std::uint32_t>> marker;
+        do
+        {
+            auto const reply = wsc->invokeBinary (request (4, marker));
+            if (! BEAST_EXPECT(reply))
+                return;
+            SerialIter sit (reply->data (), reply->size ());
+            BEAST_EXPECT(sit.get8 () == RPC::BinaryCommand::accountTx);
+            BEAST_EXPECT(sit.get16 () == rpcSUCCESS);
+            sit.get32 ();
+            sit.get32 ();
+            marker = boost::none;
+            if (sit.get8 ())
+            {
+                auto const ledger = sit.get32 ();
+                marker.emplace (ledger, sit.get32 ());
+            }
+            auto const count = sit.get32 ();
+            BEAST_EXPECT(count <= 4);
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                auto const ledger = sit.get32 ();
+                auto const tx = sit.getSlice (sit.get32 ());
+                auto const meta = sit.getSlice (sit.get32 ());
+                auto const& json = expected[blobs.size ()];
+                BEAST_EXPECT(json[jss::ledger_index] == ledger);
+                BEAST_EXPECT(json[jss::tx_blob] == strHex (tx));
+                BEAST_EXPECT(json[jss::meta] == strHex (meta));
+                blobs.push_back (strHex (tx));
+            }
+            BEAST_EXPECT(sit.empty ());
+        }
+        while (marker);
+        BEAST_EXPECT(blobs.size () == expected.size ());
+    }
+
+    void
+    run () override
+    {
+        testSubmit ();
+        testErrors ();
+        testAccountTx ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BinaryCommand,rpc,mtchain);
+
+//------------------------------------------------------------------------------
+
+// Compares submitting payments as JSON, one at a time in binary and as
+// one binary batch
+class BinaryCommandTiming_test : public beast::unit_test::suite
+{
+public:
+    void
+    run () override
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env (*this);
+        auto wsc = makeWSClient (env.app ().config ());
+        int const count = 200;
+
+        auto txs = BinaryCommand_test::makePayments (env, "json", count);
+        auto start = steady_clock::now ();
+        for (auto const& tx : txs)
+        {
+            Json::Value jv;
+            jv[jss::tx_blob] = strHex (tx.stx->getSerializer ().slice ());
+            auto const jr = wsc->invoke ("submit", jv)[jss::result];
+            BEAST_EXPECT(jr[jss::engine_result] == "tesSUCCESS");
+        }
+        auto const json = steady_clock::now () - start;
+        env.close ();
+
+        txs = BinaryCommand_test::makePayments (env, "binary", count);
+        start = steady_clock::now ();
+        for (auto const& tx : txs)
+        {
+            auto const reply = wsc->invokeBinary (
+                BinaryCommand_test::submitRequest ({ tx }));
+            BEAST_EXPECT(reply && reply->size () == 43 &&
+                (*reply)[7] == 0 && (*reply)[10] == 0);
+        }
+        auto const binary = steady_clock::now () - start;
+        env.close ();
+
+        txs = BinaryCommand_test::makePayments (env, "batch", count);
+        start = steady_clock::now ();
+        auto const reply = wsc->invokeBinary (
+            BinaryCommand_test::submitRequest (txs));
+        auto const batch = steady_clock::now () - start;
+        BEAST_EXPECT(reply && reply->size () == 7 + 36 * count);
+        env.close ();
+
+        auto const rate = [&](steady_clock::duration d)
+        {
+            return count * 1000 / std::max<std::int64_t> (1,
+                duration_cast<milliseconds> (d).count ());
+        };
+        log << count << " payments, JSON " << rate (json) << "/s, " <<
+            "binary " << rate (binary) << "/s, " <<
+            "binary batch " << rate (batch) << "/s" << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(BinaryCommandTiming,rpc,mtchain);
+
+}
+}
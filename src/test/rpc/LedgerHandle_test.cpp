@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/LedgerHandles.h>
+#include <mtchain/json/to_string.h>
+#include <mtchain/ledger/CachedSLEs.h>
+#include <mtchain/protocol/Indexes.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <test/jtx.h>
+#include <mtchain/beast/unit_test.h>
+
+namespace mtchain {
+namespace test {
+
+class LedgerHandle_test : public beast::unit_test::suite
+{
+public:
+    void
+    testLimits ()
+    {
+        testcase ("limits");
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env (*this);
+        Account const alice ("alice");
+        Account const bob ("bob");
+        env.fund (M(10000), alice, bob);
+        env.close ();
+        auto const ledger = env.closed ();
+
+        TestStopwatch clock;
+        CachedSLEs cache (minutes (1), clock);
+        auto const entry = LedgerHandles::bytesPerEntry;
+        auto const pinned = LedgerHandles::bytesPerLedger;
+        LedgerHandles handles (clock, cache,
+            { 3, 2, pinned + 2 * entry, seconds (60) });
+
+        auto const a = handles.make (ledger, "a", seconds (10), false);
+        auto const b = handles.make (ledger, "a", seconds (100), false);
+        BEAST_EXPECT(a && b && *a != *b);
+        BEAST_EXPECT(! handles.make (ledger, "a", seconds (10), false));
+        auto const c = handles.make (ledger, "a", seconds (10), true);
+        BEAST_EXPECT(c);
+        BEAST_EXPECT(! handles.make (ledger, "b", seconds (10), false));
+        BEAST_EXPECT(handles.size () == 3);
+
+        // A handle reads its ledger through a cache
+        auto const view = handles.find (*b);
+        if (! BEAST_EXPECT(view))
+            return;
+        BEAST_EXPECT(view->info ().hash == ledger->info ().hash);
+        BEAST_EXPECT(view->read (keylet::account (alice.id ())));
+        BEAST_EXPECT(view->read (keylet::account (alice.id ())));
+        BEAST_EXPECT(handles.getBytes () == pinned + entry);
+
+        // Unused handles expire, the time to live is capped
+        clock.advance (seconds (30));
+        handles.expire ();
+        BEAST_EXPECT(handles.size () == 1);
+        BEAST_EXPECT(! handles.find (*a));
+        BEAST_EXPECT(! handles.find (*c));
+        clock.advance (seconds (31));
+        BEAST_EXPECT(! handles.find (*b));
+        BEAST_EXPECT(handles.size () == 0);
+
+        BEAST_EXPECT(handles.getBytes () == 0);
+
+        // Over the budget the least recently used views drop their
+        // entries, the handles stay on the ledger
+        auto const d = handles.make (ledger, "b", seconds (60), false);
+        auto const e = handles.make (ledger, "b", seconds (60), false);
+        BEAST_EXPECT(d && e);
+        auto const full = handles.find (*d);
+        full->read (keylet::account (alice.id ()));
+        full->read (keylet::account (bob.id ()));
+        full->read (keylet::account (env.master.id ()));
+        ++clock;
+        handles.find (*e)->read (keylet::account (alice.id ()));
+        BEAST_EXPECT(handles.getBytes () == pinned + 4 * entry);
+        handles.expire ();
+        BEAST_EXPECT(handles.size () == 2);
+        BEAST_EXPECT(handles.getBytes () == pinned + entry);
+        auto const plain = handles.find (*d);
+        if (! BEAST_EXPECT(plain))
+            return;
+        BEAST_EXPECT(plain->info ().hash == ledger->info ().hash);
+        BEAST_EXPECT(plain->read (keylet::account (bob.id ())));
+        BEAST_EXPECT(handles.getBytes () == pinned + entry);
+
+        // Another ledger does not fit in the budget
+        env.close ();
+        BEAST_EXPECT(! handles.make (env.closed (), "c", seconds (60), false));
+        BEAST_EXPECT(handles.getBytes () == pinned);
+        BEAST_EXPECT(handles.make (ledger, "c", seconds (60), false));
+
+        BEAST_EXPECT(handles.release (*e));
+        BEAST_EXPECT(! handles.release (*e));
+        BEAST_EXPECT(handles.size () == 2);
+    }
+
+    void
+    testPaging ()
+    {
+        testcase ("paging");
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env (*this);
+        for (int i = 0; i < 20; ++i)
+            env.fund (M(1000), Account ("alice" + std::to_string (i)));
+        env.close ();
+        auto const ledger = env.closed ();
+        std::size_t total = 0;
+        for (auto const& sle : ledger->sles)
+        {
+            (void)sle;
+            ++total;
+        }
+
+        // The ledger holds more entries than fit in the budget
+        TestStopwatch clock;
+        CachedSLEs cache (minutes (1), clock);
+        auto const budget = LedgerHandles::bytesPerLedger +
+            4 * LedgerHandles::bytesPerEntry;
+        LedgerHandles handles (clock, cache, { 4, 4, budget, seconds (60) });
+        auto const handle = handles.make (ledger, "a", seconds (10), false);
+        if (! BEAST_EXPECT(handle))
+            return;
+
+        // The handle survives every page of the scan
+        std::size_t const page = 5;
+        std::size_t count = 0;
+        uint256 marker;
+        for (bool more = true; more;)
+        {
+            auto const view = handles.find (*handle);
+            if (! BEAST_EXPECT(view))
+                return;
+            BEAST_EXPECT(view->info ().hash == ledger->info ().hash);
+            std::size_t read = 0;
+            for (; read < page; ++read)
+            {
+                auto const next = view->succ (marker);
+                if (! next)
+                    break;
+                BEAST_EXPECT(view->read (keylet::unchecked (*next)));
+                marker = *next;
+            }
+            count += read;
+            more = read == page;
+
+            clock.advance (seconds (1));
+            handles.expire ();
+            BEAST_EXPECT(handles.getBytes () <= budget);
+        }
+        BEAST_EXPECT(total > 4);
+        BEAST_EXPECT(count == total);
+        BEAST_EXPECT(handles.size () == 1);
+    }
+
+    void
+    testRPC ()
+    {
+        testcase ("rpc");
+        using namespace jtx;
+
+        Env env (*this);
+        Account const alice ("alice");
+        env.fund (M(10000), alice);
+        env.close ();
+
+        Json::Value params;
+        params[jss::ledger_index] = "closed";
+        auto jv = env.rpc ("json", "ledger_handle",
+            to_string (params))[jss::result];
+        BEAST_EXPECT(jv[jss::status] == "success");
+        BEAST_EXPECT(jv[jss::ttl] == 60);
+        auto const handle = jv[jss::ledger_handle].asString ();
+        auto const seq = jv[jss::ledger_index];
+
+        env (pay (alice, env.master, M(1000)));
+        env.close ();
+
+        // The handle still names the ledger it was made on
+        auto const info = [&](Json::Value const& handle)
+        {
+            Json::Value params;
+            params[jss::account] = alice.human ();
+            if (handle)
+                params[jss::ledger_handle] = handle;
+            return env.rpc ("json", "account_info",
+                to_string (params))[jss::result];
+        };
+        jv = info (handle);
+        BEAST_EXPECT(jv[jss::ledger_index] == seq);
+        BEAST_EXPECT(jv[jss::account_data][sfBalance.fieldName] ==
+            "10000000000");
+        jv = info (Json::Value ());
+        BEAST_EXPECT(jv[jss::account_data][sfBalance.fieldName] !=
+            "10000000000");
+
+        // Refreshing a handle does not make a new one
+        params = Json::objectValue;
+        params[jss::ledger_handle] = handle;
+        jv = env.rpc ("json", "ledger_handle",
+            to_string (params))[jss::result];
+        BEAST_EXPECT(jv[jss::ledger_handle] == handle);
+        BEAST_EXPECT(jv[jss::ledger_index] == seq);
+        BEAST_EXPECT(env.app ().getLedgerHandles ().size () == 1);
+
+        BEAST_EXPECT(info (42)[jss::error] == "invalidParams");
+        BEAST_EXPECT(info ("xyz")[jss::error] == "invalidParams");
+        BEAST_EXPECT(info (to_string (uint256 ()))[jss::error] ==
+            "lgrNotFound");
+
+        auto const counts = env.rpc ("get_counts")[jss::result];
+        BEAST_EXPECT(counts[jss::ledger_handles][jss::handles] == 1);
+
+        params[jss::release] = true;
+        jv = env.rpc ("json", "ledger_handle",
+            to_string (params))[jss::result];
+        BEAST_EXPECT(jv[jss::released] == true);
+        BEAST_EXPECT(info (handle)[jss::error] == "lgrNotFound");
+    }
+
+    void
+    run () override
+    {
+        testLimits ();
+        testPaging ();
+        testRPC ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerHandle,rpc,mtchain);
+
+}
+}
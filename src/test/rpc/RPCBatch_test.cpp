@@ -0,0 +1,287 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/ledger/LedgerMaster.h>
+#include <mtchain/json/json_reader.h>
+#include <mtchain/json/to_string.h>
+#include <mtchain/protocol/ErrorCodes.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/rpc/impl/Tuning.h>
+#include <mtchain/server/Port.h>
+#include <test/jtx.h>
+#include <mtchain/beast/unit_test.h>
+#include <beast/core/to_string.hpp>
+#include <beast/http/message.hpp>
+#include <beast/http/read.hpp>
+#include <beast/http/streambuf_body.hpp>
+#include <beast/http/string_body.hpp>
+#include <beast/http/write.hpp>
+#include <boost/asio.hpp>
+#include <chrono>
+
+namespace mtchain {
+namespace test {
+
+class RPCBatch_test : public beast::unit_test::suite
+{
+public:
+    // Posts raw JSON-RPC requests over one HTTP connection
+    class Client
+    {
+    public:
+        explicit
+        Client (Config const& cfg)
+            : stream_ (ios_)
+        {
+            ParsedPort common;
+            parse_Port (common, cfg["server"], std::cerr);
+            for (auto const& name : cfg.section ("server").values ())
+            {
+                ParsedPort pp;
+                parse_Port (pp, cfg[name], std::cerr);
+                if (pp.protocol.count ("http") == 0)
+                    continue;
+                using boost::asio::ip::address_v4;
+                if (*pp.ip == address_v4{0x00000000})
+                    *pp.ip = address_v4{0x7f000001};
+                ep_ = { *pp.ip, *pp.port };
+                break;
+            }
+            stream_.connect (ep_);
+        }
+
+        // Returns the HTTP status and the parsed body
+        std::pair<int, Json::Value>
+        post (Json::Value const& body)
+        {
+            using namespace beast::http;
+            request<string_body> req;
+            req.method = "POST";
+            req.url = "/";
+            req.version = 11;
+            req.fields.insert ("Content-Type", "application/json");
+            req.fields.insert ("Host", ep_.address ().to_string () + ":" +
+                std::to_string (ep_.port ()));
+            req.body = to_string (body);
+            prepare (req);
+            write (stream_, req);
+
+            response<streambuf_body> res;
+            read (stream_, buffer_, res);
+            Json::Value jv;
+            Json::Reader ().parse (
+                beast::to_string (res.body.data ()), jv);
+            return { res.status, jv };
+        }
+
+    private:
+        boost::asio::io_service ios_;
+        boost::asio::ip::tcp::endpoint ep_;
+        boost::asio::ip::tcp::socket stream_;
+        beast::streambuf buffer_;
+    };
+
+    static
+    Json::Value
+    makeRequest (std::string const& method, Json::Value const& params, int id)
+    {
+        Json::Value jv;
+        jv[jss::method] = method;
+        jv[jss::jsonrpc] = "2.0";
+        jv[jss::id] = id;
+        if (params)
+            jv[jss::params].append (params);
+        return jv;
+    }
+
+    void
+    testBatch ()
+    {
+        testcase ("batch");
+        using namespace jtx;
+
+        Env env (*this);
+        int const count = 20;
+        std::vector<Account> accounts;
+        for (int i = 0; i < count; ++i)
+        {
+            accounts.emplace_back ("a" + std::to_string (i));
+            env.fund (M(1000 + i), accounts.back ());
+        }
+        env.close ();
+
+        auto const current = env.current ()->info ().seq;
+        auto const closed = env.closed ()->info ().seq;
+        auto const validated =
+            env.app ().getLedgerMaster ().getValidLedgerIndex ();
+
+        // The first request closes a ledger while the others run.
+        // Each account is looked up in all three named ledgers.
+        char const* const names[] = { "current", "closed", "validated" };
+        Json::Value batch (Json::arrayValue);
+        batch.append (makeRequest ("ledger_accept", {}, 100));
+        for (int i = 0; i < 3 * count; ++i)
+        {
+            Json::Value params;
+            params[jss::account] = accounts[i / 3].human ();
+            params[jss::ledger_index] = names[i % 3];
+            batch.append (makeRequest ("account_info", params, i));
+        }
+
+        Client client (env.app ().config ());
+        auto const reply = client.post (batch);
+        BEAST_EXPECT(reply.first == 200);
+        auto const& jv = reply.second;
+        if (! BEAST_EXPECT(jv.isArray () && jv.size () == batch.size ()))
+            return;
+
+        // The ledger closed during the batch
+        BEAST_EXPECT(jv[0u][jss::result][jss::ledger_current_index] ==
+            current + 1);
+        BEAST_EXPECT(env.current ()->info ().seq == current + 1);
+
+        // The replies are in order and all see the ledgers of the start
+        for (int i = 0; i < 3 * count; ++i)
+        {
+            auto const& item = jv[i + 1];
+            BEAST_EXPECT(item[jss::id] == i);
+            BEAST_EXPECT(item[jss::jsonrpc] == "2.0");
+            auto const& result = item[jss::result];
+            BEAST_EXPECT(result[jss::status] == jss::success);
+            switch (i % 3)
+            {
+            case 0:
+                BEAST_EXPECT(result[jss::ledger_current_index] == current);
+                break;
+            case 1:
+                BEAST_EXPECT(result[jss::ledger_index] == closed);
+                break;
+            default:
+                BEAST_EXPECT(result[jss::ledger_index] == validated);
+                BEAST_EXPECT(result[jss::validated] == true);
+            }
+            BEAST_EXPECT(result[jss::account_data][sfBalance.fieldName] ==
+                std::to_string ((1000 + i / 3) * 1000000));
+        }
+
+        // A batch of one is still a batch
+        Json::Value one (Json::arrayValue);
+        one.append (makeRequest ("ping", {}, 7));
+        auto const single = client.post (one);
+        BEAST_EXPECT(single.second.isArray () &&
+            single.second[0u][jss::id] == 7);
+    }
+
+    void
+    testErrors ()
+    {
+        testcase ("errors");
+        using namespace jtx;
+
+        Env env (*this);
+        Client client (env.app ().config ());
+
+        BEAST_EXPECT(client.post (Json::arrayValue).first == 400);
+
+        Json::Value large (Json::arrayValue);
+        for (int i = 0; i <= RPC::Tuning::maxBatchSize; ++i)
+            large.append (makeRequest ("ping", {}, i));
+        BEAST_EXPECT(client.post (large).first == 400);
+
+        // A failing request does not fail the others
+        Json::Value batch (Json::arrayValue);
+        batch.append (makeRequest ("ping", {}, 0));
+        batch.append (42);
+        Json::Value noMethod;
+        noMethod[jss::id] = 2;
+        batch.append (noMethod);
+        batch.append (makeRequest ("no_such_method", {}, 3));
+        auto badParams = makeRequest ("ping", {}, 4);
+        badParams[jss::params] = "x";
+        batch.append (badParams);
+        batch.append (makeRequest ("ping", {}, 5));
+
+        auto const reply = client.post (batch);
+        BEAST_EXPECT(reply.first == 200);
+        auto const& jv = reply.second;
+        if (! BEAST_EXPECT(jv.isArray () && jv.size () == batch.size ()))
+            return;
+
+        auto const status = [&](int i)
+        {
+            return jv[i][jss::result][jss::status].asString ();
+        };
+        auto const error = [&](int i)
+        {
+            return jv[i][jss::result][jss::error_code].asInt ();
+        };
+        BEAST_EXPECT(status (0) == "success");
+        BEAST_EXPECT(error (1) == rpcINVALID_PARAMS);
+        BEAST_EXPECT(error (2) == rpcINVALID_PARAMS);
+        BEAST_EXPECT(jv[2][jss::id] == 2);
+        BEAST_EXPECT(error (3) == rpcUNKNOWN_COMMAND);
+        BEAST_EXPECT(error (4) == rpcINVALID_PARAMS);
+        BEAST_EXPECT(status (5) == "success");
+        BEAST_EXPECT(jv[5][jss::id] == 5);
+    }
+
+    void
+    testSeparate ()
+    {
+        testcase ("same as separate");
+        using namespace jtx;
+
+        Env env (*this);
+        Account const alice ("alice");
+        Account const bob ("bob");
+        env.fund (M(10000), alice, bob);
+        env.close ();
+
+        // More requests than run at once, so items wait for a job
+        int const count = 4 * RPC::Tuning::maxBatchJobs + 1;
+        Json::Value batch (Json::arrayValue);
+        for (int i = 0; i < count; ++i)
+        {
+            Json::Value params;
+            params[jss::account] = (i % 2 ? bob : alice).human ();
+            batch.append (makeRequest (
+                i % 3 ? "account_info" : "account_lines", params, i));
+        }
+
+        Client client (env.app ().config ());
+        auto const reply = client.post (batch);
+        BEAST_EXPECT(reply.first == 200);
+        if (! BEAST_EXPECT(reply.second.size () == count))
+            return;
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto const separate = client.post (batch[i]);
+            BEAST_EXPECT(separate.first == 200);
+            BEAST_EXPECT(reply.second[i][jss::id] == i);
+            BEAST_EXPECT(reply.second[i][jss::result] ==
+                separate.second[jss::result]);
+        }
+    }
+
+    void
+    run () override
+    {
+        testBatch ();
+        testErrors ();
+        testSeparate ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RPCBatch,rpc,mtchain);
+
+}
+}
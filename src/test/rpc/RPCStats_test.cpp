@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/main/Application.h>
+#include <mtchain/json/to_string.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/rpc/impl/MethodStats.h>
+#include <mtchain/rpc/impl/Tuning.h>
+#include <test/jtx.h>
+#include <mtchain/beast/unit_test.h>
+
+namespace mtchain {
+namespace test {
+
+class RPCStats_test : public beast::unit_test::suite
+{
+public:
+    void
+    testMethods ()
+    {
+        testcase ("methods");
+        using namespace jtx;
+
+        Env env (*this);
+        for (int i = 0; i < 3; ++i)
+            env.rpc ("ping");
+        env.rpc ("server_info");
+
+        auto const result = env.rpc ("rpc_stats")[jss::result];
+        auto const& methods = result[jss::methods];
+        BEAST_EXPECT(methods.isMember ("ping"));
+        BEAST_EXPECT(methods.isMember ("server_info"));
+        BEAST_EXPECT(! methods.isMember ("account_info"));
+        BEAST_EXPECT(methods["ping"][jss::time][jss::count] == 3);
+        BEAST_EXPECT(methods["ping"][jss::size][jss::count] == 3);
+        BEAST_EXPECT(methods["server_info"][jss::time][jss::count] == 1);
+        BEAST_EXPECT(result[jss::slow_requests].size () == 0);
+        BEAST_EXPECT(result[jss::dropped] == 0);
+    }
+
+    void
+    testSlow ()
+    {
+        testcase ("slow");
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env (*this);
+        auto& stats = env.app ().getMethodStats ();
+        auto const slow = duration_cast <microseconds> (
+            RPC::Tuning::slowRequestTime);
+
+        Json::Value params;
+        params[jss::account] = "alice";
+        params[jss::secret] = "masterpassphrase";
+        params[jss::seed] = "snoPBrXtMeMyMHUVTgbuqAfg1SUTb";
+        Json::Value reply;
+        reply[jss::ledger_index] = 7;
+        reply[jss::ledger_hash] = "ABCD";
+        stats.onRequest ("account_info", params, &reply, slow, 100);
+        stats.onRequest ("account_info", params, nullptr, slow / 2, 100);
+
+        auto result = env.rpc ("rpc_stats")[jss::result];
+        auto const& info = result[jss::methods]["account_info"];
+        BEAST_EXPECT(info[jss::time][jss::count] == 2);
+        BEAST_EXPECT(info[jss::slow] == 1);
+        if (! BEAST_EXPECT(result[jss::slow_requests].size () == 1))
+            return;
+        auto const& entry = result[jss::slow_requests][0u];
+        BEAST_EXPECT(entry[jss::method] == "account_info");
+        BEAST_EXPECT(entry[jss::time] ==
+            static_cast <Json::UInt> (slow.count ()));
+        BEAST_EXPECT(entry[jss::bytes] == 100);
+        BEAST_EXPECT(entry[jss::ledger_index] == "7");
+        BEAST_EXPECT(entry[jss::ledger_hash] == "ABCD");
+        BEAST_EXPECT(! entry.isMember (jss::ledger_current_index));
+
+        // Secrets never reach the log
+        auto const logged = entry[jss::params].asString ();
+        BEAST_EXPECT(logged.find ("alice") != std::string::npos);
+        BEAST_EXPECT(logged.find ("masterpassphrase") == std::string::npos);
+        BEAST_EXPECT(logged.find ("snoPBrXt") == std::string::npos);
+
+        // Nor do admin credentials
+        Json::Value admin;
+        admin["admin_user"] = "root_user";
+        admin["admin_password"] = "root_password";
+        stats.onRequest ("stop", admin, nullptr, slow, 0);
+        result = env.rpc ("rpc_stats")[jss::result];
+        if (! BEAST_EXPECT(result[jss::slow_requests].size () == 2))
+            return;
+        auto const text = to_string (result);
+        BEAST_EXPECT(text.find ("root_user") == std::string::npos);
+        BEAST_EXPECT(text.find ("root_password") == std::string::npos);
+        BEAST_EXPECT(text.find ("admin_user") == std::string::npos);
+
+        // A burst of slow requests is rate limited
+        for (int i = 0; i < 3 * RPC::Tuning::slowRequestsPerSecond; ++i)
+            stats.onRequest ("ping", Json::objectValue, nullptr, slow, 0);
+        result = env.rpc ("rpc_stats")[jss::result];
+        BEAST_EXPECT(result[jss::methods]["ping"][jss::slow] ==
+            3 * RPC::Tuning::slowRequestsPerSecond);
+        BEAST_EXPECT(result[jss::dropped] > 0);
+        BEAST_EXPECT(result[jss::slow_requests].size () <=
+            RPC::Tuning::slowRequestLogSize);
+    }
+
+    void
+    run () override
+    {
+        testMethods ();
+        testSlow ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RPCStats,rpc,mtchain);
+
+}
+}
@@ -0,0 +1,387 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/rpc/impl/ReplyWriter.h>
+#include <mtchain/basics/contract.h>
+#include <mtchain/json/Arena.h>
+#include <mtchain/json/Object.h>
+#include <mtchain/json/json_reader.h>
+#include <mtchain/json/json_value.h>
+#include <mtchain/json/to_string.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <mtchain/resource/Fees.h>
+#include <mtchain/rpc/Context.h>
+#include <mtchain/rpc/RPCHandler.h>
+#include <test/jtx.h>
+#include <mtchain/beast/unit_test.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace mtchain {
+namespace RPC {
+
+class ReplyWriter_test : public beast::unit_test::suite
+{
+public:
+    // Pulls a reply from the Writer the way an HTTP session does
+    class Session
+    {
+    public:
+        explicit
+        Session (std::shared_ptr<Writer> writer)
+            : writer_ (std::move (writer))
+        {
+        }
+
+        // Send up to `bytes`, waiting for data if there is none
+        bool
+        send (std::size_t bytes)
+        {
+            if (writer_->complete ())
+                return false;
+
+            std::unique_lock<std::mutex> lock (mutex_);
+            resumed_ = false;
+            lock.unlock ();
+            if (! writer_->prepare (bytes,
+                [this]
+                {
+                    std::lock_guard<std::mutex> lock (mutex_);
+                    resumed_ = true;
+                    cv_.notify_all ();
+                }))
+            {
+                lock.lock ();
+                cv_.wait (lock, [this] { return resumed_; });
+                return true;
+            }
+
+            std::size_t sent = 0;
+            for (auto const& b : writer_->data ())
+            {
+                auto const n = std::min (bytes - sent,
+                    boost::asio::buffer_size (b));
+                received_.append (
+                    boost::asio::buffer_cast<char const*> (b), n);
+                sent += n;
+                if (sent == bytes)
+                    break;
+            }
+            writer_->consume (sent);
+            return true;
+        }
+
+        void
+        close ()
+        {
+            writer_.reset ();
+        }
+
+        std::string const&
+        received () const
+        {
+            return received_;
+        }
+
+    private:
+        std::shared_ptr<Writer> writer_;
+        std::string received_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool resumed_ = false;
+    };
+
+    // Returns the body of a chunked reply, or an empty string
+    static
+    std::string
+    decode (std::string const& reply, std::string const& header)
+    {
+        if (reply.compare (0, header.size (), header) != 0)
+            return {};
+
+        std::string body;
+        auto pos = header.size ();
+        for (;;)
+        {
+            auto const eol = reply.find ("\r\n", pos);
+            if (eol == std::string::npos)
+                return {};
+            auto const size = std::strtoul (
+                reply.substr (pos, eol - pos).c_str (), nullptr, 16);
+            pos = eol + 2;
+            if (size == 0)
+                return reply.compare (pos, std::string::npos, "\r\n") == 0 ?
+                    body : std::string ();
+            body.append (reply, pos, size);
+            pos += size + 2;
+        }
+    }
+
+    void
+    testChunks ()
+    {
+        testcase ("chunks");
+
+        std::string const header = "HTTP/1.1 200 OK\r\n\r\n";
+        ReplyWriter writer (header, 1 << 20, nullptr);
+        Session session (writer.getWriter ());
+
+        std::string expected;
+        for (int i = 0; i < 5000; ++i)
+        {
+            auto const s = std::to_string (i) + ",";
+            writer.write (s);
+            expected += s;
+        }
+        writer.finish ();
+        writer.finish ();
+        BEAST_EXPECT(writer.getBytes () == expected.size ());
+
+        while (session.send (1000))
+            ;
+        BEAST_EXPECT(decode (session.received (), header) == expected);
+        BEAST_EXPECT(! writer.abandoned ());
+
+        // An empty body
+        ReplyWriter empty (header, 1 << 20, nullptr);
+        Session emptySession (empty.getWriter ());
+        empty.finish ();
+        while (emptySession.send (1000))
+            ;
+        BEAST_EXPECT(emptySession.received () == header + "0\r\n\r\n");
+    }
+
+    // Runs a request against the last closed ledger
+    struct Request
+    {
+        Request (test::jtx::Env& env, Json::Value const& params)
+            : context {beast::Journal (), params, env.app (), loadType,
+                env.app ().getOPs (), env.app ().getLedgerMaster (),
+                consumer, Role::ADMIN, {}}
+        {
+        }
+
+        Resource::Charge loadType = Resource::feeReferenceRPC;
+        Resource::Consumer consumer;
+        Context context;
+    };
+
+    // Returns the result of a request built whole and the bytes held by
+    // it, its tree and its serialized text
+    static
+    std::pair<Json::Value, std::size_t>
+    build (test::jtx::Env& env, Json::Value const& params)
+    {
+        auto const& stats = Json::Arena::getStats ();
+        auto const blocks = stats.blocks;
+        Json::Value result;
+        std::size_t text;
+        {
+            Json::Arena::Scope arena;
+            Json::Value reply (Json::objectValue);
+            Request request (env, params);
+            doCommand (request.context, reply[jss::result]);
+            text = to_string (reply).size ();
+            result = std::move (reply[jss::result]);
+        }
+        return { result, (stats.blocks - blocks) * 64 * 1024 + text };
+    }
+
+    // Streams the reply of a request to a slow client, returning the
+    // result received, the size of the reply and the most bytes held
+    std::tuple<Json::Value, std::size_t, std::size_t>
+    stream (test::jtx::Env& env, Json::Value const& params)
+    {
+        std::size_t const limit = 8 * 1024;
+        std::string const header = "HTTP/1.1 200 OK\r\n\r\n";
+        ReplyWriter writer (header, limit, nullptr);
+        Session session (writer.getWriter ());
+
+        std::thread t (
+            [&]
+            {
+                while (session.send (4096))
+                    std::this_thread::yield ();
+            });
+        {
+            Json::Writer w (writer.output ());
+            Json::Object::Root root (w);
+            auto&& result = Json::addObject (root, jss::result);
+            Request request (env, params);
+            doCommand (request.context, result);
+        }
+        writer.finish ();
+        t.join ();
+
+        Json::Value received;
+        BEAST_EXPECT(Json::Reader ().parse (
+            decode (session.received (), header), received));
+
+        // One chunk past the limit at most
+        BEAST_EXPECT(writer.getPeak () < limit + 20 * 1024);
+        return std::make_tuple (received[jss::result],
+            writer.getBytes (), writer.getPeak ());
+    }
+
+    void
+    testMemory ()
+    {
+        testcase ("memory");
+        using namespace test::jtx;
+
+        Env env (*this);
+        int const count = 600;
+        for (int i = 0; i < count; ++i)
+        {
+            env.fund (M(1000), Account ("a" + std::to_string (i)));
+            if (i % 100 == 99)
+                env.close ();
+        }
+        env.close ();
+
+        Json::Value ledgerData;
+        ledgerData[jss::command] = "ledger_data";
+        ledgerData[jss::ledger_index] = "closed";
+        ledgerData[jss::limit] = 10 * count;
+
+        Json::Value accountTx;
+        accountTx[jss::command] = "account_tx";
+        accountTx[jss::account] = env.master.human ();
+        accountTx[jss::limit] = 10 * count;
+
+        struct Shape
+        {
+            Json::Value const& params;
+            char const* field;
+        };
+        Shape const shapes[] = {
+            { ledgerData, "state" },
+            { accountTx, "transactions" },
+        };
+
+        for (auto const& shape : shapes)
+        {
+            auto const whole = build (env, shape.params);
+            auto const streamed = stream (env, shape.params);
+            log << shape.params[jss::command].asString () << ": " <<
+                std::get<1> (streamed) << " bytes, " <<
+                "held " << whole.second / 1024 << "KB built whole, " <<
+                std::get<2> (streamed) / 1024 << "KB streamed" << std::endl;
+
+            auto const& result = std::get<0> (streamed);
+            BEAST_EXPECT(result == whole.first);
+            BEAST_EXPECT(result[shape.field].size () >= count);
+            BEAST_EXPECT(! result.isMember (jss::marker));
+            BEAST_EXPECT(std::get<2> (streamed) * 4 < whole.second);
+        }
+
+        // Pages read in chunks join up through their markers
+        Json::Value paged (Json::arrayValue);
+        accountTx[jss::limit] = 45;
+        for (;;)
+        {
+            auto const page = build (env, accountTx).first;
+            for (auto const& tx : page[jss::transactions])
+                paged.append (tx);
+            if (! page.isMember (jss::marker))
+                break;
+            accountTx[jss::marker] = page[jss::marker];
+        }
+        accountTx.removeMember (jss::marker);
+        accountTx[jss::limit] = 10 * count;
+        BEAST_EXPECT(paged == build (env, accountTx).first[jss::transactions]);
+    }
+
+    void
+    testAbandon ()
+    {
+        testcase ("abandon");
+
+        std::string const header = "HTTP/1.1 200 OK\r\n\r\n";
+        ReplyWriter writer (header, 64 * 1024, nullptr);
+        Session session (writer.getWriter ());
+        session.send (1024);
+
+        // The client goes away while the writer waits
+        std::thread closer (
+            [&]
+            {
+                std::this_thread::sleep_for (std::chrono::milliseconds (10));
+                session.close ();
+            });
+        std::string const data (1024, 'x');
+        for (int i = 0; i < 1000; ++i)
+            writer.write (data);
+        writer.finish ();
+        closer.join ();
+        BEAST_EXPECT(writer.abandoned ());
+        BEAST_EXPECT(writer.getPeak () < 100 * 1024);
+    }
+
+    void
+    testFail ()
+    {
+        testcase ("fail");
+
+        std::string const header = "HTTP/1.1 200 OK\r\n\r\n";
+        ReplyWriter writer (header, 64 * 1024, nullptr);
+        auto const source = writer.getWriter ();
+        Session session (source);
+
+        std::string const data (20 * 1024, 'x');
+        try
+        {
+            Json::Writer w (writer.output ());
+            Json::Object::Root root (w);
+            root["data"] = data;
+            Throw<std::runtime_error> ("row");
+        }
+        catch (std::exception const&)
+        {
+            writer.fail ();
+        }
+        writer.finish ();
+
+        while (session.send (4096))
+            ;
+        BEAST_EXPECT(source->failed ());
+        BEAST_EXPECT(! writer.abandoned ());
+
+        // What was flushed is sent, but neither the closing bracket nor
+        // the last chunk
+        auto const& received = session.received ();
+        BEAST_EXPECT(decode (received, header).empty ());
+        BEAST_EXPECT(received.find (data.substr (0, 1024)) !=
+            std::string::npos);
+        BEAST_EXPECT(received.find ('}') == std::string::npos);
+        BEAST_EXPECT(received.find ("0\r\n\r\n") == std::string::npos);
+    }
+
+    void
+    run () override
+    {
+        testChunks ();
+        testMemory ();
+        testAbandon ();
+        testFail ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ReplyWriter,rpc,mtchain);
+
+} // RPC
+} //
@@ -271,6 +271,72 @@ public:
         BEAST_EXPECT(jv[jss::status] == "success");
     }
 
+    void testLedgerBatch()
+    {
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+        Account const alice ("alice");
+        Account const bob ("bob");
+        env.fund(M(10000), alice, bob);
+        env.close();
+
+        auto wsc = makeWSClient(env.app().config());
+        Json::Value stream;
+
+        {
+            // RPC subscribe to accounts stream, a ledger at a time
+            stream[jss::accounts] = Json::arrayValue;
+            stream[jss::accounts].append(alice.human());
+            stream[jss::ledger_batch] = true;
+            auto jv = wsc->invoke("subscribe", stream);
+            BEAST_EXPECT(jv[jss::status] == "success");
+        }
+
+        {
+            // Transactions concerning alice, all in one ledger
+            env(pay(alice, bob, M(10)));
+            env(pay(bob, alice, M(20)));
+            env(pay(alice, bob, M(30)));
+            env.close();
+
+            // They arrive in one message
+            auto const jv = wsc->getMsg(5s);
+            BEAST_EXPECT(jv && (*jv)[jss::type] == "ledgerTransactions");
+            if (jv)
+            {
+                BEAST_EXPECT((*jv)[jss::validated] == true);
+                BEAST_EXPECT((*jv)[jss::ledger_index] ==
+                    env.closed()->info().seq);
+                BEAST_EXPECT((*jv)[jss::transactions].size() == 3);
+                for (auto const& tx : (*jv)[jss::transactions])
+                    BEAST_EXPECT(tx[jss::type] == "transaction" &&
+                        tx.isMember(jss::meta));
+            }
+            BEAST_EXPECT(! wsc->getMsg(10ms));
+
+            // Transaction that does not affect stream
+            env.fund(M(10000), "carol");
+            env.close();
+            BEAST_EXPECT(! wsc->getMsg(10ms));
+        }
+
+        {
+            // Delivery is reported by server_info
+            auto const result = env.rpc("server_info");
+            auto const& subs =
+                result[jss::result][jss::info][jss::subscriptions];
+            BEAST_EXPECT(subs[jss::accounts][jss::watched] == 1);
+            BEAST_EXPECT(subs["ledger_batches"][jss::events] == "1");
+            BEAST_EXPECT(subs["ledger_batches"][jss::messages] == "1");
+        }
+
+        // RPC unsubscribe
+        stream.removeMember(jss::ledger_batch);
+        auto jv = wsc->invoke("unsubscribe", stream);
+        BEAST_EXPECT(jv[jss::status] == "success");
+    }
+
     void testManifests()
     {
         using namespace jtx;
@@ -382,6 +448,7 @@ public:
         testServer();
         testLedger();
         testTransactions();
+        testLedgerBatch();
         testManifests();
         testValidations();
     }
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/json/json_reader.h>
+#include <mtchain/protocol/JsonFields.h>
+#include <test/jtx.h>
+#include <mtchain/beast/unit_test.h>
+#include <beast/core/streambuf.hpp>
+#include <beast/http.hpp>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+namespace mtchain {
+namespace test {
+
+// Measures JSON-RPC requests through the server handler on one
+// keep-alive connection, sent one at a time and pipelined
+class PipelineTiming_test : public beast::unit_test::suite
+{
+public:
+    static int const count = 1000;
+
+    static
+    std::unique_ptr<Config>
+    makeConfig ()
+    {
+        auto p = std::make_unique<Config>();
+        setupConfigForUnitTests (*p);
+        p->overwrite ("port_rpc", "pipeline", "8");
+        (*p)["server"].append ("port_alt");
+        (*p)["port_alt"].set ("ip", "127.0.0.1");
+        (*p)["port_alt"].set ("port", "8099");
+        (*p)["port_alt"].set ("protocol", "http");
+        (*p)["port_alt"].set ("admin", "127.0.0.1");
+        return p;
+    }
+
+    static
+    std::string
+    request (int id)
+    {
+        auto const body = "{\"method\":\"server_info\",\"id\":" +
+            std::to_string (id) + "}";
+        return "POST / HTTP/1.1\r\n"
+            "Host: 127.0.0.1\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: " + std::to_string (body.size ()) + "\r\n"
+            "\r\n" + body;
+    }
+
+    // Returns the seconds taken by the requests, all written at once
+    // or each after the reply to the one before
+    double
+    measure (jtx::Env& env, std::string const& section, bool pipelined)
+    {
+        using namespace boost::asio;
+        auto const port = env.app ().config ()[section].
+            get<std::uint16_t> ("port");
+        io_service ios;
+        ip::tcp::socket s (ios);
+        s.connect (ip::tcp::endpoint (
+            ip::address::from_string ("127.0.0.1"), *port));
+
+        beast::streambuf sb;
+        int answered = 0;
+        auto const start = std::chrono::steady_clock::now ();
+        for (int i = 0; i < count;)
+        {
+            auto const n = pipelined ? count : i + 1;
+            std::string text;
+            for (auto j = i; j < n; ++j)
+                text += request (j);
+            write (s, buffer (text));
+            for (; i < n; ++i)
+            {
+                beast::http::response<beast::http::string_body> resp;
+                beast::http::read (s, sb, resp);
+                Json::Value jv;
+                Json::Reader ().parse (resp.body, jv);
+                answered += jv[jss::id] == i;
+            }
+        }
+        auto const elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now () - start).count ();
+        BEAST_EXPECT(answered == count);
+
+        boost::system::error_code ec;
+        s.shutdown (ip::tcp::socket::shutdown_both, ec);
+        return elapsed;
+    }
+
+    void
+    run ()
+    {
+        jtx::Env env (*this, makeConfig ());
+
+        auto const single = measure (env, "port_alt", false);
+        auto const pipelined = measure (env, "port_rpc", true);
+        std::stringstream ss;
+        ss << count << " server_info requests on one connection, " <<
+            "one at a time: " << static_cast <std::uint64_t> (
+                count / single) << " requests/s, pipelined: " <<
+            static_cast <std::uint64_t> (count / pipelined) <<
+            " requests/s";
+        log << ss.str () << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(PipelineTiming,http,mtchain);
+
+}
+}
@@ -17,8 +17,12 @@
 #include <boost/optional.hpp>
 #include <boost/utility/in_place_factory.hpp>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace mtchain {
 namespace test {
@@ -357,11 +361,267 @@ public:
         }
     }
 
+    //--------------------------------------------------------------------------
+
+    // Expect that the next line read matches, keeping what follows it
+    template <class SyncReadStream>
+    bool
+    expect_line (SyncReadStream& s, boost::asio::streambuf& b,
+        std::string const& match)
+    {
+        boost::system::error_code ec;
+        auto const n = boost::asio::read_until (s, b, '\n', ec);
+        if (! BEAST_EXPECTS(! ec, ec.message()))
+            return false;
+        std::string got (n, 0);
+        boost::asio::buffer_copy (boost::asio::buffer (
+            &got[0], n), b.data());
+        b.consume (n);
+        return BEAST_EXPECT(got == match);
+    }
+
+    // Holds the requests until released, then answers them with their
+    // targets, the latest first.
+    struct HeldHandler : TestHandler
+    {
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        std::vector<std::shared_ptr<Session>> held_;
+        bool released_ = false;
+        int upgrades_ = 0;
+
+        static
+        void
+        answer (Session& session)
+        {
+            session.write (session.request().url + "\n");
+            session.complete();
+        }
+
+        Handoff
+        onHandoff (Session& session,
+            std::unique_ptr <beast::asio::ssl_bundle>&& bundle,
+                http_request_type&& request,
+                    boost::asio::ip::tcp::endpoint remote_address)
+        {
+            return Handoff{};
+        }
+
+        Handoff
+        onHandoff (Session& session, boost::asio::ip::tcp::socket&& socket,
+            http_request_type&& request,
+                boost::asio::ip::tcp::endpoint remote_address)
+        {
+            if (beast::http::is_upgrade (request))
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                ++upgrades_;
+            }
+            return Handoff{};
+        }
+
+        void
+        onRequest (Session& session)
+        {
+            auto detach = session.detach();
+            std::lock_guard<std::mutex> lock (mutex_);
+            if (released_)
+                return answer (*detach);
+            held_.push_back (std::move (detach));
+            cond_.notify_all();
+        }
+
+        // Wait for `count` requests to be held
+        bool
+        wait (std::size_t count)
+        {
+            std::unique_lock<std::mutex> lock (mutex_);
+            return cond_.wait_for (lock, std::chrono::seconds (5),
+                [&] { return held_.size() >= count; });
+        }
+
+        std::size_t
+        held()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return held_.size();
+        }
+
+        int
+        upgrades()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return upgrades_;
+        }
+
+        void
+        release()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            released_ = true;
+            for (auto iter = held_.rbegin(); iter != held_.rend(); ++iter)
+                answer (**iter);
+            held_.clear();
+        }
+    };
+
+    std::unique_ptr<Server>
+    makeServer (HeldHandler& handler, TestThread& thread,
+        beast::Journal journal, std::size_t depth)
+    {
+        auto s = make_Server (handler, thread.get_io_service(), journal);
+        std::vector<Port> list;
+        list.emplace_back();
+        list.back().port = testPort + 3;
+        list.back().ip = boost::asio::ip::address::from_string (
+            "127.0.0.1");
+        list.back().protocol.insert("http");
+        list.back().pipeline = depth;
+        s->ports (list);
+        return s;
+    }
+
+    void
+    testOutOfOrder()
+    {
+        testcase ("pipeline: out of order completion");
+        TestSink sink {*this};
+        TestThread thread;
+        HeldHandler handler;
+        auto server = makeServer (handler, thread, beast::Journal {sink}, 8);
+
+        boost::asio::io_service ios;
+        boost::asio::ip::tcp::socket s (ios);
+        if (! connect (s, "127.0.0.1", testPort + 3))
+            return;
+        std::string text;
+        for (int i = 0; i < 4; ++i)
+            text += "GET /" + std::to_string (i) + " HTTP/1.1\r\n\r\n";
+        if (! write (s, text))
+            return;
+
+        // The last request is answered first, the replies keep the order
+        // of the requests
+        BEAST_EXPECT(handler.wait (4));
+        handler.release();
+        boost::asio::streambuf b;
+        for (int i = 0; i < 4; ++i)
+            if (! expect_line (s, b, "/" + std::to_string (i) + "\n"))
+                break;
+
+        boost::system::error_code ec;
+        s.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    }
+
+    void
+    testCloseInPipeline()
+    {
+        testcase ("pipeline: Connection: close");
+        TestSink sink {*this};
+        TestThread thread;
+        HeldHandler handler;
+        handler.release();
+        auto server = makeServer (handler, thread, beast::Journal {sink}, 8);
+
+        boost::asio::io_service ios;
+        boost::asio::ip::tcp::socket s (ios);
+        if (! connect (s, "127.0.0.1", testPort + 3))
+            return;
+        if (! write (s,
+            "GET /0 HTTP/1.1\r\n\r\n"
+            "GET /1 HTTP/1.1\r\nConnection: close\r\n\r\n"
+            "GET /2 HTTP/1.1\r\n\r\n"))
+            return;
+
+        // The requests after the close are not answered
+        boost::asio::streambuf b;
+        if (! expect_line (s, b, "/0\n") || ! expect_line (s, b, "/1\n"))
+            return;
+        boost::system::error_code ec;
+        boost::asio::read_until (s, b, '\n', ec);
+        BEAST_EXPECT(ec);
+        BEAST_EXPECT(b.size() == 0);
+    }
+
+    void
+    testPipelineDepth()
+    {
+        testcase ("pipeline: depth");
+        TestSink sink {*this};
+        TestThread thread;
+        HeldHandler handler;
+        auto server = makeServer (handler, thread, beast::Journal {sink}, 2);
+
+        boost::asio::io_service ios;
+        boost::asio::ip::tcp::socket s (ios);
+        if (! connect (s, "127.0.0.1", testPort + 3))
+            return;
+        std::string text;
+        for (int i = 0; i < 4; ++i)
+            text += "GET /" + std::to_string (i) + " HTTP/1.1\r\n\r\n";
+        if (! write (s, text))
+            return;
+
+        // No more requests are read while the pipeline is full
+        BEAST_EXPECT(handler.wait (2));
+        std::this_thread::sleep_for (std::chrono::milliseconds (100));
+        BEAST_EXPECT(handler.held() == 2);
+
+        handler.release();
+        boost::asio::streambuf b;
+        for (int i = 0; i < 4; ++i)
+            if (! expect_line (s, b, "/" + std::to_string (i) + "\n"))
+                break;
+
+        boost::system::error_code ec;
+        s.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    }
+
+    void
+    testParkedUpgrade()
+    {
+        testcase ("pipeline: upgrade");
+        TestSink sink {*this};
+        TestThread thread;
+        HeldHandler handler;
+        auto server = makeServer (handler, thread, beast::Journal {sink}, 8);
+
+        boost::asio::io_service ios;
+        boost::asio::ip::tcp::socket s (ios);
+        if (! connect (s, "127.0.0.1", testPort + 3))
+            return;
+        if (! write (s,
+            "GET /0 HTTP/1.1\r\n\r\n"
+            "GET /ws HTTP/1.1\r\n"
+            "Connection: upgrade\r\n"
+            "Upgrade: websocket\r\n"
+            "\r\n"))
+            return;
+
+        // The upgrade waits for the requests before it to be answered
+        BEAST_EXPECT(handler.wait (1));
+        std::this_thread::sleep_for (std::chrono::milliseconds (100));
+        BEAST_EXPECT(handler.held() == 1);
+        BEAST_EXPECT(handler.upgrades() == 0);
+
+        handler.release();
+        boost::asio::streambuf b;
+        if (expect_line (s, b, "/0\n") && expect_line (s, b, "/ws\n"))
+            BEAST_EXPECT(handler.upgrades() == 1);
+
+        boost::system::error_code ec;
+        s.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    }
+
     void
     run()
     {
         basicTests();
         stressTest();
+        testOutOfOrder();
+        testCloseInPipeline();
+        testPipelineDepth();
+        testParkedUpgrade();
     }
 };
 
@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of FinPald: https://github.com/finpal/finpal-basic
+    Copyright (c) 2019 ~ 2020 FinPal Alliance.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <mtchain/app/misc/NetworkOPs.h>
+#include <mtchain/net/InfoSub.h>
+#include <mtchain/rpc/impl/WSInfoSub.h>
+#include <mtchain/server/WSSession.h>
+#include <mtchain/basics/random.h>
+#include <mtchain/beast/unit_test.h>
+#include <mtchain/json/json_reader.h>
+#include <test/jtx.h>
+#include <beast/core/streambuf.hpp>
+#include <boost/asio/buffer.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace mtchain {
+namespace test {
+
+class SubscriptionFanout_test : public beast::unit_test::suite
+{
+public:
+    // Something like a validated payment with its metadata
+    static
+    Json::Value
+    makeEvent ()
+    {
+        Json::Value jv (Json::objectValue);
+        jv["type"] = "transaction";
+        jv["validated"] = true;
+        jv["ledger_index"] = rand_int <std::uint32_t> ();
+        jv["engine_result"] = "tesSUCCESS";
+        auto& tx = jv["transaction"];
+        tx["TransactionType"] = "Payment";
+        tx["Account"] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        tx["Destination"] = "rPMh7Pi9ct699iZUTWaytJUoHcJ7cgyziK";
+        tx["Amount"] = std::to_string (rand_int <std::uint32_t> ());
+        tx["Fee"] = "10";
+        tx["Sequence"] = rand_int <std::uint32_t> ();
+        tx["SigningPubKey"] = std::string (66, 'A');
+        tx["TxnSignature"] = std::string (142, 'B');
+        auto& nodes = jv["meta"]["AffectedNodes"];
+        for (int i = 0; i < 6; ++i)
+        {
+            auto& node = nodes[i]["ModifiedNode"];
+            node["LedgerEntryType"] = "AccountRoot";
+            node["LedgerIndex"] = std::string (64, 'C');
+            node["PreviousTxnID"] = std::string (64, 'D');
+            node["FinalFields"]["Balance"] =
+                std::to_string (rand_int <std::uint64_t> ());
+            node["FinalFields"]["Flags"] = 0;
+            node["PreviousFields"]["Balance"] =
+                std::to_string (rand_int <std::uint64_t> ());
+        }
+        jv["meta"]["TransactionResult"] = "tesSUCCESS";
+        return jv;
+    }
+
+    // Writes a message out as a session does, returning its text
+    static
+    std::string
+    drain (WSMsg& m, std::size_t bytes)
+    {
+        std::string result;
+        for (;;)
+        {
+            auto const r = m.prepare (bytes, []{});
+            for (auto const& b : r.second)
+                result.append (boost::asio::buffer_cast <char const*> (b),
+                    boost::asio::buffer_size (b));
+            if (r.first)
+                return result;
+        }
+    }
+
+    void
+    testEvent ()
+    {
+        testcase ("event");
+
+        auto const jv = makeEvent ();
+        InfoSub::Event const event (jv);
+        BEAST_EXPECT(&event.getJson () == &jv);
+
+        // Serialized once, then shared
+        auto const& text = event.getText ();
+        BEAST_EXPECT(text);
+        BEAST_EXPECT(event.getText ().get () == text.get ());
+
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader ().parse (*text, parsed));
+        BEAST_EXPECT(parsed.toStyledString () == jv.toStyledString ());
+        BEAST_EXPECT(text->find ('\n') == text->size () - 1);
+    }
+
+    void
+    testSharedMsg ()
+    {
+        testcase ("shared message");
+
+        auto const text = std::make_shared <std::string const> (
+            Json::Value (makeEvent ()).toStyledString ());
+
+        // Each session writes the whole text, in frames of any size
+        for (std::size_t bytes : { 1, 7, 512, 65536 })
+        {
+            SharedWSMsg a (text);
+            SharedWSMsg b (text);
+            BEAST_EXPECT(drain (a, bytes) == *text);
+            BEAST_EXPECT(drain (b, bytes) == *text);
+        }
+        BEAST_EXPECT(text.use_count () == 1);
+
+        SharedWSMsg empty (std::make_shared <std::string const> ());
+        BEAST_EXPECT(drain (empty, 512).empty ());
+    }
+
+    // A session that keeps the messages sent to it
+    struct TestSession : WSSession
+    {
+        Port port_;
+        http_request_type request_;
+        boost::asio::ip::tcp::endpoint endpoint_;
+        std::vector <std::shared_ptr <WSMsg>> sent;
+
+        void run () override {}
+        Port const& port () const override { return port_; }
+        http_request_type const& request () const override { return request_; }
+        boost::asio::ip::tcp::endpoint const&
+        remote_endpoint () const override { return endpoint_; }
+        bool binary () const override { return false; }
+        void send (std::shared_ptr <WSMsg> w) override { sent.push_back (w); }
+        void close () override {}
+        void complete () override {}
+    };
+
+    void
+    testSubscribers ()
+    {
+        testcase ("subscribers");
+
+        jtx::Env env (*this);
+        auto& source = env.app ().getOPs ();
+        auto const jv = makeEvent ();
+
+        // What a subscriber is sent when it serializes the event itself
+        auto const alone = std::make_shared <TestSession> ();
+        WSInfoSub (source, alone).send (jv, true);
+        if (! BEAST_EXPECT(alone->sent.size () == 1))
+            return;
+        auto const expected = drain (*alone->sent.front (), 65536);
+
+        std::vector <std::shared_ptr <TestSession>> sessions;
+        std::vector <std::shared_ptr <WSInfoSub>> subs;
+        for (int i = 0; i < 10; ++i)
+        {
+            sessions.push_back (std::make_shared <TestSession> ());
+            subs.push_back (std::make_shared <WSInfoSub> (
+                source, sessions.back ()));
+        }
+
+        // Every subscriber is sent the same bytes from the shared text
+        InfoSub::Event const event (jv);
+        for (auto const& sub : subs)
+            sub->publish (event);
+        for (std::size_t i = 0; i < sessions.size (); ++i)
+        {
+            if (! BEAST_EXPECT(sessions[i]->sent.size () == 1))
+                continue;
+            BEAST_EXPECT(drain (*sessions[i]->sent.front (),
+                i % 2 ? 7 : 4096) == expected);
+        }
+        BEAST_EXPECT(event.getText ().use_count () ==
+            1 + static_cast <long> (sessions.size ()));
+    }
+
+    void
+    run () override
+    {
+        testEvent ();
+        testSharedMsg ();
+        testSubscribers ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SubscriptionFanout,server,mtchain);
+
+// Measures the cost of queueing an event for each subscriber, serialized
+// for each one and serialized once and shared
+class SubscriptionFanoutTiming_test : public beast::unit_test::suite
+{
+public:
+    // Returns the time taken to queue one event for each subscriber
+    template <class Publish>
+    std::chrono::microseconds
+    time (std::size_t subscribers, Publish&& publish)
+    {
+        using namespace std::chrono;
+        int const events = 10;
+        std::vector <Json::Value> jvs;
+        for (int i = 0; i < events; ++i)
+            jvs.push_back (SubscriptionFanout_test::makeEvent ());
+
+        std::vector <std::shared_ptr <WSMsg>> queued;
+        queued.reserve (subscribers);
+        auto const start = steady_clock::now ();
+        for (auto const& jv : jvs)
+        {
+            queued.clear ();
+            publish (jv, subscribers, queued);
+        }
+        return duration_cast <microseconds> (
+            steady_clock::now () - start) / events;
+    }
+
+    void
+    testFanout ()
+    {
+        testcase ("fanout");
+
+        // Each subscriber serializes the event for itself
+        auto const each = [] (Json::Value const& jv,
+            std::size_t subscribers,
+            std::vector <std::shared_ptr <WSMsg>>& queued)
+        {
+            for (std::size_t i = 0; i < subscribers; ++i)
+            {
+                beast::streambuf sb;
+                Json::stream (jv,
+                    [&](void const* data, std::size_t n)
+                    {
+                        sb.commit (boost::asio::buffer_copy (
+                            sb.prepare (n), boost::asio::buffer (data, n)));
+                    });
+                queued.push_back (std::make_shared <
+                    StreambufWSMsg <decltype(sb)>> (std::move (sb)));
+            }
+        };
+
+        // The event is serialized once and shared
+        auto const once = [] (Json::Value const& jv,
+            std::size_t subscribers,
+            std::vector <std::shared_ptr <WSMsg>>& queued)
+        {
+            InfoSub::Event const event (jv);
+            for (std::size_t i = 0; i < subscribers; ++i)
+                queued.push_back (
+                    std::make_shared <SharedWSMsg> (event.getText ()));
+        };
+
+        for (std::size_t subscribers : { 1, 10, 100, 1000 })
+        {
+            auto const eachTime = time (subscribers, each);
+            auto const onceTime = time (subscribers, once);
+            log << subscribers << " subscribers: " <<
+                eachTime.count () << "us serializing for each, " <<
+                onceTime.count () << "us serializing once" << std::endl;
+        }
+    }
+
+    void
+    run () override
+    {
+        testFanout ();
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SubscriptionFanoutTiming,server,mtchain);
+
+}
+}
@@ -73,13 +73,58 @@ public:
         return true;
     }
 
+    void testPrefetch (SHAMap::version v)
+    {
+        beast::Journal const j; // debug journal
+        TestFamily f(j);
+        SHAMapHash hash;
+        std::size_t nodes = 0;
+        {
+            SHAMap source (SHAMapType::STATE, f, v);
+            for (int i = 0; i < 5000; ++i)
+                source.addItem (std::move(*makeRandomAS ()), false, false);
+            source.flushDirty (hotACCOUNT_NODE, 1);
+            source.setImmutable ();
+
+            hash = source.getHash ();
+            source.visitNodes ([&nodes](SHAMapAbstractNode&)
+                {
+                    ++nodes;
+                    return false;
+                });
+        }
+
+        // Load the map again from the database alone
+        f.treecache().clear ();
+        SHAMap copy (SHAMapType::STATE, hash.as_uint256 (), f, v);
+        BEAST_EXPECT(copy.fetchRoot (hash, nullptr));
+
+        std::size_t reports = 0;
+        std::size_t loaded = 0;
+        BEAST_EXPECT(copy.prefetch ([&](std::size_t n)
+            {
+                BEAST_EXPECT(n >= loaded);
+                ++reports;
+                loaded = n;
+            }) == 0);
+        BEAST_EXPECT(reports > 0);
+        BEAST_EXPECT(loaded + 1 == nodes);
+        BEAST_EXPECT(f.treecache().getCacheSize () >= nodes - 1);
+
+        std::vector<SHAMapMissingNode> missingNodes;
+        copy.walkMap (missingNodes, 32);
+        BEAST_EXPECT(missingNodes.empty ());
+    }
+
     void run()
     {
         log << "Run, version 1\n" << std::endl;
         run(SHAMap::version{1});
+        testPrefetch(SHAMap::version{1});
 
         log << "Run, version 2\n" << std::endl;
         run(SHAMap::version{2});
+        testPrefetch(SHAMap::version{2});
     }
 
     void run(SHAMap::version v)
@@ -9,6 +9,7 @@
 */
 //==============================================================================
 
+#include <test/app/AccountSubscriptions_test.cpp>
 #include <test/app/AccountTxPaging_test.cpp>
 #include <test/app/AmendmentTable_test.cpp>
 #include <test/app/CrossingLimits_test.cpp>
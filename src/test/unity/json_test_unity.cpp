@@ -9,6 +9,8 @@
 */
 //==============================================================================
 
+#include <test/json/Arena_test.cpp>
+#include <test/json/FastReader_test.cpp>
 #include <test/json/json_value_test.cpp>
 #include <test/json/Object_test.cpp>
 #include <test/json/Output_test.cpp>
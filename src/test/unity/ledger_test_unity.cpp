@@ -11,6 +11,8 @@
 
 #include <test/ledger/BookDirs_test.cpp>
 #include <test/ledger/Directory_test.cpp>
+#include <test/ledger/FetchPackStream_test.cpp>
+#include <test/ledger/FetchPipeline_test.cpp>
 #include <test/ledger/PaymentSandbox_test.cpp>
 #include <test/ledger/PendingSaves_test.cpp>
 #include <test/ledger/SHAMapV2_test.cpp>
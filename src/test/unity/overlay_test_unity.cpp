@@ -10,5 +10,12 @@
 //==============================================================================
 
 #include <test/overlay/cluster_test.cpp>
+#include <test/overlay/compression_test.cpp>
+#include <test/overlay/ledger_data_timing_test.cpp>
+#include <test/overlay/query_tracker_test.cpp>
+#include <test/overlay/send_queue_test.cpp>
 #include <test/overlay/short_read_test.cpp>
-#include <test/overlay/TMHello_test.cpp>
\ No newline at end of file
+#include <test/overlay/squelch_test.cpp>
+#include <test/overlay/TMHello_test.cpp>
+#include <test/overlay/traffic_histograms_test.cpp>
+#include <test/overlay/tx_batch_test.cpp>
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <test/rpc/AccountObjects_test.cpp>
 #include <test/rpc/AccountOffers_test.cpp>
 #include <test/rpc/AccountSet_test.cpp>
+#include <test/rpc/BinaryCommand_test.cpp>
 #include <test/rpc/Book_test.cpp>
 #include <test/rpc/GatewayBalances_test.cpp>
 #include <test/rpc/GetCounts_test.cpp>
@@ -21,11 +22,15 @@
 #include <test/rpc/KeyGeneration_test.cpp>
 #include <test/rpc/LedgerClosed_test.cpp>
 #include <test/rpc/LedgerData_test.cpp>
+#include <test/rpc/LedgerHandle_test.cpp>
 #include <test/rpc/LedgerRPC_test.cpp>
 #include <test/rpc/LedgerRequestRPC_test.cpp>
 #include <test/rpc/NoMTChain_test.cpp>
+#include <test/rpc/ReplyWriter_test.cpp>
 #include <test/rpc/RobustTransaction_test.cpp>
+#include <test/rpc/RPCBatch_test.cpp>
 #include <test/rpc/RPCOverload_test.cpp>
+#include <test/rpc/RPCStats_test.cpp>
 #include <test/rpc/ServerInfo_test.cpp>
 #include <test/rpc/Status_test.cpp>
 #include <test/rpc/Subscribe_test.cpp>
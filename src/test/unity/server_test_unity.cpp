@@ -9,5 +9,7 @@
 */
 //==============================================================================
 
+#include <test/server/PipelineTiming_test.cpp>
 #include <test/server/Server_test.cpp>
 #include <test/server/ServerStatus_test.cpp>
+#include <test/server/SubscriptionFanout_test.cpp>